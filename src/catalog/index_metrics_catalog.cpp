@@ -35,7 +35,8 @@ IndexMetricsCatalog::IndexMetricsCatalog(concurrency::TransactionContext *txn)
                       "reads          INT NOT NULL, "
                       "deletes        INT NOT NULL, "
                       "inserts        INT NOT NULL, "
-                      "time_stamp     INT NOT NULL);",
+                      "time_stamp     INT NOT NULL, "
+                      "memory_bytes   BIGINT NOT NULL);",
                       txn) {
   // Add secondary index here if necessary
 }
@@ -44,7 +45,7 @@ IndexMetricsCatalog::~IndexMetricsCatalog() {}
 
 bool IndexMetricsCatalog::InsertIndexMetrics(
     oid_t database_oid, oid_t table_oid, oid_t index_oid, int64_t reads,
-    int64_t deletes, int64_t inserts, int64_t time_stamp,
+    int64_t deletes, int64_t inserts, int64_t time_stamp, int64_t memory_bytes,
     type::AbstractPool *pool, concurrency::TransactionContext *txn) {
   std::unique_ptr<storage::Tuple> tuple(
       new storage::Tuple(catalog_table_->GetSchema(), true));
@@ -56,6 +57,7 @@ bool IndexMetricsCatalog::InsertIndexMetrics(
   auto val4 = type::ValueFactory::GetIntegerValue(deletes);
   auto val5 = type::ValueFactory::GetIntegerValue(inserts);
   auto val6 = type::ValueFactory::GetIntegerValue(time_stamp);
+  auto val7 = type::ValueFactory::GetBigIntValue(memory_bytes);
 
   tuple->SetValue(ColumnId::DATABASE_OID, val0, pool);
   tuple->SetValue(ColumnId::TABLE_OID, val1, pool);
@@ -64,6 +66,7 @@ bool IndexMetricsCatalog::InsertIndexMetrics(
   tuple->SetValue(ColumnId::DELETES, val4, pool);
   tuple->SetValue(ColumnId::INSERTS, val5, pool);
   tuple->SetValue(ColumnId::TIME_STAMP, val6, pool);
+  tuple->SetValue(ColumnId::MEMORY_BYTES, val7, pool);
 
   // Insert the tuple
   return InsertTuple(std::move(tuple), txn);
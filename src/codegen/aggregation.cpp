@@ -580,6 +580,280 @@ void Aggregation::AdvanceValues(CodeGen &codegen, llvm::Value *space,
   AdvanceValues(codegen, space, next, empty);
 }
 
+//===----------------------------------------------------------------------===//
+// PARTIAL VALUES
+//
+// The partial values of the aggregates are laid out in the order of the
+// aggregates:
+//   COUNT(...), COUNT(*): the count
+//   SUM(), MIN(), MAX(): the value, and whether any value was seen
+//   AVG(): the sum, whether any value was seen, and the count
+//===----------------------------------------------------------------------===//
+
+static bool IsIntegerType(peloton::type::TypeId type_id) {
+  return type_id == peloton::type::TypeId::TINYINT ||
+         type_id == peloton::type::TypeId::SMALLINT ||
+         type_id == peloton::type::TypeId::INTEGER ||
+         type_id == peloton::type::TypeId::BIGINT;
+}
+
+bool Aggregation::SupportsPartialValues() const {
+  if (!IsGlobal()) {
+    return false;
+  }
+  for (const auto &agg_info : aggregate_infos_) {
+    if (agg_info.is_distinct) {
+      return false;
+    }
+    auto type_id = storage_.GetType(agg_info.storage_indices[0]).type_id;
+    switch (agg_info.aggregate_type) {
+      case ExpressionType::AGGREGATE_COUNT:
+      case ExpressionType::AGGREGATE_COUNT_STAR:
+        break;
+      case ExpressionType::AGGREGATE_SUM:
+      case ExpressionType::AGGREGATE_AVG:
+        // Summing decimals in a different order changes the result
+        if (!IsIntegerType(type_id)) return false;
+        break;
+      case ExpressionType::AGGREGATE_MIN:
+      case ExpressionType::AGGREGATE_MAX:
+        if (!IsIntegerType(type_id) &&
+            type_id != peloton::type::TypeId::DECIMAL) {
+          return false;
+        }
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+void Aggregation::CreateInitialPartialValues(
+    CodeGen &codegen, std::vector<llvm::Value *> &partials) const {
+  PL_ASSERT(SupportsPartialValues());
+  for (const auto &agg_info : aggregate_infos_) {
+    switch (agg_info.aggregate_type) {
+      case ExpressionType::AGGREGATE_COUNT:
+      case ExpressionType::AGGREGATE_COUNT_STAR: {
+        partials.push_back(codegen.Const64(0));
+        break;
+      }
+      case ExpressionType::AGGREGATE_SUM:
+      case ExpressionType::AGGREGATE_MIN:
+      case ExpressionType::AGGREGATE_MAX:
+      case ExpressionType::AGGREGATE_AVG: {
+        // Zero is the identity of SUM. MIN/MAX ignore it until a value is seen.
+        const auto &value_type = storage_.GetType(agg_info.storage_indices[0]);
+        llvm::Type *val_type = nullptr, *len_type = nullptr;
+        value_type.GetSqlType().GetTypeForMaterialization(codegen, val_type,
+                                                          len_type);
+        partials.push_back(llvm::Constant::getNullValue(val_type));
+        partials.push_back(codegen.ConstBool(false));
+        if (agg_info.aggregate_type == ExpressionType::AGGREGATE_AVG) {
+          partials.push_back(codegen.Const64(0));
+        }
+        break;
+      }
+      default: {
+        std::string message = StringUtil::Format(
+            "Unexpected aggregate type [%s] when creating partial values",
+            ExpressionTypeToString(agg_info.aggregate_type).c_str());
+        LOG_ERROR("%s", message.c_str());
+        throw Exception{ExceptionType::UNKNOWN_TYPE, message};
+      }
+    }
+  }
+}
+
+void Aggregation::AdvancePartialValue(CodeGen &codegen, ExpressionType type,
+                                      uint32_t storage_index,
+                                      const codegen::Value &update,
+                                      llvm::Value *&value,
+                                      llvm::Value *&valid) const {
+  const auto value_type = storage_.GetType(storage_index).AsNonNullable();
+  llvm::Value *update_not_null = update.IsNotNull(codegen);
+  codegen::Value curr{value_type, value};
+
+  if (type == ExpressionType::AGGREGATE_SUM) {
+    // Add zero for NULLs, so that they never trip the overflow check
+    llvm::Value *zero = llvm::Constant::getNullValue(value->getType());
+    codegen::Value delta{
+        value_type,
+        codegen->CreateSelect(update_not_null, update.GetValue(), zero)};
+    value = curr.Add(codegen, delta).GetValue();
+  } else {
+    PL_ASSERT(type == ExpressionType::AGGREGATE_MIN ||
+              type == ExpressionType::AGGREGATE_MAX);
+    codegen::Value next{value_type, update.GetValue()};
+    codegen::Value combined = type == ExpressionType::AGGREGATE_MIN
+                                  ? curr.Min(codegen, next)
+                                  : curr.Max(codegen, next);
+    llvm::Value *advanced = codegen->CreateSelect(
+        valid, combined.GetValue(), update.GetValue());
+    value = codegen->CreateSelect(update_not_null, advanced, value);
+  }
+  valid = codegen->CreateOr(valid, update_not_null);
+}
+
+void Aggregation::AdvancePartialValues(
+    CodeGen &codegen, std::vector<llvm::Value *> &partials,
+    const std::vector<codegen::Value> &next) const {
+  uint32_t pos = 0;
+  for (const auto &agg_info : aggregate_infos_) {
+    const Value &update = next[agg_info.source_index];
+    switch (agg_info.aggregate_type) {
+      case ExpressionType::AGGREGATE_COUNT_STAR: {
+        partials[pos] = codegen->CreateAdd(partials[pos], codegen.Const64(1));
+        pos++;
+        break;
+      }
+      case ExpressionType::AGGREGATE_COUNT: {
+        llvm::Value *delta = codegen->CreateZExt(update.IsNotNull(codegen),
+                                                 codegen.Int64Type());
+        partials[pos] = codegen->CreateAdd(partials[pos], delta);
+        pos++;
+        break;
+      }
+      case ExpressionType::AGGREGATE_SUM:
+      case ExpressionType::AGGREGATE_MIN:
+      case ExpressionType::AGGREGATE_MAX: {
+        AdvancePartialValue(codegen, agg_info.aggregate_type,
+                            agg_info.storage_indices[0], update,
+                            partials[pos], partials[pos + 1]);
+        pos += 2;
+        break;
+      }
+      case ExpressionType::AGGREGATE_AVG: {
+        AdvancePartialValue(codegen, ExpressionType::AGGREGATE_SUM,
+                            agg_info.storage_indices[0], update,
+                            partials[pos], partials[pos + 1]);
+        llvm::Value *delta = codegen->CreateZExt(update.IsNotNull(codegen),
+                                                 codegen.Int64Type());
+        partials[pos + 2] = codegen->CreateAdd(partials[pos + 2], delta);
+        pos += 3;
+        break;
+      }
+      default: {
+        std::string message = StringUtil::Format(
+            "Unexpected aggregate type [%s] when advancing partial values",
+            ExpressionTypeToString(agg_info.aggregate_type).c_str());
+        LOG_ERROR("%s", message.c_str());
+        throw Exception{ExceptionType::UNKNOWN_TYPE, message};
+      }
+    }
+  }
+}
+
+void Aggregation::CombinePartialValues(
+    CodeGen &codegen, std::vector<llvm::Value *> &partials,
+    const std::vector<llvm::Value *> &other) const {
+  PL_ASSERT(partials.size() == other.size());
+  uint32_t pos = 0;
+  for (const auto &agg_info : aggregate_infos_) {
+    switch (agg_info.aggregate_type) {
+      case ExpressionType::AGGREGATE_COUNT:
+      case ExpressionType::AGGREGATE_COUNT_STAR: {
+        partials[pos] = codegen->CreateAdd(partials[pos], other[pos]);
+        pos++;
+        break;
+      }
+      case ExpressionType::AGGREGATE_SUM:
+      case ExpressionType::AGGREGATE_MIN:
+      case ExpressionType::AGGREGATE_MAX:
+      case ExpressionType::AGGREGATE_AVG: {
+        // The other partial value is NULL if it has not seen any value
+        uint32_t storage_index = agg_info.storage_indices[0];
+        codegen::Value update{storage_.GetType(storage_index).AsNullable(),
+                              other[pos], nullptr,
+                              codegen->CreateNot(other[pos + 1])};
+        auto type = agg_info.aggregate_type == ExpressionType::AGGREGATE_AVG
+                        ? ExpressionType::AGGREGATE_SUM
+                        : agg_info.aggregate_type;
+        AdvancePartialValue(codegen, type, storage_index, update,
+                            partials[pos], partials[pos + 1]);
+        pos += 2;
+        if (agg_info.aggregate_type == ExpressionType::AGGREGATE_AVG) {
+          partials[pos] = codegen->CreateAdd(partials[pos], other[pos]);
+          pos++;
+        }
+        break;
+      }
+      default: {
+        std::string message = StringUtil::Format(
+            "Unexpected aggregate type [%s] when combining partial values",
+            ExpressionTypeToString(agg_info.aggregate_type).c_str());
+        LOG_ERROR("%s", message.c_str());
+        throw Exception{ExceptionType::UNKNOWN_TYPE, message};
+      }
+    }
+  }
+}
+
+void Aggregation::MergePartialValues(
+    CodeGen &codegen, llvm::Value *space,
+    const std::vector<llvm::Value *> &partials) const {
+  // The null bitmap tracker
+  UpdateableStorage::NullBitmap null_bitmap{codegen, storage_, space};
+
+  // Counts are never NULL, so add them directly
+  auto merge_count = [this, &codegen, space](uint32_t storage_index,
+                                             llvm::Value *count) {
+    auto curr = storage_.GetValueSkipNull(codegen, space, storage_index);
+    auto next = curr.Add(codegen, Value{type::BigInt::Instance(), count});
+    storage_.SetValueSkipNull(codegen, space, storage_index, next);
+  };
+
+  // Other values are advanced like a single row, which is NULL if the partial
+  // value has not seen any value
+  auto merge_value = [this, &codegen, space, &null_bitmap](
+      ExpressionType type, uint32_t storage_index, llvm::Value *value,
+      llvm::Value *valid) {
+    codegen::Value update{storage_.GetType(storage_index).AsNullable(), value,
+                          nullptr, codegen->CreateNot(valid)};
+    // Global aggregates are always NULL-able
+    PL_ASSERT(null_bitmap.IsNullable(storage_index));
+    DoNullCheck(codegen, space, type, storage_index, update, null_bitmap);
+  };
+
+  uint32_t pos = 0;
+  for (const auto &agg_info : aggregate_infos_) {
+    switch (agg_info.aggregate_type) {
+      case ExpressionType::AGGREGATE_COUNT:
+      case ExpressionType::AGGREGATE_COUNT_STAR: {
+        merge_count(agg_info.storage_indices[0], partials[pos]);
+        pos++;
+        break;
+      }
+      case ExpressionType::AGGREGATE_SUM:
+      case ExpressionType::AGGREGATE_MIN:
+      case ExpressionType::AGGREGATE_MAX: {
+        merge_value(agg_info.aggregate_type, agg_info.storage_indices[0],
+                    partials[pos], partials[pos + 1]);
+        pos += 2;
+        break;
+      }
+      case ExpressionType::AGGREGATE_AVG: {
+        merge_value(ExpressionType::AGGREGATE_SUM, agg_info.storage_indices[0],
+                    partials[pos], partials[pos + 1]);
+        merge_count(agg_info.storage_indices[1], partials[pos + 2]);
+        pos += 3;
+        break;
+      }
+      default: {
+        std::string message = StringUtil::Format(
+            "Unexpected aggregate type [%s] when merging partial values",
+            ExpressionTypeToString(agg_info.aggregate_type).c_str());
+        LOG_ERROR("%s", message.c_str());
+        throw Exception{ExceptionType::UNKNOWN_TYPE, message};
+      }
+    }
+  }
+
+  // Write the final contents of the null bitmap
+  null_bitmap.WriteBack(codegen);
+}
+
 // This function will compute the final values of all aggregates stored in the
 // provided storage space, populating the provided vector with these values.
 void Aggregation::FinalizeValues(
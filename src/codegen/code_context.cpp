@@ -12,12 +12,24 @@
 
 #include "codegen/code_context.h"
 
+#if LLVM_VERSION_GE(4, 0)
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#else
+#include "llvm/Bitcode/ReaderWriter.h"
+#endif
 #include "llvm/ExecutionEngine/MCJIT.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Linker/Linker.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/raw_os_ostream.h"
+#if LLVM_VERSION_GE(4, 0)
+#include "llvm/Transforms/IPO/AlwaysInliner.h"
+#else
+#include "llvm/Transforms/IPO.h"
+#endif
 #include "llvm/Transforms/Scalar.h"
 #if LLVM_VERSION_GE(3, 9)
 #include "llvm/Transforms/Scalar/GVN.h"
@@ -189,6 +201,68 @@ void CodeContext::RegisterBuiltin(llvm::Function *func_decl,
   function_symbols_[name] = func_impl;
 }
 
+void CodeContext::SaveBitcode() {
+  bitcode_.clear();
+  llvm::raw_string_ostream ostream{bitcode_};
+#if LLVM_VERSION_GE(7, 0)
+  llvm::WriteBitcodeToFile(*module_, ostream);
+#else
+  llvm::WriteBitcodeToFile(module_, ostream);
+#endif
+  ostream.flush();
+}
+
+llvm::Function *CodeContext::LinkFunction(const CodeContext &other,
+                                          llvm::Function *func) {
+  const std::string name = func->getName().str();
+
+  // The function may have been linked in for another call already
+  auto *linked_func = module_->getFunction(name);
+  if (linked_func != nullptr && !linked_func->isDeclaration()) {
+    return linked_func;
+  }
+
+#if LLVM_VERSION_GE(3, 9)
+  if (other.bitcode_.empty()) {
+    return nullptr;
+  }
+
+  // Each context has its own LLVM context, so the other module is read back
+  // from its bitcode into ours
+  llvm::MemoryBufferRef buffer{other.bitcode_, name};
+  auto module = llvm::parseBitcodeFile(buffer, *context_);
+  if (!module) {
+#if LLVM_VERSION_GE(4, 0)
+    llvm::consumeError(module.takeError());
+#endif
+    LOG_ERROR("Could not read the bitcode of function '%s'", name.c_str());
+    return nullptr;
+  }
+  (*module)->setDataLayout(module_->getDataLayout());
+  (*module)->setTargetTriple(module_->getTargetTriple());
+
+  if (llvm::Linker::linkModules(*module_, std::move(*module))) {
+    LOG_ERROR("Could not link function '%s'", name.c_str());
+    return nullptr;
+  }
+
+  // Keep the definition private to this module and inline it into its callers.
+  // Builtins it calls resolve to the same implementations as in the other
+  // context.
+  linked_func = module_->getFunction(name);
+  PL_ASSERT(linked_func != nullptr && !linked_func->isDeclaration());
+  linked_func->setLinkage(llvm::GlobalValue::InternalLinkage);
+  linked_func->addFnAttr(llvm::Attribute::AlwaysInline);
+  function_symbols_.insert(other.function_symbols_.begin(),
+                           other.function_symbols_.end());
+  linked_functions_.push_back(linked_func);
+  return linked_func;
+#else
+  (void)other;
+  return nullptr;
+#endif
+}
+
 /// Optimize and JIT compile all the functions that were created in this context
 bool CodeContext::Compile() {
   // Verify the module is okay
@@ -200,8 +274,24 @@ bool CodeContext::Compile() {
     return false;
   }
 
-  // Run the optimization passes over each function in this module
+  // Run the optimization passes over each function in this module. Functions
+  // linked in from other contexts are optimized and inlined into their callers
+  // first, so that they're optimized again together with the calling code.
   pass_manager_->doInitialization();
+  if (!linked_functions_.empty()) {
+    for (auto *func : linked_functions_) {
+      pass_manager_->run(*func);
+    }
+    linked_functions_.clear();
+
+    llvm::legacy::PassManager inliner;
+#if LLVM_VERSION_GE(4, 0)
+    inliner.add(llvm::createAlwaysInlinerLegacyPass());
+#else
+    inliner.add(llvm::createAlwaysInlinerPass());
+#endif
+    inliner.run(*module_);
+  }
   for (auto &func_iter : functions_) {
     pass_manager_->run(*func_iter.first);
   }
@@ -96,11 +96,9 @@ codegen::Value FunctionTranslator::DeriveValue(CodeGen &codegen,
       raw_args.push_back(args[i].GetValue());
     }
 
-    std::unique_ptr<peloton::udf::UDFHandler> udf_handler(
-        new peloton::udf::UDFHandler());
-
-    // Register function prototype in current context
-    auto *func_ptr = udf_handler->RegisterExternalFunction(codegen, func_expr);
+    // Link the UDF into the current context, so that it's inlined here
+    peloton::udf::UDFHandler udf_handler;
+    auto *func_ptr = udf_handler.LinkFunction(codegen, func_expr);
 
     auto call_ret = codegen.CallFunc(func_ptr, raw_args);
 
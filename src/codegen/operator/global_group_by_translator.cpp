@@ -14,6 +14,7 @@
 
 #include "codegen/compilation_context.h"
 #include "codegen/lang/if.h"
+#include "codegen/lang/loop.h"
 #include "common/logger.h"
 #include "planner/aggregate_plan.h"
 
@@ -22,6 +23,10 @@ namespace codegen {
 
 static const std::string kMatBufferTypeName = "Buffer";
 
+// The number of independent sets of partial aggregates advanced over a batch.
+// Must be a power of two.
+static const uint32_t kPartialLanes = 4;
+
 GlobalGroupByTranslator::GlobalGroupByTranslator(
     const planner::AggregatePlan &plan, CompilationContext &context,
     Pipeline &pipeline)
@@ -109,21 +114,128 @@ void GlobalGroupByTranslator::Produce() const {
   context.Consume(batch);
 }
 
+void GlobalGroupByTranslator::Consume(ConsumerContext &context,
+                                      RowBatch &batch) const {
+  if (!aggregation_.SupportsPartialValues()) {
+    OperatorTranslator::Consume(context, batch);
+    return;
+  }
+
+  auto &codegen = GetCodeGen();
+
+  // The partial values of an empty batch
+  std::vector<llvm::Value *> initial;
+  aggregation_.CreateInitialPartialValues(codegen, initial);
+  const uint32_t num_partials = static_cast<uint32_t>(initial.size());
+
+  // Rows are consumed kPartialLanes at a time. Each lane advances its own set
+  // of partial values, so the updates of neighbouring rows do not depend on
+  // each other.
+  auto *num_rows = batch.GetNumValidRows(codegen);
+  auto *num_unrolled =
+      codegen->CreateAnd(num_rows, codegen.Const32(~(kPartialLanes - 1)));
+
+  std::vector<lang::Loop::LoopVariable> loop_vars = {
+      {"batchPos", codegen.Const32(0)}};
+  for (uint32_t lane = 0; lane < kPartialLanes; lane++) {
+    for (auto *partial : initial) {
+      loop_vars.push_back({"partial" + std::to_string(lane), partial});
+    }
+  }
+
+  std::vector<llvm::Value *> final_vals;
+  lang::Loop unrolled_loop{
+      codegen, codegen->CreateICmpULT(codegen.Const32(0), num_unrolled),
+      loop_vars};
+  {
+    auto *batch_pos = unrolled_loop.GetLoopVar(0);
+    std::vector<llvm::Value *> next_vals = {
+        codegen->CreateAdd(batch_pos, codegen.Const32(kPartialLanes))};
+    for (uint32_t lane = 0; lane < kPartialLanes; lane++) {
+      std::vector<llvm::Value *> partials;
+      for (uint32_t i = 0; i < num_partials; i++) {
+        partials.push_back(
+            unrolled_loop.GetLoopVar(1 + lane * num_partials + i));
+      }
+
+      RowBatch::Row row =
+          batch.GetRowAt(codegen->CreateAdd(batch_pos, codegen.Const32(lane)));
+      std::vector<codegen::Value> vals;
+      DeriveAggregateValues(row, vals);
+      aggregation_.AdvancePartialValues(codegen, partials, vals);
+
+      next_vals.insert(next_vals.end(), partials.begin(), partials.end());
+    }
+    unrolled_loop.LoopEnd(codegen->CreateICmpULT(next_vals[0], num_unrolled),
+                          next_vals);
+  }
+  unrolled_loop.CollectFinalLoopVariables(final_vals);
+
+  // Combine the lanes
+  std::vector<llvm::Value *> partials(final_vals.begin() + 1,
+                                      final_vals.begin() + 1 + num_partials);
+  for (uint32_t lane = 1; lane < kPartialLanes; lane++) {
+    auto lane_begin = final_vals.begin() + 1 + lane * num_partials;
+    std::vector<llvm::Value *> lane_partials(lane_begin,
+                                             lane_begin + num_partials);
+    aggregation_.CombinePartialValues(codegen, partials, lane_partials);
+  }
+
+  // Consume the remaining rows one at a time
+  loop_vars = {{"batchPos", num_unrolled}};
+  for (auto *partial : partials) {
+    loop_vars.push_back({"partial", partial});
+  }
+  lang::Loop remainder_loop{
+      codegen, codegen->CreateICmpULT(num_unrolled, num_rows), loop_vars};
+  {
+    auto *batch_pos = remainder_loop.GetLoopVar(0);
+    std::vector<llvm::Value *> next_vals = {
+        codegen->CreateAdd(batch_pos, codegen.Const32(1))};
+    std::vector<llvm::Value *> row_partials;
+    for (uint32_t i = 0; i < num_partials; i++) {
+      row_partials.push_back(remainder_loop.GetLoopVar(1 + i));
+    }
+
+    RowBatch::Row row = batch.GetRowAt(batch_pos);
+    std::vector<codegen::Value> vals;
+    DeriveAggregateValues(row, vals);
+    aggregation_.AdvancePartialValues(codegen, row_partials, vals);
+
+    next_vals.insert(next_vals.end(), row_partials.begin(), row_partials.end());
+    remainder_loop.LoopEnd(codegen->CreateICmpULT(next_vals[0], num_rows),
+                           next_vals);
+  }
+  final_vals.clear();
+  remainder_loop.CollectFinalLoopVariables(final_vals);
+
+  // Fold the partial values of the batch into the buffer, once
+  partials.assign(final_vals.begin() + 1, final_vals.end());
+  aggregation_.MergePartialValues(codegen, LoadStatePtr(mat_buffer_id_),
+                                  partials);
+}
+
 void GlobalGroupByTranslator::Consume(ConsumerContext &,
                                       RowBatch::Row &row) const {
   // Get the updates to advance the aggregates
+  std::vector<codegen::Value> vals;
+  DeriveAggregateValues(row, vals);
+
+  // Just advance each of the aggregates in the buffer with the provided
+  // new values
+  aggregation_.AdvanceValues(GetCodeGen(), LoadStatePtr(mat_buffer_id_), vals);
+}
+
+void GlobalGroupByTranslator::DeriveAggregateValues(
+    RowBatch::Row &row, std::vector<codegen::Value> &vals) const {
   auto &aggregates = plan_.GetUniqueAggTerms();
-  std::vector<codegen::Value> vals{aggregates.size()};
+  vals.resize(aggregates.size());
   for (uint32_t i = 0; i < aggregates.size(); i++) {
     const auto &agg_term = aggregates[i];
     if (agg_term.expression != nullptr) {
       vals[i] = row.DeriveValue(GetCodeGen(), *agg_term.expression);
     }
   }
-
-  // Just advance each of the aggregates in the buffer with the provided
-  // new values
-  aggregation_.AdvanceValues(GetCodeGen(), LoadStatePtr(mat_buffer_id_), vals);
 }
 
 // Cleanup by destroying the aggregation hash-table
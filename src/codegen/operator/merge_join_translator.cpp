@@ -0,0 +1,315 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// merge_join_translator.cpp
+//
+// Identification: src/codegen/operator/merge_join_translator.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/operator/merge_join_translator.h"
+
+#include "codegen/compilation_context.h"
+#include "codegen/lang/if.h"
+#include "codegen/lang/loop.h"
+#include "codegen/operator/projection_translator.h"
+#include "codegen/proxy/sorter_proxy.h"
+#include "codegen/type/integer_type.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/merge_join_plan.h"
+
+namespace peloton {
+namespace codegen {
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// The psuedocode for the join is:
+///
+/// function main():
+///   Buffer b
+///   for r in R:
+///     if r.key is not NULL:
+///       b.append(r)
+///   cursor = 0
+///   for s in S:
+///     if s.key is NULL:
+///       continue
+///     while cursor < b.size() and b[cursor].key < s.key:
+///       cursor++
+///     for (i = cursor; i < b.size() and b[i].key == s.key; i++):
+///       if pred(b[i], s):
+///         emit(b[i], s)
+///
+/// Left tuples with NULL keys never join, and dropping them keeps the buffer
+/// sorted on its keys.
+///
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Collect the attributes of the left input the expression refers to
+void CollectLeftAttributes(
+    const expression::AbstractExpression &expr,
+    std::vector<const planner::AttributeInfo *> &attributes) {
+  if (expr.GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+    auto &tve = static_cast<const expression::TupleValueExpression &>(expr);
+    const auto *ai = tve.GetAttributeRef();
+    if (tve.GetTupleId() == 0 &&
+        std::find(attributes.begin(), attributes.end(), ai) ==
+            attributes.end()) {
+      attributes.push_back(ai);
+    }
+  }
+  for (size_t i = 0; i < expr.GetChildrenSize(); i++) {
+    CollectLeftAttributes(*expr.GetChild(i), attributes);
+  }
+}
+
+}  // anonymous namespace
+
+MergeJoinTranslator::MergeJoinTranslator(
+    const planner::MergeJoinPlan &join_plan, CompilationContext &context,
+    Pipeline &pipeline)
+    : OperatorTranslator(context, pipeline),
+      join_plan_(join_plan),
+      left_pipeline_(this) {
+  PL_ASSERT(join_plan.GetChildrenSize() == 2 &&
+            "Merge join must have exactly two children");
+  PL_ASSERT(join_plan.GetJoinType() == JoinType::INNER);
+
+  // Prepare children
+  context.Prepare(*join_plan.GetChild(0), left_pipeline_);
+  context.Prepare(*join_plan.GetChild(1), pipeline);
+
+  // Prepare the expressions producing the keys of both sides
+  std::vector<type::Type> buffer_desc;
+  for (const auto &join_clause : *join_plan.GetJoinClauses()) {
+    PL_ASSERT(!join_clause.reversed_);
+    left_key_exprs_.push_back(join_clause.left_.get());
+    right_key_exprs_.push_back(join_clause.right_.get());
+    context.Prepare(*join_clause.left_);
+    context.Prepare(*join_clause.right_);
+    buffer_desc.push_back(join_clause.left_->ResultType());
+  }
+
+  // Prepare join predicate (if one exists)
+  auto *predicate = join_plan.GetPredicate();
+  if (predicate != nullptr) {
+    context.Prepare(*predicate);
+  }
+
+  // Prepare projection (if one exists)
+  auto *projection = join_plan.GetProjInfo();
+  if (projection != nullptr) {
+    ProjectionTranslator::PrepareProjection(context, *projection);
+  }
+
+  // Collect all unique attributes from the left side that the projection and
+  // the predicate need
+  for (const auto *ai : join_plan.GetLeftAttributes()) {
+    if (std::find(unique_left_attributes_.begin(),
+                  unique_left_attributes_.end(),
+                  ai) == unique_left_attributes_.end()) {
+      unique_left_attributes_.push_back(ai);
+    }
+  }
+  if (predicate != nullptr) {
+    CollectLeftAttributes(*predicate, unique_left_attributes_);
+  }
+  for (const auto *ai : unique_left_attributes_) {
+    buffer_desc.push_back(ai->type);
+  }
+
+  // Allocate the buffer and the cursor into it in the runtime state
+  auto &codegen = GetCodeGen();
+  auto &runtime_state = context.GetRuntimeState();
+  buffer_id_ =
+      runtime_state.RegisterState("buffer", SorterProxy::GetType(codegen));
+  buffer_ = Sorter{codegen, buffer_desc};
+  cursor_id_ = runtime_state.RegisterState("cursor", codegen.Int32Type());
+}
+
+void MergeJoinTranslator::InitializeState() {
+  auto &codegen = GetCodeGen();
+  auto *null_func = codegen.Null(
+      proxy::TypeBuilder<util::Sorter::ComparisonFunction>::GetType(codegen));
+  buffer_.Init(codegen, LoadStatePtr(buffer_id_), null_func);
+  codegen->CreateStore(codegen.Const32(0), LoadStatePtr(cursor_id_));
+}
+
+void MergeJoinTranslator::TearDownState() {
+  buffer_.Destroy(GetCodeGen(), LoadStatePtr(buffer_id_));
+}
+
+std::string MergeJoinTranslator::GetName() const {
+  return StringUtil::Format("MergeJoin[# keys: %zu]", left_key_exprs_.size());
+}
+
+void MergeJoinTranslator::Produce() const {
+  // Let the left child fill the buffer, then merge it with the right child
+  GetCompilationContext().Produce(*GetPlan().GetChild(0));
+  GetCompilationContext().Produce(*GetPlan().GetChild(1));
+}
+
+bool MergeJoinTranslator::IsFromLeftChild(const Pipeline &pipeline) const {
+  return pipeline.GetChild() == left_pipeline_.GetChild();
+}
+
+void MergeJoinTranslator::Consume(ConsumerContext &ctx,
+                                  RowBatch::Row &row) const {
+  if (IsFromLeftChild(ctx.GetPipeline())) {
+    ConsumeFromLeft(ctx, row);
+  } else {
+    ConsumeFromRight(ctx, row);
+  }
+}
+
+void MergeJoinTranslator::ConsumeFromLeft(
+    UNUSED_ATTRIBUTE ConsumerContext &context, RowBatch::Row &row) const {
+  auto &codegen = GetCodeGen();
+
+  // Construct tuple, keys first
+  std::vector<Value> tuple;
+  llvm::Value *null_key = codegen.ConstBool(false);
+  for (const auto *left_key : left_key_exprs_) {
+    tuple.push_back(row.DeriveValue(codegen, *left_key));
+    null_key = codegen->CreateOr(null_key, tuple.back().IsNull(codegen));
+  }
+  for (const auto *left_ai : unique_left_attributes_) {
+    tuple.push_back(row.DeriveValue(codegen, left_ai));
+  }
+
+  // Append tuple to buffer
+  lang::If has_key{codegen, codegen->CreateNot(null_key)};
+  {
+    buffer_.Append(codegen, LoadStatePtr(buffer_id_), tuple);
+  }
+  has_key.EndIf();
+}
+
+llvm::Value *MergeJoinTranslator::CompareKeys(
+    Sorter::SorterAccess::Row &left_row,
+    const std::vector<codegen::Value> &right_keys) const {
+  auto &codegen = GetCodeGen();
+  codegen::Value result;
+  codegen::Value zero{type::Integer::Instance(), codegen.Const32(0)};
+  for (uint32_t idx = 0; idx < right_keys.size(); idx++) {
+    auto left_key = left_row.LoadColumn(codegen, idx);
+    auto cmp = left_key.CompareForSort(codegen, right_keys[idx]);
+    if (idx == 0) {
+      result = cmp;
+    } else {
+      // Carry forward the result of the previous keys unless they were equal
+      auto prev_zero = result.CompareEq(codegen, zero);
+      result = codegen::Value{
+          type::Integer::Instance(),
+          codegen->CreateSelect(prev_zero.GetValue(), cmp.GetValue(),
+                                result.GetValue())};
+    }
+  }
+  return result.GetValue();
+}
+
+void MergeJoinTranslator::ConsumeFromRight(ConsumerContext &context,
+                                           RowBatch::Row &row) const {
+  auto &codegen = GetCodeGen();
+
+  std::vector<codegen::Value> right_keys;
+  llvm::Value *null_key = codegen.ConstBool(false);
+  for (const auto *right_key : right_key_exprs_) {
+    right_keys.push_back(row.DeriveValue(codegen, *right_key));
+    null_key = codegen->CreateOr(null_key, right_keys.back().IsNull(codegen));
+  }
+
+  lang::If has_key{codegen, codegen->CreateNot(null_key)};
+  {
+    auto *buffer_ptr = LoadStatePtr(buffer_id_);
+    auto *cursor_ptr = LoadStatePtr(cursor_id_);
+    auto *num_tuples = buffer_.GetNumberOfStoredTuples(codegen, buffer_ptr);
+    auto *start_pos = buffer_.GetStartPosition(codegen, buffer_ptr);
+    auto *cursor = codegen->CreateLoad(cursor_ptr);
+
+    // Skip the left tuples with smaller keys
+    std::vector<llvm::Value *> final_vals;
+    Sorter::SorterAccess skip_access{buffer_, start_pos};
+    lang::Loop skip_loop{codegen,
+                         codegen->CreateICmpULT(cursor, num_tuples),
+                         {{"leftPos", cursor}}};
+    {
+      auto *left_pos = skip_loop.GetLoopVar(0);
+      auto &left_row = skip_access.GetRow(left_pos);
+      auto *cmp = CompareKeys(left_row, right_keys);
+      lang::If not_smaller{codegen,
+                           codegen->CreateICmpSGE(cmp, codegen.Const32(0))};
+      {
+        skip_loop.Break();
+      }
+      not_smaller.EndIf();
+
+      auto *next_pos = codegen->CreateAdd(left_pos, codegen.Const32(1));
+      skip_loop.LoopEnd(codegen->CreateICmpULT(next_pos, num_tuples),
+                        {next_pos});
+    }
+    skip_loop.CollectFinalLoopVariables(final_vals);
+    auto *match_start = final_vals[0];
+    codegen->CreateStore(match_start, cursor_ptr);
+
+    // Join with the left tuples with equal keys
+    Sorter::SorterAccess match_access{buffer_, start_pos};
+    lang::Loop match_loop{codegen,
+                          codegen->CreateICmpULT(match_start, num_tuples),
+                          {{"matchPos", match_start}}};
+    {
+      auto *match_pos = match_loop.GetLoopVar(0);
+      auto &left_row = match_access.GetRow(match_pos);
+      auto *cmp = CompareKeys(left_row, right_keys);
+      lang::If not_equal{codegen,
+                         codegen->CreateICmpNE(cmp, codegen.Const32(0))};
+      {
+        match_loop.Break();
+      }
+      not_equal.EndIf();
+
+      // Add all the attributes from the left tuple into the row coming from
+      // the right input side
+      const uint32_t num_keys = static_cast<uint32_t>(left_key_exprs_.size());
+      for (uint32_t i = 0; i < unique_left_attributes_.size(); i++) {
+        row.RegisterAttributeValue(unique_left_attributes_[i],
+                                   left_row.LoadColumn(codegen, num_keys + i));
+      }
+
+      auto *predicate = GetPlan().GetPredicate();
+      const auto *projection_info = GetPlan().GetProjInfo();
+      std::vector<RowBatch::ExpressionAccess> derived_attribute_access;
+      if (predicate == nullptr) {
+        if (projection_info != nullptr) {
+          ProjectionTranslator::AddNonTrivialAttributes(
+              row.GetBatch(), *projection_info, derived_attribute_access);
+        }
+        context.Consume(row);
+      } else {
+        const auto &valid = row.DeriveValue(codegen, *predicate);
+        lang::If valid_match{codegen, valid};
+        {
+          if (projection_info != nullptr) {
+            ProjectionTranslator::AddNonTrivialAttributes(
+                row.GetBatch(), *projection_info, derived_attribute_access);
+          }
+          context.Consume(row);
+        }
+        valid_match.EndIf();
+      }
+
+      auto *next_pos = codegen->CreateAdd(match_pos, codegen.Const32(1));
+      match_loop.LoopEnd(codegen->CreateICmpULT(next_pos, num_tuples),
+                         {next_pos});
+    }
+  }
+  has_key.EndIf();
+}
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,262 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// sorted_group_by_translator.cpp
+//
+// Identification: src/codegen/operator/sorted_group_by_translator.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/operator/sorted_group_by_translator.h"
+
+#include "codegen/compilation_context.h"
+#include "codegen/lang/if.h"
+#include "codegen/operator/projection_translator.h"
+#include "codegen/vector.h"
+#include "common/logger.h"
+#include "planner/aggregate_plan.h"
+
+namespace peloton {
+namespace codegen {
+
+static const std::string kAggBufferTypeName = "SortedGroupByBuffer";
+
+SortedGroupByTranslator::SortedGroupByTranslator(
+    const planner::AggregatePlan &plan, CompilationContext &context,
+    Pipeline &pipeline)
+    : OperatorTranslator(context, pipeline),
+      plan_(plan),
+      child_pipeline_(this),
+      aggregation_(context.GetRuntimeState()) {
+  LOG_DEBUG("Constructing SortedGroupByTranslator ...");
+
+  auto &codegen = GetCodeGen();
+  auto &runtime_state = context.GetRuntimeState();
+
+  // Prepare the input operator to this group by
+  context.Prepare(*plan_.GetChild(0), child_pipeline_);
+
+  // Prepare the predicate if one exists
+  if (plan_.GetPredicate() != nullptr) {
+    context.Prepare(*plan_.GetPredicate());
+  }
+
+  // The grouping keys of the current group. They're all stored as nullable
+  // since NULL keys form a group of their own.
+  std::vector<type::Type> key_type;
+  for (const auto *grouping_ai : plan_.GetGroupbyAIs()) {
+    key_type.push_back(grouping_ai->type);
+    key_storage_.AddType(grouping_ai->type.AsNullable());
+  }
+  group_keys_id_ =
+      runtime_state.RegisterState("groupKeys", key_storage_.Finalize(codegen));
+
+  // Prepare all the aggregation expressions
+  const auto &aggregates = plan_.GetUniqueAggTerms();
+  for (const auto &agg_term : aggregates) {
+    if (agg_term.expression != nullptr) {
+      context.Prepare(*agg_term.expression);
+    }
+  }
+
+  // Prepare the projection (if one exists)
+  const auto *projection_info = plan_.GetProjectInfo();
+  if (projection_info != nullptr) {
+    ProjectionTranslator::PrepareProjection(context, *projection_info);
+  }
+
+  // Setup the aggregation logic for this group by
+  aggregation_.Setup(codegen, aggregates, false, key_type);
+
+  // The aggregates of the current group
+  auto *aggregate_storage = aggregation_.GetAggregateStorage().GetStorageType();
+  PL_ASSERT(aggregate_storage->isStructTy());
+  auto *agg_buffer_type = llvm::StructType::create(
+      codegen.GetContext(),
+      llvm::cast<llvm::StructType>(aggregate_storage)->elements(),
+      kAggBufferTypeName, true);
+  agg_buffer_id_ = runtime_state.RegisterState("aggBuf", agg_buffer_type);
+
+  has_group_id_ = runtime_state.RegisterState("hasGroup", codegen.BoolType());
+
+  LOG_DEBUG("Finished constructing SortedGroupByTranslator ...");
+}
+
+void SortedGroupByTranslator::InitializeState() {
+  auto &codegen = GetCodeGen();
+  codegen->CreateStore(codegen.ConstBool(false), LoadStatePtr(has_group_id_));
+  aggregation_.InitializeState(codegen);
+}
+
+void SortedGroupByTranslator::Produce() const {
+  auto &codegen = GetCodeGen();
+
+  // Let the child produce its tuples, sending each finished group up
+  GetCompilationContext().Produce(*plan_.GetChild(0));
+
+  // The last group is finished once the input is
+  auto *has_group = codegen->CreateLoad(LoadStatePtr(has_group_id_));
+  lang::If last_group{codegen, has_group};
+  {
+    ProduceGroup();
+  }
+  last_group.EndIf();
+}
+
+void SortedGroupByTranslator::Consume(ConsumerContext &,
+                                      RowBatch::Row &row) const {
+  auto &codegen = GetCodeGen();
+
+  // Collect the grouping keys and the values to advance the aggregates with
+  std::vector<codegen::Value> keys;
+  for (const auto *grouping_ai : plan_.GetGroupbyAIs()) {
+    keys.push_back(row.DeriveValue(codegen, grouping_ai));
+  }
+  const auto &aggregates = plan_.GetUniqueAggTerms();
+  std::vector<codegen::Value> vals(aggregates.size());
+  for (uint32_t i = 0; i < aggregates.size(); i++) {
+    const auto &agg_term = aggregates[i];
+    if (agg_term.expression != nullptr) {
+      vals[i] = row.DeriveValue(codegen, *agg_term.expression);
+    }
+  }
+
+  // The stored keys are only read when there is a current group
+  auto *has_group_ptr = LoadStatePtr(has_group_id_);
+  auto *has_group = codegen->CreateLoad(has_group_ptr);
+  llvm::Value *same_group = nullptr;
+  lang::If in_group{codegen, has_group};
+  {
+    same_group = IsSameGroup(keys);
+  }
+  in_group.EndIf();
+  same_group = in_group.BuildPHI(same_group, codegen.ConstBool(false));
+
+  auto *agg_buffer = LoadStatePtr(agg_buffer_id_);
+  lang::If is_same_group{codegen, same_group};
+  {
+    aggregation_.AdvanceValues(codegen, agg_buffer, vals, keys);
+  }
+  is_same_group.ElseBlock();
+  {
+    // The input moved on to a new group, so the current one is finished
+    lang::If group_done{codegen, has_group};
+    {
+      ProduceGroup();
+    }
+    group_done.EndIf();
+
+    // Start the new group
+    aggregation_.CreateInitialValues(codegen, agg_buffer, vals, keys);
+    auto *group_keys = LoadStatePtr(group_keys_id_);
+    UpdateableStorage::NullBitmap null_bitmap{codegen, key_storage_,
+                                              group_keys};
+    for (uint32_t i = 0; i < keys.size(); i++) {
+      key_storage_.SetValue(codegen, group_keys, i, keys[i], null_bitmap);
+    }
+    null_bitmap.WriteBack(codegen);
+    codegen->CreateStore(codegen.ConstBool(true), has_group_ptr);
+  }
+  is_same_group.EndIf();
+}
+
+llvm::Value *SortedGroupByTranslator::IsSameGroup(
+    const std::vector<codegen::Value> &keys) const {
+  auto &codegen = GetCodeGen();
+  auto *group_keys = LoadStatePtr(group_keys_id_);
+  UpdateableStorage::NullBitmap null_bitmap{codegen, key_storage_, group_keys};
+
+  // Keys are the same if both are NULL, or neither is and they're equal
+  llvm::Value *same = codegen.ConstBool(true);
+  for (uint32_t i = 0; i < keys.size(); i++) {
+    auto group_key =
+        key_storage_.GetValue(codegen, group_keys, i, null_bitmap);
+    auto *group_null = group_key.IsNull(codegen);
+    auto *key_null = keys[i].IsNull(codegen);
+    auto equal = group_key.CompareEq(codegen, keys[i]);
+    auto *both_null = codegen->CreateAnd(group_null, key_null);
+    auto *both_equal =
+        codegen->CreateAnd(codegen->CreateNot(codegen->CreateOr(group_null,
+                                                                key_null)),
+                           equal.GetValue());
+    same = codegen->CreateAnd(same, codegen->CreateOr(both_null, both_equal));
+  }
+  return same;
+}
+
+void SortedGroupByTranslator::ProduceGroup() const {
+  auto &codegen = GetCodeGen();
+
+  // Read back the keys and finalize the aggregates of the current group
+  std::vector<codegen::Value> group_vals;
+  auto *group_keys = LoadStatePtr(group_keys_id_);
+  UpdateableStorage::NullBitmap null_bitmap{codegen, key_storage_, group_keys};
+  for (uint32_t i = 0; i < key_storage_.GetNumElements(); i++) {
+    group_vals.push_back(
+        key_storage_.GetValue(codegen, group_keys, i, null_bitmap));
+  }
+  aggregation_.FinalizeValues(codegen, LoadStatePtr(agg_buffer_id_),
+                              group_vals);
+
+  std::vector<BufferAttributeAccess> accessors;
+  for (uint32_t i = 0; i < group_vals.size(); i++) {
+    accessors.emplace_back(group_vals, i);
+  }
+
+  // Create a row-batch of one row, place all the attributes into the row
+  auto *raw_vec =
+      codegen.AllocateBuffer(codegen.Int32Type(), 1, "sortedGroupBySelVector");
+  Vector selection_vector{raw_vec, 1, codegen.Int32Type()};
+  selection_vector.SetValue(codegen, codegen.Const32(0), codegen.Const32(0));
+
+  RowBatch batch{GetCompilationContext(), codegen.Const32(0),
+                 codegen.Const32(1), selection_vector, false};
+
+  const auto &grouping_ais = plan_.GetGroupbyAIs();
+  const auto &aggregates = plan_.GetUniqueAggTerms();
+  PL_ASSERT(group_vals.size() == grouping_ais.size() + aggregates.size());
+  for (uint32_t i = 0; i < grouping_ais.size(); i++) {
+    batch.AddAttribute(grouping_ais[i], &accessors[i]);
+  }
+  for (uint32_t i = 0; i < aggregates.size(); i++) {
+    batch.AddAttribute(&aggregates[i].agg_ai,
+                       &accessors[i + grouping_ais.size()]);
+  }
+
+  std::vector<RowBatch::ExpressionAccess> derived_attribute_accessors;
+  const auto *project_info = plan_.GetProjectInfo();
+  if (project_info != nullptr) {
+    ProjectionTranslator::AddNonTrivialAttributes(batch, *project_info,
+                                                  derived_attribute_accessors);
+  }
+
+  // Send the group up, if it passes the predicate
+  ConsumerContext context{GetCompilationContext(), GetPipeline()};
+  auto *predicate = plan_.GetPredicate();
+  if (predicate != nullptr) {
+    batch.Iterate(codegen, [&](RowBatch::Row &row) {
+      codegen::Value valid_row = row.DeriveValue(codegen, *predicate);
+      lang::If is_valid_row{codegen, valid_row};
+      {
+        context.Consume(row);
+      }
+      is_valid_row.EndIf();
+    });
+  } else {
+    context.Consume(batch);
+  }
+}
+
+void SortedGroupByTranslator::TearDownState() {
+  aggregation_.TearDownState(GetCodeGen());
+}
+
+std::string SortedGroupByTranslator::GetName() const {
+  return "SortedGroupBy";
+}
+
+}  // namespace codegen
+}  // namespace peloton
@@ -13,12 +13,15 @@
 #include "codegen/operator/table_scan_translator.h"
 
 #include "codegen/lang/if.h"
+#include "codegen/lang/loop.h"
 #include "codegen/proxy/executor_context_proxy.h"
 #include "codegen/proxy/storage_manager_proxy.h"
 #include "codegen/proxy/transaction_runtime_proxy.h"
 #include "codegen/proxy/runtime_functions_proxy.h"
 #include "codegen/proxy/zone_map_proxy.h"
 #include "codegen/type/boolean_type.h"
+#include "codegen/type/sql_type.h"
+#include "expression/tuple_value_expression.h"
 #include "planner/seq_scan_plan.h"
 #include "storage/data_table.h"
 #include "storage/zone_map_manager.h"
@@ -26,6 +29,37 @@
 namespace peloton {
 namespace codegen {
 
+namespace {
+
+bool IsIntegralType(peloton::type::TypeId type_id) {
+  switch (type_id) {
+    case peloton::type::TypeId::TINYINT:
+    case peloton::type::TypeId::SMALLINT:
+    case peloton::type::TypeId::INTEGER:
+    case peloton::type::TypeId::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Can values of the two given types be compared with vector instructions? We
+// support fixed-width types whose comparison is a plain integer or floating
+// point comparison, mirroring the implicit casts the scalar path would apply.
+bool IsSIMDComparable(peloton::type::TypeId left, peloton::type::TypeId right) {
+  if (left == right) {
+    return IsIntegralType(left) || left == peloton::type::TypeId::DECIMAL ||
+           left == peloton::type::TypeId::DATE ||
+           left == peloton::type::TypeId::TIMESTAMP;
+  }
+  auto is_numeric = [](peloton::type::TypeId type_id) {
+    return IsIntegralType(type_id) || type_id == peloton::type::TypeId::DECIMAL;
+  };
+  return is_numeric(left) && is_numeric(right);
+}
+
+}  // anonymous namespace
+
 //===----------------------------------------------------------------------===//
 // TABLE SCAN TRANSLATOR
 //===----------------------------------------------------------------------===//
@@ -195,18 +229,64 @@ TableScanTranslator::ScanConsumer::GetPredicate() const {
   return translator_.GetScanPlan().GetPredicate();
 }
 
+// Filter the rows in the selection vector by the scan's predicate. If the
+// predicate is a tree of comparisons over fixed-width columns, we evaluate it
+// with vector instructions when the tile group stores all those columns in
+// columnar form. Otherwise (or for row-oriented tile groups) we fall back to
+// evaluating the predicate one row at a time.
 void TableScanTranslator::ScanConsumer::FilterRowsByPredicate(
     CodeGen &codegen, const TileGroup::TileGroupAccess &access,
     llvm::Value *tid_start, llvm::Value *tid_end,
     Vector &selection_vector) const {
+  const auto *predicate = GetPredicate();
+  if (!predicate->IsSIMDable() || !IsSIMDEvaluable(*predicate)) {
+    LOG_DEBUG("Predicate isn't SIMD-evaluable, using scalar filter");
+    ScalarFilterRows(codegen, access, tid_start, tid_end, selection_vector);
+    return;
+  }
+
+  // The SIMD path requires contiguous column values, so check the layout of
+  // the current tile group at runtime
+  std::unordered_set<const planner::AttributeInfo *> used_attributes;
+  predicate->GetUsedAttributes(used_attributes);
+  llvm::Value *all_columnar = codegen.ConstBool(true);
+  for (const auto *ai : used_attributes) {
+    llvm::Value *columnar = access.GetLayout(ai->attribute_id).is_columnar;
+    columnar = codegen->CreateICmpNE(
+        columnar, llvm::Constant::getNullValue(columnar->getType()));
+    all_columnar = codegen->CreateAnd(all_columnar, columnar);
+  }
+
+  llvm::Value *num_visible = selection_vector.GetNumElements();
+  llvm::Value *simd_count = nullptr, *scalar_count = nullptr;
+  lang::If is_columnar{codegen, all_columnar, "simdFilter"};
+  {
+    SIMDFilterRows(codegen, access, tid_start, tid_end, selection_vector);
+    simd_count = selection_vector.GetNumElements();
+  }
+  is_columnar.ElseBlock("scalarFilter");
+  {
+    selection_vector.SetNumElements(num_visible);
+    ScalarFilterRows(codegen, access, tid_start, tid_end, selection_vector);
+    scalar_count = selection_vector.GetNumElements();
+  }
+  is_columnar.EndIf();
+
+  selection_vector.SetNumElements(
+      is_columnar.BuildPHI(simd_count, scalar_count));
+}
+
+void TableScanTranslator::ScanConsumer::ScalarFilterRows(
+    CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+    llvm::Value *tid_start, llvm::Value *tid_end,
+    Vector &selection_vector) const {
   // The batch we're filtering
   auto &compilation_ctx = translator_.GetCompilationContext();
   RowBatch batch{compilation_ctx, tile_group_id_,   tid_start,
                  tid_end,         selection_vector, true};
 
-  // First, check if the predicate is SIMDable
   const auto *predicate = GetPredicate();
-  LOG_DEBUG("Is Predicate SIMDable : %d", predicate->IsSIMDable());
+
   // Determine the attributes the predicate needs
   std::unordered_set<const planner::AttributeInfo *> used_attributes;
   predicate->GetUsedAttributes(used_attributes);
@@ -235,6 +315,286 @@ void TableScanTranslator::ScanConsumer::FilterRowsByPredicate(
   });
 }
 
+// The generated code looks roughly like:
+//
+// @code
+// num_rows := tid_end - tid_start
+// for (pos := 0; pos < num_rows & ~(kSIMDLanes - 1); pos += kSIMDLanes) {
+//   mask[pos:pos+kSIMDLanes] := predicate(tid_start + pos, kSIMDLanes)
+// }
+// for (; pos < num_rows; pos++) {
+//   mask[pos] := predicate(tid_start + pos, 1)
+// }
+// for (read := 0, write := 0; read < |sel|; read++) {
+//   sel[write] := sel[read]
+//   write += mask[sel[read] - tid_start]
+// }
+// @endcode
+//
+// The last loop compacts the (visibility-filtered) selection vector without
+// branching on the outcome of the predicate.
+void TableScanTranslator::ScanConsumer::SIMDFilterRows(
+    CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+    llvm::Value *tid_start, llvm::Value *tid_end,
+    Vector &selection_vector) const {
+  const auto *predicate = GetPredicate();
+
+  // One byte per row in the batch, set if the row satisfies the predicate
+  llvm::Value *mask_buf = codegen.AllocateBuffer(
+      codegen.ByteType(), selection_vector.GetCapacity(), "simdFilterMask");
+
+  // Evaluate the predicate over [tid_start + pos, tid_start + pos + lanes)
+  // and write the outcome into the mask buffer
+  auto evaluate_predicate = [&](llvm::Value *pos, uint32_t lanes) {
+    llvm::Value *tid = codegen->CreateAdd(tid_start, pos);
+    llvm::Value *mask =
+        DeriveSIMDMask(codegen, access, *predicate, tid, lanes);
+    auto *mask_type = llvm::VectorType::get(codegen.ByteType(), lanes);
+    llvm::Value *dest = codegen->CreateBitCast(
+        codegen->CreateInBoundsGEP(codegen.ByteType(), mask_buf, pos),
+        mask_type->getPointerTo());
+    codegen->CreateAlignedStore(codegen->CreateZExt(mask, mask_type), dest, 1);
+  };
+
+  llvm::Value *num_rows = codegen->CreateSub(tid_end, tid_start);
+  llvm::Value *num_full = codegen->CreateAnd(
+      num_rows, codegen.Const32(~static_cast<int32_t>(kSIMDLanes - 1)));
+
+  // The main loop over full vectors
+  llvm::Value *pos = codegen.Const32(0);
+  lang::Loop simd_loop{codegen, codegen->CreateICmpULT(pos, num_full),
+                       {{"simdPos", pos}}};
+  {
+    pos = simd_loop.GetLoopVar(0);
+    evaluate_predicate(pos, kSIMDLanes);
+    pos = codegen->CreateAdd(pos, codegen.Const32(kSIMDLanes));
+    simd_loop.LoopEnd(codegen->CreateICmpULT(pos, num_full), {pos});
+  }
+
+  // The remaining rows that don't fill a whole vector
+  lang::Loop tail_loop{codegen, codegen->CreateICmpULT(num_full, num_rows),
+                       {{"tailPos", num_full}}};
+  {
+    pos = tail_loop.GetLoopVar(0);
+    evaluate_predicate(pos, 1);
+    pos = codegen->CreateAdd(pos, codegen.Const32(1));
+    tail_loop.LoopEnd(codegen->CreateICmpULT(pos, num_rows), {pos});
+  }
+
+  // Compact the selection vector using the mask
+  llvm::Value *num_visible = selection_vector.GetNumElements();
+  lang::Loop compact_loop{
+      codegen,
+      codegen->CreateICmpULT(codegen.Const32(0), num_visible),
+      {{"readIdx", codegen.Const32(0)}, {"writeIdx", codegen.Const32(0)}}};
+  {
+    llvm::Value *read_pos = compact_loop.GetLoopVar(0);
+    llvm::Value *write_pos = compact_loop.GetLoopVar(1);
+
+    llvm::Value *tid = selection_vector.GetValue(codegen, read_pos);
+    selection_vector.SetValue(codegen, write_pos, tid);
+
+    llvm::Value *valid = codegen->CreateLoad(codegen->CreateInBoundsGEP(
+        codegen.ByteType(), mask_buf, codegen->CreateSub(tid, tid_start)));
+    write_pos =
+        codegen->CreateAdd(write_pos, codegen->CreateZExt(valid, tid->getType()));
+    read_pos = codegen->CreateAdd(read_pos, codegen.Const32(1));
+
+    compact_loop.LoopEnd(codegen->CreateICmpULT(read_pos, num_visible),
+                         {read_pos, write_pos});
+  }
+
+  std::vector<llvm::Value *> final_vals;
+  compact_loop.CollectFinalLoopVariables(final_vals);
+  selection_vector.SetNumElements(final_vals[1]);
+}
+
+bool TableScanTranslator::ScanConsumer::IsSIMDEvaluable(
+    const expression::AbstractExpression &expr) const {
+  switch (expr.GetExpressionType()) {
+    case ExpressionType::CONJUNCTION_AND:
+    case ExpressionType::CONJUNCTION_OR: {
+      return IsSIMDEvaluable(*expr.GetChild(0)) &&
+             IsSIMDEvaluable(*expr.GetChild(1));
+    }
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO: {
+      peloton::type::TypeId left_type, right_type;
+      return GetSIMDOperandType(*expr.GetChild(0), left_type) &&
+             GetSIMDOperandType(*expr.GetChild(1), right_type) &&
+             IsSIMDComparable(left_type, right_type);
+    }
+    default: { return false; }
+  }
+}
+
+bool TableScanTranslator::ScanConsumer::GetSIMDOperandType(
+    const expression::AbstractExpression &expr,
+    peloton::type::TypeId &type_id) const {
+  switch (expr.GetExpressionType()) {
+    case ExpressionType::VALUE_TUPLE: {
+      const auto &tve =
+          static_cast<const expression::TupleValueExpression &>(expr);
+      type_id = tve.GetAttributeRef()->type.type_id;
+      return true;
+    }
+    case ExpressionType::VALUE_CONSTANT:
+    case ExpressionType::VALUE_PARAMETER: {
+      auto &ctx = translator_.GetCompilationContext();
+      const auto &val =
+          ctx.GetParameterCache().GetValue(ctx.GetParameterIdx(&expr));
+      type_id = val.GetType().type_id;
+      return true;
+    }
+    default: { return false; }
+  }
+}
+
+llvm::Value *TableScanTranslator::ScanConsumer::DeriveSIMDMask(
+    CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+    const expression::AbstractExpression &expr, llvm::Value *tid,
+    uint32_t lanes) const {
+  // Conjunctions simply combine the masks of their children. Since there is no
+  // negation in the tree, treating NULL as false at the leaves is equivalent to
+  // reifying the three-valued result at the root.
+  if (expr.GetExpressionType() == ExpressionType::CONJUNCTION_AND) {
+    return codegen->CreateAnd(
+        DeriveSIMDMask(codegen, access, *expr.GetChild(0), tid, lanes),
+        DeriveSIMDMask(codegen, access, *expr.GetChild(1), tid, lanes));
+  }
+  if (expr.GetExpressionType() == ExpressionType::CONJUNCTION_OR) {
+    return codegen->CreateOr(
+        DeriveSIMDMask(codegen, access, *expr.GetChild(0), tid, lanes),
+        DeriveSIMDMask(codegen, access, *expr.GetChild(1), tid, lanes));
+  }
+
+  // It's a comparison
+  peloton::type::TypeId left_type, right_type;
+  GetSIMDOperandType(*expr.GetChild(0), left_type);
+  GetSIMDOperandType(*expr.GetChild(1), right_type);
+
+  llvm::Value *left, *left_not_null, *right, *right_not_null;
+  LoadSIMDOperand(codegen, access, *expr.GetChild(0), tid, lanes, left,
+                  left_not_null);
+  LoadSIMDOperand(codegen, access, *expr.GetChild(1), tid, lanes, right,
+                  right_not_null);
+
+  // Bring both sides to a common type
+  bool is_decimal = left_type == peloton::type::TypeId::DECIMAL ||
+                    right_type == peloton::type::TypeId::DECIMAL;
+  if (is_decimal) {
+    auto *double_vec_type = llvm::VectorType::get(codegen.DoubleType(), lanes);
+    if (left_type != peloton::type::TypeId::DECIMAL) {
+      left = codegen->CreateSIToFP(left, double_vec_type);
+    }
+    if (right_type != peloton::type::TypeId::DECIMAL) {
+      right = codegen->CreateSIToFP(right, double_vec_type);
+    }
+  } else if (left->getType() != right->getType()) {
+    if (left->getType()->getScalarSizeInBits() <
+        right->getType()->getScalarSizeInBits()) {
+      left = codegen->CreateSExt(left, right->getType());
+    } else {
+      right = codegen->CreateSExt(right, left->getType());
+    }
+  }
+
+  // Compare using the same predicates as the scalar SQL types
+  llvm::Value *result = nullptr;
+  switch (expr.GetExpressionType()) {
+    case ExpressionType::COMPARE_EQUAL:
+      result = is_decimal ? codegen->CreateFCmpUEQ(left, right)
+                          : codegen->CreateICmpEQ(left, right);
+      break;
+    case ExpressionType::COMPARE_NOTEQUAL:
+      result = is_decimal ? codegen->CreateFCmpUNE(left, right)
+                          : codegen->CreateICmpNE(left, right);
+      break;
+    case ExpressionType::COMPARE_LESSTHAN:
+      result = is_decimal ? codegen->CreateFCmpULT(left, right)
+                          : codegen->CreateICmpSLT(left, right);
+      break;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      result = is_decimal ? codegen->CreateFCmpULE(left, right)
+                          : codegen->CreateICmpSLE(left, right);
+      break;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      result = is_decimal ? codegen->CreateFCmpUGT(left, right)
+                          : codegen->CreateICmpSGT(left, right);
+      break;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      result = is_decimal ? codegen->CreateFCmpUGE(left, right)
+                          : codegen->CreateICmpSGE(left, right);
+      break;
+    default: {
+      throw Exception{"Invalid expression type for SIMD evaluation " +
+                      ExpressionTypeToString(expr.GetExpressionType())};
+    }
+  }
+
+  // A comparison involving NULL is never true
+  if (left_not_null != nullptr) {
+    result = codegen->CreateAnd(result, left_not_null);
+  }
+  if (right_not_null != nullptr) {
+    result = codegen->CreateAnd(result, right_not_null);
+  }
+  return result;
+}
+
+void TableScanTranslator::ScanConsumer::LoadSIMDOperand(
+    CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+    const expression::AbstractExpression &expr, llvm::Value *tid,
+    uint32_t lanes, llvm::Value *&vals, llvm::Value *&not_null) const {
+  not_null = nullptr;
+
+  if (expr.GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+    // Constants and parameters are broadcast to all lanes
+    auto &ctx = translator_.GetCompilationContext();
+    const auto &val =
+        ctx.GetParameterCache().GetValue(ctx.GetParameterIdx(&expr));
+    vals = codegen->CreateVectorSplat(lanes, val.GetValue());
+    if (val.IsNullable()) {
+      not_null = codegen->CreateVectorSplat(lanes, val.IsNotNull(codegen));
+    }
+    return;
+  }
+
+  const auto *ai =
+      static_cast<const expression::TupleValueExpression &>(expr)
+          .GetAttributeRef();
+  const auto &layout = access.GetLayout(ai->attribute_id);
+  const auto &sql_type = ai->type.GetSqlType();
+
+  llvm::Type *col_type = nullptr, *col_len_type = nullptr;
+  sql_type.GetTypeForMaterialization(codegen, col_type, col_len_type);
+  PL_ASSERT(col_type != nullptr && col_len_type == nullptr);
+
+  // The column is columnar, so the values for [tid, tid + lanes) are adjacent.
+  // Tiles make no alignment promises beyond the element size.
+  auto *vec_type = llvm::VectorType::get(col_type, lanes);
+  llvm::Value *col_address =
+      codegen->CreateInBoundsGEP(codegen.ByteType(), layout.col_start_ptr,
+                                 codegen->CreateMul(tid, layout.col_stride));
+  vals = codegen->CreateAlignedLoad(
+      codegen->CreateBitCast(col_address, vec_type->getPointerTo()),
+      static_cast<unsigned>(codegen.SizeOf(col_type)));
+
+  if (ai->type.nullable) {
+    llvm::Value *null_val = codegen->CreateVectorSplat(
+        lanes, sql_type.GetNullValue(codegen).GetValue());
+    llvm::Value *is_null =
+        sql_type.TypeId() == peloton::type::TypeId::DECIMAL
+            ? codegen->CreateFCmpUEQ(vals, null_val)
+            : codegen->CreateICmpEQ(vals, null_val);
+    not_null = codegen->CreateNot(is_null);
+  }
+}
+
 //===----------------------------------------------------------------------===//
 // ATTRIBUTE ACCESS
 //===----------------------------------------------------------------------===//
@@ -25,11 +25,13 @@ Query* QueryCache::Find(const std::shared_ptr<planner::AbstractPlan> &key) {
   auto it = cache_map_.find(key);
   if (it == cache_map_.end()) {
     cache_lock_.Unlock();
+    miss_count_.fetch_add(1, std::memory_order_relaxed);
     return nullptr;
   }
   query_list_.splice(query_list_.begin(), query_list_, it->second);
   auto *query = it->second->second.get();
   cache_lock_.Unlock();
+  hit_count_.fetch_add(1, std::memory_order_relaxed);
   return query;
 }
 
@@ -15,6 +15,7 @@
 #include "codegen/compilation_context.h"
 #include "planner/aggregate_plan.h"
 #include "planner/hash_join_plan.h"
+#include "planner/merge_join_plan.h"
 #include "planner/projection_plan.h"
 #include "planner/seq_scan_plan.h"
 
@@ -78,6 +79,20 @@ bool QueryCompiler::IsSupported(const planner::AbstractPlan &plan) {
       }
       break;
     }
+    case PlanNodeType::MERGEJOIN: {
+      const auto &join = static_cast<const planner::MergeJoinPlan &>(plan);
+      // Right now, only support inner joins
+      if (join.GetJoinType() != JoinType::INNER) {
+        return false;
+      }
+      for (const auto &join_clause : *join.GetJoinClauses()) {
+        if (!IsExpressionSupported(*join_clause.left_) ||
+            !IsExpressionSupported(*join_clause.right_)) {
+          return false;
+        }
+      }
+      break;
+    }
     case PlanNodeType::HASH: {
       break;
     }
@@ -102,6 +117,11 @@ bool QueryCompiler::IsSupported(const planner::AbstractPlan &plan) {
       pred = hj_plan.GetPredicate();
       break;
     }
+    case PlanNodeType::MERGEJOIN: {
+      auto &mj_plan = static_cast<const planner::MergeJoinPlan &>(plan);
+      pred = mj_plan.GetPredicate();
+      break;
+    }
     default: { break; }
   }
 
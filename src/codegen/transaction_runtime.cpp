@@ -17,6 +17,8 @@
 #include "concurrency/transaction_context.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/executor_context.h"
+#include "settings/settings_manager.h"
+#include "statistics/backend_stats_context.h"
 #include "storage/tile_group.h"
 
 namespace peloton {
@@ -34,17 +36,27 @@ uint32_t TransactionRuntime::PerformVectorizedRead(
   // Get the tile group header
   auto tile_group_header = tile_group.GetHeader();
 
+  // Every tuple in an all-visible tile group is visible to this transaction,
+  // and the read is tracked for the tile group as a whole
+  if (txn_manager.PerformAllVisibleRead(&txn, tile_group_header)) {
+    uint32_t out_idx = 0;
+    for (uint32_t i = tid_start; i < tid_end; i++) {
+      selection_vector[out_idx++] = i;
+    }
+    // Only the tuples of this batch are read
+    if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+            settings::SettingId::stats_mode)) != StatsType::INVALID) {
+      stats::BackendStatsContext::GetInstance()->IncrementTableReads(
+          tile_group.GetTileGroupId(), tid_end - tid_start);
+    }
+    return out_idx;
+  }
+
   // Check visibility of tuples in the range [tid_start, tid_end), storing all
   // visible tuple IDs in the provided selection vector
-  uint32_t out_idx = 0;
-  for (uint32_t i = tid_start; i < tid_end; i++) {
-    // Perform the visibility check
-    auto visibility = txn_manager.IsVisible(&txn, tile_group_header, i);
-
-    // Update the output position
-    selection_vector[out_idx] = i;
-    out_idx += (visibility == VisibilityType::OK);
-  }
+  uint32_t out_idx = txn_manager.FilterVisible(&txn, tile_group_header,
+                                               tid_start, tid_end,
+                                               selection_vector);
 
   uint32_t tile_group_idx = tile_group.GetTileGroupId();
 
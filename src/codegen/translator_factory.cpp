@@ -29,8 +29,10 @@
 #include "codegen/operator/hash_join_translator.h"
 #include "codegen/operator/hash_translator.h"
 #include "codegen/operator/insert_translator.h"
+#include "codegen/operator/merge_join_translator.h"
 #include "codegen/operator/order_by_translator.h"
 #include "codegen/operator/projection_translator.h"
+#include "codegen/operator/sorted_group_by_translator.h"
 #include "codegen/operator/table_scan_translator.h"
 #include "codegen/operator/update_translator.h"
 #include "expression/aggregate_expression.h"
@@ -45,6 +47,7 @@
 #include "planner/hash_join_plan.h"
 #include "planner/hash_plan.h"
 #include "planner/insert_plan.h"
+#include "planner/merge_join_plan.h"
 #include "planner/nested_loop_join_plan.h"
 #include "planner/order_by_plan.h"
 #include "planner/projection_plan.h"
@@ -78,6 +81,11 @@ std::unique_ptr<OperatorTranslator> TranslatorFactory::CreateTranslator(
       translator = new HashJoinTranslator(join, context, pipeline);
       break;
     }
+    case PlanNodeType::MERGEJOIN: {
+      auto &join = static_cast<const planner::MergeJoinPlan &>(plan_node);
+      translator = new MergeJoinTranslator(join, context, pipeline);
+      break;
+    }
     case PlanNodeType::NESTLOOP: {
       auto &join = static_cast<const planner::NestedLoopJoinPlan &>(plan_node);
       translator = new BlockNestedLoopJoinTranslator(join, context, pipeline);
@@ -91,12 +99,16 @@ std::unique_ptr<OperatorTranslator> TranslatorFactory::CreateTranslator(
     case PlanNodeType::AGGREGATE_V2: {
       const auto &aggregate_plan =
           static_cast<const planner::AggregatePlan &>(plan_node);
-      // An aggregation without any grouping clause is simpler to handle. All
-      // other aggregations are handled using a hash-group-by for now.
-      // TODO: Implement other (non hash) group-by algorithms
+      // An aggregation without any grouping clause is simpler to handle. An
+      // input sorted on the grouping keys is aggregated one group at a time.
+      // All other aggregations are handled using a hash-group-by.
       if (aggregate_plan.IsGlobal()) {
         translator =
             new GlobalGroupByTranslator(aggregate_plan, context, pipeline);
+      } else if (aggregate_plan.GetAggregateStrategy() ==
+                 AggregateType::SORTED) {
+        translator =
+            new SortedGroupByTranslator(aggregate_plan, context, pipeline);
       } else {
         translator =
             new HashGroupByTranslator(aggregate_plan, context, pipeline);
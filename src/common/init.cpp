@@ -23,6 +23,7 @@
 #include "concurrency/transaction_manager_factory.h"
 #include "gc/gc_manager_factory.h"
 #include "index/index.h"
+#include "optimizer/stats/stats_refresher.h"
 #include "settings/settings_manager.h"
 #include "threadpool/mono_queue_pool.h"
 
@@ -44,7 +45,8 @@ void PelotonInit::Initialize() {
   threadpool::MonoQueuePool::GetInstance().Startup();
 
   // start indextuner thread pool
-  if (settings::SettingsManager::GetBool(settings::SettingId::brain)) {
+  if (settings::SettingsManager::GetBool(settings::SettingId::brain) ||
+      settings::SettingsManager::GetBool(settings::SettingId::stats_refresh)) {
     threadpool::MonoQueuePool::GetBrainInstance().Startup();
   }
 
@@ -89,9 +91,19 @@ void PelotonInit::Initialize() {
 
   // Initialize the Statement Cache Manager
   StatementCacheManager::Init();
+
+  // start background stats refresher
+  if (settings::SettingsManager::GetBool(settings::SettingId::stats_refresh)) {
+    optimizer::StatsRefresher::GetInstance().Start();
+  }
 }
 
 void PelotonInit::Shutdown() {
+  // shut down stats refresher
+  if (settings::SettingsManager::GetBool(settings::SettingId::stats_refresh)) {
+    optimizer::StatsRefresher::GetInstance().Stop();
+  }
+
   // shut down index tuner
   if (settings::SettingsManager::GetBool(settings::SettingId::index_tuner)) {
     auto &index_tuner = tuning::IndexTuner::GetInstance();
@@ -114,7 +126,8 @@ void PelotonInit::Shutdown() {
   threadpool::MonoQueuePool::GetInstance().Shutdown();
 
   // stop indextuner thread pool
-  if (settings::SettingsManager::GetBool(settings::SettingId::brain)) {
+  if (settings::SettingsManager::GetBool(settings::SettingId::brain) ||
+      settings::SettingsManager::GetBool(settings::SettingId::stats_refresh)) {
     threadpool::MonoQueuePool::GetBrainInstance().Shutdown();
   }
 
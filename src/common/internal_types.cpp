@@ -1828,6 +1828,9 @@ std::string CopyTypeToString(CopyType type) {
     case CopyType::EXPORT_OTHER: {
       return "EXPORT_OTHER";
     }
+    case CopyType::EXPORT_BINARY: {
+      return "EXPORT_BINARY";
+    }
     default: {
       throw ConversionException(
           StringUtil::Format("No string conversion for CopyType value '%d'",
@@ -1851,6 +1854,8 @@ CopyType StringToCopyType(const std::string &str) {
     return CopyType::EXPORT_STDOUT;
   } else if (upper_str == "EXPORT_OTHER") {
     return CopyType::EXPORT_OTHER;
+  } else if (upper_str == "EXPORT_BINARY") {
+    return CopyType::EXPORT_BINARY;
   } else {
     throw ConversionException(StringUtil::Format(
         "No CopyType conversion from string '%s'", upper_str.c_str()));
@@ -0,0 +1,198 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// shared_plan_cache.cpp
+//
+// Identification: src/common/shared_plan_cache.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/shared_plan_cache.h"
+
+#include "settings/settings_manager.h"
+
+namespace peloton {
+
+SharedPlanCache &SharedPlanCache::GetInstance() {
+  static SharedPlanCache shared_plan_cache;
+  return shared_plan_cache;
+}
+
+std::string SharedPlanCache::GetKey(const std::string &database_name,
+                                    const std::string &query_string,
+                                    const std::vector<type::Value> &params) {
+  // Neither the database name nor the query can contain a NUL byte, so it
+  // separates them and the types
+  std::string key = database_name;
+  key.push_back('\0');
+  key.append(query_string);
+  key.push_back('\0');
+  for (auto &param : params) {
+    key.push_back(static_cast<char>(param.GetTypeId()));
+  }
+  return key;
+}
+
+std::string SharedPlanCache::GetKey(const std::string &database_name,
+                                    const std::string &query_string,
+                                    const std::vector<int32_t> &param_types) {
+  // A different separator keeps these apart from the keys of simple queries
+  std::string key = database_name;
+  key.push_back('\0');
+  key.append(query_string);
+  key.push_back('\1');
+  for (auto param_type : param_types) {
+    key.append(std::to_string(param_type));
+    key.push_back(',');
+  }
+  return key;
+}
+
+SharedPlanCache::Entry &SharedPlanCache::GetEntry(const std::string &key) {
+  auto result = entries_.emplace(key, Entry());
+  auto &entry = result.first->second;
+  if (!result.second) {
+    lru_list_.splice(lru_list_.begin(), lru_list_, entry.lru_position);
+    return entry;
+  }
+
+  lru_list_.push_front(key);
+  entry.lru_position = lru_list_.begin();
+
+  size_t capacity = settings::SettingsManager::GetInt(
+      settings::SettingId::shared_plan_cache_size);
+  while (entries_.size() > capacity && lru_list_.size() > 1) {
+    entries_.erase(lru_list_.back());
+    lru_list_.pop_back();
+  }
+  return entry;
+}
+
+std::shared_ptr<Statement> SharedPlanCache::Acquire(const std::string &key,
+                                                    uint64_t &version,
+                                                    bool &cacheable) {
+  std::lock_guard<std::mutex> lock(cache_lock_);
+  version = version_;
+  cacheable = true;
+
+  auto entry = entries_.find(key);
+  if (entry == entries_.end()) {
+    return nullptr;
+  }
+  lru_list_.splice(lru_list_.begin(), lru_list_, entry->second.lru_position);
+
+  auto &statements = entry->second.statements;
+  if (entry->second.unplannable &&
+      entry->second.unplannable_version != version_) {
+    entry->second.unplannable = false;
+  }
+  if (!entry->second.cacheable || entry->second.unplannable) {
+    cacheable = false;
+    return nullptr;
+  }
+  if (statements.empty()) {
+    return nullptr;
+  }
+  auto statement = std::move(statements.back());
+  statements.pop_back();
+  return statement;
+}
+
+void SharedPlanCache::Release(const std::string &key,
+                              std::shared_ptr<Statement> statement,
+                              const uint64_t version) {
+  std::lock_guard<std::mutex> lock(cache_lock_);
+  // The plan may be built on a table that no longer exists. Invalidations
+  // are rare, so don't bother checking which tables they were about.
+  if (version != version_) {
+    return;
+  }
+
+  auto &entry = GetEntry(key);
+  if (!entry.cacheable) {
+    return;
+  }
+  entry.tables = statement->GetReferencedTables();
+  entry.statements.push_back(std::move(statement));
+}
+
+std::shared_ptr<Statement> SharedPlanCache::Lease(
+    const std::string &key, std::shared_ptr<Statement> statement,
+    const uint64_t version) {
+  auto *raw_statement = statement.get();
+  return std::shared_ptr<Statement>(
+      raw_statement, [key, statement, version](Statement *) mutable {
+        SharedPlanCache::GetInstance().Release(key, std::move(statement),
+                                               version);
+      });
+}
+
+void SharedPlanCache::MarkUncacheable(const std::string &key) {
+  std::lock_guard<std::mutex> lock(cache_lock_);
+  auto &entry = GetEntry(key);
+  entry.cacheable = false;
+  entry.statements.clear();
+  entry.tables.clear();
+}
+
+void SharedPlanCache::MarkUnplannable(const std::string &key,
+                                      const uint64_t version) {
+  std::lock_guard<std::mutex> lock(cache_lock_);
+  // The catalog changed while planning, so the next try may succeed
+  if (version != version_) {
+    return;
+  }
+
+  auto &entry = GetEntry(key);
+  entry.unplannable = true;
+  entry.unplannable_version = version;
+  entry.statements.clear();
+  entry.tables.clear();
+}
+
+void SharedPlanCache::InvalidateTableOids(const std::set<oid_t> &table_ids) {
+  std::lock_guard<std::mutex> lock(cache_lock_);
+  version_++;
+
+  for (auto entry = entries_.begin(); entry != entries_.end();) {
+    bool invalid = false;
+    for (auto table_id : entry->second.tables) {
+      if (table_ids.count(table_id) != 0) {
+        invalid = true;
+        break;
+      }
+    }
+    if (invalid) {
+      lru_list_.erase(entry->second.lru_position);
+      entry = entries_.erase(entry);
+    } else {
+      ++entry;
+    }
+  }
+}
+
+size_t SharedPlanCache::GetSize() {
+  std::lock_guard<std::mutex> lock(cache_lock_);
+  return entries_.size();
+}
+
+size_t SharedPlanCache::GetStatementCount(const std::string &key) {
+  std::lock_guard<std::mutex> lock(cache_lock_);
+  auto entry = entries_.find(key);
+  if (entry == entries_.end()) {
+    return 0;
+  }
+  return entry->second.statements.size();
+}
+
+void SharedPlanCache::Clear() {
+  std::lock_guard<std::mutex> lock(cache_lock_);
+  entries_.clear();
+  lru_list_.clear();
+  version_++;
+}
+
+}  // namespace peloton
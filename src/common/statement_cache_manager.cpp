@@ -12,8 +12,13 @@
 
 #include "common/statement_cache_manager.h"
 
+#include "common/shared_plan_cache.h"
+#include "optimizer/plan_template_cache.h"
+
 namespace peloton {
 
+std::shared_ptr<StatementCacheManager> statement_cache_manager;
+
 void StatementCacheManager::RegisterStatementCache(StatementCache *stmt_cache) {
   statement_caches_.Insert(stmt_cache, stmt_cache);
 }
@@ -23,6 +28,9 @@ void StatementCacheManager::UnRegisterStatementCache(StatementCache *stmt_cache)
 }
 
 void StatementCacheManager::InvalidateTableOid(oid_t table_id) {
+  SharedPlanCache::GetInstance().InvalidateTableOids({table_id});
+  optimizer::PlanTemplateCache::GetInstance().InvalidateTableOids({table_id});
+
   if (statement_caches_.IsEmpty()) 
     return;
 
@@ -38,7 +46,11 @@ void StatementCacheManager::InvalidateTableOid(oid_t table_id) {
 }
 
 void StatementCacheManager::InvalidateTableOids(std::set<oid_t> &table_ids) {
-  if (table_ids.empty() || statement_caches_.IsEmpty())
+  if (table_ids.empty()) return;
+  SharedPlanCache::GetInstance().InvalidateTableOids(table_ids);
+  optimizer::PlanTemplateCache::GetInstance().InvalidateTableOids(table_ids);
+
+  if (statement_caches_.IsEmpty())
     return;
 
   // Lock the table by grabbing the iterator
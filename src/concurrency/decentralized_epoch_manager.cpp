@@ -81,6 +81,10 @@ namespace concurrency {
       snapshot_global_epoch_id_ = global_expired_eid + 1;
     }
 
+    if (global_expired_eid != MAX_EID) {
+      last_expired_epoch_id_.store(global_expired_eid, std::memory_order_relaxed);
+    }
+
     return global_expired_eid;
   }
 
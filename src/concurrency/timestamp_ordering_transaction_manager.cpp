@@ -21,10 +21,24 @@
 #include "gc/gc_manager_factory.h"
 #include "logging/log_manager_factory.h"
 #include "settings/settings_manager.h"
+#include "storage/data_table.h"
 
 namespace peloton {
 namespace concurrency {
 
+// Adds the rows a committed transaction inserted minus those it deleted to
+// the live row count of the table
+static void ApplyLiveTupleDelta(storage::AbstractTable *table, int64_t delta) {
+  if (delta == 0) return;
+  auto data_table = dynamic_cast<storage::DataTable *>(table);
+  if (data_table == nullptr) return;
+  if (delta > 0) {
+    data_table->IncreaseLiveTupleCount(delta);
+  } else {
+    data_table->DecreaseLiveTupleCount(-delta);
+  }
+}
+
 // timestamp ordering requires a spinlock field for protecting the atomic access
 // to txn_id field and last_reader_cid field.
 common::synchronization::SpinLatch *TimestampOrderingTransactionManager::GetSpinLatchField(
@@ -175,11 +189,39 @@ bool TimestampOrderingTransactionManager::AcquireOwnership(
       GetSpinLatchField(tile_group_header, tuple_id)->Unlock();
 
       return false;
-    } else {
+    }
+
+    // the tile group can no longer be scanned without visibility checks.
+    // if it was all-visible, its deduplication no longer describes the tuples,
+    // and it's handed back to the GC to be frozen again.
+    if (tile_group_header->ClearAllVisible() == true) {
+      auto tile_group_id = tile_group_header->GetTileGroup()->GetTileGroupId();
+      auto tile_group =
+          catalog::Manager::GetInstance().GetTileGroup(tile_group_id);
+      if (tile_group != nullptr) {
+        tile_group->SetDedup(nullptr);
+      }
+      gc::GCManagerFactory::GetInstance().RegisterFreezeCandidate(
+          tile_group_id);
+    }
+
+    // scans of an all-visible tile group record their commit id for the whole
+    // tile group. the tile group is thawed before this check, so a concurrent
+    // scan either sees it as mutable or has already recorded its commit id.
+    // a relocated tile group was replaced by a copy in another layout, and
+    // the tuple must be modified there.
+    if (tile_group_header->IsRelocated() == true ||
+        tile_group_header->GetAllVisibleReaderCommitId() >
+        current_txn->GetCommitId()) {
+      tile_group_header->SetTransactionId(tuple_id, INITIAL_TXN_ID);
       GetSpinLatchField(tile_group_header, tuple_id)->Unlock();
 
-      return true;
+      return false;
     }
+
+    GetSpinLatchField(tile_group_header, tuple_id)->Unlock();
+
+    return true;
   }
 }
 
@@ -222,6 +264,7 @@ bool TimestampOrderingTransactionManager::PerformRead(
     LOG_TRACE("PerformRead (%u, %u)\n", location.block, location.offset);
     auto &manager = catalog::Manager::GetInstance();
     auto tile_group_header = manager.GetTileGroup(tile_group_id)->GetHeader();
+    tile_group_header->MarkAccessed();
 
     // Check if it's select for update before we check the ownership
     // and modify the last reader cid
@@ -289,6 +332,7 @@ bool TimestampOrderingTransactionManager::PerformRead(
     LOG_TRACE("PerformRead (%u, %u)\n", location.block, location.offset);
     auto &manager = catalog::Manager::GetInstance();
     auto tile_group_header = manager.GetTileGroup(tile_group_id)->GetHeader();
+    tile_group_header->MarkAccessed();
 
     // Check if it's select for update before we check the ownership.
     if (acquire_ownership == true) {
@@ -371,6 +415,7 @@ bool TimestampOrderingTransactionManager::PerformRead(
     LOG_TRACE("PerformRead (%u, %u)\n", location.block, location.offset);
     auto &manager = catalog::Manager::GetInstance();
     auto tile_group_header = manager.GetTileGroup(tile_group_id)->GetHeader();
+    tile_group_header->MarkAccessed();
 
     // Check if it's select for update before we check the ownership
     // and modify the last reader cid.
@@ -461,6 +506,40 @@ bool TimestampOrderingTransactionManager::PerformRead(
   }  // end SERIALIZABLE || REPEATABLE_READS
 }
 
+bool TimestampOrderingTransactionManager::PerformAllVisibleRead(
+    TransactionContext *const current_txn,
+    const storage::TileGroupHeader *const tile_group_header,
+    bool acquire_ownership) {
+  // select for update must lock every tuple it reads.
+  if (acquire_ownership == true || tile_group_header->IsAllVisible() == false) {
+    return false;
+  }
+  tile_group_header->MarkAccessed();
+
+  if (current_txn->GetIsolationLevel() == IsolationLevelType::READ_ONLY) {
+    return true;
+  }
+
+  // under SERIALIZABLE and REPEATABLE_READS, a read must prevent older
+  // transactions from overwriting the version. record the commit id once for
+  // the whole tile group, then make sure no writer thawed the tile group
+  // before the commit id became visible to it.
+  if (current_txn->GetIsolationLevel() == IsolationLevelType::SERIALIZABLE ||
+      current_txn->GetIsolationLevel() ==
+          IsolationLevelType::REPEATABLE_READS) {
+    tile_group_header->SetAllVisibleReaderCommitId(current_txn->GetCommitId());
+    if (tile_group_header->IsAllVisible() == false) {
+      return false;
+    }
+  }
+
+  // there's no need to maintain the read set: T/O does not check it during
+  // the commit phase, and nothing in an all-visible tile group is owned.
+  // the table read stats are left to the caller, which knows how many tuples
+  // it reads.
+  return true;
+}
+
 void TimestampOrderingTransactionManager::PerformInsert(
     TransactionContext *const current_txn, const ItemPointer &location,
     ItemPointer *index_entry_ptr) {
@@ -474,8 +553,10 @@ void TimestampOrderingTransactionManager::PerformInsert(
   auto transaction_id = current_txn->GetTransactionId();
 
   // check MVCC info
-  // the tuple slot must be empty.
-  PL_ASSERT(tile_group_header->GetTransactionId(tuple_id) == INVALID_TXN_ID);
+  // the tuple slot must be empty, or already owned by a bulk load of this
+  // transaction.
+  PL_ASSERT(tile_group_header->GetTransactionId(tuple_id) == INVALID_TXN_ID ||
+            tile_group_header->GetTransactionId(tuple_id) == transaction_id);
   PL_ASSERT(tile_group_header->GetBeginCommitId(tuple_id) == MAX_CID);
   PL_ASSERT(tile_group_header->GetEndCommitId(tuple_id) == MAX_CID);
 
@@ -752,6 +833,15 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
   //// handle other isolation levels
   //////////////////////////////////////////////////////////
 
+  bool stats_enabled =
+      static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID;
+  if (stats_enabled) {
+    stats::BackendStatsContext::GetInstance()
+        ->GetCommitLatencyMetric()
+        .StartTimer();
+  }
+
   auto &manager = catalog::Manager::GetInstance();
   auto &log_manager = logging::LogManager::GetInstance();
 
@@ -793,6 +883,20 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
   // 3. install a new tuple for insert operations.
   // Iterate through each item pointer in the read write set
 
+  // Rows inserted minus rows deleted. The delta is only added to the table
+  // when the next tuple is from another table, which most transactions never
+  // see.
+  storage::AbstractTable *delta_table = nullptr;
+  int64_t live_tuple_delta = 0;
+  auto add_live_tuples = [&](storage::AbstractTable *table, int64_t delta) {
+    if (table != delta_table) {
+      ApplyLiveTupleDelta(delta_table, live_tuple_delta);
+      delta_table = table;
+      live_tuple_delta = 0;
+    }
+    live_tuple_delta += delta;
+  };
+
   // TODO (Pooja): This might be inefficient since we will have to get the
   // tile_group_header for each entry. Check if this needs to be consolidated
   for (const auto &tuple_entry : rw_set.GetConstIterator()) {
@@ -800,7 +904,8 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
     oid_t tile_group_id = item_ptr.block;
     oid_t tuple_slot = item_ptr.offset;
 
-    auto tile_group_header = manager.GetTileGroup(tile_group_id)->GetHeader();
+    auto tile_group = manager.GetTileGroup(tile_group_id);
+    auto tile_group_header = tile_group->GetHeader();
 
     if (tuple_entry.second == RWType::READ_OWN) {
       // A read operation has acquired ownership but hasn't done any further
@@ -871,6 +976,7 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
       // the gc should be responsible for recycling the newer empty version.
       gc_set->operator[](tile_group_id)[tuple_slot] =
           GCVersionType::COMMIT_DELETE;
+      add_live_tuples(tile_group->GetAbstractTable(), -1);
 
       log_manager.LogDelete(ItemPointer(tile_group_id, tuple_slot));
 
@@ -887,6 +993,7 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
       tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
 
       // nothing to be added to gc set.
+      add_live_tuples(tile_group->GetAbstractTable(), 1);
 
       log_manager.LogInsert(ItemPointer(tile_group_id, tuple_slot));
 
@@ -911,6 +1018,8 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
     }
   }
 
+  ApplyLiveTupleDelta(delta_table, live_tuple_delta);
+
   ResultType result = current_txn->GetResult();
 
   log_manager.LogEnd();
@@ -918,10 +1027,10 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
   EndTransaction(current_txn);
 
   // Increment # txns committed metric
-  if (static_cast<StatsType>(settings::SettingsManager::GetInt(settings::SettingId::stats_mode)) !=
-      StatsType::INVALID) {
-    stats::BackendStatsContext::GetInstance()->IncrementTxnCommitted(
-        database_id);
+  if (stats_enabled) {
+    auto stats_context = stats::BackendStatsContext::GetInstance();
+    stats_context->GetCommitLatencyMetric().RecordLatency();
+    stats_context->IncrementTxnCommitted(database_id);
   }
 
   return result;
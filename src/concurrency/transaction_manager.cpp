@@ -255,5 +255,62 @@ VisibilityType TransactionManager::IsVisible(
   }
 }
 
+uint32_t TransactionManager::FilterVisible(
+    TransactionContext *const current_txn,
+    const storage::TileGroupHeader *const tile_group_header,
+    const oid_t &tid_start, const oid_t &tid_end,
+    uint32_t *selection_vector) {
+  cid_t txn_vis_id = current_txn->GetReadId();
+
+  uint32_t out_idx = 0;
+  if (tile_group_header->IsColumnarMVCC()) {
+    const txn_id_t *txn_ids = tile_group_header->GetTransactionIdArray();
+    const cid_t *begin_cids = tile_group_header->GetBeginCommitIdArray();
+    const cid_t *end_cids = tile_group_header->GetEndCommitIdArray();
+
+    for (oid_t tuple_id = tid_start; tuple_id < tid_end; tuple_id++) {
+      txn_id_t tuple_txn_id = txn_ids[tuple_id];
+
+      // Only versions not owned by any transaction can pass the commit id
+      // check. Empty and aborted slots (INVALID_TXN_ID) are never visible
+      // either, so just the slots owned by a transaction need IsVisible().
+      bool unowned = (tuple_txn_id == INITIAL_TXN_ID);
+      bool visible = unowned & (txn_vis_id >= begin_cids[tuple_id]) &
+                     (txn_vis_id < end_cids[tuple_id]);
+      if (unlikely_branch(!unowned & (tuple_txn_id != INVALID_TXN_ID))) {
+        visible = (IsVisible(current_txn, tile_group_header, tuple_id) ==
+                   VisibilityType::OK);
+      }
+
+      selection_vector[out_idx] = tuple_id;
+      out_idx += static_cast<uint32_t>(visible);
+    }
+
+    return out_idx;
+  }
+
+  for (oid_t tuple_id = tid_start; tuple_id < tid_end; tuple_id++) {
+    txn_id_t tuple_txn_id = tile_group_header->GetTransactionId(tuple_id);
+
+    bool visible;
+    if (tuple_txn_id == INITIAL_TXN_ID) {
+      // Most versions are committed and not owned by any transaction. Their
+      // visibility only depends on the begin and end commit ids, which we
+      // check without branching.
+      cid_t tuple_begin_cid = tile_group_header->GetBeginCommitId(tuple_id);
+      cid_t tuple_end_cid = tile_group_header->GetEndCommitId(tuple_id);
+      visible = (txn_vis_id >= tuple_begin_cid) & (txn_vis_id < tuple_end_cid);
+    } else {
+      visible = (IsVisible(current_txn, tile_group_header, tuple_id) ==
+                 VisibilityType::OK);
+    }
+
+    selection_vector[out_idx] = tuple_id;
+    out_idx += static_cast<uint32_t>(visible);
+  }
+
+  return out_idx;
+}
+
 }  // namespace concurrency
 }  // namespace peloton
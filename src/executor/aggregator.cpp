@@ -283,7 +283,9 @@ bool SortedAggregator::Advance(AbstractTuple *next_tuple) {
       type::Value rval =
           (delegate_tuple_.GetValue(node->GetGroupbyColIds()[grpColOffset]));
 
-      if (lval.CompareNotEquals(rval) == CmpBool::CmpTrue) {
+      // NULLs are a group of their own
+      if (lval.IsNull() != rval.IsNull() ||
+          lval.CompareNotEquals(rval) == CmpBool::CmpTrue) {
         LOG_TRACE("Group-by columns changed.");
 
         // Call helper to output the current group result
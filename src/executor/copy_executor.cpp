@@ -12,17 +12,27 @@
 
 #include "common/logger.h"
 #include "catalog/catalog.h"
+#include "common/container_tuple.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/copy_executor.h"
 #include "executor/executor_context.h"
 #include "executor/logical_tile_factory.h"
+#include "gc/gc_manager_factory.h"
 #include "planner/copy_plan.h"
+#include "settings/settings_manager.h"
+#include "statistics/backend_stats_context.h"
+#include "storage/data_table.h"
 #include "storage/table_factory.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
 #include "network/postgres_protocol_handler.h"
 #include "common/exception.h"
 #include "common/macros.h"
+#include "type/value_factory.h"
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/mman.h>
+#include <thread>
 
 namespace peloton {
 namespace executor {
@@ -42,11 +52,24 @@ CopyExecutor::~CopyExecutor() {}
  * @return true on success, false otherwise.
  */
 bool CopyExecutor::DInit() {
-  PL_ASSERT(children_.size() == 1);
-
   // Grab info from plan node and check it
   const planner::CopyPlan &node = GetPlanNode<planner::CopyPlan>();
 
+  // Imports read the file in DExecute()
+  if (node.IsImport()) {
+    PL_ASSERT(children_.size() == 0);
+    if (node.target_table == nullptr) {
+      throw ExecutorException("Table to import " + node.file_path +
+                              " into does not exist");
+    }
+    return true;
+  }
+
+  // Tables are exported without the child unless the query parameters have
+  // to be deserialized
+  PL_ASSERT(children_.size() == 1 || (node.target_table != nullptr &&
+                                      node.deserialize_parameters == false));
+
   bool success = InitFileHandle(node.file_path.c_str(), "w");
 
   if (success == false) {
@@ -187,6 +210,16 @@ bool CopyExecutor::DExecute() {
     return false;
   }
 
+  const planner::CopyPlan &node = GetPlanNode<planner::CopyPlan>();
+  if (node.IsImport()) {
+    done = true;
+    return ExecuteImport(node);
+  }
+  if (node.target_table != nullptr && node.deserialize_parameters == false) {
+    done = true;
+    return ExecuteExport(node);
+  }
+
   while (children_[0]->Execute() == true) {
     // Get input a tile
     std::unique_ptr<LogicalTile> logical_tile(children_[0]->GetOutput());
@@ -304,5 +337,746 @@ bool CopyExecutor::DExecute() {
   return true;
 }
 
+/**
+ * @brief Load the file into the target table. The file is split into parts at
+ * line boundaries, and each part is parsed by its own thread straight into new
+ * tile groups, which are appended to the table as a whole. Index entries are
+ * added by the same threads. The tuples only become visible once they are
+ * registered with the transaction at the end.
+ * @return true on success, false otherwise.
+ */
+bool CopyExecutor::ExecuteImport(const planner::CopyPlan &node) {
+  auto fd = open(node.file_path.c_str(), O_RDONLY);
+  if (fd == INVALID_FILE_DESCRIPTOR) {
+    throw ExecutorException("Failed to open file " + node.file_path +
+                            ". Try absolute path and make sure you have the "
+                            "permission to access this file.");
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    close(fd);
+    throw ExecutorException("Failed to stat file " + node.file_path);
+  }
+  size_t file_size = file_stat.st_size;
+  if (file_size == 0) {
+    close(fd);
+    return true;
+  }
+
+  auto data = static_cast<const char *>(
+      mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0));
+  close(fd);
+  if (data == MAP_FAILED) {
+    throw ExecutorException("Failed to map file " + node.file_path);
+  }
+  madvise(const_cast<char *>(data), file_size, MADV_SEQUENTIAL);
+  const char *end = data + file_size;
+
+  // Small files are loaded by fewer threads since spawning them costs more
+  // than parsing the file
+  size_t max_worker_count = std::max(
+      settings::SettingsManager::GetInt(settings::SettingId::copy_worker_count),
+      1);
+  size_t worker_count = std::max<size_t>(
+      std::min(max_worker_count, file_size / kMinImportBytesPerWorker), 1);
+
+  // Each part but the first starts after the first line break past its even
+  // share of the file
+  std::vector<const char *> bounds{data};
+  for (size_t worker = 1; worker < worker_count; worker++) {
+    const char *pos =
+        std::max(data + file_size * worker / worker_count, bounds.back());
+    pos = static_cast<const char *>(memchr(pos, new_line, end - pos));
+    bounds.push_back(pos == nullptr ? end : pos + 1);
+  }
+  bounds.push_back(end);
+
+  std::vector<ImportResult> results(worker_count);
+  std::atomic<bool> failed(false);
+  if (worker_count == 1) {
+    ImportRecords(node, data, end, results[0], failed);
+  } else {
+    std::vector<std::thread> workers;
+    for (size_t worker = 0; worker < worker_count; worker++) {
+      workers.emplace_back(&CopyExecutor::ImportRecords, this, std::cref(node),
+                           bounds[worker], bounds[worker + 1],
+                           std::ref(results[worker]), std::ref(failed));
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+  }
+  munmap(const_cast<char *>(data), file_size);
+
+  // Hand every inserted tuple to the transaction, including those loaded
+  // before a failure, so that aborting it cleans them up
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto current_txn = executor_context_->GetTransaction();
+  size_t tuple_count = 0;
+  for (auto &result : results) {
+    for (auto &tuple : result.tuples) {
+      txn_manager.PerformInsert(current_txn, tuple.first, tuple.second);
+    }
+    tuple_count += result.tuples.size();
+  }
+
+  // Like tile groups filled by inserts, the loaded ones become all-visible
+  // once the transaction has committed and its versions are old enough
+  auto &gc_manager = gc::GCManagerFactory::GetInstance();
+  for (auto &result : results) {
+    for (auto tile_group_id : result.tile_group_ids) {
+      gc_manager.RegisterFreezeCandidate(tile_group_id);
+    }
+  }
+
+  for (auto &result : results) {
+    if (result.error_message.empty() == false) {
+      txn_manager.SetTransactionResult(current_txn, ResultType::FAILURE);
+      throw ExecutorException("Failed to import " + node.file_path + ": " +
+                              result.error_message);
+    }
+  }
+
+  executor_context_->num_processed += tuple_count;
+  LOG_DEBUG("Imported %zu tuples from %s with %zu threads", tuple_count,
+            node.file_path.c_str(), worker_count);
+  return true;
+}
+
+void CopyExecutor::ImportRecords(const planner::CopyPlan &node,
+                                 const char *begin, const char *end,
+                                 ImportResult &result,
+                                 std::atomic<bool> &failed) {
+  auto table = node.target_table;
+  auto schema = table->GetSchema();
+  auto column_count = schema->GetColumnCount();
+  auto current_txn = executor_context_->GetTransaction();
+
+  std::vector<std::string> fields;
+  std::vector<bool> nulls;
+  std::vector<type::Value> values(column_count);
+  std::shared_ptr<storage::TileGroup> tile_group;
+  const char *pos = begin;
+
+  try {
+    while (pos < end && failed == false) {
+      const char *record_start = pos;
+      auto field_count = ParseRecord(node, pos, end, fields, nulls);
+      auto record_text = [&]() {
+        return std::string(record_start, pos[-1] == new_line ? pos - 1 : pos);
+      };
+
+      if (field_count != column_count) {
+        throw ExecutorException("expected " + std::to_string(column_count) +
+                                " fields but found " +
+                                std::to_string(field_count) + " in record \"" +
+                                record_text() + "\"");
+      }
+
+      // Parse the whole record before claiming a slot, since a slot that is
+      // never stamped can't be reclaimed
+      for (oid_t column_id = 0; column_id < column_count; column_id++) {
+        values[column_id] = ParseValue(fields[column_id], nulls[column_id],
+                                       schema->GetType(column_id));
+      }
+
+      // Fill the tile groups of this worker one after another
+      oid_t tuple_slot = INVALID_OID;
+      if (tile_group != nullptr) {
+        tuple_slot = tile_group->InsertTuple(nullptr);
+      }
+      if (tuple_slot == INVALID_OID) {
+        tile_group = table->AppendTileGroup();
+        result.tile_group_ids.push_back(tile_group->GetTileGroupId());
+        tuple_slot = tile_group->InsertTuple(nullptr);
+      }
+
+      for (oid_t column_id = 0; column_id < column_count; column_id++) {
+        tile_group->SetValue(values[column_id], tuple_slot, column_id);
+      }
+
+      // Own the slot before adding the index entries, so that the unique
+      // checks of later records, on this thread or another, see it as an
+      // insert of this transaction. The insert is recorded in the transaction
+      // once all threads are done.
+      auto tile_group_header = tile_group->GetHeader();
+      tile_group_header->SetTransactionId(tuple_slot,
+                                          current_txn->GetTransactionId());
+
+      // Check constraints and add the index entries
+      ItemPointer location(tile_group->GetTileGroupId(), tuple_slot);
+      ItemPointer *index_entry_ptr = nullptr;
+      ContainerTuple<storage::TileGroup> tuple(tile_group.get(), tuple_slot);
+      if (table->InsertTuple(&tuple, location, current_txn,
+                             &index_entry_ptr) == false) {
+        tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
+        throw ExecutorException("constraint violated by record \"" +
+                                record_text() + "\"");
+      }
+      result.tuples.emplace_back(location, index_entry_ptr);
+    }
+  } catch (Exception &e) {
+    result.error_message = e.what();
+    failed = true;
+  }
+}
+
+size_t CopyExecutor::ParseRecord(const planner::CopyPlan &node,
+                                 const char *&pos, const char *end,
+                                 std::vector<std::string> &fields,
+                                 std::vector<bool> &nulls) {
+  bool csv = (node.copy_type == CopyType::IMPORT_CSV);
+  char field_delimiter = node.delimiter;
+
+  auto is_field_end = [&](const char *p) {
+    return p == end || *p == field_delimiter || *p == new_line ||
+           (*p == '\r' && (p + 1 == end || p[1] == new_line));
+  };
+
+  size_t field_count = 0;
+  while (true) {
+    // Reuse the strings of the previous record to avoid allocations
+    if (field_count == fields.size()) {
+      fields.emplace_back();
+      nulls.push_back(false);
+    }
+    std::string &field = fields[field_count];
+    field.clear();
+    bool is_null = false;
+
+    if (csv && pos < end && *pos == '"') {
+      // Quoted CSV field, where "" is a quote. It can't span lines since the
+      // file is split at line breaks.
+      pos++;
+      while (true) {
+        if (pos == end || *pos == new_line) {
+          throw ExecutorException("unterminated quoted field");
+        }
+        if (*pos == '"') {
+          pos++;
+          if (pos == end || *pos != '"') break;
+        }
+        field.push_back(*pos++);
+      }
+      if (is_field_end(pos) == false) {
+        throw ExecutorException("unexpected character after quoted field");
+      }
+    } else if (csv == false && pos + 1 < end && pos[0] == '\\' &&
+               pos[1] == 'N' && is_field_end(pos + 2)) {
+      // \N is null in the text format
+      is_null = true;
+      pos += 2;
+    } else {
+      // Find the end of an unquoted field in one pass, then copy it. The text
+      // format escapes delimiters, line breaks and backslashes.
+      while (true) {
+        const char *field_start = pos;
+        while (is_field_end(pos) == false && (csv || *pos != '\\')) {
+          pos++;
+        }
+        field.append(field_start, pos);
+        if (is_field_end(pos)) break;
+
+        // Backslash escape
+        if (++pos == end) break;
+        switch (*pos) {
+          case 't':
+            field.push_back('\t');
+            break;
+          case 'n':
+            field.push_back('\n');
+            break;
+          case 'r':
+            field.push_back('\r');
+            break;
+          default:
+            field.push_back(*pos);
+        }
+        pos++;
+      }
+      // Only \N is null in the text format, while CSV treats an unquoted
+      // empty field as null
+      is_null = csv && field.empty();
+    }
+
+    nulls[field_count++] = is_null;
+
+    // Tolerate Windows line breaks
+    if (pos < end && *pos == '\r') pos++;
+    if (pos == end) return field_count;
+    if (*pos++ == new_line) return field_count;
+  }
+}
+
+type::Value CopyExecutor::ParseValue(const std::string &field, bool is_null,
+                                     type::TypeId type_id) {
+  if (is_null) {
+    return type::ValueFactory::GetNullValueByType(type_id);
+  }
+
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT: {
+      // Parse integers directly rather than casting a varchar value
+      char *parse_end;
+      errno = 0;
+      int64_t value = std::strtoll(field.c_str(), &parse_end, 10);
+      if (parse_end == field.c_str() || *parse_end != '\0' || errno != 0) {
+        throw ExecutorException("invalid integer \"" + field + "\"");
+      }
+      // Out of range values fail the cast
+      return type::ValueFactory::GetBigIntValue(value).CastAs(type_id);
+    }
+    case type::TypeId::DECIMAL: {
+      char *parse_end;
+      double value = std::strtod(field.c_str(), &parse_end);
+      if (parse_end == field.c_str() || *parse_end != '\0') {
+        throw ExecutorException("invalid decimal \"" + field + "\"");
+      }
+      return type::ValueFactory::GetDecimalValue(value);
+    }
+    case type::TypeId::VARCHAR:
+    case type::TypeId::VARBINARY:
+      return type::ValueFactory::GetVarcharValue(field);
+    default:
+      // Cast here rather than in the tile, so that a bad value fails before
+      // the record claims a slot
+      return type::ValueFactory::GetVarcharValue(field).CastAs(type_id);
+  }
+}
+
+/**
+ * @brief Write the visible tuples of the target table to the file. The tile
+ * groups are spread over several threads, which format the values straight
+ * from tile memory into large buffers and write them with pwrite().
+ * @return true on success, false otherwise.
+ */
+bool CopyExecutor::ExecuteExport(const planner::CopyPlan &node) {
+  auto table = node.target_table;
+  export_file_offset = 0;
+  export_read_failed = false;
+
+  if (node.copy_type == CopyType::EXPORT_BINARY) {
+    // The header holds the column count and the type of each column
+    auto schema = table->GetSchema();
+    uint32_t column_count = schema->GetColumnCount();
+    size_t magic_size = strlen(kBinaryExportMagic);
+
+    ExportBuffer header;
+    header.size = magic_size + sizeof(column_count) + column_count;
+    header.data.resize(header.size);
+    PL_MEMCPY(header.data.data(), kBinaryExportMagic, magic_size);
+    PL_MEMCPY(header.data.data() + magic_size, &column_count,
+              sizeof(column_count));
+    for (oid_t column_id = 0; column_id < column_count; column_id++) {
+      header.data[magic_size + sizeof(column_count) + column_id] =
+          static_cast<char>(schema->GetType(column_id));
+    }
+    FlushExportBuffer(header);
+  }
+
+  // Small tables are exported by fewer threads since spawning them costs more
+  // than formatting the tuples
+  size_t tile_group_count = table->GetTileGroupCount();
+  size_t max_worker_count = std::max(
+      settings::SettingsManager::GetInt(settings::SettingId::copy_worker_count),
+      1);
+  size_t worker_count = std::max<size_t>(
+      std::min(max_worker_count,
+               tile_group_count / kMinExportTileGroupsPerWorker),
+      1);
+
+  std::vector<ExportResult> results(worker_count);
+  std::atomic<oid_t> next_tile_group(0);
+  if (worker_count == 1) {
+    ExportTileGroups(node, next_tile_group, results[0]);
+  } else {
+    std::vector<std::thread> workers;
+    for (size_t worker = 0; worker < worker_count; worker++) {
+      workers.emplace_back(&CopyExecutor::ExportTileGroups, this,
+                           std::cref(node), std::ref(next_tile_group),
+                           std::ref(results[worker]));
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+  }
+
+  FFlushFsync();
+  fclose(file_handle_.file);
+  total_bytes_written = export_file_offset;
+
+  for (auto &result : results) {
+    if (result.error_message.empty() == false) {
+      throw ExecutorException("Failed to export to " + node.file_path + ": " +
+                              result.error_message);
+    }
+  }
+
+  if (export_read_failed) {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    txn_manager.SetTransactionResult(executor_context_->GetTransaction(),
+                                     ResultType::FAILURE);
+    return false;
+  }
+
+  LOG_DEBUG("Exported %zu bytes to %s with %zu threads", total_bytes_written,
+            node.file_path.c_str(), worker_count);
+  return true;
+}
+
+void CopyExecutor::ExportTileGroups(const planner::CopyPlan &node,
+                                    std::atomic<oid_t> &next_tile_group,
+                                    ExportResult &result) {
+  auto table = node.target_table;
+  auto column_count = table->GetSchema()->GetColumnCount();
+  bool binary = (node.copy_type == CopyType::EXPORT_BINARY);
+  bool csv = (node.copy_type == CopyType::EXPORT_CSV);
+  size_t null_bitmap_size = (column_count + 7) / 8;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto current_txn = executor_context_->GetTransaction();
+
+  ExportBuffer buffer;
+  buffer.data.resize(kExportBufferSize);
+  std::vector<ExportColumn> columns(column_count);
+  std::vector<char> null_bitmap(null_bitmap_size);
+  std::vector<uint32_t> selection_vector;
+
+  try {
+    size_t tile_group_count = table->GetTileGroupCount();
+    for (oid_t tile_group_offset = next_tile_group++;
+         tile_group_offset < tile_group_count;
+         tile_group_offset = next_tile_group++) {
+      if (export_read_failed) break;
+      auto tile_group = table->GetTileGroup(tile_group_offset);
+      if (tile_group == nullptr) continue;
+      auto tile_group_header = tile_group->GetHeader();
+      oid_t tid_end = tile_group_header->GetCurrentNextTupleSlot();
+      selection_vector.resize(tid_end);
+
+      uint32_t visible_count;
+      if (txn_manager.PerformAllVisibleRead(current_txn, tile_group_header)) {
+        for (oid_t tuple_id = 0; tuple_id < tid_end; tuple_id++) {
+          selection_vector[tuple_id] = tuple_id;
+        }
+        visible_count = tid_end;
+        if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+                settings::SettingId::stats_mode)) != StatsType::INVALID) {
+          stats::BackendStatsContext::GetInstance()->IncrementTableReads(
+              tile_group->GetTileGroupId(), tid_end);
+        }
+      } else {
+        visible_count = txn_manager.FilterVisible(
+            current_txn, tile_group_header, 0, tid_end,
+            selection_vector.data());
+
+        // Register the reads before the tuples are formatted, so that no
+        // writer can overwrite a version this transaction has already read
+        std::lock_guard<std::mutex> lock(export_txn_lock);
+        for (uint32_t idx = 0; idx < visible_count; idx++) {
+          ItemPointer location(tile_group->GetTileGroupId(),
+                               selection_vector[idx]);
+          if (txn_manager.PerformRead(current_txn, location) == false) {
+            export_read_failed = true;
+            break;
+          }
+        }
+        if (export_read_failed) break;
+      }
+
+      // Tile groups can have different layouts
+      for (oid_t column_id = 0; column_id < column_count; column_id++) {
+        oid_t tile_offset, tile_column_id;
+        tile_group->LocateTileAndColumn(column_id, tile_offset,
+                                        tile_column_id);
+        auto tile = tile_group->GetTile(tile_offset);
+        auto tile_schema = tile->GetSchema();
+        columns[column_id] = {tile, tile_schema->GetOffset(tile_column_id),
+                              tile_schema->GetType(tile_column_id),
+                              tile_schema->IsInlined(tile_column_id)};
+      }
+
+      for (uint32_t idx = 0; idx < visible_count; idx++) {
+        oid_t tuple_id = selection_vector[idx];
+
+        if (binary == false) {
+          for (oid_t column_id = 0; column_id < column_count; column_id++) {
+            auto &column = columns[column_id];
+            FormatTextField(column,
+                            column.tile->GetTupleLocation(tuple_id),
+                            node.delimiter, csv,
+                            column_id == column_count - 1, buffer);
+          }
+          continue;
+        }
+
+        // Each binary row starts with a bitmap of its null fields
+        std::fill(null_bitmap.begin(), null_bitmap.end(), 0);
+        for (oid_t column_id = 0; column_id < column_count; column_id++) {
+          auto &column = columns[column_id];
+          if (IsNullField(column, column.tile->GetTupleLocation(tuple_id) +
+                                      column.offset)) {
+            null_bitmap[column_id / 8] |= (1 << (column_id % 8));
+          }
+        }
+        PL_MEMCPY(ReserveExportBuffer(buffer, null_bitmap_size),
+                  null_bitmap.data(), null_bitmap_size);
+        buffer.size += null_bitmap_size;
+
+        for (oid_t column_id = 0; column_id < column_count; column_id++) {
+          if (null_bitmap[column_id / 8] & (1 << (column_id % 8))) continue;
+          auto &column = columns[column_id];
+          FormatBinaryField(
+              column, column.tile->GetTupleLocation(tuple_id) + column.offset,
+              buffer);
+        }
+      }
+    }
+
+    FlushExportBuffer(buffer);
+  } catch (Exception &e) {
+    result.error_message = e.what();
+  }
+}
+
+// Write the decimal digits of value to out and return how many there are
+static size_t FormatInteger(int64_t value, char *out) {
+  char digits[20];
+  size_t digit_count = 0;
+  // Negate in unsigned arithmetic so the smallest value does not overflow
+  uint64_t magnitude = (value < 0) ? (0 - static_cast<uint64_t>(value))
+                                   : static_cast<uint64_t>(value);
+  do {
+    digits[digit_count++] = '0' + (magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0);
+
+  size_t len = 0;
+  if (value < 0) out[len++] = '-';
+  while (digit_count > 0) out[len++] = digits[--digit_count];
+  return len;
+}
+
+void CopyExecutor::FormatTextField(const ExportColumn &column,
+                                   const char *tuple_location,
+                                   char field_delimiter, bool csv,
+                                   bool end_of_line, ExportBuffer &buffer) {
+  const char *field = tuple_location + column.offset;
+
+  if (IsNullField(column, field)) {
+    // CSV leaves nulls empty, while the text format writes \N
+    if (csv == false) {
+      char *out = ReserveExportBuffer(buffer, 2);
+      out[0] = '\\';
+      out[1] = 'N';
+      buffer.size += 2;
+    }
+  } else {
+    switch (column.type_id) {
+      case type::TypeId::TINYINT: {
+        char *out = ReserveExportBuffer(buffer, 20);
+        buffer.size +=
+            FormatInteger(*reinterpret_cast<const int8_t *>(field), out);
+        break;
+      }
+      case type::TypeId::SMALLINT: {
+        char *out = ReserveExportBuffer(buffer, 20);
+        buffer.size +=
+            FormatInteger(*reinterpret_cast<const int16_t *>(field), out);
+        break;
+      }
+      case type::TypeId::INTEGER: {
+        char *out = ReserveExportBuffer(buffer, 20);
+        buffer.size +=
+            FormatInteger(*reinterpret_cast<const int32_t *>(field), out);
+        break;
+      }
+      case type::TypeId::BIGINT: {
+        char *out = ReserveExportBuffer(buffer, 20);
+        buffer.size +=
+            FormatInteger(*reinterpret_cast<const int64_t *>(field), out);
+        break;
+      }
+      case type::TypeId::DECIMAL: {
+        // Same format as DecimalType::ToString()
+        char *out = ReserveExportBuffer(buffer, 32);
+        buffer.size += snprintf(out, 32, "%g",
+                                *reinterpret_cast<const double *>(field));
+        break;
+      }
+      case type::TypeId::VARCHAR:
+      case type::TypeId::VARBINARY: {
+        // Varlen fields point to their length followed by the data
+        const char *varlen = *reinterpret_cast<const char *const *>(field);
+        uint32_t len = *reinterpret_cast<const uint32_t *>(varlen);
+        // Don't write the NULL character for varchar
+        if (column.type_id == type::TypeId::VARCHAR && len > 0) len--;
+        AppendEscapedText(varlen + sizeof(uint32_t), len, field_delimiter, csv,
+                          buffer);
+        break;
+      }
+      default: {
+        auto value = type::Value::DeserializeFrom(field, column.type_id,
+                                                  column.is_inlined);
+        auto value_str = value.ToString();
+        AppendEscapedText(value_str.c_str(), value_str.length(),
+                          field_delimiter, csv, buffer);
+      }
+    }
+  }
+
+  *ReserveExportBuffer(buffer, 1) = end_of_line ? new_line : field_delimiter;
+  buffer.size++;
+}
+
+void CopyExecutor::AppendEscapedText(const char *data, size_t len,
+                                     char field_delimiter, bool csv,
+                                     ExportBuffer &buffer) {
+  const char *data_end = data + len;
+
+  if (csv) {
+    // Fields with delimiters, quotes or line breaks are quoted and their
+    // quotes doubled. Empty strings are quoted to tell them from nulls.
+    bool quote = (len == 0);
+    for (const char *pos = data; pos < data_end && quote == false; pos++) {
+      quote = (*pos == field_delimiter || *pos == '"' || *pos == new_line ||
+               *pos == '\r');
+    }
+    if (quote == false) {
+      PL_MEMCPY(ReserveExportBuffer(buffer, len), data, len);
+      buffer.size += len;
+      return;
+    }
+
+    // Worst case every character is a quote
+    char *out = ReserveExportBuffer(buffer, len * 2 + 2);
+    char *out_start = out;
+    *out++ = '"';
+    for (const char *pos = data; pos < data_end; pos++) {
+      if (*pos == '"') *out++ = '"';
+      *out++ = *pos;
+    }
+    *out++ = '"';
+    buffer.size += out - out_start;
+    return;
+  }
+
+  // The text format escapes backslashes, delimiters and line breaks with a
+  // backslash. Worst case we need to escape all characters.
+  char *out = ReserveExportBuffer(buffer, len * 2);
+  char *out_start = out;
+
+  // Copy the runs between special characters in one go
+  const char *run_start = data;
+  for (const char *pos = data; pos < data_end; pos++) {
+    char escaped;
+    switch (*pos) {
+      case '\\':
+        escaped = '\\';
+        break;
+      case '\n':
+        escaped = 'n';
+        break;
+      case '\r':
+        escaped = 'r';
+        break;
+      case '\t':
+        escaped = 't';
+        break;
+      default:
+        if (*pos != field_delimiter) continue;
+        escaped = field_delimiter;
+    }
+    PL_MEMCPY(out, run_start, pos - run_start);
+    out += pos - run_start;
+    *out++ = '\\';
+    *out++ = escaped;
+    run_start = pos + 1;
+  }
+  PL_MEMCPY(out, run_start, data_end - run_start);
+  out += data_end - run_start;
+
+  buffer.size += out - out_start;
+}
+
+void CopyExecutor::FormatBinaryField(const ExportColumn &column,
+                                     const char *field, ExportBuffer &buffer) {
+  if (column.type_id == type::TypeId::VARCHAR ||
+      column.type_id == type::TypeId::VARBINARY) {
+    // Length followed by the data, without the NULL character for varchar
+    const char *varlen = *reinterpret_cast<const char *const *>(field);
+    uint32_t len = *reinterpret_cast<const uint32_t *>(varlen);
+    if (column.type_id == type::TypeId::VARCHAR && len > 0) len--;
+    char *out = ReserveExportBuffer(buffer, sizeof(len) + len);
+    PL_MEMCPY(out, &len, sizeof(len));
+    PL_MEMCPY(out + sizeof(len), varlen + sizeof(uint32_t), len);
+    buffer.size += sizeof(len) + len;
+    return;
+  }
+
+  // Fixed-length values are copied as they are stored
+  size_t size = type::Type::GetTypeSize(column.type_id);
+  PL_MEMCPY(ReserveExportBuffer(buffer, size), field, size);
+  buffer.size += size;
+}
+
+bool CopyExecutor::IsNullField(const ExportColumn &column, const char *field) {
+  switch (column.type_id) {
+    case type::TypeId::TINYINT:
+      return *reinterpret_cast<const int8_t *>(field) == type::PELOTON_INT8_NULL;
+    case type::TypeId::SMALLINT:
+      return *reinterpret_cast<const int16_t *>(field) ==
+             type::PELOTON_INT16_NULL;
+    case type::TypeId::INTEGER:
+      return *reinterpret_cast<const int32_t *>(field) ==
+             type::PELOTON_INT32_NULL;
+    case type::TypeId::BIGINT:
+      return *reinterpret_cast<const int64_t *>(field) ==
+             type::PELOTON_INT64_NULL;
+    case type::TypeId::DECIMAL:
+      return *reinterpret_cast<const double *>(field) ==
+             type::PELOTON_DECIMAL_NULL;
+    case type::TypeId::VARCHAR:
+    case type::TypeId::VARBINARY:
+      return *reinterpret_cast<const char *const *>(field) == nullptr;
+    default:
+      return type::Value::DeserializeFrom(field, column.type_id,
+                                          column.is_inlined)
+          .IsNull();
+  }
+}
+
+char *CopyExecutor::ReserveExportBuffer(ExportBuffer &buffer, size_t size) {
+  if (buffer.size + size > buffer.data.size()) {
+    FlushExportBuffer(buffer);
+    if (size > buffer.data.size()) {
+      buffer.data.resize(size);
+    }
+  }
+  return buffer.data.data() + buffer.size;
+}
+
+void CopyExecutor::FlushExportBuffer(ExportBuffer &buffer) {
+  if (buffer.size == 0) return;
+
+  // Claim a range of the file, so the threads never wait on each other
+  size_t offset = export_file_offset.fetch_add(buffer.size);
+  size_t bytes_written = 0;
+  while (bytes_written < buffer.size) {
+    auto ret = pwrite(file_handle_.fd, buffer.data.data() + bytes_written,
+                      buffer.size - bytes_written, offset + bytes_written);
+    if (ret < 0) {
+      if (errno == EINTR) continue;
+      throw ExecutorException(std::string("Failed to write: ") +
+                              strerror(errno));
+    }
+    bytes_written += ret;
+  }
+  buffer.size = 0;
+}
+
 }  // namespace executor
 }  // namespace peloton
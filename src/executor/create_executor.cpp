@@ -17,6 +17,7 @@
 #include "catalog/trigger_catalog.h"
 #include "catalog/database_catalog.h"
 #include "catalog/table_catalog.h"
+#include "common/statement_cache_manager.h"
 #include "concurrency/transaction_context.h"
 #include "executor/executor_context.h"
 #include "planner/create_plan.h"
@@ -111,6 +112,16 @@ bool CreateExecutor::CreateTable(const planner::CreatePlan &node) {
   if (current_txn->GetResult() == ResultType::SUCCESS) {
     LOG_TRACE("Creating table succeeded!");
 
+    // Queries that failed to plan may have referred to the new table
+    if (StatementCacheManager::GetStmtCacheManager().get()) {
+      oid_t table_id = catalog::Catalog::GetInstance()
+                           ->GetTableObject(database_name, table_name,
+                                            current_txn)
+                           ->GetTableOid();
+      StatementCacheManager::GetStmtCacheManager()->InvalidateTableOid(
+          table_id);
+    }
+
     // Add the foreign key constraint (or other multi-column constraints)
     if (node.GetForeignKeys().empty() == false) {
       auto catalog = catalog::Catalog::GetInstance();
@@ -217,9 +228,18 @@ bool CreateExecutor::CreateIndex(const planner::CreatePlan &node) {
   txn->SetResult(result);
 
   if (txn->GetResult() == ResultType::SUCCESS) {
-    LOG_TRACE("Creating table succeeded!");
+    LOG_TRACE("Creating index succeeded!");
+
+    // Plans picked before may be beaten by a scan on the new index
+    if (StatementCacheManager::GetStmtCacheManager().get()) {
+      oid_t table_id = catalog::Catalog::GetInstance()
+                           ->GetTableObject(database_name, table_name, txn)
+                           ->GetTableOid();
+      StatementCacheManager::GetStmtCacheManager()->InvalidateTableOid(
+          table_id);
+    }
   } else if (txn->GetResult() == ResultType::FAILURE) {
-    LOG_TRACE("Creating table failed!");
+    LOG_TRACE("Creating index failed!");
   } else {
     LOG_TRACE("Result is: %s",
               ResultTypeToString(txn->GetResult()).c_str());
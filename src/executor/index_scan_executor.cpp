@@ -155,7 +155,9 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
 
   PL_ASSERT(index_->GetIndexType() == IndexConstraintType::PRIMARY_KEY);
 
-  if (0 == key_column_ids_.size()) {
+  if (TakeBatchedLookup(tuple_location_ptrs)) {
+    LOG_TRACE("Batched lookup in Primary Index");
+  } else if (0 == key_column_ids_.size()) {
     index_->ScanAllKeys(tuple_location_ptrs);
   } else {
     // Limit clause accelerate
@@ -389,7 +391,9 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
   // Grab info from plan node
   bool acquire_owner = GetPlanNode<planner::AbstractScan>().IsForUpdate();
 
-  if (0 == key_column_ids_.size()) {
+  if (TakeBatchedLookup(tuple_location_ptrs)) {
+    LOG_TRACE("Batched lookup in Secondary Index");
+  } else if (0 == key_column_ids_.size()) {
     index_->ScanAllKeys(tuple_location_ptrs);
   } else {
     // Limit clause accelerate
@@ -644,6 +648,52 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
   return true;
 }
 
+bool IndexScanExecutor::PrepareBatchedLookups(
+    const std::vector<oid_t> &column_ids,
+    const std::vector<std::vector<type::Value>> &value_list) {
+  batched_results_.clear();
+  batched_probe_ = INVALID_OID;
+
+  // Only a single point lookup per probe can be batched
+  const auto &conjunctions = index_predicate_.GetConjunctionList();
+  if (limit_ || conjunctions.size() != 1 ||
+      conjunctions[0].IsPointQuery() == false) {
+    return false;
+  }
+
+  auto *pool = executor_context_->GetPool();
+  auto *key_schema = index_->GetKeySchema();
+  std::vector<std::unique_ptr<storage::Tuple>> keys;
+  std::vector<const storage::Tuple *> key_ptrs;
+  for (const auto &values : value_list) {
+    // Bind the probe's values, then copy out the resulting search key
+    UpdatePredicate(column_ids, values);
+    const storage::Tuple *point_query_key =
+        index_predicate_.GetConjunctionList()[0].GetPointQueryKey();
+
+    std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+    for (oid_t col = 0; col < key_schema->GetColumnCount(); col++) {
+      key->SetValue(col, point_query_key->GetValue(col), pool);
+    }
+    key_ptrs.push_back(key.get());
+    keys.push_back(std::move(key));
+  }
+
+  index_->ScanKeys(key_ptrs, batched_results_);
+  LOG_TRACE("Batched %lu index lookups", key_ptrs.size());
+  return true;
+}
+
+bool IndexScanExecutor::TakeBatchedLookup(
+    std::vector<ItemPointer *> &tuple_location_ptrs) {
+  if (batched_probe_ >= batched_results_.size()) {
+    return false;
+  }
+  tuple_location_ptrs = batched_results_[batched_probe_];
+  batched_probe_ = INVALID_OID;
+  return true;
+}
+
 void IndexScanExecutor::CheckOpenRangeWithReturnedTuples(
     std::vector<ItemPointer> &tuple_locations) {
   while (left_open_) {
@@ -145,6 +145,20 @@ bool MergeJoinExecutor::DExecute() {
       auto right_value =
           clause.right_->Evaluate(&left_tuple, &right_tuple, nullptr);
 
+      // NULL keys never match, skip them
+      if (left_value.IsNull()) {
+        left_start_row = left_end_row;
+        left_end_row = Advance(left_tile, left_start_row, true);
+        not_matching_tuple_pair = true;
+        break;
+      }
+      if (right_value.IsNull()) {
+        right_start_row = right_end_row;
+        right_end_row = Advance(right_tile, right_start_row, false);
+        not_matching_tuple_pair = true;
+        break;
+      }
+
       // Left key < Right key, advance left
       if (left_value.CompareLessThan(right_value) == CmpBool::CmpTrue) {
         LOG_TRACE("left < right, advance left ");
@@ -174,28 +188,23 @@ bool MergeJoinExecutor::DExecute() {
     // Join clauses matched, try to match predicate
     LOG_TRACE("one pair of tuples matches join clause ");
 
-    // Join predicate exists
-    if (predicate_ != nullptr) {
-      auto eval = predicate_->Evaluate(&left_tuple,
-                                      &right_tuple, executor_context_);
-      if (eval.IsFalse()) {
-      //if (predicate_->Evaluate(&left_tuple, &right_tuple, executor_context_)
-      //        .IsFalse()) {
-        // Join predicate is false. Advance both.
-        left_start_row = left_end_row;
-        left_end_row = Advance(left_tile, left_start_row, true);
-
-        right_start_row = right_end_row;
-        right_end_row = Advance(right_tile, right_start_row, false);
-      }
-    }
-
     // Sub tile matched, do a Cartesian product
-    // Go over every pair of tuples in left and right logical tiles
+    // Go over every pair of tuples in left and right logical tiles, keeping
+    // the pairs the join predicate holds for
     for (size_t left_tile_row_itr = left_start_row;
          left_tile_row_itr < left_end_row; left_tile_row_itr++) {
       for (size_t right_tile_row_itr = right_start_row;
            right_tile_row_itr < right_end_row; right_tile_row_itr++) {
+        if (predicate_ != nullptr) {
+          ContainerTuple<executor::LogicalTile> left_pair_tuple(
+              left_tile, left_tile_row_itr);
+          ContainerTuple<executor::LogicalTile> right_pair_tuple(
+              right_tile, right_tile_row_itr);
+          auto eval = predicate_->Evaluate(&left_pair_tuple, &right_pair_tuple,
+                                           executor_context_);
+          if (!eval.IsTrue()) continue;
+        }
+
         // Insert a tuple into the output logical tile
         pos_lists_builder.AddRow(left_tile_row_itr, right_tile_row_itr);
 
@@ -205,6 +214,13 @@ bool MergeJoinExecutor::DExecute() {
       }
     }
 
+    // The run of left rows may continue in the next left tile, which has to
+    // be matched against the same right rows
+    if (left_end_row == left_tile->GetTupleCount() && !left_child_done_) {
+      left_start_row = left_end_row;
+      break;
+    }
+
     // Then, advance both if necessary
     right_start_row = right_end_row;
     right_end_row = Advance(right_tile, right_start_row, false);
@@ -226,10 +242,8 @@ bool MergeJoinExecutor::DExecute() {
     // If we are out of any more pairs of child tiles to examine,
     // then we will return false earlier in this function
     // So, no need to return false here
-    DExecute();
+    return DExecute();
   }
-
-  return true;
 }
 
 /**
@@ -111,6 +111,11 @@ bool NestedLoopJoinExecutor::DExecute() {
                                                        left_tile_row_itr_);
 
       // Grab the values
+      if (batched_lookups_) {
+        // Pass the row whose batched lookup the right executor should use
+        auto *index_scan = static_cast<IndexScanExecutor *>(children_[1]);
+        index_scan->SelectBatchedLookup(left_tile_row_itr_);
+      }
       if (!join_column_ids_left.empty() && !join_column_ids_right.empty()) {
         std::vector<type::Value> join_values;
         for (auto column_id : join_column_ids_left) {
@@ -218,6 +223,27 @@ bool NestedLoopJoinExecutor::DExecute() {
       // Set the flag with init status
       left_tile_done_ = false;
       left_tile_row_itr_ = 0;
+
+      // If the right child is an index lookup, probe the index for every row
+      // of the new left tile at once
+      batched_lookups_ = false;
+      auto *index_scan = dynamic_cast<IndexScanExecutor *>(children_[1]);
+      if (index_scan != nullptr && !join_column_ids_left.empty() &&
+          !join_column_ids_right.empty()) {
+        std::vector<std::vector<type::Value>> join_value_list;
+        for (oid_t left_row = 0; left_row < left_tile_->GetTupleCount();
+             left_row++) {
+          ContainerTuple<executor::LogicalTile> left_tuple(left_tile_.get(),
+                                                           left_row);
+          std::vector<type::Value> join_values;
+          for (auto column_id : join_column_ids_left) {
+            join_values.push_back(left_tuple.GetValue(column_id));
+          }
+          join_value_list.push_back(std::move(join_values));
+        }
+        batched_lookups_ = index_scan->PrepareBatchedLookups(
+            join_column_ids_right, join_value_list);
+      }
     }
 
     LOG_TRACE("Get a new left tile. Continue the loop.");
@@ -21,6 +21,7 @@
 #include "executor/executor_context.h"
 #include "executor/executors.h"
 #include "settings/settings_manager.h"
+#include "statistics/backend_stats_context.h"
 #include "storage/tuple_iterator.h"
 
 namespace peloton {
@@ -56,9 +57,20 @@ static void CompileAndExecutePlan(
   // Compile the query
   codegen::Query *query = codegen::QueryCache::Instance().Find(plan);
   if (query == nullptr) {
+    bool stats_enabled =
+        static_cast<StatsType>(settings::SettingsManager::GetInt(
+            settings::SettingId::stats_mode)) != StatsType::INVALID;
+    codegen::QueryCompiler::CompileStats compile_stats;
     codegen::QueryCompiler compiler;
     auto compiled_query = compiler.Compile(
-        *plan, executor_context->GetParams().GetQueryParametersMap(), consumer);
+        *plan, executor_context->GetParams().GetQueryParametersMap(), consumer,
+        stats_enabled ? &compile_stats : nullptr);
+    if (stats_enabled) {
+      stats::BackendStatsContext::GetInstance()
+          ->GetCompileLatencyMetric()
+          .RecordLatency(compile_stats.setup_ms + compile_stats.ir_gen_ms +
+                         compile_stats.jit_ms);
+    }
     query = compiled_query.get();
     codegen::QueryCache::Instance().Add(plan, std::move(compiled_query));
   }
@@ -24,7 +24,10 @@
 #include "expression/comparison_expression.h"
 #include "common/container_tuple.h"
 #include "planner/create_plan.h"
+#include "settings/settings_manager.h"
+#include "statistics/backend_stats_context.h"
 #include "storage/data_table.h"
+#include "storage/deduplicated_tile_group.h"
 #include "storage/tile_group_header.h"
 #include "storage/tile.h"
 #include "concurrency/transaction_manager_factory.h"
@@ -68,9 +71,36 @@ bool SeqScanExecutor::DInit() {
     }
   }
 
+  InitDedupPredicate();
+
   return true;
 }
 
+void SeqScanExecutor::InitDedupPredicate() {
+  dedup_column_id_ = INVALID_OID;
+  if (predicate_ == nullptr ||
+      predicate_->GetExpressionType() != ExpressionType::COMPARE_EQUAL ||
+      predicate_->GetChild(0)->GetExpressionType() !=
+          ExpressionType::VALUE_TUPLE ||
+      predicate_->GetChild(1)->GetExpressionType() !=
+          ExpressionType::VALUE_CONSTANT) {
+    return;
+  }
+
+  auto column_expr = static_cast<const expression::TupleValueExpression *>(
+      predicate_->GetChild(0));
+  auto value = static_cast<const expression::ConstantValueExpression *>(
+                   predicate_->GetChild(1))->GetValue();
+  if (column_expr->GetTupleId() != 0 || value.IsNull() ||
+      (value.GetTypeId() != type::TypeId::VARCHAR &&
+       value.GetTypeId() != type::TypeId::VARBINARY) ||
+      value.GetTypeId() != column_expr->GetValueType()) {
+    return;
+  }
+  dedup_column_id_ = column_expr->GetColumnId();
+  dedup_value_ = value.Copy();
+}
+
 /**
  * @brief Creates logical tile from tile group and applies scan predicate.
  * @return true on success, false otherwise.
@@ -158,12 +188,66 @@ bool SeqScanExecutor::DExecute() {
 
       oid_t active_tuple_count = tile_group->GetNextTupleSlot();
 
+      // Tuples in an all-visible tile group need neither visibility checks
+      // nor per-tuple read tracking
+      bool all_visible = transaction_manager.PerformAllVisibleRead(
+          current_txn, tile_group_header, acquire_owner);
+      if (all_visible &&
+          static_cast<StatsType>(settings::SettingsManager::GetInt(
+              settings::SettingId::stats_mode)) != StatsType::INVALID) {
+        stats::BackendStatsContext::GetInstance()->IncrementTableReads(
+            tile_group->GetTileGroupId(), active_tuple_count);
+      }
+
+      // Every field of a deduplicated column points to the entry of its
+      // value, so equality is a pointer comparison
+      const char *dedup_entry = nullptr;
+      const storage::Tile *dedup_tile = nullptr;
+      size_t dedup_offset = 0;
+      if (all_visible && dedup_column_id_ != INVALID_OID) {
+        auto dedup = tile_group->GetDedup();
+        if (dedup != nullptr &&
+            dedup->GetColumn(dedup_column_id_).encoding ==
+                storage::DeduplicatedTileGroup::ColumnEncoding::DEDUPLICATED) {
+          dedup_entry = dedup->LookupEntry(dedup_column_id_, dedup_value_);
+          if (dedup_entry == nullptr) {
+            // No tuple has the value
+            continue;
+          }
+          oid_t tile_offset, tile_column_id;
+          tile_group->LocateTileAndColumn(dedup_column_id_, tile_offset,
+                                          tile_column_id);
+          dedup_tile = tile_group->GetTile(tile_offset);
+          dedup_offset = dedup_tile->GetSchema()->GetOffset(tile_column_id);
+        }
+      }
+
       // Construct position list by looping through tile group
       // and applying the predicate.
       std::vector<oid_t> position_list;
       for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
         ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
 
+        if (all_visible) {
+          if (predicate_ == nullptr) {
+            position_list.push_back(tuple_id);
+          } else if (dedup_entry != nullptr) {
+            auto field = *reinterpret_cast<const char *const *>(
+                dedup_tile->GetTupleLocation(tuple_id) + dedup_offset);
+            if (field == dedup_entry) {
+              position_list.push_back(tuple_id);
+            }
+          } else {
+            ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
+                                                     tuple_id);
+            if (predicate_->Evaluate(&tuple, nullptr, executor_context_)
+                    .IsTrue()) {
+              position_list.push_back(tuple_id);
+            }
+          }
+          continue;
+        }
+
         auto visibility = transaction_manager.IsVisible(
             current_txn, tile_group_header, tuple_id);
 
@@ -254,6 +338,7 @@ void SeqScanExecutor::UpdatePredicate(const std::vector<oid_t> &column_ids,
   // we should eventually make prediate_ a unique_ptr
   new_predicate_.reset(new_predicate);
   predicate_ = new_predicate;
+  InitDedupPredicate();
 }
 
 // Transfer a list of equality predicate
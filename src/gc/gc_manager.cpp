@@ -17,6 +17,7 @@
 #include "type/value.h"
 #include "type/abstract_pool.h"
 #include "storage/tile.h"
+#include "storage/deduplicated_tile_group.h"
 #include "storage/tile_group.h"
 
 namespace peloton {
@@ -30,6 +31,8 @@ void GCManager::CheckAndReclaimVarlenColumns(storage::TileGroup *tg, oid_t tuple
     char *tuple_location;
     char *field_location;
     char *varlen_ptr;
+    // Deduplicated entries are shared by other tuples, even after a thaw
+    auto dedup = tg->GetLastDedup();
 
       for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
         const catalog::Schema &schema = tg->tile_schemas[tile_itr];
@@ -51,7 +54,9 @@ void GCManager::CheckAndReclaimVarlenColumns(storage::TileGroup *tg, oid_t tuple
             field_location = tuple_location + schema.GetOffset(tile_col_itr);
             varlen_ptr = type::Value::GetDataFromStorage(type_id, field_location);
             // Call the corresponding varlen pool free
-              if (varlen_ptr != nullptr) {
+              if (varlen_ptr != nullptr &&
+                  (dedup == nullptr ||
+                   dedup->IsSharedEntry(varlen_ptr) == false)) {
                 tile->pool->Free(varlen_ptr);
               }
           }
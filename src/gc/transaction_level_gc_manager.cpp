@@ -19,10 +19,14 @@
 #include "concurrency/transaction_manager_factory.h"
 #include "settings/settings_manager.h"
 #include "index/index.h"
+#include "storage/data_table.h"
 #include "storage/database.h"
+#include "storage/deduplicated_tile_group.h"
 #include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
 #include "storage/tuple.h"
 #include "storage/storage_manager.h"
+#include "storage/tile.h"
 #include "threadpool/mono_queue_pool.h"
 
 
@@ -31,10 +35,15 @@ namespace gc {
 
 bool TransactionLevelGCManager::ResetTuple(const ItemPointer &location) {
   auto &manager = catalog::Manager::GetInstance();
-  auto tile_group = manager.GetTileGroup(location.block).get();
+  auto tile_group = manager.GetTileGroup(location.block);
 
   auto tile_group_header = tile_group->GetHeader();
 
+  // The tile group was compacted and released in the meantime
+  if (location.offset >= tile_group_header->GetCurrentNextTupleSlot()) {
+    return false;
+  }
+
   // Reset the header
   tile_group_header->SetTransactionId(location.offset, INVALID_TXN_ID);
   tile_group_header->SetBeginCommitId(location.offset, MAX_CID);
@@ -46,7 +55,7 @@ bool TransactionLevelGCManager::ResetTuple(const ItemPointer &location) {
             storage::TileGroupHeader::GetReservedSize());
 
   // Reclaim the varlen pool
-  CheckAndReclaimVarlenColumns(tile_group, location.offset);
+  CheckAndReclaimVarlenColumns(tile_group.get(), location.offset);
 
   LOG_TRACE("Garbage tuple(%u, %u) is reset", location.block, location.offset);
   return true;
@@ -68,11 +77,15 @@ void TransactionLevelGCManager::Running(const int &thread_id) {
 
     int reclaimed_count = Reclaim(thread_id, expired_eid);
     int unlinked_count = Unlink(thread_id, expired_eid);
+    int frozen_count = (thread_id == 0) ? Freeze(expired_eid) : 0;
+    int compacted_count = (thread_id == 0) ? Compact(expired_eid) : 0;
+    int evicted_count = (thread_id == 0) ? Evict(expired_eid) : 0;
 
     if (is_running_ == false) {
       return;
     }
-    if (reclaimed_count == 0 && unlinked_count == 0) {
+    if (reclaimed_count == 0 && unlinked_count == 0 && frozen_count == 0 &&
+        compacted_count == 0 && evicted_count == 0) {
       // sleep at most 0.8192 s
       if (backoff_shifts < 13) {
         ++backoff_shifts;
@@ -216,6 +229,9 @@ int TransactionLevelGCManager::Reclaim(const int &thread_id,
 // Multiple GC thread share the same recycle map
 void TransactionLevelGCManager::AddToRecycleMap(
     concurrency::TransactionContext* txn_ctx) {
+  bool compact = settings::SettingsManager::GetBool(
+      settings::SettingId::tile_group_compaction);
+
   for (auto &entry : *(txn_ctx->GetGCSetPtr().get())) {
     auto &manager = catalog::Manager::GetInstance();
     auto tile_group = manager.GetTileGroup(entry.first);
@@ -253,6 +269,11 @@ void TransactionLevelGCManager::AddToRecycleMap(
         recycle_queue_map_[table_id]->Enqueue(location);
       }
     }
+
+    // the tile group has fewer tuples now, and may be worth compacting
+    if ((!immutable) && compact) {
+      compaction_queue_->Enqueue(entry.first);
+    }
   }
 
   auto storage_manager = storage::StorageManager::GetInstance();
@@ -282,6 +303,324 @@ void TransactionLevelGCManager::AddToRecycleMap(
   delete txn_ctx;
 }
 
+bool TransactionLevelGCManager::IsFreezingEnabled() {
+  return settings::SettingsManager::GetBool(
+             settings::SettingId::tile_group_freezing) ||
+         settings::SettingsManager::GetBool(
+             settings::SettingId::tile_group_varlen_dedup) ||
+         settings::SettingsManager::GetBool(
+             settings::SettingId::cold_storage);
+}
+
+void TransactionLevelGCManager::RegisterFreezeCandidate(
+    const oid_t &tile_group_id) {
+  if (IsFreezingEnabled() == false) {
+    return;
+  }
+
+  // inserts keep registering the same tile group, so it is only queued if it
+  // is not waiting in the queue already
+  auto tile_group = catalog::Manager::GetInstance().GetTileGroup(tile_group_id);
+  if (tile_group == nullptr ||
+      tile_group->GetHeader()->MarkFreezeQueued() == false) {
+    return;
+  }
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  freeze_queue_->Enqueue(
+      std::make_pair(tile_group_id, epoch_manager.GetCurrentEpochId()));
+}
+
+// executed by a single thread. so no synchronization is required.
+int TransactionLevelGCManager::Freeze(const eid_t &expired_eid) {
+  int frozen_count = 0;
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  cid_t expired_cid = epoch_manager.GetExpiredCid();
+
+  FreeRetiredVarlens(expired_eid);
+
+  // queued tile groups stay queued until freezing is enabled again
+  if (IsFreezingEnabled() == false) {
+    return 0;
+  }
+
+  std::vector<std::pair<oid_t, eid_t>> candidates;
+  local_freeze_queue_.remove_if(
+      [&candidates, expired_eid](const std::pair<oid_t, eid_t> &entry) {
+        bool res = entry.second <= expired_eid;
+        if (res == true) {
+          candidates.push_back(entry);
+        }
+        return res;
+      });
+
+  for (size_t i = 0; i < MAX_ATTEMPT_COUNT; ++i) {
+    std::pair<oid_t, eid_t> entry;
+    if (freeze_queue_->Dequeue(entry) == false) {
+      break;
+    }
+    if (entry.second <= expired_eid) {
+      candidates.push_back(entry);
+    } else {
+      local_freeze_queue_.push_back(entry);
+    }
+  }
+
+  for (auto &entry : candidates) {
+    auto result = FreezeTileGroup(entry.first, expired_cid);
+    if (result == FreezeResult::FROZEN) {
+      frozen_count++;
+      if (settings::SettingsManager::GetBool(
+              settings::SettingId::cold_storage)) {
+        cold_candidates_.emplace(entry.first,
+                                 std::chrono::steady_clock::now());
+      }
+    } else if (result == FreezeResult::RETRY) {
+      // check it again once the transactions that are active now finish
+      RegisterFreezeCandidate(entry.first);
+    }
+  }
+
+  LOG_TRACE("Froze %d tile groups", frozen_count);
+  return frozen_count;
+}
+
+TransactionLevelGCManager::FreezeResult
+TransactionLevelGCManager::FreezeTileGroup(const oid_t &tile_group_id,
+                                           const cid_t &expired_cid) {
+  auto tile_group = catalog::Manager::GetInstance().GetTileGroup(tile_group_id);
+
+  // the table may have been dropped in the meantime
+  if (tile_group == nullptr) {
+    return FreezeResult::SKIP;
+  }
+
+  // the tile group is out of the queue before it is checked, so that writes
+  // changing the outcome of the check register it again
+  auto tile_group_header = tile_group->GetHeader();
+  tile_group_header->ClearFreezeQueued();
+
+  // only full tile groups can be frozen, since inserts into fresh slots are
+  // never thawed. the tile group is registered again once it fills up.
+  if (tile_group_header->GetCurrentNextTupleSlot() <
+      tile_group->GetAllocatedTupleCount()) {
+    return FreezeResult::SKIP;
+  }
+
+  if (tile_group_header->BeginFreeze() == false) {
+    // already all-visible
+    return FreezeResult::SKIP;
+  }
+
+  oid_t tuple_count = tile_group_header->GetCurrentNextTupleSlot();
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    txn_id_t txn_id = tile_group_header->GetTransactionId(tuple_id);
+    cid_t begin_cid = tile_group_header->GetBeginCommitId(tuple_id);
+    cid_t end_cid = tile_group_header->GetEndCommitId(tuple_id);
+
+    if (txn_id != INITIAL_TXN_ID && txn_id != INVALID_TXN_ID) {
+      // the version is owned by a running transaction
+      tile_group_header->AbortFreeze();
+      return FreezeResult::RETRY;
+    }
+
+    if (txn_id == INVALID_TXN_ID || begin_cid == MAX_CID ||
+        end_cid != MAX_CID) {
+      // the slot is empty or holds an old version. it must be recycled and
+      // reused before the tile group can be frozen; reusing a slot registers
+      // the tile group again.
+      tile_group_header->AbortFreeze();
+      return FreezeResult::SKIP;
+    }
+
+    if (begin_cid > expired_cid) {
+      // the version may be invisible to some active transaction
+      tile_group_header->AbortFreeze();
+      return FreezeResult::RETRY;
+    }
+  }
+
+  // scans use the deduplication as soon as the tile group is all-visible, so
+  // it is installed before that is published
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::tile_group_varlen_dedup)) {
+    DeduplicateTileGroup(tile_group.get());
+  }
+
+  // fails if a transaction acquired ownership of a tuple while we were checking
+  // or deduplicating. that thaw doesn't reset the deduplication since the tile
+  // group was never all-visible, so it's reset here.
+  if (tile_group_header->FinishFreeze() == false) {
+    tile_group->SetDedup(nullptr);
+    return FreezeResult::RETRY;
+  }
+  return FreezeResult::FROZEN;
+}
+
+void TransactionLevelGCManager::DeduplicateTileGroup(
+    storage::TileGroup *tile_group) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  eid_t current_eid = epoch_manager.GetCurrentEpochId();
+
+  std::vector<storage::DeduplicatedTileGroup::RetiredVarlen> retired;
+  auto previous = tile_group->GetLastDedup();
+  auto dedup = storage::DeduplicatedTileGroup::Deduplicate(
+      tile_group, previous.get(), retired);
+  tile_group->SetDedup(dedup);
+
+  for (auto &varlen : retired) {
+    retired_varlens_.emplace_back(current_eid, std::move(varlen));
+  }
+  LOG_TRACE("Deduplicated tile group %u, %zu bytes retired",
+            tile_group->GetTileGroupId(), dedup->GetSavedBytes());
+}
+
+// executed by a single thread. so no synchronization is required.
+void TransactionLevelGCManager::FreeRetiredVarlens(const eid_t &expired_eid) {
+  // the list is ordered by epoch
+  while (retired_varlens_.empty() == false &&
+         retired_varlens_.front().first <= expired_eid) {
+    auto &varlen = retired_varlens_.front().second;
+    varlen.first->GetPool()->Free(varlen.second);
+    retired_varlens_.pop_front();
+  }
+}
+
+// Slots holding a version, whether committed or not
+static oid_t CountUsedSlots(const storage::TileGroupHeader *tile_group_header) {
+  oid_t used_count = 0;
+  oid_t tuple_count = tile_group_header->GetCurrentNextTupleSlot();
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    if (tile_group_header->GetTransactionId(tuple_id) != INVALID_TXN_ID) {
+      used_count++;
+    }
+  }
+  return used_count;
+}
+
+// executed by a single thread. so no synchronization is required.
+int TransactionLevelGCManager::Compact(const eid_t &expired_eid) {
+  int compacted_count = 0;
+  auto &manager = catalog::Manager::GetInstance();
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  eid_t current_eid = epoch_manager.GetCurrentEpochId();
+  double threshold = settings::SettingsManager::GetDouble(
+      settings::SettingId::tile_group_compaction_threshold);
+
+  for (size_t i = 0; i < MAX_ATTEMPT_COUNT; ++i) {
+    oid_t tile_group_id;
+    if (compaction_queue_->Dequeue(tile_group_id) == false) {
+      break;
+    }
+    if (compacting_tile_groups_.count(tile_group_id) != 0) {
+      continue;
+    }
+
+    auto tile_group = manager.GetTileGroup(tile_group_id);
+    if (tile_group == nullptr) {
+      continue;
+    }
+
+    // only full tile groups are compacted, since the others still take
+    // inserts
+    auto tile_group_header = tile_group->GetHeader();
+    oid_t allocated_count = tile_group->GetAllocatedTupleCount();
+    if (tile_group_header->GetCurrentNextTupleSlot() < allocated_count ||
+        CountUsedSlots(tile_group_header) >= threshold * allocated_count) {
+      continue;
+    }
+
+    // stop handing out the recycled slots of the tile group. tile groups
+    // made immutable for other reasons are left alone.
+    if (tile_group_header->SetImmutability() == false) {
+      continue;
+    }
+    LOG_TRACE("Compacting tile group %u", tile_group_id);
+    compacting_tile_groups_[tile_group_id] = current_eid;
+  }
+
+  auto entry = compacting_tile_groups_.begin();
+  while (entry != compacting_tile_groups_.end()) {
+    auto tile_group = manager.GetTileGroup(entry->first);
+
+    // the table may have been dropped in the meantime
+    if (tile_group == nullptr) {
+      entry = compacting_tile_groups_.erase(entry);
+      continue;
+    }
+
+    // a transaction that took a recycled slot of the tile group before it
+    // became immutable may still fill it, until its epoch has expired. once
+    // the moved versions are reclaimed as well, the tile group is empty.
+    if (entry->second <= expired_eid &&
+        CountUsedSlots(tile_group->GetHeader()) == 0) {
+      storage::DataTable *table =
+          dynamic_cast<storage::DataTable *>(tile_group->GetAbstractTable());
+      PL_ASSERT(table != nullptr);
+      table->ReleaseTileGroup(entry->first);
+      LOG_TRACE("Released tile group %u", entry->first);
+
+      compacted_count++;
+      entry = compacting_tile_groups_.erase(entry);
+      continue;
+    }
+
+    compacted_count += MoveTuples(tile_group.get());
+    ++entry;
+  }
+
+  return compacted_count;
+}
+
+int TransactionLevelGCManager::MoveTuples(storage::TileGroup *tile_group) {
+  int moved_count = 0;
+  auto &manager = catalog::Manager::GetInstance();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  storage::DataTable *table =
+      dynamic_cast<storage::DataTable *>(tile_group->GetAbstractTable());
+  PL_ASSERT(table != nullptr);
+
+  oid_t tile_group_id = tile_group->GetTileGroupId();
+  auto tile_group_header = tile_group->GetHeader();
+  oid_t column_count = tile_group->GetColumnMap().size();
+  oid_t tuple_count = tile_group_header->GetCurrentNextTupleSlot();
+
+  auto txn = txn_manager.BeginTransaction();
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    // only the latest version of a tuple is moved. tuples that are being
+    // modified by other transactions are moved in a later round.
+    if (txn_manager.IsVisible(txn, tile_group_header, tuple_id) !=
+            VisibilityType::OK ||
+        txn_manager.IsOwnable(txn, tile_group_header, tuple_id) == false ||
+        txn_manager.AcquireOwnership(txn, tile_group_header, tuple_id) ==
+            false) {
+      continue;
+    }
+
+    ItemPointer new_location = table->AcquireVersion();
+    if (new_location.IsNull() == true) {
+      txn_manager.YieldOwnership(txn, tile_group_header, tuple_id);
+      break;
+    }
+
+    // the move is an update that leaves the tuple as it is. the indexes
+    // reach the new version through the indirection of the old one.
+    auto new_tile_group = manager.GetTileGroup(new_location.block);
+    for (oid_t column_id = 0; column_id < column_count; column_id++) {
+      auto value = tile_group->GetValue(tuple_id, column_id);
+      new_tile_group->SetValue(value, new_location.offset, column_id);
+    }
+    txn_manager.PerformUpdate(txn, ItemPointer(tile_group_id, tuple_id),
+                              new_location);
+    moved_count++;
+  }
+  txn_manager.CommitTransaction(txn);
+
+  LOG_TRACE("Moved %d tuples out of tile group %u", moved_count,
+            tile_group_id);
+  return moved_count;
+}
+
 // this function returns a free tuple slot, if one exists
 // called by data_table.
 ItemPointer TransactionLevelGCManager::ReturnFreeSlot(const oid_t &table_id) {
@@ -408,5 +747,101 @@ void TransactionLevelGCManager::UnlinkVersion(const ItemPointer location,
   }
 }
 
+// executed by a single thread. so no synchronization is required.
+int TransactionLevelGCManager::Evict(const eid_t &expired_eid) {
+  FreeRetiredTileData(expired_eid);
+  if (cold_candidates_.empty()) {
+    return 0;
+  }
+
+  // the access marks are cleared on every sweep, so a tile group must go
+  // unaccessed for a few sweeps before it is evicted
+  auto threshold = std::chrono::milliseconds(settings::SettingsManager::GetInt(
+      settings::SettingId::cold_storage_threshold));
+  auto now = std::chrono::steady_clock::now();
+  if (now - last_cold_sweep_ < threshold / 4) {
+    return 0;
+  }
+  last_cold_sweep_ = now;
+
+  int evicted_count = 0;
+  auto &manager = catalog::Manager::GetInstance();
+  for (auto entry = cold_candidates_.begin();
+       entry != cold_candidates_.end();) {
+    auto tile_group = manager.GetTileGroup(entry->first);
+
+    // tile groups that were thawed are registered again once they are frozen
+    if (tile_group == nullptr ||
+        tile_group->GetHeader()->IsAllVisible() == false) {
+      entry = cold_candidates_.erase(entry);
+      continue;
+    }
+
+    if (tile_group->GetHeader()->ClearAccessed() == true) {
+      entry->second = now;
+      ++entry;
+      continue;
+    }
+    if (now - entry->second < threshold) {
+      ++entry;
+      continue;
+    }
+
+    if (EvictTileGroup(tile_group.get()) == true) {
+      evicted_count++;
+    }
+    entry = cold_candidates_.erase(entry);
+  }
+
+  LOG_TRACE("Evicted %d tile groups", evicted_count);
+  return evicted_count;
+}
+
+bool TransactionLevelGCManager::EvictTileGroup(
+    storage::TileGroup *tile_group) {
+  auto tile_group_header = tile_group->GetHeader();
+
+  // tuple data is only written when a slot is reused, and the slots of
+  // immutable tile groups are never reused. an all-visible tile group has no
+  // recycled slots, so once it is immutable its data cannot change while it
+  // is copied, even if a transaction thaws it.
+  bool set_immutable = tile_group_header->SetImmutability();
+  if (tile_group_header->BeginRelocate() == false) {
+    if (set_immutable == true) {
+      tile_group_header->ResetImmutability();
+    }
+    return false;
+  }
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  eid_t current_eid = epoch_manager.GetCurrentEpochId();
+  bool evicted = false;
+  for (oid_t tile_itr = 0; tile_itr < tile_group->GetTileCount(); tile_itr++) {
+    char *heap_data = tile_group->GetTile(tile_itr)->Evict();
+    if (heap_data == nullptr) {
+      continue;
+    }
+    retired_tile_data_.emplace_back(current_eid, heap_data);
+    evicted = true;
+  }
+
+  tile_group_header->AbortRelocate();
+  if (set_immutable == true) {
+    tile_group_header->ResetImmutability();
+  }
+  LOG_TRACE("Evicted tile group %u", tile_group->GetTileGroupId());
+  return evicted;
+}
+
+// executed by a single thread. so no synchronization is required.
+void TransactionLevelGCManager::FreeRetiredTileData(const eid_t &expired_eid) {
+  // the list is ordered by epoch
+  while (retired_tile_data_.empty() == false &&
+         retired_tile_data_.front().first <= expired_eid) {
+    delete[] retired_tile_data_.front().second;
+    retired_tile_data_.pop_front();
+  }
+}
+
 }  // namespace gc
 }  // namespace peloton
@@ -21,6 +21,7 @@
 // 4: deletes
 // 5: inserts
 // 6: time_stamp
+// 7: memory_bytes
 //
 // Indexes: (index offset: indexed columns)
 // 0: index_oid (unique & primary key)
@@ -50,7 +51,8 @@ class IndexMetricsCatalog : public AbstractCatalog {
   //===--------------------------------------------------------------------===//
   bool InsertIndexMetrics(oid_t database_oid, oid_t table_oid, oid_t index_oid,
                           int64_t reads, int64_t deletes, int64_t inserts,
-                          int64_t time_stamp, type::AbstractPool *pool,
+                          int64_t time_stamp, int64_t memory_bytes,
+                          type::AbstractPool *pool,
                           concurrency::TransactionContext *txn);
   bool DeleteIndexMetrics(oid_t index_oid, concurrency::TransactionContext *txn);
 
@@ -70,6 +72,7 @@ class IndexMetricsCatalog : public AbstractCatalog {
     DELETES = 4,
     INSERTS = 5,
     TIME_STAMP = 6,
+    MEMORY_BYTES = 7,
     // Add new columns here in creation order
   };
 
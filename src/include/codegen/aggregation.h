@@ -83,6 +83,37 @@ class Aggregation {
   void FinalizeValues(CodeGen &codegen, llvm::Value *space,
                       std::vector<codegen::Value> &final_vals) const;
 
+  //===--------------------------------------------------------------------===//
+  // Partial values
+  //
+  // Global aggregates over a batch of rows can be advanced in registers
+  // rather than in the storage space, and merged into the storage space once
+  // per batch. Callers may keep several independent sets of partial values,
+  // e.g., one per lane of an unrolled loop, and combine them at the end.
+  //===--------------------------------------------------------------------===//
+
+  // Can all aggregates be computed through partial values?
+  bool SupportsPartialValues() const;
+
+  // Create the partial values of an empty set of rows
+  void CreateInitialPartialValues(CodeGen &codegen,
+                                  std::vector<llvm::Value *> &partials) const;
+
+  // Advance the partial values using the values of the next row
+  void AdvancePartialValues(CodeGen &codegen,
+                            std::vector<llvm::Value *> &partials,
+                            const std::vector<codegen::Value> &next) const;
+
+  // Combine the other partial values into the provided ones
+  void CombinePartialValues(CodeGen &codegen,
+                            std::vector<llvm::Value *> &partials,
+                            const std::vector<llvm::Value *> &other) const;
+
+  // Merge the partial values into the aggregates stored in the provided
+  // storage space
+  void MergePartialValues(CodeGen &codegen, llvm::Value *space,
+                          const std::vector<llvm::Value *> &partials) const;
+
   // Get the total number of bytes needed to store all the aggregates this is
   // configured to store
   uint32_t GetAggregatesStorageSize() const {
@@ -150,6 +181,12 @@ class Aggregation {
   void DoAdvanceValue(CodeGen &codegen, llvm::Value *space, ExpressionType type,
                       uint32_t storage_index, const codegen::Value &next) const;
 
+  // Advance the partial value (and its validity flag) of a SUM, MIN or MAX
+  // component. NULL updates are skipped.
+  void AdvancePartialValue(CodeGen &codegen, ExpressionType type,
+                           uint32_t storage_index, const codegen::Value &update,
+                           llvm::Value *&value, llvm::Value *&valid) const;
+
   // Advancethe value of a specifig aggregate. Performs NULL check if necessary
   // and finally calls DoAdvanceValue()
   void AdvanceValue(CodeGen &codegen, llvm::Value *space,
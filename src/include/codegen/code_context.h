@@ -73,6 +73,15 @@ class CodeContext {
   // Sets UDF function ptr
   void SetUDF(llvm::Function *func_ptr) { udf_func_ptr_ = func_ptr; }
 
+  /// Keep a bitcode copy of the module, so that the functions in this context
+  /// can later be linked into other contexts
+  void SaveBitcode();
+
+  /// Link the definition of a function from another context into this one,
+  /// so that it is inlined into its callers here. Returns the function in this
+  /// context's module, or NULL if it could not be linked.
+  llvm::Function *LinkFunction(const CodeContext &other, llvm::Function *func);
+
   /// Compile all the code contained in this context
   bool Compile();
 
@@ -164,6 +173,12 @@ class CodeContext {
 
   std::unordered_map<std::string, FuncPtr> function_symbols_;
 
+  // The module's bitcode, saved by SaveBitcode()
+  std::string bitcode_;
+
+  // The functions linked in from other contexts, until they're inlined
+  std::vector<llvm::Function *> linked_functions_;
+
  private:
   // This class cannot be copy or move-constructed
   DISALLOW_COPY_AND_MOVE(CodeContext);
@@ -44,6 +44,9 @@ class GlobalGroupByTranslator : public OperatorTranslator {
   // Produce!
   void Produce() const override;
 
+  // Consume a batch, keeping the aggregates in registers where possible
+  void Consume(ConsumerContext &context, RowBatch &batch) const override;
+
   // Consume!
   void Consume(ConsumerContext &context, RowBatch::Row &row) const override;
 
@@ -52,6 +55,11 @@ class GlobalGroupByTranslator : public OperatorTranslator {
 
   std::string GetName() const override;
 
+ private:
+  // Derive the values the aggregates are advanced with from the given row
+  void DeriveAggregateValues(RowBatch::Row &row,
+                             std::vector<codegen::Value> &vals) const;
+
  private:
   //===--------------------------------------------------------------------===//
   // An accessor into a single tuple stored in buffered state
@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// merge_join_translator.h
+//
+// Identification: src/include/codegen/operator/merge_join_translator.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/operator/operator_translator.h"
+#include "codegen/pipeline.h"
+#include "codegen/sorter.h"
+
+namespace peloton {
+
+namespace planner {
+class MergeJoinPlan;
+}  // namespace planner
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// The translator for an inner merge join. Both inputs arrive sorted ascending
+// on their join keys. The left input is buffered in a Sorter instance, without
+// sorting it. Every right tuple then moves a cursor over the buffer past the
+// left tuples with smaller keys, and joins with the run of left tuples with
+// equal keys that follows. The cursor never moves back, so the join is a
+// single pass over both inputs.
+//===----------------------------------------------------------------------===//
+class MergeJoinTranslator : public OperatorTranslator {
+ public:
+  MergeJoinTranslator(const planner::MergeJoinPlan &join_plan,
+                      CompilationContext &context, Pipeline &pipeline);
+
+  void InitializeState() override;
+
+  // No helper functions
+  void DefineAuxiliaryFunctions() override {}
+
+  void TearDownState() override;
+
+  std::string GetName() const override;
+
+  void Produce() const override;
+
+  void Consume(ConsumerContext &context, RowBatch::Row &row) const override;
+
+ private:
+  bool IsFromLeftChild(const Pipeline &pipeline) const;
+
+  void ConsumeFromLeft(ConsumerContext &context, RowBatch::Row &row) const;
+  void ConsumeFromRight(ConsumerContext &context, RowBatch::Row &row) const;
+
+  // Compare the keys of a buffered left tuple with the given right keys,
+  // returning a negative, zero or positive i32 like a sort comparison
+  llvm::Value *CompareKeys(Sorter::SorterAccess::Row &left_row,
+                           const std::vector<codegen::Value> &right_keys) const;
+
+  const planner::MergeJoinPlan &GetPlan() const { return join_plan_; }
+
+ private:
+  // The plan
+  const planner::MergeJoinPlan &join_plan_;
+
+  // The pipeline for the left subtree of the plan
+  Pipeline left_pipeline_;
+
+  // The expressions producing the keys of each side
+  std::vector<const expression::AbstractExpression *> left_key_exprs_;
+  std::vector<const expression::AbstractExpression *> right_key_exprs_;
+
+  // All the attributes from the left input that are materialized, stored
+  // after the left keys
+  std::vector<const planner::AttributeInfo *> unique_left_attributes_;
+
+  // The buffer of left input tuples, kept in the order they arrive in
+  RuntimeState::StateID buffer_id_;
+  Sorter buffer_;
+
+  // The position in the buffer of the first left tuple whose key isn't
+  // smaller than the keys of the last right tuple
+  RuntimeState::StateID cursor_id_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// sorted_group_by_translator.h
+//
+// Identification: src/include/codegen/operator/sorted_group_by_translator.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/aggregation.h"
+#include "codegen/operator/operator_translator.h"
+#include "codegen/pipeline.h"
+#include "codegen/updateable_storage.h"
+
+namespace peloton {
+
+namespace planner {
+class AggregatePlan;
+}  // namespace planner
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// A sorted group-by aggregates an input that arrives ordered on the grouping
+// keys. Only the group being aggregated is kept, in the runtime state. When a
+// row with different keys arrives, the group is finished and sent to the parent
+// right away, so no hash table is built and groups stream out as the input is
+// consumed.
+//===----------------------------------------------------------------------===//
+class SortedGroupByTranslator : public OperatorTranslator {
+ public:
+  // Constructor
+  SortedGroupByTranslator(const planner::AggregatePlan &plan,
+                          CompilationContext &context, Pipeline &pipeline);
+
+  // Codegen any initialization work for this operator
+  void InitializeState() override;
+
+  // No helper functions
+  void DefineAuxiliaryFunctions() override {}
+
+  // Produce!
+  void Produce() const override;
+
+  // Consume!
+  void Consume(ConsumerContext &context, RowBatch::Row &row) const override;
+
+  // Cleanup by destroying the aggregation hash tables of distinct aggregates
+  void TearDownState() override;
+
+  std::string GetName() const override;
+
+ private:
+  // Does the given row belong to the group being aggregated?
+  llvm::Value *IsSameGroup(const std::vector<codegen::Value> &keys) const;
+
+  // Finalize the group being aggregated and send it to the parent
+  void ProduceGroup() const;
+
+ private:
+  //===--------------------------------------------------------------------===//
+  // An accessor into a single value of the finished group
+  //===--------------------------------------------------------------------===//
+  class BufferAttributeAccess : public RowBatch::AttributeAccess {
+   public:
+    // Constructor
+    BufferAttributeAccess(const std::vector<codegen::Value> &group_vals,
+                          uint32_t index)
+        : group_vals_(group_vals), index_(index) {}
+
+    Value Access(CodeGen &, RowBatch::Row &) override {
+      return group_vals_[index_];
+    }
+
+   private:
+    // The grouping keys followed by the aggregates
+    const std::vector<codegen::Value> &group_vals_;
+
+    // The value this accessor is for
+    uint32_t index_;
+  };
+
+ private:
+  // The aggregation plan
+  const planner::AggregatePlan &plan_;
+
+  // The pipeline the child operator of this aggregation belongs to
+  Pipeline child_pipeline_;
+
+  // The class responsible for handling the aggregation for all our aggregates
+  Aggregation aggregation_;
+
+  // The storage format of the grouping keys of the current group
+  UpdateableStorage key_storage_;
+
+  // The IDs of the grouping keys and of the aggregates of the current group,
+  // and of the flag telling whether there is a current group, in the runtime
+  // state
+  RuntimeState::StateID group_keys_id_;
+  RuntimeState::StateID agg_buffer_id_;
+  RuntimeState::StateID has_group_id_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -122,10 +122,51 @@ class TableScanTranslator : public OperatorTranslator {
                                llvm::Value *tid_start, llvm::Value *tid_end,
                                Vector &selection_vector) const;
 
-    llvm::Value *SIMDFilterRows(RowBatch &batch,
-                                const TileGroup::TileGroupAccess &access) const;
+    // Evaluate the predicate one row at a time over the rows in the selection
+    // vector. This works for any predicate and any tile group layout.
+    void ScalarFilterRows(CodeGen &codegen,
+                          const TileGroup::TileGroupAccess &access,
+                          llvm::Value *tid_start, llvm::Value *tid_end,
+                          Vector &selection_vector) const;
+
+    // Evaluate the predicate over contiguous runs of column values using
+    // vector instructions, then compact the selection vector with the result.
+    // Only valid if all columns the predicate touches are stored columnar.
+    void SIMDFilterRows(CodeGen &codegen,
+                        const TileGroup::TileGroupAccess &access,
+                        llvm::Value *tid_start, llvm::Value *tid_end,
+                        Vector &selection_vector) const;
+
+    // Can the given predicate be evaluated by SIMDFilterRows()? This is true
+    // for conjunctions of comparisons between fixed-width numeric columns and
+    // constants/parameters.
+    bool IsSIMDEvaluable(const expression::AbstractExpression &expr) const;
+
+    // Determine the SQL type of an operand of a SIMD comparison. Returns false
+    // if the expression isn't a column, constant or parameter.
+    bool GetSIMDOperandType(const expression::AbstractExpression &expr,
+                            peloton::type::TypeId &type_id) const;
+
+    // Compute a <lanes x i1> mask of the rows [tid, tid + lanes) that satisfy
+    // the given (SIMD-evaluable) expression
+    llvm::Value *DeriveSIMDMask(CodeGen &codegen,
+                                const TileGroup::TileGroupAccess &access,
+                                const expression::AbstractExpression &expr,
+                                llvm::Value *tid, uint32_t lanes) const;
+
+    // Load (or broadcast) the values of a comparison operand for the rows
+    // [tid, tid + lanes). The validity mask is null if the operand can't be
+    // NULL.
+    void LoadSIMDOperand(CodeGen &codegen,
+                         const TileGroup::TileGroupAccess &access,
+                         const expression::AbstractExpression &expr,
+                         llvm::Value *tid, uint32_t lanes, llvm::Value *&vals,
+                         llvm::Value *&not_null) const;
 
    private:
+    // The number of rows the SIMD filter evaluates per vector
+    static constexpr uint32_t kSIMDLanes = 16;
+
     // The translator instance the consumer is generating code for
     const TableScanTranslator &translator_;
 
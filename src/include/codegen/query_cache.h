@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <list>
 
 #include "codegen/query.h"
@@ -53,6 +54,10 @@ class QueryCache : public Singleton<QueryCache> {
   // Get the total capacity of the cache, i.e. max. no. of queries to be cached
   size_t GetCapacity() const { return capacity_; }
 
+  // Get the number of lookups that found (or missed) a cached query
+  uint64_t GetHitCount() const { return hit_count_.load(); }
+  uint64_t GetMissCount() const { return miss_count_.load(); }
+
   // Set the total capacity of the cache
   void SetCapacity(size_t capacity) { Resize(capacity); }
 
@@ -78,6 +83,9 @@ class QueryCache : public Singleton<QueryCache> {
   common::synchronization::ReadWriteLatch cache_lock_;
 
   size_t capacity_ = 0;
+
+  std::atomic<uint64_t> hit_count_{0};
+  std::atomic<uint64_t> miss_count_{0};
 };
 
 }  // namespace codegen
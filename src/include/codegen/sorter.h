@@ -125,6 +125,11 @@ class Sorter {
   llvm::Value *GetNumberOfStoredTuples(CodeGen &codegen,
                                        llvm::Value *sorter_ptr) const;
 
+  // The position of the first stored tuple, to access the tuples through a
+  // SorterAccess. Appending tuples may move them.
+  llvm::Value *GetStartPosition(CodeGen &codegen,
+                                llvm::Value *sorter_ptr) const;
+
  private:
   //===--------------------------------------------------------------------===//
   // ACCESSORS
@@ -132,8 +137,6 @@ class Sorter {
   //       to something like: codegen.LoadMember<SorterProxy::start_pos>(...)
   //===--------------------------------------------------------------------===//
 
-  llvm::Value *GetStartPosition(CodeGen &codegen,
-                                llvm::Value *sorter_ptr) const;
   llvm::Value *GetTupleSize(CodeGen &codegen) const;
 
  private:
@@ -70,6 +70,9 @@ class UpdateableStorage {
     return static_cast<uint32_t>(schema_.size());
   }
 
+  // Return the type of the element with the provided index
+  const type::Type &GetType(uint32_t index) const { return schema_[index]; }
+
  public:
   // Convenience class to handle NULL bitmaps.
   class NullBitmap {
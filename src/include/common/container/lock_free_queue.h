@@ -38,6 +38,10 @@ class LockFreeQueue {
 
   bool IsEmpty() { return queue_.size_approx() == 0; }
 
+  // Number of items in the queue, which may be off while other threads
+  // enqueue or dequeue
+  size_t GetSizeApprox() { return queue_.size_approx(); }
+
  private:
   // Underlying moodycamel's concurrent queue
   moodycamel::ConcurrentQueue<T> queue_;
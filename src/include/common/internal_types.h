@@ -803,7 +803,8 @@ enum class CopyType {
   IMPORT_TSV,                 // Import tsv data to database
   EXPORT_CSV,                 // Export data to csv file
   EXPORT_STDOUT,              // Export data to std out
-  EXPORT_OTHER                // Export data to other file format
+  EXPORT_OTHER,               // Export data to other file format
+  EXPORT_BINARY               // Export data to binary file
 };
 std::string CopyTypeToString(CopyType type);
 CopyType StringToCopyType(const std::string &str);
@@ -1328,11 +1329,13 @@ enum class RuleType : uint32_t {
   INSERT_TO_PHYSICAL,
   INSERT_SELECT_TO_PHYSICAL,
   AGGREGATE_TO_HASH_AGGREGATE,
+  AGGREGATE_TO_SORT_AGGREGATE,
   AGGREGATE_TO_PLAIN_AGGREGATE,
   JOIN_TO_NL_JOIN,
   JOIN_TO_HASH_JOIN,
   INNER_JOIN_TO_NL_JOIN,
   INNER_JOIN_TO_HASH_JOIN,
+  INNER_JOIN_TO_MERGE_JOIN,
   IMPLEMENT_DISTINCT,
   IMPLEMENT_LIMIT,
 
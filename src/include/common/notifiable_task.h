@@ -62,6 +62,12 @@ class NotifiableTask {
    */
   inline int Id() const { return task_id_; }
 
+  /**
+   * @return the event base this task's events are registered to, for use by
+   * libevent facilities that manage their own events (e.g. evhttp)
+   */
+  inline struct event_base *GetEventBase() const { return base_; }
+
   /**
    * @brief Register an event with the event base associated with this
    * notifiable task.
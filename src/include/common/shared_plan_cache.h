@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// shared_plan_cache.h
+//
+// Identification: src/include/common/shared_plan_cache.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/statement.h"
+#include "type/value.h"
+
+namespace peloton {
+
+//===--------------------------------------------------------------------===//
+// Shared Plan Cache
+//
+// Keeps the planned statements of parameterized simple queries, so that
+// connections sending the same query with different literals skip parsing,
+// binding and optimization.
+//
+// Parameter values are bound to a plan in place, so a statement is only used
+// by one connection at a time: Acquire() takes an idle statement out of the
+// cache and Release() hands it back once the query finished. A query running
+// on n connections at once ends up with n statements in the cache.
+//
+// Prepared statements of the extended protocol are shared the same way: a
+// connection only keeps the name, parameter types and tuple descriptor of a
+// statement, and leases a plan from the cache for each portal it binds.
+//
+// Queries are evicted in LRU order, and their statements are dropped when a
+// table they reference is invalidated through the StatementCacheManager.
+//===--------------------------------------------------------------------===//
+
+class SharedPlanCache {
+ public:
+  // Global Singleton
+  static SharedPlanCache &GetInstance();
+
+  // Build the key of a parameterized query bound to the given values. Table
+  // names are resolved in the database, so it is part of the key.
+  static std::string GetKey(const std::string &database_name,
+                            const std::string &query_string,
+                            const std::vector<type::Value> &params);
+
+  // Build the key of a query prepared with the given parameter type oids
+  static std::string GetKey(const std::string &database_name,
+                            const std::string &query_string,
+                            const std::vector<int32_t> &param_types);
+
+  // Take an idle statement for the key out of the cache. Returns nullptr if
+  // there is none, and clears cacheable if the query was marked uncacheable.
+  // The version has to be passed back to Release().
+  std::shared_ptr<Statement> Acquire(const std::string &key, uint64_t &version,
+                                     bool &cacheable);
+
+  // Hand a statement back once it executed. It is dropped if any table was
+  // invalidated since the version was taken.
+  void Release(const std::string &key, std::shared_ptr<Statement> statement,
+               const uint64_t version);
+
+  // Wrap an acquired statement, so that it is released once the last copy of
+  // the returned pointer is gone
+  std::shared_ptr<Statement> Lease(const std::string &key,
+                                   std::shared_ptr<Statement> statement,
+                                   const uint64_t version);
+
+  // Remember that the query cannot be planned with parameters
+  void MarkUncacheable(const std::string &key);
+
+  // Remember that planning the query failed. It is reported as uncacheable
+  // until the next invalidation, since the failure may come from a table
+  // that did not exist yet. The version is the one Acquire() returned.
+  void MarkUnplannable(const std::string &key, const uint64_t version);
+
+  // Drop the statements that reference any of the tables
+  void InvalidateTableOids(const std::set<oid_t> &table_ids);
+
+  // Number of queries in the cache
+  size_t GetSize();
+
+  // Number of idle statements of the query
+  size_t GetStatementCount(const std::string &key);
+
+  void Clear();
+
+ private:
+  struct Entry {
+    bool cacheable = true;
+    // Set by MarkUnplannable(), cleared once the version moved on
+    bool unplannable = false;
+    uint64_t unplannable_version = 0;
+    std::vector<std::shared_ptr<Statement>> statements;
+    std::set<oid_t> tables;
+    std::list<std::string>::iterator lru_position;
+  };
+
+  SharedPlanCache() {}
+
+  // Find or create the entry of the key and move it to the front of the LRU
+  // list. Must hold the cache lock.
+  Entry &GetEntry(const std::string &key);
+
+  std::mutex cache_lock_;
+
+  std::unordered_map<std::string, Entry> entries_;
+
+  // Keys, most recently used first
+  std::list<std::string> lru_list_;
+
+  // Bumped by every invalidation and by every new table
+  uint64_t version_ = 0;
+};
+
+}  // namespace peloton
@@ -85,6 +85,14 @@ class Statement : public Printable {
 
   inline void SetNeedsReplan(bool replan) { needs_replan_ = replan; }
 
+  inline void SetSharedPlanKey(const std::string &key) {
+    shared_plan_key_ = key;
+  }
+
+  inline const std::string &GetSharedPlanKey() const {
+    return shared_plan_key_;
+  }
+
   // Get a string representation for debugging
   const std::string GetInfo() const;
 
@@ -121,5 +129,9 @@ class Statement : public Printable {
 
   // If this flag is true, then somebody wants us to replan this query
   bool needs_replan_ = false;
+
+  // Key of the SharedPlanCache entry this statement is bound through. Such a
+  // statement has neither a parse tree nor a plan of its own.
+  std::string shared_plan_key_;
 };
 }  // namespace peloton
@@ -19,8 +19,8 @@ namespace peloton {
 
 // TODO(Tianyi) remove this singleton
 class StatementCacheManager;
-// Singleton statement_cache_manager
-static std::shared_ptr<StatementCacheManager> statement_cache_manager;
+// Singleton statement_cache_manager, shared by every translation unit
+extern std::shared_ptr<StatementCacheManager> statement_cache_manager;
 
 /**
  * The manager that stores all the registered statement caches.
@@ -52,6 +52,7 @@ class StatementCacheManager {
    * connections coming in and old connection tearing down.
    * However, current connections can still retrieve updated plans from their
    * plan cache.
+   * Both also drop the affected plans of the SharedPlanCache.
    */
 
   /**
@@ -56,6 +56,7 @@ public:
     current_global_epoch_id_ = current_epoch_id;
     next_txn_id_ = 0;
     snapshot_global_epoch_id_ = 1;
+    last_expired_epoch_id_ = 0;
     local_epochs_.clear();
     
     RegisterThread(0);
@@ -121,6 +122,15 @@ public:
     return current_global_epoch_id_.load();
   }  
 
+  virtual eid_t GetEpochLag() override {
+    eid_t expired_eid = last_expired_epoch_id_.load(std::memory_order_relaxed);
+    eid_t current_eid = current_global_epoch_id_.load();
+    if (expired_eid == 0 || expired_eid > current_eid) {
+      return 0;
+    }
+    return current_eid - expired_eid;
+  }
+
 private:
 
 
@@ -155,6 +165,10 @@ private:
   // visible to on-the-fly transactions
   eid_t snapshot_global_epoch_id_;
 
+  // the epoch returned by the last call to GetExpiredEpochId(), 0 if none
+  // has expired yet
+  std::atomic<eid_t> last_expired_epoch_id_{0};
+
   bool is_running_;
 
 };
@@ -59,6 +59,10 @@ public:
 
   virtual cid_t GetExpiredCid() = 0;
 
+  // Number of epochs between the current epoch and the last epoch found
+  // expired, i.e. how far behind garbage collection is
+  virtual eid_t GetEpochLag() { return 0; }
+
 };
 
 }
@@ -83,6 +83,11 @@ class TimestampOrderingTransactionManager : public TransactionManager {
                            const ItemPointer &location,
                            bool acquire_ownership = false);
 
+  virtual bool PerformAllVisibleRead(
+      TransactionContext *const current_txn,
+      const storage::TileGroupHeader *const tile_group_header,
+      bool acquire_ownership = false);
+
   virtual void PerformUpdate(TransactionContext *const current_txn,
                              const ItemPointer &old_location,
                              const ItemPointer &new_location);
@@ -65,6 +65,15 @@ class TransactionManager {
       const oid_t &tuple_id,
       const VisibilityIdType type = VisibilityIdType::READ_ID);
 
+  // This method checks the visibility of the tuples in [tid_start, tid_end)
+  // for reads, storing the ids of the visible ones in the selection vector.
+  // It returns the number of visible tuples.
+  uint32_t FilterVisible(
+      TransactionContext *const current_txn,
+      const storage::TileGroupHeader *const tile_group_header,
+      const oid_t &tid_start, const oid_t &tid_end,
+      uint32_t *selection_vector);
+
   // This method test whether the current transaction is the owner of this version.
   virtual bool IsOwner(
       TransactionContext *const current_txn,
@@ -112,6 +121,16 @@ class TransactionManager {
                            const ItemPointer &location,
                            bool acquire_ownership = false) = 0;
 
+  // This method reads every tuple in an all-visible tile group at once,
+  // skipping the per-tuple visibility checks and read set. It returns false if
+  // the caller must fall back to IsVisible() and PerformRead() on each tuple.
+  // The caller may read only part of the tile group, so it also counts the
+  // tuples it reads in the table read stats.
+  virtual bool PerformAllVisibleRead(
+      TransactionContext *const current_txn,
+      const storage::TileGroupHeader *const tile_group_header,
+      bool acquire_ownership = false) = 0;
+
   virtual void PerformUpdate(TransactionContext *const current_txn,
                              const ItemPointer &old_location,
                              const ItemPointer &new_location) = 0;
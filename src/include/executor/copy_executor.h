@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>
+
 #include "executor/abstract_executor.h"
 #include "catalog/query_metrics_catalog.h"
 
@@ -19,6 +22,15 @@
 #define INVALID_COL_ID -1
 
 namespace peloton {
+
+namespace planner {
+class CopyPlan;
+}
+
+namespace storage {
+class Tile;
+}
+
 namespace executor {
 
 class CopyExecutor : public AbstractExecutor {
@@ -35,6 +47,18 @@ class CopyExecutor : public AbstractExecutor {
 
   inline size_t GetTotalBytesWritten() { return total_bytes_written; }
 
+  // Smallest part of an imported file worth loading on its own thread
+  static constexpr size_t kMinImportBytesPerWorker = 1 << 20;
+
+  // Fewest tile groups worth exporting on their own thread
+  static constexpr size_t kMinExportTileGroupsPerWorker = 4;
+
+  // Size of the output buffer of each export thread
+  static constexpr size_t kExportBufferSize = 4 << 20;
+
+  // Leading bytes of a binary export
+  static constexpr const char *kBinaryExportMagic = "PLCOPY1\n";
+
  protected:
   bool DInit();
 
@@ -53,6 +77,95 @@ class CopyExecutor : public AbstractExecutor {
   // Copy and escape the content of column to local buffer
   void Copy(const char *data, int len, bool end_of_line);
 
+  //===--------------------------------------------------------------------===//
+  // Import
+  //===--------------------------------------------------------------------===//
+
+  // The tuples one import worker inserted, with their index entries
+  struct ImportResult {
+    std::vector<std::pair<ItemPointer, ItemPointer *>> tuples;
+    std::vector<oid_t> tile_group_ids;
+    std::string error_message;
+  };
+
+  // Load the whole file into the target table
+  bool ExecuteImport(const planner::CopyPlan &node);
+
+  // Load the records in [begin, end) into tile groups of their own. Stops
+  // early once any worker has failed.
+  void ImportRecords(const planner::CopyPlan &node, const char *begin,
+                     const char *end, ImportResult &result,
+                     std::atomic<bool> &failed);
+
+  // Split the record starting at pos into fields, move pos past its end and
+  // return the number of fields. A field is null if it is \N in the text
+  // format, or empty and unquoted in CSV.
+  size_t ParseRecord(const planner::CopyPlan &node, const char *&pos,
+                     const char *end, std::vector<std::string> &fields,
+                     std::vector<bool> &nulls);
+
+  // Convert a field to a value of the column's type
+  static type::Value ParseValue(const std::string &field, bool is_null,
+                                type::TypeId type_id);
+
+  //===--------------------------------------------------------------------===//
+  // Export
+  //===--------------------------------------------------------------------===//
+
+  // Output buffer of one export thread. Full buffers are written to the file
+  // at offsets the threads reserve, so rows end up in no particular order.
+  struct ExportBuffer {
+    std::vector<char> data;
+    size_t size = 0;
+  };
+
+  // Where a column of the tile group being exported lives
+  struct ExportColumn {
+    const storage::Tile *tile;
+    size_t offset;
+    type::TypeId type_id;
+    bool is_inlined;
+  };
+
+  // What went wrong in one export thread
+  struct ExportResult {
+    std::string error_message;
+  };
+
+  // Write the visible tuples of the target table to the file, formatting
+  // them straight from tile group memory on several threads
+  bool ExecuteExport(const planner::CopyPlan &node);
+
+  // Export tile groups, taking the next one from next_tile_group until none
+  // are left
+  void ExportTileGroups(const planner::CopyPlan &node,
+                        std::atomic<oid_t> &next_tile_group,
+                        ExportResult &result);
+
+  // Append a field and the delimiter or line break that follows it, in the
+  // text or CSV format that ParseRecord() reads. Nulls are \N in the text
+  // format and empty in CSV.
+  void FormatTextField(const ExportColumn &column, const char *tuple_location,
+                       char field_delimiter, bool csv, bool end_of_line,
+                       ExportBuffer &buffer);
+
+  // Append text with backslash escapes, or quoted if needed in CSV
+  void AppendEscapedText(const char *data, size_t len, char field_delimiter,
+                         bool csv, ExportBuffer &buffer);
+
+  // Append a non-null field in the binary format
+  void FormatBinaryField(const ExportColumn &column, const char *field,
+                         ExportBuffer &buffer);
+
+  // Whether the field of the column holds null
+  static bool IsNullField(const ExportColumn &column, const char *field);
+
+  // Make room for size more bytes, writing the buffer out if it is full
+  char *ReserveExportBuffer(ExportBuffer &buffer, size_t size);
+
+  // Write the buffer at the next free offset of the file and empty it
+  void FlushExportBuffer(ExportBuffer &buffer);
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -81,6 +194,17 @@ class CopyExecutor : public AbstractExecutor {
   // Total number of bytes written
   size_t total_bytes_written = 0;
 
+  // End of the data the export threads have reserved in the file
+  std::atomic<size_t> export_file_offset{0};
+
+  // The transaction isn't thread-safe, so the export threads take turns
+  // registering their reads with it
+  std::mutex export_txn_lock;
+
+  // Set once the transaction failed to read a tuple, which stops the export
+  // threads
+  std::atomic<bool> export_read_failed{false};
+
   // The special column ids in query_metric table
   unsigned int num_param_col_id =
       catalog::QueryMetricsCatalog::ColumnId::NUM_PARAMS;
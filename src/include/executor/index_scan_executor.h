@@ -49,6 +49,17 @@ class IndexScanExecutor : public AbstractScanExecutor {
 
   void ResetState();
 
+  // Look up the index for every probe of a join at once. Each entry of
+  // value_list holds the values of column_ids for one outer tuple. Returns
+  // false if the scan isn't a point lookup, in which case each probe has to
+  // be executed on its own.
+  bool PrepareBatchedLookups(
+      const std::vector<oid_t> &column_ids,
+      const std::vector<std::vector<type::Value>> &value_list);
+
+  // Answer the next execution with the results of the given batched probe
+  void SelectBatchedLookup(oid_t probe) { batched_probe_ = probe; }
+
  protected:
   bool DInit();
 
@@ -61,6 +72,9 @@ class IndexScanExecutor : public AbstractScanExecutor {
   bool ExecPrimaryIndexLookup();
   bool ExecSecondaryIndexLookup();
 
+  // Take the results of the selected batched probe, if there is one
+  bool TakeBatchedLookup(std::vector<ItemPointer *> &tuple_location_ptrs);
+
   // When the required scan range has open boundaries, the tuples found by the
   // index might not be exact since the index can only give back tuples in a
   // close range. This function prune the head and the tail of the returned
@@ -85,6 +99,12 @@ class IndexScanExecutor : public AbstractScanExecutor {
   /** @brief Computed the result */
   bool done_ = false;
 
+  /** @brief Index lookups performed ahead by PrepareBatchedLookups() */
+  std::vector<std::vector<ItemPointer *>> batched_results_;
+
+  /** @brief The batched probe answering the next execution */
+  oid_t batched_probe_ = INVALID_OID;
+
   //===--------------------------------------------------------------------===//
   // Plan Info
   //===--------------------------------------------------------------------===//
@@ -54,6 +54,10 @@ class NestedLoopJoinExecutor : public AbstractJoinExecutor {
   // return the combine result when there is a matched right tile. So next time,
   // we will begin from the point of last time, if left_tile_done is false
   bool left_tile_done_ = true;
+
+  // Whether the right child looked up the index for all rows of the current
+  // left tile at once
+  bool batched_lookups_ = false;
 };
 
 }  // namespace executor
@@ -55,6 +55,10 @@ class SeqScanExecutor : public AbstractScanExecutor {
   expression::AbstractExpression *ColumnValueToCmpExpr(
       const oid_t column_id, const type::Value &value);
 
+  // Check whether the predicate is an equality between a varlen column and a
+  // constant, which can be evaluated on deduplicated fields
+  void InitDedupPredicate();
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -81,6 +85,11 @@ class SeqScanExecutor : public AbstractScanExecutor {
   // The original predicate, if it's not nullptr
   // we need to combine it with the undated predicate 
   const expression::AbstractExpression *old_predicate_;
+
+  // Column and constant of a predicate that can be evaluated on deduplicated
+  // fields, or INVALID_OID
+  oid_t dedup_column_id_ = INVALID_OID;
+  type::Value dedup_value_;
 };
 
 }  // namespace executor
@@ -75,6 +75,14 @@ class GCManager {
 
   virtual size_t GetTableCount() { return 0; }
 
+  // Number of committed txns waiting for their versions to be unlinked
+  virtual size_t GetUnlinkQueueSize() { return 0; }
+
+  // Register a tile group that may have become all-visible (e.g., because it
+  // just filled up). The GC freezes it once its versions are old enough.
+  virtual void RegisterFreezeCandidate(
+      const oid_t &tile_group_id UNUSED_ATTRIBUTE) {}
+
   virtual void RecycleTransaction(
                       concurrency::TransactionContext *txn UNUSED_ATTRIBUTE) {}
 
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <list>
 #include <map>
 #include <thread>
@@ -24,6 +25,7 @@
 #include "concurrency/transaction_context.h"
 #include "gc/gc_manager.h"
 #include "common/internal_types.h"
+#include "storage/deduplicated_tile_group.h"
 
 #include "common/container/lock_free_queue.h"
 
@@ -45,6 +47,9 @@ class TransactionLevelGCManager : public GCManager {
       unlink_queues_.push_back(unlink_queue);
       local_unlink_queues_.emplace_back();
     }
+    freeze_queue_.reset(
+        new LockFreeQueue<std::pair<oid_t, eid_t>>(MAX_QUEUE_LENGTH));
+    compaction_queue_.reset(new LockFreeQueue<oid_t>(MAX_QUEUE_LENGTH));
   }
 
   virtual ~TransactionLevelGCManager() {}
@@ -67,6 +72,17 @@ class TransactionLevelGCManager : public GCManager {
     reclaim_maps_.resize(gc_thread_count_);
     recycle_queue_map_.clear();
 
+    freeze_queue_.reset(
+        new LockFreeQueue<std::pair<oid_t, eid_t>>(MAX_QUEUE_LENGTH));
+    local_freeze_queue_.clear();
+    FreeRetiredVarlens(MAX_EID);
+
+    compaction_queue_.reset(new LockFreeQueue<oid_t>(MAX_QUEUE_LENGTH));
+    compacting_tile_groups_.clear();
+
+    cold_candidates_.clear();
+    FreeRetiredTileData(MAX_EID);
+
     is_running_ = false;
   }
 
@@ -125,10 +141,34 @@ class TransactionLevelGCManager : public GCManager {
 
   virtual size_t GetTableCount() override { return recycle_queue_map_.size(); }
 
+  virtual size_t GetUnlinkQueueSize() override {
+    size_t size = 0;
+    for (auto &unlink_queue : unlink_queues_) {
+      size += unlink_queue->GetSizeApprox();
+    }
+    return size;
+  }
+
+  virtual void RegisterFreezeCandidate(const oid_t &tile_group_id) override;
+
   int Unlink(const int &thread_id, const eid_t &expired_eid);
 
   int Reclaim(const int &thread_id, const eid_t &expired_eid);
 
+  // Try to mark the registered tile groups as all-visible. Only the first GC
+  // thread calls this. Returns the number of tile groups frozen.
+  int Freeze(const eid_t &expired_eid);
+
+  // Move the tuples out of sparse tile groups, and release the tile groups
+  // once they are empty. Only the first GC thread calls this. Returns the
+  // number of tuples moved and tile groups released.
+  int Compact(const eid_t &expired_eid);
+
+  // Move the tuple data of all-visible tile groups that have not been
+  // accessed for a while to cold storage. Only the first GC thread calls
+  // this. Returns the number of tile groups evicted.
+  int Evict(const eid_t &expired_eid);
+
  private:
   inline unsigned int HashToThread(const size_t &thread_id) {
     return (unsigned int)thread_id % gc_thread_count_;
@@ -156,6 +196,34 @@ class TransactionLevelGCManager : public GCManager {
   // this function unlinks a specified version from the index.
   void UnlinkVersion(const ItemPointer location, const GCVersionType type);
 
+  enum class FreezeResult { FROZEN, RETRY, SKIP };
+
+  // Whether tile groups are frozen at all
+  static bool IsFreezingEnabled();
+
+  // Freeze the tile group if every version in it is visible to all active and
+  // future transactions. RETRY means the tile group is worth checking again
+  // once the currently active transactions have finished.
+  FreezeResult FreezeTileGroup(const oid_t &tile_group_id,
+                               const cid_t &expired_cid);
+
+  // Deduplicate the varlen columns of a tile group that was just frozen
+  void DeduplicateTileGroup(storage::TileGroup *tile_group);
+
+  // Free the varlen allocations retired in epochs up to expired_eid
+  void FreeRetiredVarlens(const eid_t &expired_eid);
+
+  // Move the live tuples of a tile group being compacted into other tile
+  // groups. Returns the number of tuples moved.
+  int MoveTuples(storage::TileGroup *tile_group);
+
+  // Move the tuple data of an all-visible tile group to cold storage
+  bool EvictTileGroup(storage::TileGroup *tile_group);
+
+  // Free the tile data replaced by cold storage mappings in epochs up to
+  // expired_eid
+  void FreeRetiredTileData(const eid_t &expired_eid);
+
  private:
   //===--------------------------------------------------------------------===//
   // Data members
@@ -186,6 +254,44 @@ class TransactionLevelGCManager : public GCManager {
   std::unordered_map<oid_t,
                      std::shared_ptr<peloton::LockFreeQueue<ItemPointer>>>
       recycle_queue_map_;
+
+  // queue for tile groups that may be frozen, along with the epoch in which
+  // they were registered. A tile group is only checked once that epoch has
+  // expired, i.e., once the transactions that wrote it have finished. The
+  // freeze-queued flag of the tile group header keeps it from being queued
+  // more than once.
+  std::unique_ptr<peloton::LockFreeQueue<std::pair<oid_t, eid_t>>>
+      freeze_queue_;
+
+  // tile groups that could not be frozen yet. only touched by the first GC
+  // thread.
+  std::list<std::pair<oid_t, eid_t>> local_freeze_queue_;
+
+  // varlen allocations that deduplication made unreachable, along with the
+  // epoch in which they were retired. readers may still hold them until that
+  // epoch has expired. only touched by the first GC thread.
+  std::list<std::pair<eid_t, storage::DeduplicatedTileGroup::RetiredVarlen>>
+      retired_varlens_;
+
+  // queue for tile groups whose tuples were reclaimed, and which may have
+  // become sparse
+  std::unique_ptr<peloton::LockFreeQueue<oid_t>> compaction_queue_;
+
+  // tile groups being compacted, along with the epoch in which they stopped
+  // handing out recycled slots. only touched by the first GC thread.
+  std::unordered_map<oid_t, eid_t> compacting_tile_groups_;
+
+  // all-visible tile groups that may be evicted, along with the last time
+  // they were seen accessed. only touched by the first GC thread.
+  std::unordered_map<oid_t, std::chrono::steady_clock::time_point>
+      cold_candidates_;
+
+  // the last time the access marks of the candidates were checked
+  std::chrono::steady_clock::time_point last_cold_sweep_;
+
+  // tile data replaced by cold storage mappings, along with the epoch in
+  // which it was retired. only touched by the first GC thread.
+  std::list<std::pair<eid_t, char *>> retired_tile_data_;
 };
 }
 }  // namespace peloton
@@ -86,19 +86,33 @@ class ArtIndex : public Index {
   void ScanKey(const storage::Tuple *key,
                std::vector<ItemPointer *> &result) override;
 
+  void ScanKeys(const std::vector<const storage::Tuple *> &keys,
+                std::vector<std::vector<ItemPointer *>> &results) override;
+
   /// Return the index type
   std::string GetTypeName() const override {
     return IndexTypeToString(GetIndexMethodType());
   }
 
-  // TODO(pmenon): Implement me
-  size_t GetMemoryFootprint() override { return 0; }
+  /// Return the bytes held by the tree, including unlinked nodes that have not
+  /// been reclaimed yet
+  size_t GetMemoryFootprint() override {
+    return container_.getMemoryFootprint();
+  }
+
+  /// Return the bytes held by reachable tree nodes of the given class
+  size_t GetMemoryUsage(art::MemoryClass memory_class) const {
+    return container_.getMemoryUsage(memory_class);
+  }
+
+  /// Nodes replaced by growing, shrinking or removal are only reclaimed once
+  /// no thread can observe them anymore
+  bool NeedGC() override { return container_.getGarbageSize() > 0; }
 
-  // TODO(pmenon): Implement me
-  bool NeedGC() override { return false; }
+  void PerformGC() override { container_.collectGarbage(); }
 
-  // TODO(pmenon): Implement me
-  void PerformGC() override {}
+  /// Are short keys stored in the tree, sparing lookups a trip to the table?
+  bool StoresKeysInline() const { return container_.storesKeysInline(); }
 
   /**
    * Configure the load-key function for this index. The load-key function
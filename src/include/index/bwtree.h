@@ -260,6 +260,36 @@ class BwTreeBase {
                 "class PaddedGCMetadata size does"
                 " not conform to the alignment!");
 
+ public:
+  /*
+   * class MemoryStats - Bytes of node memory held by one BwTree instance
+   *
+   * Base node bodies are charged to either inner or leaf bytes. The chunk
+   * preallocated with every base node for its delta chain, as well as any
+   * chunk grown later for a long delta chain, is charged to delta bytes.
+   * Counters are only touched when a base node or chunk is allocated or
+   * freed, never on the insertion of a single delta record
+   */
+  class MemoryStats {
+   public:
+    std::atomic<int64_t> inner_bytes;
+    std::atomic<int64_t> leaf_bytes;
+    std::atomic<int64_t> delta_bytes;
+
+    MemoryStats() : inner_bytes{0}, leaf_bytes{0}, delta_bytes{0} {}
+
+    /*
+     * GetTotalBytes() - Returns the sum of all counters
+     */
+    size_t GetTotalBytes() const {
+      int64_t total = inner_bytes.load(std::memory_order_relaxed) +
+                      leaf_bytes.load(std::memory_order_relaxed) +
+                      delta_bytes.load(std::memory_order_relaxed);
+
+      return total < 0 ? 0 : static_cast<size_t>(total);
+    }
+  };
+
  public:
   // This is used as the garbage collection ID, and is maintained in a per
   // thread level
@@ -1747,12 +1777,41 @@ class BwTree : public BwTreeBase {
     // free chunks of memory
     std::atomic<AllocationMeta *> next;
 
+    // The counters this chain of chunks is charged to, together with the
+    // counter and size of the base node it was allocated with. These are
+    // only set on the first chunk of a base node allocated by a tree
+    MemoryStats *stats_p;
+    std::atomic<int64_t> *node_bytes_p;
+    int64_t node_bytes;
+
    public:
     /*
      * Constructor
      */
     AllocationMeta(char *p_tail, char *p_limit)
-        : tail{p_tail}, limit{p_limit}, next{nullptr} {}
+        : tail{p_tail},
+          limit{p_limit},
+          next{nullptr},
+          stats_p{nullptr},
+          node_bytes_p{nullptr},
+          node_bytes{0} {}
+
+    /*
+     * Charge() - Charges the base node and the first chunk to the counters
+     *
+     * The same amount is subtracted again when the chain is destroyed
+     */
+    void Charge(MemoryStats *p_stats_p, std::atomic<int64_t> *p_node_bytes_p,
+                int64_t p_node_bytes) {
+      stats_p = p_stats_p;
+      node_bytes_p = p_node_bytes_p;
+      node_bytes = p_node_bytes;
+
+      node_bytes_p->fetch_add(node_bytes, std::memory_order_relaxed);
+      stats_p->delta_bytes.fetch_add(CHUNK_SIZE(), std::memory_order_relaxed);
+
+      return;
+    }
 
     /*
      * TryAllocate() - Try to allocate from this chunk
@@ -1794,7 +1853,7 @@ class BwTree : public BwTreeBase {
      * Whether or not this has succeded, always return the pointer to the next
      * chunk such that the caller could retry on next chunk
      */
-    AllocationMeta *GrowChunk() {
+    AllocationMeta *GrowChunk(MemoryStats *p_stats_p) {
       // If we know there is a next chunk just return it to avoid
       // having too many failed CAS instruction
       AllocationMeta *meta_p = next.load();
@@ -1820,6 +1879,11 @@ class BwTree : public BwTreeBase {
       // a chunk that has already been installed here
       bool ret = next.compare_exchange_strong(expected, new_meta_base);
       if (ret == true) {
+        if (p_stats_p != nullptr) {
+          p_stats_p->delta_bytes.fetch_add(CHUNK_SIZE(),
+                                           std::memory_order_relaxed);
+        }
+
         return new_meta_base;
       }
 
@@ -1855,7 +1919,7 @@ class BwTree : public BwTreeBase {
           // This will surely traverse the entire linked list
           // but since the linked list itself is supposed to be relatively short
           // even under contention, we do not worry about it right now
-          meta_p = meta_p->GrowChunk();
+          meta_p = meta_p->GrowChunk(stats_p);
           PL_ASSERT(meta_p != nullptr);
         } else {
           return p;
@@ -1877,7 +1941,14 @@ class BwTree : public BwTreeBase {
      * thread environment such as GC
      */
     void Destroy() {
+      // Remove the base node from the counters before its header is freed
+      MemoryStats *chain_stats_p = stats_p;
+      if (chain_stats_p != nullptr) {
+        node_bytes_p->fetch_sub(node_bytes, std::memory_order_relaxed);
+      }
+
       AllocationMeta *meta_p = this;
+      int64_t chunk_count = 0;
 
       while (meta_p != nullptr) {
         // Save the next pointer to traverse to it later
@@ -1891,6 +1962,12 @@ class BwTree : public BwTreeBase {
         delete[] reinterpret_cast<char *>(meta_p);
 
         meta_p = next_p;
+        chunk_count++;
+      }
+
+      if (chain_stats_p != nullptr) {
+        chain_stats_p->delta_bytes.fetch_sub(chunk_count * CHUNK_SIZE(),
+                                             std::memory_order_relaxed);
       }
 
       return;
@@ -1939,10 +2016,11 @@ class BwTree : public BwTreeBase {
     /*
      * Copy() - Copy constructs another instance
      */
-    static ElasticNode *Copy(const ElasticNode &other) {
+    static ElasticNode *Copy(const ElasticNode &other, MemoryStats *stats_p) {
       ElasticNode *node_p = ElasticNode::Get(
           other.GetItemCount(), other.GetType(), other.GetDepth(),
-          other.GetItemCount(), other.GetLowKeyPair(), other.GetHighKeyPair());
+          other.GetItemCount(), other.GetLowKeyPair(), other.GetHighKeyPair(),
+          stats_p);
 
       node_p->PushBack(other.Begin(), other.End());
 
@@ -2072,7 +2150,8 @@ class BwTree : public BwTreeBase {
                                    NodeType p_type, int p_depth,
                                    int p_item_count,  // Usually equal to size
                                    const KeyNodeIDPair &p_low_key,
-                                   const KeyNodeIDPair &p_high_key) {
+                                   const KeyNodeIDPair &p_high_key,
+                                   MemoryStats *stats_p) {
       // Currently this is always true - if we want a larger array then
       // just remove this line
       PL_ASSERT(size == p_item_count);
@@ -2101,6 +2180,14 @@ class BwTree : public BwTreeBase {
       ElasticNode *node_p = reinterpret_cast<ElasticNode *>(
           alloc_base + AllocationMeta::CHUNK_SIZE());
 
+      // Charge the node body and its delta chunk to the owning tree
+      PL_ASSERT(stats_p != nullptr);
+      reinterpret_cast<AllocationMeta *>(alloc_base)
+          ->Charge(stats_p, p_type == NodeType::InnerType
+                                ? &stats_p->inner_bytes
+                                : &stats_p->leaf_bytes,
+                   sizeof(ElasticNode) + size * sizeof(ElementType));
+
       // Call placement new to initialize all that could be initialized
       new (node_p)
           ElasticNode{p_type, p_depth, p_item_count, p_low_key, p_high_key};
@@ -2202,8 +2289,10 @@ class BwTree : public BwTreeBase {
      * This function does not change the current node since all existing nodes
      * should be read-only to avoid data race. It copies half of the inner node
      * into the split sibling, and return the sibling node.
+     *
+     * The tree is passed in to charge the sibling to its memory counters
      */
-    InnerNode *GetSplitSibling() const {
+    InnerNode *GetSplitSibling(const BwTree *t) const {
       // Call function in class ElasticNode to determine the size of the
       // inner node
       int key_num = this->GetSize();
@@ -2230,7 +2319,8 @@ class BwTree : public BwTreeBase {
       InnerNode *inner_node_p =
           reinterpret_cast<InnerNode *>(ElasticNode<KeyNodeIDPair>::Get(
               sibling_size, NodeType::InnerType, 0, sibling_size,
-              this->At(split_item_index), this->GetHighKeyPair()));
+              this->At(split_item_index), this->GetHighKeyPair(),
+              t->GetMemoryStats()));
 
       // Call overloaded PushBack() to insert an array of elements
       inner_node_p->PushBack(copy_start_it, this->End());
@@ -2395,7 +2485,7 @@ class BwTree : public BwTreeBase {
           reinterpret_cast<LeafNode *>(ElasticNode<KeyValuePair>::Get(
               sibling_size, NodeType::LeafType, 0, sibling_size,
               std::make_pair(split_key, ~INVALID_NODE_ID),
-              this->GetHighKeyPair()));
+              this->GetHighKeyPair(), t->GetMemoryStats()));
 
       // Copy data item into the new node using PushBack()
       leaf_node_p->PushBack(copy_start_it, copy_end_it);
@@ -2801,7 +2891,7 @@ class BwTree : public BwTreeBase {
     InnerNode *root_node_p =
         reinterpret_cast<InnerNode *>(ElasticNode<KeyNodeIDPair>::Get(
             1, NodeType::InnerType, 0, 1, first_sep,
-            std::make_pair(KeyType(), INVALID_NODE_ID)));
+            std::make_pair(KeyType(), INVALID_NODE_ID), GetMemoryStats()));
 
 #else
 
@@ -2817,7 +2907,7 @@ class BwTree : public BwTreeBase {
         reinterpret_cast<InnerNode *>(ElasticNode<KeyNodeIDPair>::Get(
             1, NodeType::InnerType, 0, 1,
             first_sep,  // Copy this as the first key
-            std::make_pair(KeyType{}, INVALID_NODE_ID)));
+            std::make_pair(KeyType{}, INVALID_NODE_ID), GetMemoryStats()));
 
 #endif
 
@@ -2836,7 +2926,7 @@ class BwTree : public BwTreeBase {
         reinterpret_cast<LeafNode *>(ElasticNode<KeyValuePair>::Get(
             0, NodeType::LeafType, 0, 0,
             std::make_pair(KeyType(), INVALID_NODE_ID),
-            std::make_pair(KeyType(), INVALID_NODE_ID)));
+            std::make_pair(KeyType(), INVALID_NODE_ID), GetMemoryStats()));
 
 #else
 
@@ -2844,7 +2934,7 @@ class BwTree : public BwTreeBase {
         reinterpret_cast<LeafNode *>(ElasticNode<KeyValuePair>::Get(
             0, NodeType::LeafType, 0, 0,
             std::make_pair(KeyType{}, INVALID_NODE_ID),
-            std::make_pair(KeyType{}, INVALID_NODE_ID)));
+            std::make_pair(KeyType{}, INVALID_NODE_ID), GetMemoryStats()));
 
 #endif
 
@@ -3658,7 +3748,7 @@ class BwTree : public BwTreeBase {
         reinterpret_cast<InnerNode *>(ElasticNode<KeyNodeIDPair>::Get(
             node_p->GetItemCount(), NodeType::InnerType, p_depth,
             node_p->GetItemCount(), node_p->GetLowKeyPair(),
-            node_p->GetHighKeyPair()));
+            node_p->GetHighKeyPair(), GetMemoryStats()));
 
     // The first element is always the low key
     // since we know it will never be deleted
@@ -4541,7 +4631,8 @@ class BwTree : public BwTreeBase {
     if (leaf_node_p == nullptr) {
       leaf_node_p = reinterpret_cast<LeafNode *>(ElasticNode<KeyValuePair>::Get(
           node_p->GetItemCount(), NodeType::LeafType, 0, node_p->GetItemCount(),
-          node_p->GetLowKeyPair(), node_p->GetHighKeyPair()));
+          node_p->GetLowKeyPair(), node_p->GetHighKeyPair(),
+          GetMemoryStats()));
     }
 
     PL_ASSERT(leaf_node_p != nullptr);
@@ -5315,6 +5406,50 @@ class BwTree : public BwTreeBase {
     return;
   }
 
+  /*
+   * NavigateCachedLeaf() - Collect values from a leaf found by an earlier
+   *                        lookup in the same epoch
+   *
+   * The search key must not be less than the key that found the leaf, so
+   * it is never below the leaf's low key. If the leaf is being removed or
+   * the search key is not below its high key, nothing is collected and
+   * false is returned; the caller should then do a normal traversal.
+   */
+  bool NavigateCachedLeaf(NodeID leaf_node_id, Context *context_p,
+                          std::vector<ValueType> *value_list_p) {
+    LoadNodeIDReadOptimized(leaf_node_id, context_p);
+
+    if (context_p->abort_flag == true) {
+      LOG_TRACE("Cached leaf is being removed (RO)");
+
+      return false;
+    }
+
+    const BaseNode *node_p = GetLatestNodeSnapshot(context_p)->node_p;
+
+    PL_ASSERT(node_p->IsOnLeafDeltaChain() == true);
+
+    if ((node_p->GetNextNodeID() != INVALID_NODE_ID) &&
+        (KeyCmpGreaterEqual(context_p->search_key, node_p->GetHighKey()))) {
+      return false;
+    }
+
+    size_t value_count = value_list_p->size();
+
+    NavigateLeafNode(context_p, *value_list_p);
+
+    if (context_p->abort_flag == true) {
+      LOG_TRACE("NavigateLeafNode aborts on cached leaf (RO)");
+
+      value_list_p->erase(value_list_p->begin() + value_count,
+                          value_list_p->end());
+
+      return false;
+    }
+
+    return true;
+  }
+
   void TraverseReadOptimized(Context *context_p,
                              std::vector<ValueType> *value_list_p) {
   retry_traverse:
@@ -5820,7 +5955,8 @@ class BwTree : public BwTreeBase {
           InnerNode *inner_node_p =
               reinterpret_cast<InnerNode *>(ElasticNode<KeyNodeIDPair>::Get(
                   2, NodeType::InnerType, 0, 2, first_item,
-                  std::make_pair(KeyType(), INVALID_NODE_ID)));
+                  std::make_pair(KeyType(), INVALID_NODE_ID),
+                  GetMemoryStats()));
 
 #else
 
@@ -5833,7 +5969,8 @@ class BwTree : public BwTreeBase {
           InnerNode *inner_node_p =
               reinterpret_cast<InnerNode *>(ElasticNode<KeyNodeIDPair>::Get(
                   2, NodeType::InnerType, 0, 2, first_item,
-                  std::make_pair(KeyType{}, INVALID_NODE_ID)));
+                  std::make_pair(KeyType{}, INVALID_NODE_ID),
+                  GetMemoryStats()));
 
 #endif
 
@@ -6288,7 +6425,7 @@ class BwTree : public BwTreeBase {
       if (node_size >= INNER_NODE_SIZE_UPPER_THRESHOLD) {
         LOG_TRACE("Node size >= inner upper threshold. Split");
 
-        const InnerNode *new_inner_node_p = inner_node_p->GetSplitSibling();
+        const InnerNode *new_inner_node_p = inner_node_p->GetSplitSibling(this);
 
         // Since this is a split sibling, the low key must be a valid key
         // NOTE: Only for InnerNodes could we call GetLowKey()
@@ -7266,6 +7403,47 @@ class BwTree : public BwTreeBase {
     return;
   }
 
+  /*
+   * GetValues() - Fill one value list for each of the given keys
+   *
+   * The values of *key_list[i] are appended to value_list_list[i]. All
+   * lookups share a single epoch. When the keys are sorted, a key that
+   * falls into the leaf of the previous key is read from that leaf
+   * directly instead of traversing down from the root again.
+   */
+  void GetValues(const KeyType *const *key_list, size_t key_count,
+                 std::vector<ValueType> *value_list_list) {
+    LOG_TRACE("GetValues()");
+
+    EpochNode *epoch_node_p = epoch_manager.JoinEpoch();
+
+    // Leaf of the previous lookup. It cannot be recycled while we are
+    // inside the epoch, so reloading it by its NodeID is always safe
+    NodeID leaf_node_id = INVALID_NODE_ID;
+
+    for (size_t i = 0; i < key_count; i++) {
+      if (leaf_node_id != INVALID_NODE_ID) {
+        Context context{*key_list[i]};
+
+        if (NavigateCachedLeaf(leaf_node_id, &context, &value_list_list[i])) {
+          leaf_node_id = context.current_snapshot.node_id;
+
+          continue;
+        }
+      }
+
+      Context context{*key_list[i]};
+
+      TraverseReadOptimized(&context, &value_list_list[i]);
+
+      leaf_node_id = context.current_snapshot.node_id;
+    }
+
+    epoch_manager.LeaveEpoch(epoch_node_p);
+
+    return;
+  }
+
   /*
    * GetValue() - Return value in a ValueSet object
    *
@@ -7307,6 +7485,22 @@ class BwTree : public BwTreeBase {
    */
   bool NeedGarbageCollection() { return true; }
 
+  /*
+   * GetMemoryStats() - Returns the node memory counters of this tree
+   */
+  MemoryStats *GetMemoryStats() const { return &memory_stats; }
+
+  /*
+   * GetMemoryFootprint() - Returns the number of bytes held by this tree
+   *
+   * This includes the mapping table, which is allocated with the tree, and
+   * all base nodes and delta chunks, including those that have been unlinked
+   * but not yet reclaimed by the epoch manager
+   */
+  size_t GetMemoryFootprint() const {
+    return sizeof(mapping_table) + memory_stats.GetTotalBytes();
+  }
+
   /*
    * PerformGarbageCollection() - Interface function for external users to
    *                              force a garbage collection
@@ -7390,6 +7584,10 @@ class BwTree : public BwTreeBase {
 
   // InteractiveDebugger idb;
 
+  // Bytes held by tree nodes; mutable since nodes are also allocated
+  // through const pointers to the tree, e.g. when splitting
+  mutable MemoryStats memory_stats;
+
   EpochManager epoch_manager;
 
  public:
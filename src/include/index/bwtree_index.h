@@ -96,10 +96,19 @@ class BWTreeIndex : public Index {
   void ScanKey(const storage::Tuple *key,
                std::vector<ValueType> &result) override;
 
+  void ScanKeys(const std::vector<const storage::Tuple *> &keys,
+                std::vector<std::vector<ValueType>> &results) override;
+
   std::string GetTypeName() const override;
 
-  // TODO: Implement this
-  size_t GetMemoryFootprint() override { return 0; }
+  size_t GetMemoryFootprint() override {
+    return container.GetMemoryFootprint();
+  }
+
+  // Breakdown of the node memory into inner, leaf and delta bytes
+  const typename MapType::MemoryStats &GetMemoryStats() const {
+    return *container.GetMemoryStats();
+  }
   
   bool NeedGC() override {
     return container.NeedGarbageCollection();
@@ -334,6 +334,18 @@ class Index : public Printable {
   virtual void ScanKey(const storage::Tuple *key,
                        std::vector<ItemPointer *> &result) = 0;
 
+  /**
+   * Finds the values for each of the given keys. The values for keys[i] are
+   * appended to results[i]. Probing many keys at once lets an index order
+   * the lookups and share work between neighbouring keys, which is faster
+   * than calling ScanKey() for each key in turn.
+   *
+   * @param keys The keys to look up
+   * @param[out] results Where the results for each key are stored
+   */
+  virtual void ScanKeys(const std::vector<const storage::Tuple *> &keys,
+                        std::vector<std::vector<ItemPointer *>> &results);
+
   //////////////////////////////////////////////////////////////////////////////
   /// Garbage Collection
   //////////////////////////////////////////////////////////////////////////////
@@ -15,6 +15,7 @@
 #include <event2/bufferevent.h>
 #include <event2/event.h>
 #include <event2/listener.h>
+#include <atomic>
 #include <unordered_map>
 
 #include <csignal>
@@ -76,6 +77,11 @@ class ConnectionHandle {
     return protocol_handler_;
   }
 
+  // Number of client connections opened and not closed yet
+  static inline int64_t GetOpenConnectionCount() {
+    return open_connection_count_.load(std::memory_order_relaxed);
+  }
+
   // State Machine actions
   /**
    * refill_read_buffer - Used to repopulate read buffer with a fresh
@@ -223,6 +229,8 @@ class ConnectionHandle {
   StateMachine state_machine_;
 
   short curr_event_flag_;  // current libevent event flag
+
+  static std::atomic<int64_t> open_connection_count_;
 };
 }  // namespace network
 }  // namespace peloton
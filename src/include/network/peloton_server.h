@@ -15,6 +15,7 @@
 #include <event2/buffer.h>
 #include <event2/bufferevent.h>
 #include <event2/event.h>
+#include <event2/http.h>
 #include <event2/listener.h>
 
 #include <arpa/inet.h>
@@ -133,6 +134,15 @@ class PelotonServer : public DedicatedThreadOwner {
 
   std::shared_ptr<ConnectionDispatcherTask> dispatcher_task;
 
+  // Local metrics endpoint served on the dispatcher's event loop, or null
+  struct evhttp *metrics_http_ = nullptr;
+
+  // Starts serving the metrics registry over http on the metrics port
+  void SetupMetricsEndpoint();
+
+  // Replies to a scrape of the metrics endpoint
+  static void HandleMetricsRequest(struct evhttp_request *request, void *arg);
+
   template <typename... Ts>
   void TrySslOperation(int (*func)(Ts...), Ts... arg);
 
@@ -161,6 +161,18 @@ class PostgresProtocolHandler : public ProtocolHandler {
   /* Execute a Simple query protocol message */
   ProcessResult ExecQueryMessage(InputPacket *pkt, const size_t thread_id);
 
+  /* Execute a simple query with a plan from the shared plan cache. Returns
+   * false if the query can't use the cache and has to be planned as it is
+   */
+  bool ExecSharedPlanQuery(const std::string &query, const size_t thread_id,
+                           ProcessResult &result);
+
+  /* Lease a plan of a prepared query from the shared plan cache, planning it
+   * on a miss. Returns nullptr if the query can't be planned.
+   */
+  std::shared_ptr<Statement> LeaseSharedStatement(const std::string &key,
+                                                  const std::string &query);
+
   /* Process the PARSE message of the extended query protocol */
   void ExecParseMessage(InputPacket *pkt);
 
@@ -204,6 +216,11 @@ class PostgresProtocolHandler : public ProtocolHandler {
   // Statement cache
   StatementCache statement_cache_;
 
+  // Statement taken from the shared plan cache for the running simple query
+  std::shared_ptr<Statement> shared_statement_;
+  std::string shared_statement_key_;
+  uint64_t shared_statement_version_ = 0;
+
   //  Portals
   std::unordered_map<std::string, std::shared_ptr<Portal>> portals_;
 
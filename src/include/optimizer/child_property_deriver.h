@@ -52,6 +52,7 @@ class ChildPropertyDeriver : public OperatorVisitor {
   void Visit(const PhysicalLeftHashJoin *) override;
   void Visit(const PhysicalRightHashJoin *) override;
   void Visit(const PhysicalOuterHashJoin *) override;
+  void Visit(const PhysicalInnerMergeJoin *) override;
   void Visit(const PhysicalInsert *) override;
   void Visit(const PhysicalInsertSelect *) override;
   void Visit(const PhysicalDelete *) override;
@@ -78,6 +78,7 @@ class InputColumnDeriver : public OperatorVisitor {
   void Visit(const PhysicalRightHashJoin *) override;
 
   void Visit(const PhysicalOuterHashJoin *) override;
+  void Visit(const PhysicalInnerMergeJoin *) override;
 
   void Visit(const PhysicalInsert *) override;
 
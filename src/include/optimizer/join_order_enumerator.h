@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// join_order_enumerator.h
+//
+// Identification: src/include/optimizer/join_order_enumerator.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace peloton {
+namespace optimizer {
+
+/**
+ * @brief Finds a cheap order for a multi-way inner join, given the join graph:
+ * the cardinality of every joined relation and the selectivity of every join
+ * predicate.
+ *
+ * Small joins are ordered with dynamic programming over the connected
+ * subgraphs of the join graph (DPccp, Moerkotte & Neumann 2006), which finds
+ * the cheapest bushy tree without cross products while only looking at the
+ * csg-cmp pairs that can actually be joined. Large or disconnected joins are
+ * ordered with Greedy Operator Ordering (Fegaras 1998), which keeps joining
+ * the pair of subtrees with the smallest result.
+ *
+ * The cardinality of a set is computed once from its relations rather than
+ * from every pair that produces it, and ties between plans are broken by
+ * their left side, so the chosen tree doesn't depend on the order in which
+ * pairs are costed.
+ *
+ * The cost of a join mirrors the CostCalculator: the sum of the input sizes
+ * if there's an equi-join predicate to hash on, their product otherwise.
+ */
+class JoinOrderEnumerator {
+ public:
+  // A set of relations, one bit per relation
+  using RelationSet = uint64_t;
+
+  static const size_t kMaxRelations = 64;
+
+  // The best plan found for a set of relations
+  struct JoinNode {
+    RelationSet relations;
+    // The sets joined to produce the relations, both 0 for a base relation
+    RelationSet left;
+    RelationSet right;
+    double cardinality;
+    double cost;
+  };
+
+  // Adds a relation with its estimated cardinality, returns its index
+  size_t AddRelation(double cardinality);
+
+  // Adds a join predicate over the given relations. A predicate over two
+  // relations connects them in the join graph.
+  void AddPredicate(RelationSet relations, double selectivity,
+                    bool is_equi_join);
+
+  // Orders the join with dynamic programming if it joins at most
+  // dp_threshold relations and its join graph is connected, or greedily
+  // otherwise
+  void Enumerate(size_t dp_threshold);
+
+  // Orders the join with DPccp. The join graph must be connected.
+  void EnumerateDP();
+
+  // Orders the join with Greedy Operator Ordering
+  void EnumerateGreedy();
+
+  inline size_t GetRelationCount() const { return cardinalities_.size(); }
+
+  inline RelationSet GetAllRelations() const {
+    return GetRelationCount() == kMaxRelations
+               ? ~RelationSet{0}
+               : (RelationSet{1} << GetRelationCount()) - 1;
+  }
+
+  // Returns the plan chosen for a set of relations of the join tree, starting
+  // with GetAllRelations()
+  const JoinNode &GetJoinNode(RelationSet relations) const;
+
+  // Returns the estimated cost of the chosen join tree
+  double GetCost() const { return GetJoinNode(GetAllRelations()).cost; }
+
+  // Number of pairs of subtrees costed while enumerating
+  inline size_t GetPairCount() const { return pair_count_; }
+
+  // Whether the join graph connects all relations without cross products
+  bool IsConnected() const;
+
+ private:
+  struct Predicate {
+    RelationSet relations;
+    double selectivity;
+    bool is_equi_join;
+  };
+
+  // Adds the plans for all base relations
+  void InitPlans();
+
+  // The estimated cardinality of joining the relations
+  double GetCardinality(RelationSet relations) const;
+
+  // The relations next to the given ones in the join graph, excluding the
+  // relations in excluded
+  RelationSet GetNeighbors(RelationSet relations, RelationSet excluded) const;
+
+  // Costs joining the best plans of left and right, keeping the join if it's
+  // the cheapest plan of their union so far
+  void EmitCsgCmp(RelationSet left, RelationSet right);
+
+  void EmitCsg(RelationSet csg);
+  void EnumerateCsgRec(RelationSet csg, RelationSet excluded);
+  void EnumerateCmpRec(RelationSet csg, RelationSet cmp, RelationSet excluded);
+
+  std::vector<double> cardinalities_;
+  std::vector<Predicate> predicates_;
+  // The neighbors of each relation in the join graph
+  std::vector<RelationSet> neighbors_;
+
+  std::unordered_map<RelationSet, JoinNode> plans_;
+  size_t pair_count_ = 0;
+};
+
+}  // namespace optimizer
+}  // namespace peloton
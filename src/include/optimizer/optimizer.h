@@ -14,6 +14,7 @@
 
 #include <memory>
 
+#include "common/timer.h"
 #include "optimizer/abstract_optimizer.h"
 #include "optimizer/property_set.h"
 #include "optimizer/optimizer_metadata.h"
@@ -150,6 +151,13 @@ class Optimizer : public AbstractOptimizer {
   void ExecuteTaskStack(OptimizerTaskStack &task_stack, int root_group_id,
                         std::shared_ptr<OptimizeContext> root_context);
 
+  /* RecordOptimizeLatency - record the time taken to pick a plan for a query
+   * when stats are collected
+   *
+   * timer: the timer started when the optimizer got the query
+   */
+  void RecordOptimizeLatency(Timer<std::milli> &timer);
+
   //////////////////////////////////////////////////////////////////////////////
   /// Metadata
   OptimizerMetadata metadata_;
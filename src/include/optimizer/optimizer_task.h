@@ -47,7 +47,8 @@ enum class OptimizerTaskType {
   REWRITE_EXPR,
   APPLY_REWIRE_RULE,
   TOP_DOWN_REWRITE,
-  BOTTOM_UP_REWRITE
+  BOTTOM_UP_REWRITE,
+  ENUMERATE_JOIN_ORDER
 };
 
 /**
@@ -281,5 +282,28 @@ class BottomUpRewrite : public OptimizerTask {
   RewriteRuleSetName rule_set_name_;
   bool has_optimized_child_;
 };
+
+/**
+ * @brief Pick the join order of every tree of inner joins below a group with
+ * the JoinOrderEnumerator, using the stats derived for the joined groups, and
+ * replace the tree in the memo with the chosen one. This runs between the
+ * rewrite and the optimization, so that exploration starts from a good join
+ * order instead of the order the joins were written in the query.
+ */
+class EnumerateJoinOrder : public OptimizerTask {
+ public:
+  EnumerateJoinOrder(GroupID group_id, std::shared_ptr<OptimizeContext> context)
+      : OptimizerTask(context, OptimizerTaskType::ENUMERATE_JOIN_ORDER),
+        group_id_(group_id) {}
+  virtual void execute() override;
+
+ private:
+  // Collects the groups joined by the tree of inner joins rooted at the group
+  // and the predicates of those joins
+  void CollectJoinGraph(GroupID group_id, std::vector<GroupID> &leaf_groups,
+                        std::vector<AnnotatedExpression> &predicates);
+
+  GroupID group_id_;
+};
 }  // namespace optimizer
 }  // namespace peloton
@@ -79,6 +79,7 @@ class PlanGenerator : public OperatorVisitor {
   void Visit(const PhysicalRightHashJoin *) override;
 
   void Visit(const PhysicalOuterHashJoin *) override;
+  void Visit(const PhysicalInnerMergeJoin *) override;
 
   void Visit(const PhysicalInsert *) override;
 
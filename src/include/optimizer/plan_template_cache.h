@@ -0,0 +1,174 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_template_cache.h
+//
+// Identification: src/include/optimizer/plan_template_cache.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "planner/abstract_plan.h"
+
+namespace peloton {
+
+namespace expression {
+class AbstractExpression;
+}
+
+namespace optimizer {
+
+class OperatorExpression;
+class PropertySet;
+
+//===--------------------------------------------------------------------===//
+// Plan Template Cache
+//
+// Keeps the plans the optimizer picked for logical operator trees, so that
+// optimizing the same query again, e.g. a prepared statement re-prepared by
+// another connection, skips building the memo and deriving stats. The key is
+// the normalized operator tree: the tables and columns it references by oid,
+// its predicates with constants and parameter slots, and the output columns
+// and sort order required from the plan. Parameter values are bound to a plan
+// in place after optimization as before.
+//
+// Constants are part of the key on purpose: the cache only reuses a plan for
+// the exact tree it was picked for. The stats calculator estimates the
+// selectivity of a predicate from its constant, so the cheapest plan for one
+// literal isn't necessarily the cheapest for another, and constants such as
+// LIMIT counts are built into the plans where no parameter can rebind them.
+// Queries that only differ in their literals share a template when the
+// literals reach the optimizer as parameters: prepared statements carry them
+// that way, and simple queries are parameterized when the shared_plan_cache
+// setting is on (see the SharedPlanCache).
+//
+// Plans are bound in place, so like in the SharedPlanCache a plan is only
+// used by one statement at a time: Acquire() takes an idle plan out of the
+// cache and hands it out as a lease, which puts the plan back once the last
+// reference to it is gone.
+//
+// A plan is only reused while it's likely to still be the best one: plans
+// are dropped when the optimizer stats changed since they were picked, when
+// the number of live rows of a table they read grew or shrank by more than
+// plan_template_drift_ratio, or when a table is invalidated through the
+// StatementCacheManager, e.g. because an index was created on it.
+//===--------------------------------------------------------------------===//
+
+class PlanTemplateCache {
+ public:
+  // Global Singleton
+  static PlanTemplateCache &GetInstance();
+
+  // A key gets an idle plan for every statement that ran it at once. Plans
+  // released beyond this many are dropped.
+  static constexpr size_t kMaxPlansPerKey = 16;
+
+  // A table read by a plan, by database and table oid
+  using TableRef = std::pair<oid_t, oid_t>;
+
+  // Build the key of an operator tree that must produce the given columns
+  // with the given properties. Returns false if the tree has operators or
+  // expressions the key can't tell apart, in which case it isn't cached.
+  static bool GetKey(const OperatorExpression &tree,
+                     const std::vector<expression::AbstractExpression *> &
+                         output_exprs,
+                     const PropertySet &required_props, std::string &key,
+                     std::vector<TableRef> &tables);
+
+  // Take an idle plan for the key out of the cache, leased until the last
+  // copy of the returned pointer is gone. Returns nullptr if there is none
+  // or the cached plans are stale, in which case the versions have to be
+  // passed to Lease() along with the plan the optimizer picks instead.
+  std::shared_ptr<planner::AbstractPlan> Acquire(const std::string &key,
+                                                 uint64_t &version,
+                                                 uint64_t &stats_version);
+
+  // Lease a plan just picked by the optimizer for the key, so that it's
+  // cached once the caller is done with it
+  std::shared_ptr<planner::AbstractPlan> Lease(
+      const std::string &key, std::unique_ptr<planner::AbstractPlan> plan,
+      const std::vector<TableRef> &tables, uint64_t version,
+      uint64_t stats_version);
+
+  // Drop the plans that read any of the tables
+  void InvalidateTableOids(const std::set<oid_t> &table_ids);
+
+  // Number of keys in the cache
+  size_t GetSize();
+
+  // Number of idle plans of the key
+  size_t GetPlanCount(const std::string &key);
+
+  void Clear();
+
+  inline uint64_t GetHitCount() const { return hit_count_; }
+  inline uint64_t GetMissCount() const { return miss_count_; }
+  // Lookups that found plans but dropped them as stale
+  inline uint64_t GetReoptimizeCount() const { return reoptimize_count_; }
+
+ private:
+  struct Entry {
+    std::vector<std::unique_ptr<planner::AbstractPlan>> plans;
+    std::vector<TableRef> tables;
+    // The size of each table when the plans were picked
+    std::vector<size_t> table_sizes;
+    // The optimizer stats the plans were picked with
+    uint64_t stats_version = 0;
+    std::list<std::string>::iterator lru_position;
+  };
+
+  PlanTemplateCache() {}
+
+
+  // Hand a leased plan back
+  void Release(const std::string &key,
+               std::unique_ptr<planner::AbstractPlan> plan,
+               const std::vector<TableRef> &tables, uint64_t stats_version,
+               const std::vector<size_t> &table_sizes, uint64_t version);
+
+  // Wrap a plan so that it's released once the last copy of the returned
+  // pointer is gone
+  std::shared_ptr<planner::AbstractPlan> MakeLease(
+      const std::string &key, std::unique_ptr<planner::AbstractPlan> plan,
+      const std::vector<TableRef> &tables, uint64_t stats_version,
+      const std::vector<size_t> &table_sizes, uint64_t version);
+
+  // Whether a table the plans of the entry read grew or shrank too much since
+  // they were picked
+  bool HasDrifted(const Entry &entry);
+
+  // Drop an entry. Must hold the cache lock.
+  void Erase(std::unordered_map<std::string, Entry>::iterator entry);
+
+  std::mutex cache_lock_;
+
+  std::unordered_map<std::string, Entry> entries_;
+
+  // Keys, most recently used first
+  std::list<std::string> lru_list_;
+
+  // Bumped by every invalidation
+  uint64_t version_ = 0;
+
+  std::atomic<uint64_t> hit_count_{0};
+  std::atomic<uint64_t> miss_count_{0};
+  std::atomic<uint64_t> reoptimize_count_{0};
+};
+
+}  // namespace optimizer
+}  // namespace peloton
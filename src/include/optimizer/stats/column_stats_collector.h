@@ -17,6 +17,7 @@
 #include <libcount/hll.h>
 
 #include "common/internal_types.h"
+#include "common/macros.h"
 #include "optimizer/stats/count_min_sketch.h"
 #include "optimizer/stats/top_k_elements.h"
 #include "optimizer/stats/histogram.h"
@@ -46,13 +47,15 @@ class ColumnStatsCollector {
 
   void AddValue(const type::Value& value);
 
+  // Merge the stats of another collector on the same column into this one.
+  // Used to combine the thread-local collectors of a parallel ANALYZE.
+  void Merge(const ColumnStatsCollector& other);
+
   double GetFracNull();
 
-  inline std::vector<ValueFrequencyPair> GetCommonValueAndFrequency() {
-    return topk_.GetAllOrderedMaxFirst();
-  }
+  std::vector<ValueFrequencyPair> GetCommonValueAndFrequency();
 
-  inline uint64_t GetCardinality() { return hll_.EstimateCardinality(); }
+  uint64_t GetCardinality();
 
   inline double GetCardinalityError() { return hll_.RelativeError(); }
 
@@ -64,6 +67,15 @@ class ColumnStatsCollector {
 
   inline bool HasIndex() { return has_index_; }
 
+  // Fraction of the table the values were drawn from. Frequencies and
+  // cardinality are scaled back up to the whole table when it is below 1.
+  inline void SetSampleRatio(double sample_ratio) {
+    PL_ASSERT(sample_ratio > 0 && sample_ratio <= 1);
+    sample_ratio_ = sample_ratio;
+  }
+
+  inline double GetSampleRatio() { return sample_ratio_; }
+
  private:
   const oid_t database_id_;
   const oid_t table_id_;
@@ -77,6 +89,8 @@ class ColumnStatsCollector {
 
   bool has_index_ = false;
 
+  double sample_ratio_ = 1.0;
+
   size_t null_count_ = 0;
   size_t total_count_ = 0;
 
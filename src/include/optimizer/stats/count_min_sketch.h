@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "common/logger.h"
+#include "common/macros.h"
 #include "murmur3/MurmurHash3.h"
 
 namespace peloton {
@@ -120,6 +121,20 @@ class CountMinSketch {
     }
   }
 
+  // Merge the counters of another sketch into this one. Both sketches must
+  // share the same dimensions so that an item hashes to the same bins.
+  // The size becomes an upper bound since items seen by both sketches are
+  // counted twice.
+  void Merge(const CountMinSketch& other) {
+    PL_ASSERT(depth == other.depth && width == other.width);
+    for (int i = 0; i < depth; i++) {
+      for (int j = 0; j < width; j++) {
+        table[i][j] += other.table[i][j];
+      }
+    }
+    size += other.size;
+  }
+
   uint64_t EstimateItemCount(int64_t item) {
     uint64_t count = UINT64_MAX;
     std::vector<int> bins = getHashBins(item);
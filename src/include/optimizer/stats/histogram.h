@@ -89,6 +89,21 @@ class Histogram {
     }
   }
 
+  /*
+   * Input: another histogram h
+   *
+   * Merge h into this histogram so that it represents the union of both
+   * point sets, keeping at most max_bins bins (Algorithm 2 in the paper).
+   */
+  void Merge(const Histogram &other) {
+    for (const Bin &bin : other.bins) {
+      InsertBin(bin);
+    }
+    while (bins.size() > max_bins_) {
+      MergeTwoBinsWithMinGap();
+    }
+  }
+
   /*
    * Input: a point b such that p1 < b < pB
    *
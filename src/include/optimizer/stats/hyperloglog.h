@@ -41,6 +41,14 @@ class HyperLogLog {
     hll_->Update(StatsUtil::HashValue(value));
   }
 
+  // Merge the registers of another HLL into this one. Both sketches must have
+  // been created with the same precision.
+  void Merge(const HyperLogLog& other) {
+    PL_ASSERT(precision_ == other.precision_);
+    UNUSED_ATTRIBUTE int result = hll_->Merge(other.hll_);
+    PL_ASSERT(result == 0);
+  }
+
   uint64_t EstimateCardinality() {
     uint64_t cardinality = hll_->Estimate();
     LOG_TRACE("Estimated cardinality: %" PRId64, cardinality);
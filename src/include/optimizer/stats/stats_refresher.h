@@ -0,0 +1,143 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// stats_refresher.h
+//
+// Identification: src/include/optimizer/stats/stats_refresher.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "common/internal_types.h"
+
+namespace peloton {
+
+namespace storage {
+class DataTable;
+}
+
+namespace optimizer {
+
+//===--------------------------------------------------------------------===//
+// StatsRefresher
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Background task that keeps the optimizer stats fresh.
+ *
+ * Every DML statement bumps the modification count of the table it touches.
+ * The refresher periodically compares that count with the one recorded at
+ * the table's last ANALYZE and, once the churn exceeds stats_refresh_threshold
+ * of the analyzed row count, re-analyzes the table on the brain pool and
+ * invalidates the cached plans that read it.
+ */
+class StatsRefresher {
+ public:
+  StatsRefresher(const StatsRefresher &) = delete;
+  StatsRefresher &operator=(const StatsRefresher &) = delete;
+  StatsRefresher(StatsRefresher &&) = delete;
+  StatsRefresher &operator=(StatsRefresher &&) = delete;
+
+  /**
+   * Tables with fewer rows than this are treated as having this many rows
+   * when computing their churn, so tiny tables are not re-analyzed after
+   * every handful of inserts.
+   */
+  static constexpr size_t kMinRefreshRows = 1000;
+
+  /**
+   * Singleton
+   *
+   * @return     The instance.
+   */
+  static StatsRefresher &GetInstance();
+
+  /**
+   * Start the background checking thread
+   */
+  void Start();
+
+  /**
+   * Stop the background checking thread
+   */
+  void Stop();
+
+  /**
+   * Check every user table once and queue a refresh for each stale one on
+   * the brain pool.
+   *
+   * @return     The number of refreshes queued.
+   */
+  size_t CheckTables();
+
+  /**
+   * Check whether a table changed enough since its last ANALYZE
+   *
+   * @param      table  The table
+   */
+  bool IsStale(storage::DataTable *table);
+
+  /**
+   * Re-analyze a table in its own transaction and invalidate the cached
+   * plans that depend on it.
+   *
+   * @param[in]  database_oid  The database oid
+   * @param[in]  table_oid     The table oid
+   */
+  ResultType RefreshTable(oid_t database_oid, oid_t table_oid);
+
+  /**
+   * Remember the state of a table at the time it was analyzed. Called by
+   * StatsStorage whenever a table's stats are collected.
+   *
+   * @param      table               The table
+   * @param[in]  modification_count  The modification count before collecting
+   * @param[in]  num_rows            The number of rows that were analyzed
+   */
+  void RecordAnalyze(storage::DataTable *table, size_t modification_count,
+                     size_t num_rows);
+
+  /**
+   * Forget what was recorded for a table. Called when the table is dropped.
+   *
+   * @param[in]  table_oid  The table oid
+   */
+  void DeregisterTable(oid_t table_oid);
+
+ private:
+  StatsRefresher();
+
+  void Run();
+
+  struct AnalyzeMark {
+    size_t modification_count;
+    size_t num_rows;
+  };
+
+  /** State of each table at its last ANALYZE, keyed by table oid */
+  std::unordered_map<oid_t, AnalyzeMark> analyze_marks_;
+
+  /** Tables with a refresh queued but not finished yet */
+  std::unordered_set<oid_t> pending_tables_;
+
+  std::mutex refresher_mutex_;
+
+  /** Stop signal */
+  std::atomic<bool> refresher_stop_;
+
+  /** Refresher thread */
+  std::thread refresher_thread_;
+};
+
+}  // namespace optimizer
+}  // namespace peloton
@@ -15,6 +15,7 @@
 #include "optimizer/stats/table_stats_collector.h"
 #include "optimizer/stats/column_stats_collector.h"
 
+#include <atomic>
 #include <sstream>
 
 #include "common/macros.h"
@@ -81,9 +82,15 @@ class StatsStorage {
   ResultType AnalayzeStatsForColumns(storage::DataTable *table,
                                      std::vector<std::string> column_names);
 
+  // Bumped whenever any column stats change, so that plans picked with older
+  // stats can tell
+  inline uint64_t GetVersion() const { return version_; }
+
  private:
   std::unique_ptr<type::AbstractPool> pool_;
 
+  std::atomic<uint64_t> version_{0};
+
   std::shared_ptr<ColumnStats> ConvertVectorToColumnStats(
       oid_t database_id, oid_t table_id, oid_t column_id,
       std::unique_ptr<std::vector<type::Value>> &column_stats_vector);
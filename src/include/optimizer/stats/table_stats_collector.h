@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "optimizer/stats/column_stats_collector.h"
@@ -26,29 +27,56 @@ namespace optimizer {
 //===--------------------------------------------------------------------===//
 class TableStatsCollector {
  public:
+  using ColumnStatsCollectors =
+      std::vector<std::unique_ptr<ColumnStatsCollector>>;
+
+  // Minimum number of tile groups handed to each ANALYZE worker. Smaller
+  // tables are scanned by fewer threads since spawning them costs more than
+  // the scan itself.
+  static constexpr size_t kMinTileGroupsPerWorker = 8;
+
   TableStatsCollector(storage::DataTable* table);
 
   ~TableStatsCollector();
 
+  // Collect stats using the analyze_worker_count and analyze_sample_rate
+  // settings.
   void CollectColumnStats();
 
+  // Collect stats with at most max_worker_count threads over a block sample
+  // of roughly sample_rate of the tile groups. Each worker fills its own
+  // column collectors which are merged once all workers are done.
+  void CollectColumnStats(size_t max_worker_count, double sample_rate);
+
   inline size_t GetActiveTupleCount() { return active_tuple_count_; }
 
+  inline size_t GetSampledTupleCount() { return sampled_tuple_count_; }
+
   inline size_t GetColumnCount() { return column_count_; }
 
+  inline size_t GetWorkerCount() { return worker_count_; }
+
   ColumnStatsCollector* GetColumnStats(oid_t column_id);
 
  private:
   storage::DataTable* table_;
   catalog::Schema* schema_;
-  std::vector<std::unique_ptr<ColumnStatsCollector>> column_stats_collectors_;
+  ColumnStatsCollectors column_stats_collectors_;
   size_t active_tuple_count_;
+  size_t sampled_tuple_count_;
   size_t column_count_;
+  size_t worker_count_;
 
   TableStatsCollector(const TableStatsCollector&);
   void operator=(const TableStatsCollector&);
 
-  void InitColumnStatsCollectors();
+  void InitColumnStatsCollectors(ColumnStatsCollectors& collectors);
+
+  std::vector<oid_t> SampleTileGroups(double sample_rate);
+
+  void CollectTileGroupStats(const std::vector<oid_t>& tile_group_offsets,
+                             size_t begin, size_t end,
+                             ColumnStatsCollectors& collectors);
 };
 
 }  // namespace optimizer
@@ -16,8 +16,11 @@
 #include <cstdio>
 #include <cstring>
 #include <string>
+#include <functional>
 #include <stack>
 #include <queue>
+#include <set>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 
@@ -41,6 +44,7 @@ class TopKElements {
   template <class T, class Container, class Compare>
   class UpdatableQueue;
   class TopKQueue;
+  class CandidateSet;
 
   /*
    * Class Definition
@@ -519,14 +523,127 @@ class TopKElements {
 
   };  // end of class TopKQueue
 
+  /*
+   * CandidateSet
+   *    The most frequent items, like a TopKQueue, but indexed by item
+   *    so that updating an entry doesn't scan the queue
+   */
+  class CandidateSet {
+   public:
+    CandidateSet(int param_capacity) : capacity{param_capacity} {}
+
+    // by_count points into counts, so it's rebuilt rather than copied
+    CandidateSet(const CandidateSet& other)
+        : capacity{other.capacity}, counts{other.counts} {
+      rebuild_index();
+    }
+
+    CandidateSet& operator=(const CandidateSet& other) {
+      capacity = other.capacity;
+      counts = other.counts;
+      rebuild_index();
+      return *this;
+    }
+
+    int get_capacity() const { return capacity; }
+
+    int get_size() const { return static_cast<int>(counts.size()); }
+
+    bool is_exist(const ApproxTopEntry& entry) const {
+      return counts.count(entry.approx_top_elem) != 0;
+    }
+
+    /*
+     * Set the count of an entry. A new entry is only kept if there is room,
+     * or if it is more frequent than the least frequent one, which it then
+     * replaces.
+     */
+    void update(const ApproxTopEntry& entry) {
+      auto it = counts.find(entry.approx_top_elem);
+      if (it != counts.end()) {
+        by_count.erase(std::make_pair(it->second, &it->first));
+        it->second = entry.approx_count;
+        by_count.emplace(it->second, &it->first);
+        return;
+      }
+
+      if (get_size() >= capacity) {
+        if (capacity == 0 || by_count.begin()->first >= entry.approx_count) {
+          return;
+        }
+        auto least = by_count.begin()->second;
+        by_count.erase(by_count.begin());
+        counts.erase(*least);
+      }
+      it = counts.emplace(entry.approx_top_elem, entry.approx_count).first;
+      by_count.emplace(it->second, &it->first);
+    }
+
+    /*
+     * Remove an entry if it's there
+     */
+    void remove(const ApproxTopEntry& entry) {
+      auto it = counts.find(entry.approx_top_elem);
+      if (it == counts.end()) return;
+      by_count.erase(std::make_pair(it->second, &it->first));
+      counts.erase(it);
+    }
+
+    /*
+     * Retrieve all the items in the set, unordered
+     */
+    std::vector<ApproxTopEntry> retrieve_all() const {
+      std::vector<ApproxTopEntry> vec;
+      for (auto& count : counts) {
+        vec.emplace_back(count.first, count.second);
+      }
+      return vec;
+    }
+
+   private:
+    void rebuild_index() {
+      by_count.clear();
+      for (auto& count : counts) {
+        by_count.emplace(count.second, &count.first);
+      }
+    }
+
+    struct ElemHash {
+      size_t operator()(const ApproxTopEntryElem& elem) const {
+        if (elem.item_type == ApproxTopEntryElem::ElemType::INT_TYPE) {
+          return std::hash<int64_t>()(elem.int_item);
+        }
+        return std::hash<std::string>()(elem.str_item);
+      }
+    };
+
+    // the maximum number of entries
+    int capacity;
+    // the count of each entry
+    std::unordered_map<ApproxTopEntryElem, int64_t, ElemHash> counts;
+    // the entries ordered by count, least frequent first
+    std::set<std::pair<int64_t, const ApproxTopEntryElem*>> by_count;
+
+  };  // end of class CandidateSet
+
+  /*
+   * Number of candidates kept per top k entry. An item that is not among the
+   * top k of a partition, but among its k * kCandidateFactor most frequent
+   * items, is still considered when partitions are merged.
+   */
+  static constexpr int kCandidateFactor = 4;
+
   // TopKElements members
   TopKQueue tkq;
+  // the k * kCandidateFactor most frequent items, a superset of tkq
+  CandidateSet candidates;
   CountMinSketch cmsketch;
 
   /*
    * TopKElements Constructor
    */
-  TopKElements(CountMinSketch& sketch, int k) : tkq{k}, cmsketch{sketch} {}
+  TopKElements(CountMinSketch& sketch, int k)
+      : tkq{k}, candidates{k * kCandidateFactor}, cmsketch{sketch} {}
 
   /*
    * Add an item into this bookkeeping datastructure as well as
@@ -641,6 +758,42 @@ class TopKElements {
     DecrFreqItem(e);
   }
 
+  /*
+   * Merge another TopKElements into this one.
+   * The sketches are merged first; the candidates of both sides are then
+   * re-estimated against the merged sketch, and the top k are the most
+   * frequent of the candidates that are kept. An item
+   * that is frequent overall but below the k * kCandidateFactor most frequent
+   * items of every partition is still missed.
+   */
+  void Merge(const TopKElements& other) {
+    cmsketch.Merge(other.cmsketch);
+
+    std::vector<ApproxTopEntry> entries = candidates.retrieve_all();
+    std::vector<ApproxTopEntry> other_entries =
+        other.candidates.retrieve_all();
+    entries.insert(entries.end(), other_entries.begin(), other_entries.end());
+
+    CandidateSet merged_candidates{candidates.get_capacity()};
+    for (auto& entry : entries) {
+      if (merged_candidates.is_exist(entry)) continue;
+      const ApproxTopEntryElem& elem = entry.approx_top_elem;
+      if (elem.item_type == ApproxTopEntryElem::ElemType::INT_TYPE) {
+        entry.approx_count = cmsketch.EstimateItemCount(elem.int_item);
+      } else {
+        entry.approx_count = cmsketch.EstimateItemCount(elem.str_item.c_str());
+      }
+      merged_candidates.update(entry);
+    }
+
+    TopKQueue merged{tkq.get_k()};
+    for (auto& entry : merged_candidates.retrieve_all()) {
+      merged.push(entry);
+    }
+    tkq = merged;
+    candidates = merged_candidates;
+  }
+
   /*
    * Top K Elements Retrieval Functions
    */
@@ -818,6 +971,7 @@ class TopKElements {
       // update
       tkq.update(entry);
     }
+    candidates.update(entry);
   }
 
   /*
@@ -836,6 +990,12 @@ class TopKElements {
         tkq.update(entry);
       }
     }
+
+    if (entry.approx_count == 0) {
+      candidates.remove(entry);
+    } else if (candidates.is_exist(entry)) {
+      candidates.update(entry);
+    }
   }
 
 };  // end of class TopKElements
@@ -16,6 +16,7 @@
 #include "parser/pg_query.h"
 #include "parser/statements.h"
 #include "common/internal_types.h"
+#include "type/value.h"
 
 namespace peloton {
 namespace parser {
@@ -52,11 +53,25 @@ class PostgresParser {
   std::unique_ptr<parser::SQLStatementList> BuildParseTree(
       const std::string &query_string);
 
+  // Replace the literals of a SELECT, INSERT, UPDATE or DELETE query that can
+  // be bound late with parameters ($1, $2, ...), and collect their values in
+  // order. Literals that the planner needs (e.g. LIMIT) are kept. Returns
+  // false if the query cannot be parameterized.
+  static bool ParameterizeQuery(const std::string &query,
+                                std::string &parameterized_query,
+                                std::vector<type::Value> &params);
+
  private:
   //===--------------------------------------------------------------------===//
   // Helper Functions
   //===--------------------------------------------------------------------===//
 
+  // Length of the literal at pos of the query, 0 if there is none
+  static size_t LiteralLength(const std::string &query, size_t pos);
+
+  // Value of a literal, as the parse tree transform would read it
+  static type::Value LiteralValue(const std::string &literal);
+
   static FKConstrActionType CharToActionType(char &type) {
     switch (type) {
       case 'a':
@@ -37,6 +37,21 @@ class CopyPlan : public AbstractPlan {
     LOG_DEBUG("Creating a Copy Plan");
   }
 
+  // Plan to load the file into the table
+  CopyPlan(storage::DataTable *table, std::string file_path,
+           CopyType copy_type, char delimiter)
+      : file_path(file_path),
+        copy_type(copy_type),
+        delimiter(delimiter),
+        target_table(table) {
+    LOG_DEBUG("Creating a Copy Plan for import");
+  }
+
+  inline bool IsImport() const {
+    return copy_type == CopyType::IMPORT_CSV ||
+           copy_type == CopyType::IMPORT_TSV;
+  }
+
   inline PlanNodeType GetPlanNodeType() const { return PlanNodeType::COPY; }
 
   const std::string GetInfo() const { return "CopyPlan"; }
@@ -50,6 +65,14 @@ class CopyPlan : public AbstractPlan {
   // Whether the copying requires deserialization of parameters
   bool deserialize_parameters = false;
 
+  CopyType copy_type = CopyType::EXPORT_OTHER;
+
+  // Field delimiter of the imported or exported file
+  char delimiter = ',';
+
+  // The table to load the imported file into, or to export
+  storage::DataTable *target_table = nullptr;
+
  private:
   DISALLOW_COPY_AND_MOVE(CopyPlan);
 };
@@ -59,8 +59,10 @@ class MergeJoinPlan : public AbstractJoinPlan {
                             const BindingContext &input) override {
     for (auto &join_clause : *GetJoinClauses()) {
       auto &exp = from_left ? join_clause.left_ : join_clause.right_;
+      // The clauses are evaluated against both tuples, with the right ones
+      // referring to the second
       const_cast<expression::AbstractExpression *>(exp.get())
-          ->PerformBinding({&input});
+          ->PerformBinding({&input, &input});
     }
   }
 
@@ -74,6 +76,28 @@ class MergeJoinPlan : public AbstractJoinPlan {
 
   const std::string GetInfo() const override { return "MergeJoin"; }
 
+  hash_t Hash() const override {
+    hash_t hash = AbstractJoinPlan::Hash();
+    for (const auto &join_clause : join_clauses_) {
+      hash = HashUtil::CombineHashes(hash, join_clause.left_->Hash());
+      hash = HashUtil::CombineHashes(hash, join_clause.right_->Hash());
+    }
+    return HashUtil::CombineHashes(hash, AbstractPlan::Hash());
+  }
+
+  bool operator==(const AbstractPlan &rhs) const override {
+    if (!AbstractJoinPlan::operator==(rhs)) return false;
+    const auto &other = static_cast<const MergeJoinPlan &>(rhs);
+    if (join_clauses_.size() != other.join_clauses_.size()) return false;
+    for (size_t i = 0; i < join_clauses_.size(); i++) {
+      if (*join_clauses_[i].left_ != *other.join_clauses_[i].left_ ||
+          *join_clauses_[i].right_ != *other.join_clauses_[i].right_ ||
+          join_clauses_[i].reversed_ != other.join_clauses_[i].reversed_)
+        return false;
+    }
+    return AbstractPlan::operator==(rhs);
+  }
+
   std::unique_ptr<AbstractPlan> Copy() const override {
     std::vector<JoinClause> new_join_clauses;
     for (size_t i = 0; i < join_clauses_.size(); i++) {
@@ -83,7 +107,7 @@ class MergeJoinPlan : public AbstractJoinPlan {
     }
 
     std::unique_ptr<const expression::AbstractExpression> predicate_copy(
-        GetPredicate()->Copy());
+        GetPredicate() ? GetPredicate()->Copy() : nullptr);
     std::shared_ptr<const catalog::Schema> schema_copy(
         catalog::Schema::CopySchema(GetSchema()));
     MergeJoinPlan *new_plan = new MergeJoinPlan(
@@ -43,6 +43,17 @@ SETTING_bool(rpc_enabled,
              "Enable rpc, this should be turned off when testing",
              false, false, false)
 
+// Serves the metrics registry in a text format to local scrapers, without
+// going through the SQL path
+SETTING_bool(metrics_endpoint,
+             "Enable the local metrics endpoint (default: false)",
+             false, false, false)
+
+SETTING_int(metrics_port,
+            "Port of the local metrics endpoint (default: 15722)",
+            15722,
+            false, false)
+
 // Socket family
 SETTING_string(socket_family,
               "Socket family (default: AF_INET)",
@@ -101,6 +112,62 @@ SETTING_int(connection_thread_count,
             "Number of connection threads (default: std::hardware_concurrency())",
             std::thread::hardware_concurrency(), false, false)
 
+// Store short keys in ART leaves so lookups don't read them from the table
+SETTING_bool(art_inline_keys,
+             "Store keys of at most 32 bytes in ART index leaves "
+                 "(default: false)",
+             false, true, true)
+
+// Store the MVCC fields read by visibility checks in dense per-tile group
+// arrays. This only affects tile groups created after the setting changes.
+SETTING_bool(columnar_mvcc_header,
+             "Store tuple txn ids and begin/end commit ids in separate arrays "
+                 "(default: false)",
+             false, true, true)
+
+// Let the GC mark full tile groups all-visible once their versions are older
+// than every active transaction, so that scans skip the visibility checks.
+// Deduplication and cold storage only apply to all-visible tile groups, so
+// enabling either of them enables this as well.
+SETTING_bool(tile_group_freezing,
+             "Mark old, full tile groups all-visible (default: false)",
+             false, true, true)
+
+// Let equal varchar values of tile groups share one allocation once the GC
+// marks them all-visible, and keep their value ranges in memory for pruning
+// scans. Fixed-width columns are not compressed.
+SETTING_bool(tile_group_varlen_dedup,
+             "Deduplicate the varchar values of all-visible tile groups "
+                 "(default: false)",
+             false, true, true)
+
+// Move the tuples of mostly empty tile groups into other tile groups, and
+// release their memory once they are empty
+SETTING_bool(tile_group_compaction,
+             "Compact sparse tile groups (default: false)",
+             false, true, true)
+
+SETTING_double(tile_group_compaction_threshold,
+               "Fraction of a full tile group's slots that must be in use "
+                   "for it not to be compacted (default: 0.1)",
+               0.1, true, true)
+
+// Move the tuple data of all-visible tile groups that were not accessed for a
+// while into memory-mapped segment files
+SETTING_bool(cold_storage,
+             "Evict cold tile groups to segment files (default: false)",
+             false, true, true)
+
+SETTING_int(cold_storage_threshold,
+            "Time (in ms) an all-visible tile group must go unaccessed "
+                "before it is evicted (default: 60000)",
+            60000, true, true)
+
+SETTING_string(cold_storage_directory,
+               "Directory of the segment files of evicted tile groups "
+                   "(default: /tmp)",
+               "/tmp", false, false)
+
 //===----------------------------------------------------------------------===//
 // WRITE AHEAD LOG
 //===----------------------------------------------------------------------===//
@@ -129,6 +196,13 @@ SETTING_int(stats_mode,
            static_cast<int>(peloton::StatsType::INVALID),
            true, true)
 
+// Latency percentiles only cover the latencies recorded in the last few
+// aggregation intervals
+SETTING_int(stats_latency_window,
+            "Number of stats aggregation intervals latency percentiles are "
+                "computed over, 0 covers all latencies (default: 10)",
+            10, true, true)
+
 //===----------------------------------------------------------------------===//
 // AI
 //===----------------------------------------------------------------------===//
@@ -145,6 +219,14 @@ SETTING_bool(layout_tuner,
             false,
             true, true)
 
+// Bound the work the layout tuner does moving existing tile groups to the
+// tuned layout
+SETTING_int(layout_tuner_transform_rate,
+            "Maximum number of tile groups the layout tuner transforms per "
+            "second (default: 100)",
+            100,
+            true, true)
+
 //===----------------------------------------------------------------------===//
 // BRAIN
 //===----------------------------------------------------------------------===//
@@ -195,12 +277,84 @@ SETTING_bool(hash_join_bloom_filter,
              true,
              true, true)
 
+// Order multi-way inner joins before exploring the memo, instead of searching
+// the orders with the join associativity rule. Off until its plans have been
+// compared against the associativity search.
+SETTING_bool(join_order_enumeration,
+             "Enumerate the order of inner joins with dynamic programming "
+                 "(default: false)",
+             false, true, true)
+
+SETTING_int(join_order_dp_threshold,
+            "Maximum number of tables a join is ordered with dynamic "
+                "programming, larger joins are ordered greedily (default: 12)",
+            12, true, true)
+
+// Plan simple queries with their literals replaced by parameters, and share
+// the plans across connections
+SETTING_bool(shared_plan_cache,
+             "Cache the plans of parameterized simple queries across "
+                 "connections (default: false)",
+             false, true, true)
+
+SETTING_int(shared_plan_cache_size,
+            "Maximum number of distinct queries kept in the shared plan "
+                "cache (default: 1024)",
+            1024, true, true)
+
+// Reuse the plans the optimizer picked for the same operator tree, until the
+// stats or the sizes of the tables they read change
+SETTING_bool(plan_template_cache,
+             "Cache the plans picked by the optimizer across executions "
+                 "(default: false)",
+             false, true, true)
+
+SETTING_int(plan_template_cache_size,
+            "Maximum number of distinct operator trees kept in the plan "
+                "template cache (default: 1024)",
+            1024, true, true)
+
+SETTING_double(plan_template_drift_ratio,
+               "Re-optimize a cached plan once a table it reads grew or "
+                   "shrank by this factor (default: 2.0)",
+               2.0, true, true)
+
 SETTING_int(task_execution_timeout,
             "Maximum allowed length of time (in ms) for task "
                 "execution step of optimizer, "
                 "assuming one plan has been found (default 5000)",
             5000, true, true)
 
+SETTING_int(analyze_worker_count,
+            "Maximum number of threads used by ANALYZE to scan a table "
+                "(default: std::hardware_concurrency())",
+            std::thread::hardware_concurrency(), true, true)
+
+SETTING_int(copy_worker_count,
+            "Maximum number of threads used by COPY to load or export a "
+                "table (default: std::hardware_concurrency())",
+            std::thread::hardware_concurrency(), true, true)
+
+SETTING_double(analyze_sample_rate,
+               "Fraction of tile groups sampled by ANALYZE, "
+                   "1.0 scans the whole table (default: 1.0)",
+               1.0, true, true)
+
+SETTING_bool(stats_refresh,
+             "Re-analyze tables in the background once enough of their "
+                 "tuples changed (default: false)",
+             false, true, true)
+
+SETTING_double(stats_refresh_threshold,
+               "Fraction of a table's rows that must be modified before its "
+                   "stats are refreshed (default: 0.2)",
+               0.2, true, true)
+
+SETTING_int(stats_refresh_interval,
+            "Interval (in ms) between checks for stale table stats "
+                "(default: 1000)",
+            1000, true, true)
+
 //===----------------------------------------------------------------------===//
 // GENERAL
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// access_counter_array.h
+//
+// Identification: src/include/statistics/access_counter_array.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "catalog/catalog_defaults.h"
+#include "common/internal_types.h"
+#include "common/platform.h"
+#include "statistics/access_metric.h"
+
+namespace peloton {
+namespace stats {
+
+/**
+ * Access counters of a single table or index, padded to a cache line. Only
+ * the owning worker thread bumps them, so it does so with plain stores, while
+ * the aggregator thread reads them at any time.
+ */
+struct CACHE_ALIGNED AccessCounters {
+  std::atomic<int64_t> reads{0};
+  std::atomic<int64_t> updates{0};
+  std::atomic<int64_t> inserts{0};
+  std::atomic<int64_t> deletes{0};
+
+  oid_t database_id = INVALID_OID;
+  oid_t table_id = INVALID_OID;
+  oid_t oid = INVALID_OID;
+
+  // Set once the ids above are filled in
+  std::atomic<bool> in_use{false};
+
+  static inline void Add(std::atomic<int64_t> &counter, int64_t count) {
+    counter.store(counter.load(std::memory_order_relaxed) + count,
+                  std::memory_order_relaxed);
+  }
+
+  // Adds the counters to the access metric
+  void AggregateInto(AccessMetric &access) const {
+    access.IncrementReads(reads.load(std::memory_order_relaxed));
+    access.IncrementUpdates(updates.load(std::memory_order_relaxed));
+    access.IncrementInserts(inserts.load(std::memory_order_relaxed));
+    access.IncrementDeletes(deletes.load(std::memory_order_relaxed));
+  }
+};
+
+/**
+ * The access counters of one worker thread for all tables (or all indexes),
+ * indexed by oid. The array grows one chunk at a time, and chunks are only
+ * freed with the array, so the aggregator can walk it while the worker keeps
+ * counting.
+ */
+class AccessCounterArray {
+ public:
+  AccessCounterArray();
+  ~AccessCounterArray();
+
+  // Returns the counters of the table or index with the given oid
+  inline AccessCounters &GetCounters(oid_t database_id, oid_t table_id,
+                                     oid_t oid) {
+    oid_t offset = oid & kOidMask;
+    auto *chunk = chunks_[offset / kChunkSize].load(std::memory_order_acquire);
+    if (chunk == nullptr) {
+      chunk = AllocateChunk(offset / kChunkSize);
+    }
+
+    auto &counters = chunk[offset % kChunkSize];
+    if (!counters.in_use.load(std::memory_order_relaxed)) {
+      counters.database_id = database_id;
+      counters.table_id = table_id;
+      counters.oid = oid;
+      counters.in_use.store(true, std::memory_order_release);
+    }
+    return counters;
+  }
+
+  // Calls func with the counters of every table or index counted so far. Safe
+  // to call from any thread.
+  template <typename Func>
+  void ForEach(Func func) const {
+    for (size_t i = 0; i < kNumChunks; i++) {
+      auto *chunk = chunks_[i].load(std::memory_order_acquire);
+      if (chunk == nullptr) {
+        continue;
+      }
+      for (size_t j = 0; j < kChunkSize; j++) {
+        if (chunk[j].in_use.load(std::memory_order_acquire)) {
+          func(chunk[j]);
+        }
+      }
+    }
+  }
+
+  // Sets all counters to zero
+  void Reset();
+
+ private:
+  // Oids carry their catalog type in the high bits, which are the same for
+  // all the objects in an array
+  static const oid_t kOidMask = (1 << CATALOG_TYPE_OFFSET) - 1;
+  static const size_t kChunkSize = 1024;
+  static const size_t kNumChunks = (kOidMask + 1) / kChunkSize;
+
+  AccessCounters *AllocateChunk(size_t chunk_id);
+
+  std::unique_ptr<std::atomic<AccessCounters *>[]> chunks_;
+};
+
+}  // namespace stats
+}  // namespace peloton
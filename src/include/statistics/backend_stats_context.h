@@ -21,6 +21,7 @@
 #include "common/container/cuckoo_map.h"
 #include "common/container/lock_free_queue.h"
 #include "common/synchronization/spin_latch.h"
+#include "statistics/access_counter_array.h"
 #include "statistics/table_metric.h"
 #include "statistics/index_metric.h"
 #include "statistics/latency_metric.h"
@@ -48,7 +49,7 @@ class BackendStatsContext {
  public:
   static BackendStatsContext* GetInstance();
 
-  BackendStatsContext(size_t max_latency_history, bool regiser_to_aggregator);
+  explicit BackendStatsContext(bool register_to_aggregator);
   ~BackendStatsContext();
 
   //===--------------------------------------------------------------------===//
@@ -79,8 +80,29 @@ class BackendStatsContext {
   // Returns the latency metric
   LatencyMetric& GetTxnLatencyMetric();
 
+  // Returns the latency metric of txn commits
+  LatencyMetric& GetCommitLatencyMetric() { return commit_latencies_; }
+
+  // Returns the metric of the time taken to JIT compile queries
+  LatencyMetric& GetCompileLatencyMetric() { return compile_latencies_; }
+
+  // Returns the metric of the time taken to pick plans for queries
+  LatencyMetric& GetOptimizeLatencyMetric() { return optimize_latencies_; }
+
+  // Returns the latency metric of queries of the given type
+  LatencyMetric& GetQueryLatencyMetric(QueryType query_type);
+
+  // Returns the number of txns committed (or aborted) in all databases. Safe
+  // to call from any thread.
+  int64_t GetTxnsCommitted() const {
+    return txns_committed_.load(std::memory_order_relaxed);
+  }
+  int64_t GetTxnsAborted() const {
+    return txns_aborted_.load(std::memory_order_relaxed);
+  }
+
   // Increment the read stat for given tile group
-  void IncrementTableReads(oid_t tile_group_id);
+  void IncrementTableReads(oid_t tile_group_id, int64_t count = 1);
 
   // Increment the insert stat for given tile group
   void IncrementTableInserts(oid_t tile_group_id);
@@ -127,6 +149,10 @@ class BackendStatsContext {
   // (e.g., sets all counters to zero)
   void Reset();
 
+  // Computes the measurements of all latency metrics, once all contexts
+  // were aggregated
+  void ComputeLatencies();
+
   std::string ToString() const;
 
   // Returns the total number of query aggregated so far
@@ -168,7 +194,24 @@ class BackendStatsContext {
   std::thread::id thread_id_;
 
   // Latencies recorded by this worker
-  LatencyMetric txn_latencies_;
+  LatencyMetric txn_latencies_{MetricType::LATENCY, "TXN LATENCY"};
+
+  LatencyMetric commit_latencies_{MetricType::LATENCY, "COMMIT LATENCY"};
+
+  LatencyMetric compile_latencies_{MetricType::LATENCY, "COMPILE TIME"};
+
+  LatencyMetric optimize_latencies_{MetricType::LATENCY, "OPTIMIZE TIME"};
+
+  // Query latencies, indexed by query type
+  std::vector<std::unique_ptr<LatencyMetric>> query_latencies_;
+
+  // The type of the on going query
+  QueryType ongoing_query_type_ = QueryType::QUERY_INVALID;
+
+  // Txns committed and aborted in all databases. Unlike the database metrics,
+  // these can be read while the worker keeps counting.
+  std::atomic<int64_t> txns_committed_{0};
+  std::atomic<int64_t> txns_aborted_{0};
 
   // Whether this context is registered to the global aggregator
   bool is_registered_to_aggregator_;
@@ -179,6 +222,15 @@ class BackendStatsContext {
   // Index oid spin lock
   common::synchronization::SpinLatch index_id_lock;
 
+  // Table and index accesses counted by this worker. They're folded into the
+  // table and index metrics of the aggregated stats.
+  AccessCounterArray table_counters_;
+  AccessCounterArray index_counters_;
+
+  // The last tile group accessed and the counters of its table
+  oid_t cached_tile_group_id_ = INVALID_OID;
+  AccessCounters *cached_table_counters_ = nullptr;
+
   //===--------------------------------------------------------------------===//
   // HELPER FUNCTIONS
   //===--------------------------------------------------------------------===//
@@ -186,6 +238,12 @@ class BackendStatsContext {
   // Mark the on going query as completed and move it to completed query queue
   void CompleteQueryMetric();
 
+  // Returns the counters of the table the tile group belongs to
+  AccessCounters& GetTableCounters(oid_t tile_group_id);
+
+  // Returns the counters of the index
+  AccessCounters& GetIndexCounters(index::IndexMetadata* metadata);
+
   // Get the mapping table of backend stat context for each thread
   static CuckooMap<std::thread::id, std::shared_ptr<BackendStatsContext>> &
     GetBackendContextMap(void);
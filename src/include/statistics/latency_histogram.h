@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// latency_histogram.h
+//
+// Identification: src/include/statistics/latency_histogram.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace peloton {
+namespace stats {
+
+/**
+ * A log-bucketed histogram of latencies, in the style of HdrHistogram.
+ * Latencies are counted in microseconds. Values below 64us get a bucket each;
+ * above that every power of two is split into 32 buckets, which keeps the
+ * error of a percentile under ~3% for latencies of up to 2^36us (~19 hours).
+ *
+ * Recording is constant time and lock-free, but only one thread may record
+ * into (or merge into) a histogram. Any other thread can read it, or merge it
+ * into its own histogram, while that thread keeps recording. The buckets are
+ * allocated on the first record, so unused histograms stay small.
+ */
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+  LatencyHistogram(const LatencyHistogram &other);
+  LatencyHistogram &operator=(const LatencyHistogram &other);
+  ~LatencyHistogram();
+
+  // Records a latency, given in ms
+  void Record(double latency_ms);
+
+  // Adds the counts of the source histogram
+  void Merge(const LatencyHistogram &source);
+
+  // Removes the counts of an earlier copy of this histogram, leaving the
+  // latencies recorded since the copy was taken
+  void Subtract(const LatencyHistogram &earlier);
+
+  // Sets all counts to zero
+  void Reset();
+
+  // Number of latencies recorded
+  inline uint64_t GetCount() const {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  // Sum of all latencies recorded, in ms
+  inline double GetSum() const {
+    return sum_us_.load(std::memory_order_relaxed) / 1000.0;
+  }
+
+  // Returns the latency (in ms) that the given fraction of all the latencies
+  // recorded don't exceed, e.g. 0.99 for the 99th percentile
+  double GetPercentile(double fraction) const;
+
+  // Smallest and largest latency recorded, in ms
+  double GetMin() const { return GetPercentile(0.0); }
+  double GetMax() const { return GetPercentile(1.0); }
+
+ private:
+  static const uint32_t kSubBucketBits = 6;
+  static const uint64_t kSubBucketCount = 1ull << kSubBucketBits;
+  static const uint64_t kSubBucketHalfCount = kSubBucketCount / 2;
+  static const uint32_t kMaxValueBits = 36;
+  static const uint64_t kMaxValue = (1ull << kMaxValueBits) - 1;
+  static const size_t kNumBuckets =
+      kSubBucketCount +
+      (kMaxValueBits - kSubBucketBits) * kSubBucketHalfCount;
+
+  // Returns the bucket a latency (in us) is counted in
+  static inline size_t GetBucketIndex(uint64_t value) {
+    if (value < kSubBucketCount) {
+      return value;
+    }
+    uint32_t msb = 63 - __builtin_clzll(value);
+    uint32_t shift = msb - kSubBucketBits + 1;
+    return kSubBucketCount + (shift - 1) * kSubBucketHalfCount +
+           ((value >> shift) - kSubBucketHalfCount);
+  }
+
+  // Returns the latency (in us) a bucket stands for, the middle of its range
+  static uint64_t GetBucketValue(size_t index);
+
+  static inline void Add(std::atomic<uint64_t> &counter, uint64_t count) {
+    counter.store(counter.load(std::memory_order_relaxed) + count,
+                  std::memory_order_relaxed);
+  }
+
+  // Returns the buckets, allocating them if needed
+  std::atomic<uint64_t> *GetBuckets();
+
+  std::atomic<std::atomic<uint64_t> *> buckets_{nullptr};
+
+  std::atomic<uint64_t> count_{0};
+
+  std::atomic<uint64_t> sum_us_{0};
+};
+
+}  // namespace stats
+}  // namespace peloton
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <deque>
 #include <string>
 #include <sstream>
 
@@ -19,15 +20,15 @@
 #include "common/macros.h"
 #include "common/internal_types.h"
 #include "common/exception.h"
-#include "common/container/circular_buffer.h"
 #include "statistics/abstract_metric.h"
-#include <mutex>
+#include "statistics/latency_histogram.h"
 
 namespace peloton {
 namespace stats {
 
 // Container for different latency measurements
 struct LatencyMeasurements {
+  uint64_t count_ = 0;
   double average_ = 0.0;
   double min_ = 0.0;
   double max_ = 0.0;
@@ -35,22 +36,25 @@ struct LatencyMeasurements {
   double perc_25th_ = 0.0;
   double perc_75th_ = 0.0;
   double perc_99th_ = 0.0;
+  double perc_999th_ = 0.0;
 };
 
 /**
- * Metric for storing raw latency values and computing
- * latency measurements.
+ * Metric for recording latencies into a histogram and computing latency
+ * measurements over a window of recent aggregation intervals.
  */
 class LatencyMetric : public AbstractMetric {
  public:
-  LatencyMetric(MetricType type, size_t max_history);
+  LatencyMetric(MetricType type, const std::string &name = "TXN LATENCY");
 
   //===--------------------------------------------------------------------===//
   // HELPER METHODS
   //===--------------------------------------------------------------------===//
 
+  // Clears the latencies recorded. The history the window is computed over is
+  // kept, since the aggregator resets its metrics every interval.
   inline void Reset() {
-    latencies_.Clear();
+    latencies_.Reset();
     timer_ms_.Reset();
   }
 
@@ -63,57 +67,64 @@ class LatencyMetric : public AbstractMetric {
   // Stops the latency timer and records the total time elapsed
   inline void RecordLatency() {
     timer_ms_.Stop();
-    double latency_value = timer_ms_.GetDuration();
-    // Record this latency only if we can do so without blocking.
-    // Occasionally losing single latency measurements is fine.
-    {
-      std::unique_lock<std::mutex> lock(latency_mutex_, std::defer_lock);
-      if (lock.try_lock()) {
-        latencies_.PushBack(latency_value);
-      }
+    RecordLatency(timer_ms_.GetDuration());
+  }
+
+  // Records a latency (in ms) measured elsewhere
+  inline void RecordLatency(double latency_ms) {
+    if (latencies_.GetCount() == 0) {
+      first_latency_ = latency_ms;
     }
+    latencies_.Record(latency_ms);
   }
 
   // Returns the first latency value recorded
   inline double GetFirstLatencyValue() {
-    PL_ASSERT(latencies_.begin() != latencies_.end());
-    return *(latencies_.begin());
+    PL_ASSERT(latencies_.GetCount() != 0);
+    return first_latency_;
   }
 
-  // Computes the latency measurements using the latencies
-  // collected so far.
+  // Returns the histogram of all latencies recorded
+  inline const LatencyHistogram &GetHistogram() const { return latencies_; }
+
+  // Computes the latency measurements over the latencies recorded within the
+  // last stats_latency_window calls
   void ComputeLatencies();
 
-  // Combines the source latency metric with this latency metric
+  // Returns the result of the last call to ComputeLatencies()
+  inline const LatencyMeasurements &GetLatencyMeasurements() const {
+    return latency_measurements_;
+  }
+
+  // Combines the source latency metric with this latency metric. The source
+  // may keep recording meanwhile.
   void Aggregate(AbstractMetric &source);
 
   // Returns a string representation of this latency metric
   const std::string GetInfo() const;
 
-  // Returns a copy of the latencies collected
-  CircularBuffer<double> Copy();
-
  private:
   //===--------------------------------------------------------------------===//
   // MEMBERS
   //===--------------------------------------------------------------------===//
 
-  // Circular buffer with capacity N that stores the <= N
-  // most recent latencies collected
-  CircularBuffer<double> latencies_;
+  // The name printed with the measurements
+  std::string name_;
+
+  // All latencies recorded since the last reset
+  LatencyHistogram latencies_;
+
+  // The first latency recorded since the last reset
+  double first_latency_ = 0.0;
+
+  // Copies of latencies_ taken by the last calls to ComputeLatencies()
+  std::deque<LatencyHistogram> history_;
 
   // Timer for timing individual latencies
   Timer<std::ratio<1, 1000>> timer_ms_;
 
   // Stores result of last call to ComputeLatencies()
   LatencyMeasurements latency_measurements_;
-
-  // The maximum number of latencies that can be stored
-  // (the capacity size N of the circular buffer)
-  size_t max_history_;
-
-  // Protects accesses to the circular buffer
-  std::mutex latency_mutex_;
 };
 
 }  // namespace stats
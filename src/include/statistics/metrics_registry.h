@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// metrics_registry.h
+//
+// Identification: src/include/statistics/metrics_registry.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "common/macros.h"
+#include "statistics/latency_histogram.h"
+
+namespace peloton {
+namespace stats {
+
+/**
+ * In-process registry of the metrics exposed to local scrapers. Metrics are
+ * read by callbacks when scraped, so the components they're taken from don't
+ * do any extra work until somebody asks, and scraping never goes through the
+ * SQL path or the metric catalog tables.
+ *
+ * Scrape() renders all metrics in the Prometheus text exposition format.
+ */
+class MetricsRegistry {
+ public:
+  // Reads the current value of a counter or gauge
+  using ValueFunc = std::function<double()>;
+
+  // Merges the latencies of a summary into the given histogram
+  using HistogramFunc = std::function<void(LatencyHistogram &)>;
+
+  DISALLOW_COPY_AND_MOVE(MetricsRegistry);
+
+  // Global singleton
+  static MetricsRegistry &GetInstance();
+
+  // Registers a value that only goes up, e.g. the number of txns committed.
+  // A metric registered under an existing name replaces it.
+  void RegisterCounter(const std::string &name, const std::string &help,
+                       ValueFunc func);
+
+  // Registers a value that goes up and down, e.g. a queue depth
+  void RegisterGauge(const std::string &name, const std::string &help,
+                     ValueFunc func);
+
+  // Registers latencies that are scraped as percentiles, a sum and a count
+  void RegisterSummary(const std::string &name, const std::string &help,
+                       HistogramFunc func);
+
+  void Unregister(const std::string &name);
+
+  // Registers the metrics of the storage, txn and execution layers: txn
+  // counts and latencies, GC backlog, epoch lag, JIT compile and optimize
+  // time, query and plan cache hits and task queue depth
+  void RegisterDefaultMetrics();
+
+  // Returns all metrics in the text exposition format
+  std::string Scrape();
+
+ private:
+  MetricsRegistry();
+
+  enum class MetricKind { COUNTER, GAUGE, SUMMARY };
+
+  struct Metric {
+    MetricKind kind;
+    std::string help;
+    ValueFunc value_func;
+    HistogramFunc histogram_func;
+  };
+
+  void Register(const std::string &name, Metric metric);
+
+  // Protects metrics_ and scrape_times_, and serializes scrapes
+  std::mutex mutex_;
+
+  // Ordered by name, so scrapes list the metrics in a stable order
+  std::map<std::string, Metric> metrics_;
+
+  // The time taken by each scrape, which is exposed as a metric itself
+  LatencyHistogram scrape_times_;
+};
+
+}  // namespace stats
+}  // namespace peloton
@@ -16,9 +16,9 @@
 #include <sstream>
 #include <vector>
 #include "common/internal_types.h"
+#include "common/timer.h"
 #include "statistics/abstract_metric.h"
 #include "statistics/access_metric.h"
-#include "statistics/latency_metric.h"
 #include "statistics/processor_metric.h"
 #include "util/string_util.h"
 
@@ -73,7 +73,8 @@ class QueryMetric : public AbstractMetric {
 
   inline AccessMetric &GetQueryAccess() { return query_access_; }
 
-  inline LatencyMetric &GetQueryLatency() { return latency_metric_; }
+  // Returns the latency (in ms) recorded by RecordLatency()
+  inline double GetLatency() const { return latency_ms_; }
 
   inline ProcessorMetric &GetProcessorMetric() { return processor_metric_; }
 
@@ -91,6 +92,13 @@ class QueryMetric : public AbstractMetric {
 
   inline void Reset() { query_access_.Reset(); }
 
+  // Records the time elapsed since the query started. The latency histograms
+  // are kept per thread and query type, so that a query does not carry one.
+  inline void RecordLatency() {
+    latency_timer_.Stop();
+    latency_ms_ = latency_timer_.GetDuration();
+  }
+
   void Aggregate(AbstractMetric &source);
 
   inline const std::string GetInfo() const {
@@ -119,8 +127,11 @@ class QueryMetric : public AbstractMetric {
   // The number of tuple accesses
   AccessMetric query_access_{MetricType::ACCESS};
 
-  // Latency metric
-  LatencyMetric latency_metric_{MetricType::LATENCY, 2};
+  // Times the query from its start
+  Timer<std::ratio<1, 1000>> latency_timer_;
+
+  // Latency (in ms) of the query
+  double latency_ms_ = 0.0;
 
   // Processor metric
   ProcessorMetric processor_metric_{MetricType::PROCESSOR};
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <functional>
 #include <mutex>
 #include <map>
 #include <vector>
@@ -33,8 +34,6 @@
 
 #define STATS_AGGREGATION_INTERVAL_MS 1000
 #define STATS_LOG_INTERVALS 10
-#define LATENCY_MAX_HISTORY_THREAD 100
-#define LATENCY_MAX_HISTORY_AGGREGATOR 10000
 
 class BackendStatsContext;
 
@@ -92,6 +91,10 @@ class StatsAggregator {
   // Utility function to get the metric table
   storage::DataTable *GetMetricTable(std::string table_name);
 
+  // Calls func with the stats context of every worker thread, and the stats
+  // history of the exited ones. Contexts can't be unregistered meanwhile.
+  void ForEachContext(std::function<void(BackendStatsContext &)> func);
+
   // Aggregate the stats of current living threads
   void Aggregate(int64_t &interval_cnt, double &alpha,
                  double &weighted_avg_throughput);
@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// cold_storage_manager.h
+//
+// Identification: src/include/storage/cold_storage_manager.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#include "common/internal_types.h"
+
+namespace peloton {
+namespace storage {
+
+//===--------------------------------------------------------------------===//
+// Cold Storage Manager
+//
+// Keeps the tuple data of cold tile groups in per-table segment files. The
+// data is mapped back privately, so the kernel pages it in when it is read
+// and may drop it again under memory pressure. Writes to a mapping stay in
+// memory and never reach the file.
+//
+// Segment files are unlinked as soon as they are created: they only back the
+// mappings of the running process and are not meant for recovery. Segments
+// only grow, but releasing a mapping punches a hole into the file where the
+// filesystem supports it, so the disk space of tiles that are gone is given
+// back before the table is dropped.
+//===--------------------------------------------------------------------===//
+
+class ColdStorageManager {
+ public:
+  // Global Singleton
+  static ColdStorageManager &GetInstance();
+
+  ~ColdStorageManager();
+
+  // Append the data to the segment of the table and map it back. Returns
+  // nullptr if the data could not be written.
+  char *Evict(const oid_t &table_id, const char *data, const size_t &size);
+
+  // Unmap data returned by Evict(), and free its space in the segment
+  void Release(char *address, const size_t &size);
+
+  // Stop appending to the segment of the table. Existing mappings stay valid,
+  // and the file is gone once the last of them is released.
+  void DropTable(const oid_t &table_id);
+
+  // Number of bytes of the mappings that were not released yet
+  size_t GetEvictedSize() const { return evicted_size_.load(); }
+
+  // Close every segment file. Only used by tests.
+  void Reset();
+
+ private:
+  ColdStorageManager();
+
+  struct Segment {
+    int fd;
+    size_t size;
+    // Tells a segment apart from a later one of the same table
+    uint64_t segment_id;
+  };
+
+  // Where the data of a mapping lives
+  struct Mapping {
+    oid_t table_id;
+    uint64_t segment_id;
+    size_t offset;
+  };
+
+  // Open a segment file for the table. Returns nullptr on failure.
+  Segment *GetSegment(const oid_t &table_id);
+
+  size_t page_size_;
+
+  std::mutex segments_lock_;
+
+  std::unordered_map<oid_t, Segment> segments_;
+
+  // Mappings returned by Evict(), by address
+  std::unordered_map<const char *, Mapping> mappings_;
+
+  uint64_t next_segment_id_ = 0;
+
+  std::atomic<size_t> evicted_size_{0};
+};
+
+}  // namespace storage
+}  // namespace peloton
@@ -137,6 +137,10 @@ class DataTable : public AbstractTable {
 
   void AddTileGroup(const std::shared_ptr<TileGroup> &tile_group);
 
+  // add a tile group with the default layout to the end of the table without
+  // making it active, so only the caller inserts into it. used by bulk loading.
+  std::shared_ptr<TileGroup> AppendTileGroup();
+
   // Offset is a 0-based number local to the table
   std::shared_ptr<storage::TileGroup> GetTileGroup(
       const std::size_t &tile_group_offset) const;
@@ -218,9 +222,16 @@ class DataTable : public AbstractTable {
   // TRANSFORMERS
   //===--------------------------------------------------------------------===//
 
+  // Copy the tile group into the default layout and swap it in, if their
+  // difference is at least theta and the tile group is all-visible. Returns
+  // the new tile group, or nullptr if it was not transformed.
   storage::TileGroup *TransformTileGroup(const oid_t &tile_group_offset,
                                          const double &theta);
 
+  // Replace a tile group whose tuples were all moved out by an empty one,
+  // releasing its memory
+  void ReleaseTileGroup(const oid_t &tile_group_id);
+
   //===--------------------------------------------------------------------===//
   // STATS
   //===--------------------------------------------------------------------===//
@@ -237,6 +248,14 @@ class DataTable : public AbstractTable {
 
   void ResetDirty();
 
+  size_t GetModificationCount() const;
+
+  void IncreaseLiveTupleCount(const size_t &amount);
+
+  void DecreaseLiveTupleCount(const size_t &amount);
+
+  size_t GetLiveTupleCount() const;
+
   //===--------------------------------------------------------------------===//
   // LAYOUT TUNER
   //===--------------------------------------------------------------------===//
@@ -407,6 +426,14 @@ class DataTable : public AbstractTable {
   // dirty flag. for detecting whether the tile group has been used.
   bool dirty_ = false;
 
+  // # of tuple versions inserted, updated or deleted since the table was
+  // created. never decreases; used to decide when the stats are stale.
+  std::atomic<size_t> modification_count_ = ATOMIC_VAR_INIT(0);
+
+  // # of rows inserted and not deleted by committed transactions. unlike
+  // number_of_tuples_, versions created by updates and aborts don't count.
+  std::atomic<size_t> live_tuple_count_ = ATOMIC_VAR_INIT(0);
+
   //===--------------------------------------------------------------------===//
   // TUNING MEMBERS
   //===--------------------------------------------------------------------===//
@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// deduplicated_tile_group.h
+//
+// Identification: src/include/storage/deduplicated_tile_group.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace storage {
+
+class Tile;
+class TileGroup;
+struct PredicateInfo;
+
+//===--------------------------------------------------------------------===//
+// Deduplicated Tile Group
+//===--------------------------------------------------------------------===//
+
+/**
+ * Varlen deduplication and value bounds of an all-visible tile group.
+ *
+ * Varlen columns are deduplicated in place: equal values share one varlen
+ * entry, and every field of the column points to its entry. An equality
+ * predicate is evaluated by comparing the field pointers with the entry of the
+ * constant. The entries that are no longer referenced are handed back to the
+ * caller, which frees them once no reader can hold them. Only columns whose
+ * fields are pointer-aligned are deduplicated, since readers may load a field
+ * while it is rewritten.
+ *
+ * Nothing is compressed: fixed-width columns keep their slots as they are, and
+ * the codegen scans read the fields without looking at the entries. Every
+ * column records its min and max, a zone map which lets scans skip the tile
+ * group.
+ *
+ * The deduplication only holds while the tile group stays all-visible, since
+ * reused slots are not deduplicated.
+ */
+class DeduplicatedTileGroup {
+ public:
+  enum class ColumnEncoding { NONE, DEDUPLICATED };
+
+  struct DeduplicatedColumn {
+    ColumnEncoding encoding = ColumnEncoding::NONE;
+
+    // Whether min and max were computed, and whether the column holds any
+    // non-null value. min and max are only set if it does.
+    bool analyzed = false;
+    bool has_values = false;
+    type::Value min;
+    type::Value max;
+
+    // DEDUPLICATED: the distinct varlen entries, ordered by length and bytes
+    std::vector<const char *> distinct;
+  };
+
+  // A varlen allocation that is no longer referenced. The tile keeps the
+  // pool it belongs to alive until it is freed.
+  typedef std::pair<std::shared_ptr<Tile>, char *> RetiredVarlen;
+
+  // Deduplicate the varlen columns of the tile group and compute the bounds of
+  // every column. previous is its last deduplication, if any, whose entries
+  // are reused. The allocations that were deduplicated are
+  // appended to retired.
+  static std::shared_ptr<const DeduplicatedTileGroup> Deduplicate(
+      TileGroup *tile_group, const DeduplicatedTileGroup *previous,
+      std::vector<RetiredVarlen> &retired);
+
+  const DeduplicatedColumn &GetColumn(oid_t column_id) const {
+    return columns_[column_id];
+  }
+
+  // Returns the shared entry that fields equal to value point to, or
+  // nullptr if no field of the column equals value
+  const char *LookupEntry(oid_t column_id, const type::Value &value) const;
+
+  // Whether varlen is an entry shared by the fields of some column, which
+  // must not be freed along with a single tuple
+  bool IsSharedEntry(const char *varlen) const {
+    return entries_.count(varlen) != 0;
+  }
+
+  // Returns false if no tuple of the tile group can satisfy all predicates
+  bool ShouldScan(const PredicateInfo *predicates,
+                  int32_t num_predicates) const;
+
+  // Bytes of varlen data freed by deduplicating
+  size_t GetSavedBytes() const { return saved_bytes_; }
+
+ private:
+  void DeduplicateVarlenColumn(TileGroup *tile_group, oid_t column_id,
+                               const DeduplicatedTileGroup *previous,
+                               std::vector<RetiredVarlen> &retired);
+
+  void ComputeFixedColumnBounds(TileGroup *tile_group, oid_t column_id);
+
+  std::vector<DeduplicatedColumn> columns_;
+
+  // Shared entries of all columns
+  std::unordered_set<const char *> entries_;
+
+  size_t saved_bytes_ = 0;
+};
+
+}  // namespace storage
+}  // namespace peloton
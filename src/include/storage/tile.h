@@ -177,6 +177,18 @@ class Tile : public Printable {
   // Sync the contents
   void Sync();
 
+  //===--------------------------------------------------------------------===//
+  // Cold Storage
+  //===--------------------------------------------------------------------===//
+
+  // Move the tuple data into the cold storage segment of the table. Returns
+  // the previous copy of the data, which readers may still be using, or
+  // nullptr if the data was not moved.
+  char *Evict();
+
+  // Whether the tuple data is mapped from a cold storage segment
+  bool IsEvicted() const { return evicted; }
+
  protected:
   //===--------------------------------------------------------------------===//
   // Data members
@@ -197,6 +209,9 @@ class Tile : public Printable {
   // set of fixed-length tuple slots
   char *data;
 
+  // whether data is mapped from a cold storage segment
+  bool evicted;
+
   // relevant tile group
   TileGroup *tile_group;
 
@@ -49,6 +49,7 @@ namespace storage {
 class Tuple;
 class Tile;
 class TileGroupHeader;
+class DeduplicatedTileGroup;
 class AbstractTable;
 class TileGroupIterator;
 class RollbackSegment;
@@ -182,6 +183,28 @@ class TileGroup : public Printable {
 
   double GetSchemaDifference(const storage::column_map_type &new_column_map);
 
+  // The varlen deduplication of the tile group, or nullptr if it was never
+  // deduplicated or was thawed since. It must be installed before the tile
+  // group is published as all-visible, and reset when it is thawed.
+  std::shared_ptr<const DeduplicatedTileGroup> GetDedup() const {
+    return std::atomic_load(&dedup);
+  }
+
+  // The last deduplication installed, even if it was reset since. Fields may
+  // still point to its shared entries, which must not be freed along with a
+  // single tuple.
+  std::shared_ptr<const DeduplicatedTileGroup> GetLastDedup() const {
+    return std::atomic_load(&last_dedup);
+  }
+
+  // Install a deduplication, or reset it with nullptr
+  void SetDedup(std::shared_ptr<const DeduplicatedTileGroup> dedup_) {
+    if (dedup_ != nullptr) {
+      std::atomic_store(&last_dedup, dedup_);
+    }
+    std::atomic_store(&dedup, dedup_);
+  }
+
   // Sync the contents
   void Sync();
 
@@ -221,6 +244,10 @@ class TileGroup : public Printable {
   // column to tile mapping :
   // <column offset> to <tile offset, tile column offset>
   column_map_type column_map;
+
+  // varlen deduplication, swapped atomically by the GC
+  std::shared_ptr<const DeduplicatedTileGroup> dedup;
+  std::shared_ptr<const DeduplicatedTileGroup> last_dedup;
 };
 
 }  // namespace storage
@@ -61,9 +61,18 @@ class TileGroup;
  *  TxnID != INITIAL_TXN_ID, BeginTS != MAX_CID --> to-be-updated old version
  *  TxnID != INITIAL_TXN_ID, BeginTS == MAX_CID, EndTS == MAX_CID --> to-be-installed new version
  *  TxnID != INITIAL_TXN_ID, BeginTS == MAX_CID, EndTS == INVALID_CID --> to-be-installed deleted version
+ *
+ *  COLUMNAR MVCC LAYOUT:
+ *  ===================
+ *  When the columnar_mvcc_header setting is on, TxnID, BeginTimeStamp and
+ *  EndTimeStamp are stored in three dense arrays instead of the per-slot
+ *  record (whose copies of these fields are then unused). A visibility check
+ *  over a range of slots then reads 24 bytes per tuple instead of a whole
+ *  header entry. The accessors below work with either layout.
  */
 
 #define TUPLE_HEADER_LOCATION data + (tuple_slot_id * header_entry_size)
+#define TUPLE_MVCC_LOCATION(column) column + (tuple_slot_id * mvcc_stride)
 
 class TileGroupHeader : public Printable {
   TileGroupHeader() = delete;
@@ -78,7 +87,12 @@ class TileGroupHeader : public Printable {
     header_size = other.header_size;
 
     // copy over all the data
+    PL_ASSERT(IsColumnarMVCC() == other.IsColumnarMVCC());
     PL_MEMCPY(data, other.data, header_size);
+    if (IsColumnarMVCC()) {
+      PL_MEMCPY(mvcc_data, other.mvcc_data,
+                num_tuple_slots * mvcc_column_entry_size);
+    }
 
     num_tuple_slots = other.num_tuple_slots;
     oid_t val = other.next_tuple_slot;
@@ -149,15 +163,15 @@ class TileGroupHeader : public Printable {
   // but the current transaction reads the txn_id.
   // the returned value seems to be uncertain.
   inline txn_id_t GetTransactionId(const oid_t &tuple_slot_id) const {
-    return *((txn_id_t *)(TUPLE_HEADER_LOCATION));
+    return *((txn_id_t *)(TUPLE_MVCC_LOCATION(txn_id_column)));
   }
 
   inline cid_t GetBeginCommitId(const oid_t &tuple_slot_id) const {
-    return *((cid_t *)(TUPLE_HEADER_LOCATION + begin_cid_offset));
+    return *((cid_t *)(TUPLE_MVCC_LOCATION(begin_cid_column)));
   }
 
   inline cid_t GetEndCommitId(const oid_t &tuple_slot_id) const {
-    return *((cid_t *)(TUPLE_HEADER_LOCATION + end_cid_offset));
+    return *((cid_t *)(TUPLE_MVCC_LOCATION(end_cid_column)));
   }
 
   inline ItemPointer GetNextItemPointer(const oid_t &tuple_slot_id) const {
@@ -184,17 +198,17 @@ class TileGroupHeader : public Printable {
   }
   inline void SetTransactionId(const oid_t &tuple_slot_id,
                                const txn_id_t &transaction_id) const {
-    *((txn_id_t *)(TUPLE_HEADER_LOCATION)) = transaction_id;
+    *((txn_id_t *)(TUPLE_MVCC_LOCATION(txn_id_column))) = transaction_id;
   }
 
   inline void SetBeginCommitId(const oid_t &tuple_slot_id,
                                const cid_t &begin_cid) {
-    *((cid_t *)(TUPLE_HEADER_LOCATION + begin_cid_offset)) = begin_cid;
+    *((cid_t *)(TUPLE_MVCC_LOCATION(begin_cid_column))) = begin_cid;
   }
 
   inline void SetEndCommitId(const oid_t &tuple_slot_id,
                              const cid_t &end_cid) const {
-    *((cid_t *)(TUPLE_HEADER_LOCATION + end_cid_offset)) = end_cid;
+    *((cid_t *)(TUPLE_MVCC_LOCATION(end_cid_column))) = end_cid;
   }
 
   inline void SetNextItemPointer(const oid_t &tuple_slot_id,
@@ -216,13 +230,13 @@ class TileGroupHeader : public Printable {
   inline txn_id_t SetAtomicTransactionId(const oid_t &tuple_slot_id,
                                          const txn_id_t &old_txn_id,
                                          const txn_id_t &new_txn_id) const {
-    txn_id_t *txn_id_ptr = (txn_id_t *)(TUPLE_HEADER_LOCATION);
+    txn_id_t *txn_id_ptr = (txn_id_t *)(TUPLE_MVCC_LOCATION(txn_id_column));
     return __sync_val_compare_and_swap(txn_id_ptr, old_txn_id, new_txn_id);
   }
 
   inline bool SetAtomicTransactionId(const oid_t &tuple_slot_id,
                                      const txn_id_t &transaction_id) const {
-    txn_id_t *txn_id_ptr = (txn_id_t *)(TUPLE_HEADER_LOCATION);
+    txn_id_t *txn_id_ptr = (txn_id_t *)(TUPLE_MVCC_LOCATION(txn_id_column));
     return __sync_bool_compare_and_swap(txn_id_ptr, INITIAL_TXN_ID,
                                         transaction_id);
   }
@@ -245,6 +259,170 @@ class TileGroupHeader : public Printable {
 
   inline bool GetImmutability() const { return immutable; }
 
+  // Whether the txn id and begin/end commit ids are stored in dense arrays
+  inline bool IsColumnarMVCC() const { return mvcc_data != nullptr; }
+
+  // The dense arrays, indexed by tuple slot id. Only valid if
+  // IsColumnarMVCC() is true.
+  inline const txn_id_t *GetTransactionIdArray() const {
+    PL_ASSERT(IsColumnarMVCC());
+    return (const txn_id_t *)txn_id_column;
+  }
+
+  inline const cid_t *GetBeginCommitIdArray() const {
+    PL_ASSERT(IsColumnarMVCC());
+    return (const cid_t *)begin_cid_column;
+  }
+
+  inline const cid_t *GetEndCommitIdArray() const {
+    PL_ASSERT(IsColumnarMVCC());
+    return (const cid_t *)end_cid_column;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Access tracking
+  //
+  // Transactions mark the tile groups they access, and the GC clears the mark
+  // to find the all-visible tile groups that went cold.
+  //===--------------------------------------------------------------------===//
+
+  inline void MarkAccessed() const {
+    // do not dirty the cache line if the mark is already set
+    if (accessed.load(std::memory_order_relaxed) == false) {
+      accessed.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  // Returns whether the tile group was accessed since the last call
+  inline bool ClearAccessed() const {
+    return accessed.exchange(false, std::memory_order_relaxed);
+  }
+
+  // Mark the tile group as waiting in the GC's freeze queue. Returns false
+  // if it is queued already, in which case it must not be queued again.
+  inline bool MarkFreezeQueued() const {
+    bool expected = false;
+    return freeze_queued.compare_exchange_strong(expected, true);
+  }
+
+  // The GC took the tile group out of the freeze queue
+  inline void ClearFreezeQueued() const { freeze_queued.store(false); }
+
+  inline bool IsFreezeQueued() const { return freeze_queued.load(); }
+
+  //===--------------------------------------------------------------------===//
+  // All-visible state
+  //
+  // A tile group is all-visible when every slot holds a committed, live version
+  // that is older than every active transaction. Scans can then skip the
+  // per-tuple visibility checks and read-set maintenance. The GC freezes tile
+  // groups (MUTABLE -> FREEZING -> ALL_VISIBLE), and a transaction acquiring
+  // ownership of any tuple in the tile group thaws it back to MUTABLE.
+  //
+  // An all-visible tile group can also be copied into a new layout
+  // (ALL_VISIBLE -> RELOCATING -> RELOCATED). Thawing it while it is being
+  // copied cancels the copy. Once RELOCATED, the tile group is replaced in the
+  // catalog and its tuples can no longer be modified.
+  // The GC also holds a tile group in RELOCATING while it moves the tuple data
+  // to cold storage, and then returns it to ALL_VISIBLE.
+  //===--------------------------------------------------------------------===//
+
+  inline bool IsAllVisible() const {
+    return all_visible_state == AllVisibleState::ALL_VISIBLE;
+  }
+
+  // Start freezing the tile group. Only the GC should call this.
+  inline bool BeginFreeze() const {
+    auto expected = AllVisibleState::MUTABLE;
+    return all_visible_state.compare_exchange_strong(expected,
+                                                     AllVisibleState::FREEZING);
+  }
+
+  // Finish freezing the tile group. This fails if a transaction acquired
+  // ownership of a tuple after BeginFreeze().
+  inline bool FinishFreeze() const {
+    auto expected = AllVisibleState::FREEZING;
+    return all_visible_state.compare_exchange_strong(
+        expected, AllVisibleState::ALL_VISIBLE);
+  }
+
+  inline void AbortFreeze() const {
+    auto expected = AllVisibleState::FREEZING;
+    all_visible_state.compare_exchange_strong(expected,
+                                              AllVisibleState::MUTABLE);
+  }
+
+  // Mark the tile group as mutable. This must be called after a transaction
+  // acquires ownership of a tuple in the tile group, which must then check
+  // IsRelocated(). Returns true if the tile group was all-visible, or was
+  // being relocated.
+  inline bool ClearAllVisible() const {
+    auto state = all_visible_state.load();
+    while (state != AllVisibleState::MUTABLE &&
+           state != AllVisibleState::RELOCATED) {
+      if (all_visible_state.compare_exchange_weak(state,
+                                                  AllVisibleState::MUTABLE)) {
+        return state == AllVisibleState::ALL_VISIBLE ||
+               state == AllVisibleState::RELOCATING;
+      }
+    }
+    return false;
+  }
+
+  // Start copying the tile group into a new layout. Only succeeds if the tile
+  // group is all-visible.
+  inline bool BeginRelocate() const {
+    auto expected = AllVisibleState::ALL_VISIBLE;
+    return all_visible_state.compare_exchange_strong(
+        expected, AllVisibleState::RELOCATING);
+  }
+
+  // Finish the copy. This fails if a transaction acquired ownership of a tuple
+  // after BeginRelocate(), in which case the copy must be discarded.
+  inline bool FinishRelocate() const {
+    auto expected = AllVisibleState::RELOCATING;
+    return all_visible_state.compare_exchange_strong(
+        expected, AllVisibleState::RELOCATED);
+  }
+
+  inline void AbortRelocate() const {
+    auto expected = AllVisibleState::RELOCATING;
+    all_visible_state.compare_exchange_strong(expected,
+                                              AllVisibleState::ALL_VISIBLE);
+  }
+
+  // Whether the tile group was replaced by a copy, so that its tuples must be
+  // modified through the copy
+  inline bool IsRelocated() const {
+    return all_visible_state == AllVisibleState::RELOCATED;
+  }
+
+  // Scans of an all-visible tile group record their commit id here rather
+  // than in the last reader field of every tuple
+  inline void SetAllVisibleReaderCommitId(const cid_t &reader_cid) const {
+    cid_t curr_cid = all_visible_reader_cid.load();
+    while (curr_cid < reader_cid &&
+           !all_visible_reader_cid.compare_exchange_weak(curr_cid,
+                                                         reader_cid)) {
+    }
+  }
+
+  inline cid_t GetAllVisibleReaderCommitId() const {
+    return all_visible_reader_cid.load();
+  }
+
+  // Take over the versions of a relocated tile group. None of them is owned
+  // by a transaction, and the reserved fields are cleared. Until
+  // SetRelocatedReaderCommitId() is called, no transaction can acquire
+  // ownership of a tuple in this tile group.
+  void CopyRelocatedVersions(const TileGroupHeader &other);
+
+  // Bound the commit ids of the transactions that read the versions before
+  // they were relocated
+  inline void SetRelocatedReaderCommitId(const cid_t &reader_cid) const {
+    all_visible_reader_cid.store(reader_cid);
+  }
+
   void PrintVisibility(txn_id_t txn_id, cid_t at_cid);
 
   // Getter for spin lock
@@ -278,6 +456,11 @@ class TileGroupHeader : public Printable {
   static const size_t reserved_field_offset =
       indirection_offset + sizeof(ItemPointer);
 
+  // size of the txn id and begin/end commit ids of one slot in the columnar
+  // MVCC layout
+  static const size_t mvcc_column_entry_size =
+      sizeof(txn_id_t) + 2 * sizeof(cid_t);
+
  private:
   //===--------------------------------------------------------------------===//
   // Data members
@@ -294,6 +477,17 @@ class TileGroupHeader : public Printable {
   // set of fixed-length tuple slots
   char *data;
 
+  // dense txn id and begin/end commit id arrays, or nullptr if these fields
+  // live in the tuple slots
+  char *mvcc_data;
+
+  // start of the txn id and begin/end commit id fields of the first slot,
+  // and the distance between the fields of consecutive slots
+  char *txn_id_column;
+  char *begin_cid_column;
+  char *end_cid_column;
+  size_t mvcc_stride;
+
   // number of tuple slots allocated
   oid_t num_tuple_slots;
 
@@ -307,6 +501,27 @@ class TileGroupHeader : public Printable {
   // Immmutable Flag. Should be set by the indextuner to be true.
   // By default it will be set to false.
   bool immutable;
+
+  enum class AllVisibleState : uint8_t {
+    MUTABLE,
+    FREEZING,
+    ALL_VISIBLE,
+    RELOCATING,
+    RELOCATED
+  };
+
+  // Whether all tuples in this tile group are visible to every transaction
+  mutable std::atomic<AllVisibleState> all_visible_state;
+
+  // The largest commit id of the transactions that scanned this tile group
+  // while it was all-visible
+  mutable std::atomic<cid_t> all_visible_reader_cid;
+
+  // Whether a transaction accessed this tile group since the GC last checked
+  mutable std::atomic<bool> accessed;
+
+  // Whether the tile group is waiting in the GC's freeze queue
+  mutable std::atomic<bool> freeze_queued;
 };
 
 }  // namespace storage
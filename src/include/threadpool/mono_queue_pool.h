@@ -52,6 +52,9 @@ class MonoQueuePool {
     task_queue_.Enqueue(std::move(func));
   }
 
+  // Number of tasks waiting for a worker
+  size_t GetTaskQueueSize() { return task_queue_.GetSizeApprox(); }
+
   static MonoQueuePool &GetInstance() {
     uint32_t task_queue_size = settings::SettingsManager::GetInt(
         settings::SettingId::monoqueue_task_queue_size);
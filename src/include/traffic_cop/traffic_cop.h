@@ -88,6 +88,19 @@ class TrafficCop {
       const std::vector<std::unique_ptr<expression::AbstractExpression>> &,
       const size_t thread_id = 0);
 
+  // Plan a parameterized query for the shared plan cache. The plan is built
+  // in a transaction of its own, so a failure leaves the current one alone.
+  std::shared_ptr<Statement> PrepareSharedStatement(
+      const std::string &query_string,
+      std::unique_ptr<parser::SQLStatementList> sql_stmt_list,
+      size_t thread_id = 0);
+
+  // Bind the literals of a simple query to the plan of the current statement,
+  // which came from the shared plan cache
+  void BindParamsForSharedPlan(std::vector<type::Value> param_values,
+                               const std::string &query_string,
+                               size_t thread_id = 0);
+
   std::vector<FieldInfo> GenerateTupleDescriptor(
       parser::SQLStatement *select_stmt);
 
@@ -145,6 +158,10 @@ class TrafficCop {
     default_database_name_ = std::move(default_database_name);
   }
 
+  const std::string &GetDefaultDatabaseName() const {
+    return default_database_name_;
+  }
+
   // TODO: this member variable should be in statement_ after parser part
   // finished
   std::string query_;
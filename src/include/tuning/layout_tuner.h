@@ -15,6 +15,7 @@
 #include <atomic>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "clusterer.h"
@@ -98,12 +99,28 @@ class LayoutTuner {
    */
   void UpdateDefaultPartition(storage::DataTable *table);
 
+  /**
+   * Transform existing tile groups of table into its default layout,
+   * continuing from where the last call stopped
+   *
+   * @param      table      The table
+   * @param[in]  max_count  The maximum number of tile groups to transform
+   *
+   * @return     The number of tile groups transformed
+   */
+  oid_t TransformTileGroups(storage::DataTable *table, oid_t max_count);
+
  private:
   /**
    * Tables whose layout must be tuned
    */
   std::vector<storage::DataTable *> tables;
 
+  /**
+   * Offset of the next tile group to transform in each table
+   */
+  std::unordered_map<storage::DataTable *, oid_t> transform_offsets;
+
   std::mutex layout_tuner_mutex;
 
   /**
@@ -142,6 +159,9 @@ class LayoutTuner {
   /** Desired layout tile count */
   oid_t tile_count = 2;
 
+  /** Tile groups examined per table in each round */
+  oid_t transform_scan_count = 64;
+
 };
 
 }  // namespace indextuner
@@ -20,11 +20,21 @@ class UDFHandler {
       concurrency::TransactionContext *txn, std::string func_name,
       std::string func_body, std::vector<std::string> args_name,
       std::vector<arg_type> args_type, arg_type ret_type);
+
+  // Link the body of the UDF into the current context so it can be inlined,
+  // falling back to calling the UDF's compiled code
+  llvm::Function *LinkFunction(peloton::codegen::CodeGen &codegen,
+                               const expression::FunctionExpression &func_expr);
+
   llvm::Function *RegisterExternalFunction(
       peloton::codegen::CodeGen &codegen,
       const expression::FunctionExpression &func_expr);
 
  private:
+  llvm::FunctionType *GetFunctionType(
+      peloton::codegen::CodeGen &codegen,
+      const expression::FunctionExpression &func_expr);
+
   std::shared_ptr<codegen::CodeContext> Compile(
       concurrency::TransactionContext *txn, std::string func_name,
       std::string func_body, std::vector<std::string> args_name,
@@ -53,7 +53,9 @@ void LoadKey(void *ctx, TID tid, art::Key &key) {
 
 ArtIndex::ArtIndex(IndexMetadata *metadata)
     : Index(metadata),
-      container_(LoadKey, this),
+      container_(LoadKey, this,
+                 settings::SettingsManager::GetBool(
+                     settings::SettingId::art_inline_keys)),
       key_constructor_(*GetKeySchema()) {}
 
 bool ArtIndex::InsertEntry(const storage::Tuple *key, ItemPointer *value) {
@@ -200,6 +202,46 @@ void ArtIndex::ScanKey(const storage::Tuple *key,
   }
 }
 
+void ArtIndex::ScanKeys(const std::vector<const storage::Tuple *> &keys,
+                        std::vector<std::vector<ItemPointer *>> &results) {
+  results.resize(keys.size());
+
+  std::vector<art::Key> tree_keys(keys.size());
+  std::vector<const art::Key *> sorted_keys(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    ConstructArtKey(*keys[i], tree_keys[i]);
+    sorted_keys[i] = &tree_keys[i];
+  }
+
+  // Probe in key order so the interleaved lookups share their path
+  std::sort(sorted_keys.begin(), sorted_keys.end(),
+            [](const art::Key *a, const art::Key *b) {
+              auto len = std::min(a->getKeyLen(), b->getKeyLen());
+              int cmp = len == 0 ? 0 : std::memcmp(&(*a)[0], &(*b)[0], len);
+              return cmp < 0 || (cmp == 0 && a->getKeyLen() < b->getKeyLen());
+            });
+
+  std::vector<std::vector<TID>> tmp_results(keys.size());
+  auto thread_info = container_.getThreadInfo();
+  container_.lookupBatch(sorted_keys.data(), sorted_keys.size(),
+                         tmp_results.data(), thread_info);
+
+  size_t num_results = 0;
+  for (size_t i = 0; i < keys.size(); i++) {
+    auto &result = results[sorted_keys[i] - tree_keys.data()];
+    for (const auto &tid : tmp_results[i]) {
+      result.push_back(reinterpret_cast<ItemPointer *>(tid));
+    }
+    num_results += tmp_results[i].size();
+  }
+
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        num_results, GetMetadata());
+  }
+}
+
 void ArtIndex::ScanRange(const art::Key &start, const art::Key &end,
                          std::vector<ItemPointer *> &result) {
   const uint32_t batch_size = 1000;
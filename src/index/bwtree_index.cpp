@@ -289,6 +289,63 @@ void BWTREE_INDEX_TYPE::ScanKey(const storage::Tuple *key,
   return;
 }
 
+/*
+ * ScanKeys() - Probe the tree for all keys in key order
+ *
+ * Sorting the probes lets keys that land in the same leaf as the key before
+ * them skip the traversal from the root, and equal keys are only looked up
+ * once.
+ */
+BWTREE_TEMPLATE_ARGUMENTS
+void BWTREE_INDEX_TYPE::ScanKeys(
+    const std::vector<const storage::Tuple *> &keys,
+    std::vector<std::vector<ValueType>> &results) {
+  results.resize(keys.size());
+
+  std::vector<KeyType> index_keys(keys.size());
+  std::vector<size_t> order(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    index_keys[i].SetFromKey(keys[i]);
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [this, &index_keys](size_t a,
+                                                            size_t b) {
+    return comparator(index_keys[a], index_keys[b]);
+  });
+
+  // Only probe the first of each run of equal keys
+  std::vector<const KeyType *> probe_keys;
+  std::vector<size_t> probe_start;
+  for (size_t i = 0; i < order.size(); i++) {
+    if (i == 0 || !equals(index_keys[order[i - 1]], index_keys[order[i]])) {
+      probe_keys.push_back(&index_keys[order[i]]);
+      probe_start.push_back(i);
+    }
+  }
+
+  std::vector<std::vector<ValueType>> probe_results(probe_keys.size());
+  container.GetValues(probe_keys.data(), probe_keys.size(),
+                      probe_results.data());
+
+  size_t num_results = 0;
+  for (size_t probe = 0; probe < probe_keys.size(); probe++) {
+    size_t end = (probe + 1 < probe_start.size()) ? probe_start[probe + 1]
+                                                  : order.size();
+    for (size_t i = probe_start[probe]; i < end; i++) {
+      auto &result = results[order[i]];
+      result.insert(result.end(), probe_results[probe].begin(),
+                    probe_results[probe].end());
+      num_results += probe_results[probe].size();
+    }
+  }
+
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        num_results, metadata);
+  }
+}
+
 BWTREE_TEMPLATE_ARGUMENTS
 std::string BWTREE_INDEX_TYPE::GetTypeName() const { return "BWTree"; }
 
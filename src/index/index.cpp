@@ -187,6 +187,17 @@ void Index::ScanTest(const std::vector<type::Value> &value_list,
   return;
 }
 
+/*
+ * ScanKeys() - Fallback for indexes without a batched lookup
+ */
+void Index::ScanKeys(const std::vector<const storage::Tuple *> &keys,
+                     std::vector<std::vector<ItemPointer *>> &results) {
+  results.resize(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    ScanKey(keys[i], results[i]);
+  }
+}
+
 // Check whether a given index key satisfies a predicate. The predicate has the
 // same specification as those in Scan()
 bool Index::Compare(const AbstractTuple &index_key,
@@ -18,6 +18,7 @@
 #include "benchmark/sdbench/sdbench_workload.h"
 #include "benchmark/sdbench/sdbench_loader.h"
 #include "concurrency/epoch_manager_factory.h"
+#include "gc/gc_manager_factory.h"
 
 #include <google/protobuf/stubs/common.h>
 
@@ -40,6 +41,18 @@ void RunBenchmark() {
 
   epoch_manager.StartEpoch(epoch_thread);
 
+  // The layout tuner only transforms tile groups that the GC marked
+  // all-visible
+  if (state.layout_mode == LayoutType::HYBRID) {
+    gc::GCManagerFactory::Configure(1);
+  }
+
+  std::vector<std::unique_ptr<std::thread>> gc_threads;
+
+  gc::GCManager &gc_manager = gc::GCManagerFactory::GetInstance();
+
+  gc_manager.StartGC(gc_threads);
+
   if (state.multi_stage) {
     // Run holistic indexing comparison benchmark
     RunMultiStageBenchmark();
@@ -48,8 +61,14 @@ void RunBenchmark() {
     RunSDBenchTest();
   }
 
+  gc_manager.StopGC();
+
   epoch_manager.StopEpoch();
 
+  for (auto &gc_thread : gc_threads) {
+    gc_thread->join();
+  }
+
   epoch_thread->join();
 }
 
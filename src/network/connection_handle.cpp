@@ -139,6 +139,8 @@ void ConnectionHandle::StateMachine::Accept(Transition action,
   }
 }
 
+std::atomic<int64_t> ConnectionHandle::open_connection_count_{0};
+
 ConnectionHandle::ConnectionHandle(int sock_fd, ConnectionHandlerTask *handler,
                                    std::shared_ptr<Buffer> rbuf,
                                    std::shared_ptr<Buffer> wbuf)
@@ -149,6 +151,7 @@ ConnectionHandle::ConnectionHandle(int sock_fd, ConnectionHandlerTask *handler,
       wbuf_(std::move(wbuf)) {
   SetNonBlocking(sock_fd_);
   SetTCPNoDelay(sock_fd_);
+  open_connection_count_.fetch_add(1, std::memory_order_relaxed);
 
   network_event = handler->RegisterEvent(
       sock_fd_, EV_READ | EV_PERSIST,
@@ -567,6 +570,7 @@ Transition ConnectionHandle::CloseSocket() {
       }
     }
     LOG_DEBUG("Already Closed the connection %d", sock_fd_);
+    open_connection_count_.fetch_sub(1, std::memory_order_relaxed);
     return Transition::NONE;
   }
 }
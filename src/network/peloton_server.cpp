@@ -16,9 +16,11 @@
 #include "event2/thread.h"
 
 #include "common/dedicated_thread_registry.h"
+#include "network/connection_handle.h"
 #include "network/peloton_rpc_handler_task.h"
 #include "network/peloton_server.h"
 #include "settings/settings_manager.h"
+#include "statistics/metrics_registry.h"
 
 #include "peloton_config.h"
 
@@ -262,10 +264,51 @@ PelotonServer &PelotonServer::SetupServer() {
   dispatcher_task_ = std::make_shared<ConnectionDispatcherTask>(
       CONNECTION_THREAD_COUNT, listen_fd_);
 
+  if (settings::SettingsManager::GetBool(
+      settings::SettingId::metrics_endpoint)) {
+    SetupMetricsEndpoint();
+  }
+
   LOG_INFO("Listening on port %llu", (unsigned long long) port_);
   return *this;
 }
 
+void PelotonServer::SetupMetricsEndpoint() {
+  int metrics_port =
+      settings::SettingsManager::GetInt(settings::SettingId::metrics_port);
+  stats::MetricsRegistry::GetInstance().RegisterDefaultMetrics();
+  stats::MetricsRegistry::GetInstance().RegisterGauge(
+      "peloton_connections", "Open client connections", [] {
+        return static_cast<double>(ConnectionHandle::GetOpenConnectionCount());
+      });
+
+  // Scrapes are rare and cheap, so they're served by the dispatcher thread
+  // instead of a thread of their own. The endpoint only listens locally.
+  metrics_http_ = evhttp_new(dispatcher_task_->GetEventBase());
+  if (metrics_http_ == nullptr ||
+      evhttp_bind_socket(metrics_http_, "127.0.0.1", metrics_port) != 0) {
+    LOG_ERROR("Failed to serve metrics on port %d", metrics_port);
+    if (metrics_http_ != nullptr) {
+      evhttp_free(metrics_http_);
+      metrics_http_ = nullptr;
+    }
+    return;
+  }
+  evhttp_set_cb(metrics_http_, "/metrics", HandleMetricsRequest, nullptr);
+  LOG_INFO("Serving metrics on port %d", metrics_port);
+}
+
+void PelotonServer::HandleMetricsRequest(struct evhttp_request *request,
+                                         UNUSED_ATTRIBUTE void *arg) {
+  std::string metrics = stats::MetricsRegistry::GetInstance().Scrape();
+  struct evbuffer *reply = evbuffer_new();
+  evbuffer_add(reply, metrics.data(), metrics.size());
+  evhttp_add_header(evhttp_request_get_output_headers(request),
+                    "Content-Type", "text/plain; version=0.0.4");
+  evhttp_send_reply(request, HTTP_OK, "OK", reply);
+  evbuffer_free(reply);
+}
+
 void PelotonServer::ServerLoop() {
   if (settings::SettingsManager::GetBool(settings::SettingId::rpc_enabled)) {
     int rpc_port =
@@ -277,6 +320,10 @@ void PelotonServer::ServerLoop() {
   }
   dispatcher_task_->EventLoop();
   LOG_INFO("Closing server");
+  if (metrics_http_ != nullptr) {
+    evhttp_free(metrics_http_);
+    metrics_http_ = nullptr;
+  }
   int status;
   do {
     status = close(listen_fd_);
@@ -18,6 +18,7 @@
 #include "common/internal_types.h"
 #include "common/macros.h"
 #include "common/portal.h"
+#include "common/shared_plan_cache.h"
 #include "expression/expression_util.h"
 #include "network/marshal.h"
 #include "network/postgres_protocol_handler.h"
@@ -115,6 +116,15 @@ ProcessResult PostgresProtocolHandler::ExecQueryMessage(
   std::string error_message;
   PacketGetString(pkt, pkt->len, query);
   LOG_TRACE("Execute query: %s", query.c_str());
+
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::shared_plan_cache)) {
+    ProcessResult result;
+    if (ExecSharedPlanQuery(query, thread_id, result)) {
+      return result;
+    }
+  }
+
   std::unique_ptr<parser::SQLStatementList> sql_stmt_list;
   try {
     auto &peloton_parser = parser::PostgresParser::GetInstance();
@@ -248,7 +258,112 @@ ProcessResult PostgresProtocolHandler::ExecQueryMessage(
   }
 }
 
+bool PostgresProtocolHandler::ExecSharedPlanQuery(const std::string &query,
+                                                  const size_t thread_id,
+                                                  ProcessResult &result) {
+  std::string parameterized_query;
+  std::vector<type::Value> param_values;
+  if (!parser::PostgresParser::ParameterizeQuery(query, parameterized_query,
+                                                 param_values)) {
+    return false;
+  }
+
+  auto &shared_plan_cache = SharedPlanCache::GetInstance();
+  auto key = SharedPlanCache::GetKey(traffic_cop_->GetDefaultDatabaseName(),
+                                     parameterized_query, param_values);
+  uint64_t version;
+  bool cacheable;
+  auto statement = shared_plan_cache.Acquire(key, version, cacheable);
+  if (!cacheable) {
+    return false;
+  }
+
+  if (statement.get() == nullptr) {
+    // Plan the parameterized query. If the parser can't take parameters
+    // where the literals were, it never will; if only the optimizer fails,
+    // planning the query with its literals reports the error.
+    std::unique_ptr<parser::SQLStatementList> sql_stmt_list;
+    try {
+      auto &peloton_parser = parser::PostgresParser::GetInstance();
+      sql_stmt_list = peloton_parser.BuildParseTree(parameterized_query);
+    } catch (Exception &e) {
+      sql_stmt_list.reset();
+    }
+    if (sql_stmt_list.get() == nullptr || !sql_stmt_list->is_valid ||
+        sql_stmt_list->GetNumStatements() != 1) {
+      shared_plan_cache.MarkUncacheable(key);
+      return false;
+    }
+    statement = traffic_cop_->PrepareSharedStatement(
+        parameterized_query, std::move(sql_stmt_list), thread_id);
+    if (statement.get() == nullptr) {
+      shared_plan_cache.MarkUnplannable(key, version);
+      return false;
+    }
+  }
+
+  protocol_type_ = NetworkProtocolType::POSTGRES_PSQL;
+  shared_statement_ = statement;
+  shared_statement_key_ = std::move(key);
+  shared_statement_version_ = version;
+
+  traffic_cop_->SetStatement(statement);
+  traffic_cop_->BindParamsForSharedPlan(std::move(param_values), query,
+                                        thread_id);
+  result_format_ =
+      std::vector<int>(statement->GetTupleDescriptor().size(), 0);
+  bool unnamed = false;
+  auto status = traffic_cop_->ExecuteStatement(
+      statement, traffic_cop_->GetParamVal(), unnamed, nullptr,
+      result_format_, traffic_cop_->GetResult(), thread_id);
+  if (traffic_cop_->GetQueuing()) {
+    result = ProcessResult::PROCESSING;
+    return true;
+  }
+  ExecQueryMessageGetResult(status);
+  result = ProcessResult::COMPLETE;
+  return true;
+}
+
+std::shared_ptr<Statement> PostgresProtocolHandler::LeaseSharedStatement(
+    const std::string &key, const std::string &query) {
+  auto &shared_plan_cache = SharedPlanCache::GetInstance();
+  uint64_t version;
+  bool cacheable;
+  auto statement = shared_plan_cache.Acquire(key, version, cacheable);
+
+  if (statement.get() == nullptr) {
+    std::unique_ptr<parser::SQLStatementList> sql_stmt_list;
+    try {
+      auto &peloton_parser = parser::PostgresParser::GetInstance();
+      sql_stmt_list = peloton_parser.BuildParseTree(query);
+    } catch (Exception &e) {
+      return nullptr;
+    }
+    if (sql_stmt_list.get() == nullptr || !sql_stmt_list->is_valid ||
+        sql_stmt_list->GetNumStatements() != 1) {
+      return nullptr;
+    }
+    statement =
+        traffic_cop_->PrepareSharedStatement(query, std::move(sql_stmt_list));
+    if (statement.get() == nullptr) {
+      return nullptr;
+    }
+  }
+  return shared_plan_cache.Lease(key, std::move(statement), version);
+}
+
 void PostgresProtocolHandler::ExecQueryMessageGetResult(ResultType status) {
+  // The plan is done executing, so another connection may bind it. The
+  // statement itself stays with the traffic cop, which only reads its tuple
+  // descriptor and query type from here on.
+  if (shared_statement_.get() != nullptr) {
+    SharedPlanCache::GetInstance().Release(shared_statement_key_,
+                                           std::move(shared_statement_),
+                                           shared_statement_version_);
+    shared_statement_.reset();
+  }
+
   std::vector<FieldInfo> tuple_descriptor;
   if (status == ResultType::SUCCESS) {
     tuple_descriptor = traffic_cop_->GetStatement()->GetTupleDescriptor();
@@ -327,11 +442,41 @@ void PostgresProtocolHandler::ExecParseMessage(InputPacket *pkt) {
     return;
   }
 
+  // Read number of params
+  int num_params = PacketGetInt(pkt, 2);
+
+  // Read param types
+  std::vector<int32_t> param_types(num_params);
+  auto type_buf_begin = pkt->Begin() + pkt->ptr;
+  auto type_buf_len = ReadParamType(pkt, num_params, param_types);
+
   // Prepare statement
   std::shared_ptr<Statement> statement(nullptr);
 
-  statement = traffic_cop_->PrepareStatement(statement_name, query,
-                                             std::move(sql_stmt_list));
+  if (!empty &&
+      settings::SettingsManager::GetBool(
+          settings::SettingId::shared_plan_cache) &&
+      (query_type == QueryType::QUERY_SELECT ||
+       query_type == QueryType::QUERY_INSERT ||
+       query_type == QueryType::QUERY_UPDATE ||
+       query_type == QueryType::QUERY_DELETE)) {
+    auto key = SharedPlanCache::GetKey(traffic_cop_->GetDefaultDatabaseName(),
+                                       query, param_types);
+    auto shared_statement = LeaseSharedStatement(key, query);
+    // Only keep what DESCRIBE and BIND need, the plan goes back to the cache
+    if (shared_statement.get() != nullptr) {
+      statement = std::make_shared<Statement>(statement_name, query_type,
+                                              query, nullptr);
+      statement->SetTupleDescriptor(shared_statement->GetTupleDescriptor());
+      statement->SetReferencedTables(shared_statement->GetReferencedTables());
+      statement->SetSharedPlanKey(key);
+    }
+  }
+
+  if (statement.get() == nullptr) {
+    statement = traffic_cop_->PrepareStatement(statement_name, query,
+                                               std::move(sql_stmt_list));
+  }
   if (statement.get() == nullptr) {
     traffic_cop_->ProcessInvalidStatement();
     skipped_stmt_ = true;
@@ -341,13 +486,6 @@ void PostgresProtocolHandler::ExecParseMessage(InputPacket *pkt) {
   }
   LOG_TRACE("PrepareStatement[%s] => %s", statement_name.c_str(),
             query.c_str());
-  // Read number of params
-  int num_params = PacketGetInt(pkt, 2);
-
-  // Read param types
-  std::vector<int32_t> param_types(num_params);
-  auto type_buf_begin = pkt->Begin() + pkt->ptr;
-  auto type_buf_len = ReadParamType(pkt, num_params, param_types);
 
   // Cache the received query
   bool unnamed_query = statement_name.empty();
@@ -493,6 +631,18 @@ void PostgresProtocolHandler::ExecBindMessage(InputPacket *pkt) {
     }
   }
 
+  // A shared statement binds a plan leased from the shared plan cache. The
+  // portal keeps the lease until it is closed or replaced.
+  if (!statement->GetSharedPlanKey().empty()) {
+    statement = LeaseSharedStatement(statement->GetSharedPlanKey(),
+                                     query_string);
+    if (statement.get() == nullptr) {
+      SendErrorResponse({{NetworkMessageType::HUMAN_READABLE_ERROR,
+                          traffic_cop_->GetErrorMessage()}});
+      return;
+    }
+  }
+
   if (param_values.size() > 0) {
     statement->GetPlanTree()->SetParameterValues(&param_values);
     // Instead of tree traversal, we should put param values in the
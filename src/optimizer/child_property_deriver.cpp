@@ -163,6 +163,27 @@ void ChildPropertyDeriver::Visit(const PhysicalInnerHashJoin *) {
 void ChildPropertyDeriver::Visit(const PhysicalLeftHashJoin *) {}
 void ChildPropertyDeriver::Visit(const PhysicalRightHashJoin *) {}
 void ChildPropertyDeriver::Visit(const PhysicalOuterHashJoin *) {}
+
+void ChildPropertyDeriver::Visit(const PhysicalInnerMergeJoin *op) {
+  // Both children must be sorted on their join keys, and the output comes out
+  // sorted on them as well
+  vector<expression::AbstractExpression *> left_sort_cols;
+  vector<expression::AbstractExpression *> right_sort_cols;
+  for (auto &key : op->left_keys) left_sort_cols.push_back(key.get());
+  for (auto &key : op->right_keys) right_sort_cols.push_back(key.get());
+  shared_ptr<Property> left_sort_prop(new PropertySort(
+      left_sort_cols, vector<bool>(left_sort_cols.size(), true)));
+  shared_ptr<Property> right_sort_prop(new PropertySort(
+      right_sort_cols, vector<bool>(right_sort_cols.size(), true)));
+  auto left_prop_set =
+      make_shared<PropertySet>(vector<shared_ptr<Property>>{left_sort_prop});
+  auto right_prop_set =
+      make_shared<PropertySet>(vector<shared_ptr<Property>>{right_sort_prop});
+  output_.push_back(make_pair(
+      left_prop_set,
+      vector<shared_ptr<PropertySet>>{left_prop_set, right_prop_set}));
+}
+
 void ChildPropertyDeriver::Visit(const PhysicalInsert *) {
   vector<shared_ptr<PropertySet>> child_input_properties;
 
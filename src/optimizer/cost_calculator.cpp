@@ -63,7 +63,7 @@ void CostCalculator::Visit(UNUSED_ATTRIBUTE const QueryDerivedScan *op) {
   output_cost_ = 0.f;
 }
 
-void CostCalculator::Visit(const PhysicalOrderBy *) { SortCost(); }
+void CostCalculator::Visit(const PhysicalOrderBy *) { output_cost_ = SortCost(); }
 
 void CostCalculator::Visit(const PhysicalLimit *op) {
   auto child_num_rows =
@@ -110,6 +110,18 @@ void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalInnerHashJoin *op) {
 void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalLeftHashJoin *op) {}
 void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalRightHashJoin *op) {}
 void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalOuterHashJoin *op) {}
+void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalInnerMergeJoin *op) {
+  auto left_child_rows =
+      memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetNumRows();
+  auto right_child_rows =
+      memo_->GetGroupByID(gexpr_->GetChildGroupId(1))->GetNumRows();
+  // Merging sorted inputs only compares keys, there is no hash table to build
+  // or probe. Sorting inputs that are not ordered yet is costed by the
+  // enforcer. The startup cost breaks ties with a hash join in favor of the
+  // hash join, e.g., when there are no stats and every input has zero rows.
+  output_cost_ =
+      (left_child_rows + right_child_rows + 1) * DEFAULT_OPERATOR_COST;
+}
 void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalInsert *op) {}
 void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalInsertSelect *op) {}
 void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalDelete *op) {}
@@ -0,0 +1,266 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// join_order_enumerator.cpp
+//
+// Identification: src/optimizer/join_order_enumerator.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/join_order_enumerator.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "common/macros.h"
+
+namespace peloton {
+namespace optimizer {
+
+namespace {
+
+inline JoinOrderEnumerator::RelationSet Bit(size_t relation) {
+  return JoinOrderEnumerator::RelationSet{1} << relation;
+}
+
+// The relations with an index up to the given one
+inline JoinOrderEnumerator::RelationSet UpTo(size_t relation) {
+  return relation + 1 == JoinOrderEnumerator::kMaxRelations
+             ? ~JoinOrderEnumerator::RelationSet{0}
+             : Bit(relation + 1) - 1;
+}
+
+inline size_t LowestRelation(JoinOrderEnumerator::RelationSet relations) {
+  return __builtin_ctzll(relations);
+}
+
+inline size_t HighestRelation(JoinOrderEnumerator::RelationSet relations) {
+  return 63 - __builtin_clzll(relations);
+}
+
+inline size_t RelationCount(JoinOrderEnumerator::RelationSet relations) {
+  return __builtin_popcountll(relations);
+}
+
+// Calls func with every non-empty subset of the relations, in increasing
+// order
+template <typename Func>
+inline void ForEachSubset(JoinOrderEnumerator::RelationSet relations,
+                          Func func) {
+  JoinOrderEnumerator::RelationSet subset = 0;
+  while ((subset = (subset - relations) & relations) != 0) {
+    func(subset);
+  }
+}
+
+}  // namespace
+
+size_t JoinOrderEnumerator::AddRelation(double cardinality) {
+  PL_ASSERT(cardinalities_.size() < kMaxRelations);
+  cardinalities_.push_back(std::max(cardinality, 1.0));
+  neighbors_.push_back(0);
+  return cardinalities_.size() - 1;
+}
+
+void JoinOrderEnumerator::AddPredicate(RelationSet relations,
+                                       double selectivity, bool is_equi_join) {
+  predicates_.push_back({relations, selectivity, is_equi_join});
+  if (__builtin_popcountll(relations) == 2) {
+    size_t first = LowestRelation(relations);
+    size_t second = HighestRelation(relations);
+    neighbors_[first] |= Bit(second);
+    neighbors_[second] |= Bit(first);
+  }
+}
+
+bool JoinOrderEnumerator::IsConnected() const {
+  if (cardinalities_.empty()) {
+    return false;
+  }
+  RelationSet reached = Bit(0);
+  RelationSet frontier = reached;
+  while (frontier != 0) {
+    frontier = GetNeighbors(frontier, reached);
+    reached |= frontier;
+  }
+  return reached == GetAllRelations();
+}
+
+void JoinOrderEnumerator::Enumerate(size_t dp_threshold) {
+  if (GetRelationCount() <= dp_threshold && IsConnected()) {
+    EnumerateDP();
+  } else {
+    EnumerateGreedy();
+  }
+}
+
+const JoinOrderEnumerator::JoinNode &JoinOrderEnumerator::GetJoinNode(
+    RelationSet relations) const {
+  auto it = plans_.find(relations);
+  PL_ASSERT(it != plans_.end());
+  return it->second;
+}
+
+void JoinOrderEnumerator::InitPlans() {
+  plans_.clear();
+  pair_count_ = 0;
+  for (size_t relation = 0; relation < GetRelationCount(); relation++) {
+    double cardinality = cardinalities_[relation];
+    plans_[Bit(relation)] = {Bit(relation), 0, 0, cardinality, cardinality};
+  }
+}
+
+JoinOrderEnumerator::RelationSet JoinOrderEnumerator::GetNeighbors(
+    RelationSet relations, RelationSet excluded) const {
+  RelationSet neighbors = 0;
+  for (RelationSet rest = relations; rest != 0; rest &= rest - 1) {
+    neighbors |= neighbors_[LowestRelation(rest)];
+  }
+  return neighbors & ~relations & ~excluded;
+}
+
+double JoinOrderEnumerator::GetCardinality(RelationSet relations) const {
+  double cardinality = 1;
+  for (RelationSet rest = relations; rest != 0; rest &= rest - 1) {
+    cardinality *= cardinalities_[LowestRelation(rest)];
+  }
+  // Like for the join graph, only predicates over several relations count
+  for (auto &predicate : predicates_) {
+    if ((predicate.relations & ~relations) == 0 &&
+        RelationCount(predicate.relations) > 1) {
+      cardinality *= predicate.selectivity;
+    }
+  }
+  return cardinality;
+}
+
+void JoinOrderEnumerator::EmitCsgCmp(RelationSet left, RelationSet right) {
+  auto left_it = plans_.find(left);
+  auto right_it = plans_.find(right);
+  PL_ASSERT(left_it != plans_.end() && right_it != plans_.end());
+  auto &left_plan = left_it->second;
+  auto &right_plan = right_it->second;
+  pair_count_++;
+
+  // Hash on an equi-join predicate joining both sides if there is one
+  RelationSet relations = left | right;
+  bool is_equi_join = false;
+  for (auto &predicate : predicates_) {
+    if (predicate.is_equi_join && (predicate.relations & ~relations) == 0 &&
+        (predicate.relations & left) != 0 &&
+        (predicate.relations & right) != 0) {
+      is_equi_join = true;
+      break;
+    }
+  }
+
+  double join_cost = is_equi_join
+                         ? left_plan.cardinality + right_plan.cardinality
+                         : left_plan.cardinality * right_plan.cardinality;
+  double cost = left_plan.cost + right_plan.cost + join_cost;
+
+  auto it = plans_.find(relations);
+  if (it == plans_.end()) {
+    // The cardinality of a set doesn't depend on the join order
+    plans_[relations] = {relations, left, right, GetCardinality(relations),
+                         cost};
+  } else if (cost < it->second.cost ||
+             (cost == it->second.cost && left < it->second.left)) {
+    // Break ties the same way whatever order the pairs are costed in
+    it->second.left = left;
+    it->second.right = right;
+    it->second.cost = cost;
+  }
+}
+
+void JoinOrderEnumerator::EnumerateDP() {
+  PL_ASSERT(IsConnected());
+  InitPlans();
+  // Visit the relations from the highest index down, so that the plans of
+  // all subsets of a csg-cmp pair are complete by the time it's emitted
+  for (size_t relation = GetRelationCount(); relation-- > 0;) {
+    EmitCsg(Bit(relation));
+    EnumerateCsgRec(Bit(relation), UpTo(relation));
+  }
+}
+
+void JoinOrderEnumerator::EmitCsg(RelationSet csg) {
+  RelationSet excluded = csg | UpTo(LowestRelation(csg));
+  RelationSet neighbors = GetNeighbors(csg, excluded);
+  for (RelationSet rest = neighbors; rest != 0;) {
+    size_t relation = HighestRelation(rest);
+    rest &= ~Bit(relation);
+    EmitCsgCmp(csg, Bit(relation));
+    EnumerateCmpRec(csg, Bit(relation),
+                    excluded | (UpTo(relation) & neighbors));
+  }
+}
+
+void JoinOrderEnumerator::EnumerateCsgRec(RelationSet csg,
+                                          RelationSet excluded) {
+  RelationSet neighbors = GetNeighbors(csg, excluded);
+  if (neighbors == 0) {
+    return;
+  }
+  ForEachSubset(neighbors,
+                [&](RelationSet subset) { EmitCsg(csg | subset); });
+  ForEachSubset(neighbors, [&](RelationSet subset) {
+    EnumerateCsgRec(csg | subset, excluded | neighbors);
+  });
+}
+
+void JoinOrderEnumerator::EnumerateCmpRec(RelationSet csg, RelationSet cmp,
+                                          RelationSet excluded) {
+  RelationSet neighbors = GetNeighbors(cmp, excluded);
+  if (neighbors == 0) {
+    return;
+  }
+  ForEachSubset(neighbors,
+                [&](RelationSet subset) { EmitCsgCmp(csg, cmp | subset); });
+  ForEachSubset(neighbors, [&](RelationSet subset) {
+    EnumerateCmpRec(csg, cmp | subset, excluded | neighbors);
+  });
+}
+
+void JoinOrderEnumerator::EnumerateGreedy() {
+  InitPlans();
+  std::vector<RelationSet> trees;
+  for (size_t relation = 0; relation < GetRelationCount(); relation++) {
+    trees.push_back(Bit(relation));
+  }
+
+  while (trees.size() > 1) {
+    // Join the connected pair with the smallest result, falling back to a
+    // cross product when no pair is connected
+    size_t best_left = 0, best_right = 0;
+    bool best_connected = false;
+    double best_cardinality = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < trees.size(); i++) {
+      for (size_t j = i + 1; j < trees.size(); j++) {
+        bool connected = GetNeighbors(trees[i], 0) & trees[j];
+        if (best_connected && !connected) {
+          continue;
+        }
+        // The cardinality of the union doesn't depend on how it's joined
+        EmitCsgCmp(trees[i], trees[j]);
+        double cardinality = plans_[trees[i] | trees[j]].cardinality;
+        if ((connected && !best_connected) ||
+            cardinality < best_cardinality) {
+          best_left = i;
+          best_right = j;
+          best_connected = connected;
+          best_cardinality = cardinality;
+        }
+      }
+    }
+
+    trees[best_left] |= trees[best_right];
+    trees.erase(trees.begin() + best_right);
+  }
+}
+
+}  // namespace optimizer
+}  // namespace peloton
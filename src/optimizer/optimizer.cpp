@@ -27,6 +27,7 @@
 #include "optimizer/query_to_operator_transformer.h"
 #include "optimizer/input_column_deriver.h"
 #include "optimizer/plan_generator.h"
+#include "optimizer/plan_template_cache.h"
 #include "optimizer/rule.h"
 #include "optimizer/rule_impls.h"
 #include "optimizer/optimizer_task_pool.h"
@@ -41,6 +42,8 @@
 #include "planner/populate_index_plan.h"
 #include "planner/projection_plan.h"
 #include "planner/seq_scan_plan.h"
+#include "settings/settings_manager.h"
+#include "statistics/backend_stats_context.h"
 
 #include "storage/data_table.h"
 
@@ -83,6 +86,12 @@ void Optimizer::OptimizeLoop(int root_group_id,
   task_stack->Push(new OptimizeGroup(metadata_.memo.GetGroupByID(root_group_id),
                                      root_context));
 
+  // Order the joins once their inputs have stats
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::join_order_enumeration)) {
+    task_stack->Push(new EnumerateJoinOrder(root_group_id, root_context));
+  }
+
   // Derive stats for the only one logical expression before optimizing
   task_stack->Push(new DeriveStats(
       metadata_.memo.GetGroupByID(root_group_id)->GetLogicalExpression(),
@@ -115,16 +124,46 @@ shared_ptr<planner::AbstractPlan> Optimizer::BuildPelotonPlanTree(
   }
 
   metadata_.txn = txn;
+  Timer<std::milli> optimize_timer;
+  optimize_timer.Start();
+
   // Generate initial operator tree from query tree
-  shared_ptr<GroupExpression> gexpr = InsertQueryTree(parse_tree, txn);
-  GroupID root_id = gexpr->GetGroupID();
+  QueryToOperatorTransformer converter(txn);
+  shared_ptr<OperatorExpression> initial =
+      converter.ConvertToOpExpression(parse_tree);
   // Get the physical properties the final plan must output
   auto query_info = GetQueryInfo(parse_tree);
 
+  // Reuse the plan picked for the same operator tree before if it's still
+  // good, in which case there's no memo to build and no stats to read
+  std::string template_key;
+  std::vector<PlanTemplateCache::TableRef> template_tables;
+  uint64_t template_version = 0, stats_version = 0;
+  bool cacheable =
+      settings::SettingsManager::GetBool(
+          settings::SettingId::plan_template_cache) &&
+      PlanTemplateCache::GetKey(*initial, query_info.output_exprs,
+                                *query_info.physical_props, template_key,
+                                template_tables);
+  if (cacheable) {
+    auto plan = PlanTemplateCache::GetInstance().Acquire(
+        template_key, template_version, stats_version);
+    if (plan != nullptr) {
+      RecordOptimizeLatency(optimize_timer);
+      return plan;
+    }
+  }
+
+  shared_ptr<GroupExpression> gexpr;
+  metadata_.RecordTransformedExpression(initial, gexpr);
+  GroupID root_id = gexpr->GetGroupID();
+
   try {
     OptimizeLoop(root_id, query_info.physical_props);
   } catch (OptimizerException &e) {
     LOG_WARN("Optimize Loop ended prematurely: %s", e.what());
+    // The best plan found so far may be far from the best one
+    cacheable = false;
   }
 
   try {
@@ -133,6 +172,12 @@ shared_ptr<planner::AbstractPlan> Optimizer::BuildPelotonPlanTree(
     if (best_plan == nullptr) return nullptr;
     // Reset memo after finishing the optimization
     Reset();
+    RecordOptimizeLatency(optimize_timer);
+    if (cacheable) {
+      return PlanTemplateCache::GetInstance().Lease(
+          template_key, move(best_plan), template_tables, template_version,
+          stats_version);
+    }
     //  return shared_ptr<planner::AbstractPlan>(best_plan.release());
     return move(best_plan);
   } catch (Exception &e) {
@@ -141,6 +186,17 @@ shared_ptr<planner::AbstractPlan> Optimizer::BuildPelotonPlanTree(
   }
 }
 
+void Optimizer::RecordOptimizeLatency(Timer<std::milli> &timer) {
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) == StatsType::INVALID) {
+    return;
+  }
+  timer.Stop();
+  stats::BackendStatsContext::GetInstance()
+      ->GetOptimizeLatencyMetric()
+      .RecordLatency(timer.GetDuration());
+}
+
 void Optimizer::Reset() { metadata_ = OptimizerMetadata(); }
 
 unique_ptr<planner::AbstractPlan> Optimizer::HandleDDLStatement(
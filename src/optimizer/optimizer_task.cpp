@@ -12,6 +12,8 @@
 
 #include "optimizer/optimizer_task.h"
 
+#include <functional>
+
 #include "optimizer/property_enforcer.h"
 #include "optimizer/optimizer_metadata.h"
 #include "optimizer/binding.h"
@@ -19,6 +21,9 @@
 #include "optimizer/cost_calculator.h"
 #include "optimizer/stats_calculator.h"
 #include "optimizer/child_stats_deriver.h"
+#include "optimizer/join_order_enumerator.h"
+#include "optimizer/operators.h"
+#include "settings/settings_manager.h"
 
 namespace peloton {
 namespace optimizer {
@@ -504,5 +509,151 @@ void BottomUpRewrite::execute() {
     cur_group_expr->SetRuleExplored(r.rule);
   }
 }
+
+//===--------------------------------------------------------------------===//
+// EnumerateJoinOrder
+//===--------------------------------------------------------------------===//
+void EnumerateJoinOrder::execute() {
+  auto cur_group_expr =
+      GetMemo().GetGroupByID(group_id_)->GetLogicalExpression();
+  std::vector<GroupID> leaf_groups;
+  std::vector<AnnotatedExpression> predicates;
+  if (cur_group_expr->Op().GetType() == OpType::InnerJoin) {
+    CollectJoinGraph(group_id_, leaf_groups, predicates);
+  }
+
+  // A join of two groups has only one order up to commutativity, which is
+  // still explored by the rule
+  if (leaf_groups.size() < 3 ||
+      leaf_groups.size() > JoinOrderEnumerator::kMaxRelations) {
+    for (size_t child_group_idx = 0;
+         child_group_idx < cur_group_expr->GetChildrenGroupsSize();
+         child_group_idx++) {
+      PushTask(new EnumerateJoinOrder(
+          cur_group_expr->GetChildGroupId(child_group_idx), context_));
+    }
+    return;
+  }
+
+  JoinOrderEnumerator enumerator;
+  std::unordered_map<std::string, JoinOrderEnumerator::RelationSet>
+      alias_to_relation;
+  for (auto leaf_group_id : leaf_groups) {
+    auto leaf_group = GetMemo().GetGroupByID(leaf_group_id);
+    auto relation = enumerator.AddRelation(leaf_group->GetNumRows());
+    for (auto &alias : leaf_group->GetTableAliases()) {
+      alias_to_relation[alias] = JoinOrderEnumerator::RelationSet{1}
+                                 << relation;
+    }
+  }
+
+  // The relations referenced by each predicate. Predicates on unknown tables
+  // are kept at the root of the join tree.
+  std::vector<JoinOrderEnumerator::RelationSet> predicate_relations;
+  for (auto &predicate : predicates) {
+    JoinOrderEnumerator::RelationSet relations = 0;
+    for (auto &alias : predicate.table_alias_set) {
+      auto it = alias_to_relation.find(alias);
+      if (it == alias_to_relation.end()) {
+        relations = enumerator.GetAllRelations();
+        break;
+      }
+      relations |= it->second;
+    }
+    if (relations == 0) {
+      relations = enumerator.GetAllRelations();
+    }
+    predicate_relations.push_back(relations);
+
+    // Estimate the selectivity the same way as the StatsCalculator: an
+    // equality between columns of two tables keeps 1 / max(rows) of their
+    // cross product
+    auto expr = predicate.expr.get();
+    bool is_equi_join =
+        expr->GetExpressionType() == ExpressionType::COMPARE_EQUAL &&
+        expr->GetChild(0)->GetExpressionType() == ExpressionType::VALUE_TUPLE &&
+        expr->GetChild(1)->GetExpressionType() == ExpressionType::VALUE_TUPLE;
+    double selectivity = 1;
+    if (is_equi_join) {
+      for (auto &alias : predicate.table_alias_set) {
+        auto it = alias_to_relation.find(alias);
+        if (it == alias_to_relation.end()) continue;
+        auto num_rows = std::max(
+            GetMemo()
+                .GetGroupByID(leaf_groups[__builtin_ctzll(it->second)])
+                ->GetNumRows(),
+            1);
+        selectivity = std::min(selectivity, 1.0 / num_rows);
+      }
+    }
+    enumerator.AddPredicate(relations, selectivity, is_equi_join);
+  }
+
+  enumerator.Enumerate(settings::SettingsManager::GetInt(
+      settings::SettingId::join_order_dp_threshold));
+  LOG_TRACE("Enumerated %zu pairs to order a join of %zu groups",
+            enumerator.GetPairCount(), leaf_groups.size());
+
+  // Rebuild the chosen tree, putting every predicate on the lowest join that
+  // has all the tables it references
+  std::function<std::shared_ptr<OperatorExpression>(
+      JoinOrderEnumerator::RelationSet)>
+      build_tree = [&](JoinOrderEnumerator::RelationSet relations) {
+        auto &node = enumerator.GetJoinNode(relations);
+        if (node.left == 0) {
+          return std::make_shared<OperatorExpression>(LeafOperator::make(
+              leaf_groups[__builtin_ctzll(node.relations)]));
+        }
+        // Whether a predicate over the relations goes to a join below
+        auto is_below = [](JoinOrderEnumerator::RelationSet relations,
+                           JoinOrderEnumerator::RelationSet child) {
+          return (relations & ~child) == 0 && (child & (child - 1)) != 0;
+        };
+        std::vector<AnnotatedExpression> join_predicates;
+        for (size_t idx = 0; idx < predicates.size(); idx++) {
+          auto predicate_set = predicate_relations[idx];
+          if ((predicate_set & ~node.relations) == 0 &&
+              !is_below(predicate_set, node.left) &&
+              !is_below(predicate_set, node.right)) {
+            join_predicates.push_back(predicates[idx]);
+          }
+        }
+        auto join = std::make_shared<OperatorExpression>(
+            LogicalInnerJoin::make(join_predicates));
+        join->PushChild(build_tree(node.left));
+        join->PushChild(build_tree(node.right));
+        return join;
+      };
+  context_->metadata->ReplaceRewritedExpression(
+      build_tree(enumerator.GetAllRelations()), group_id_);
+
+  for (auto leaf_group_id : leaf_groups) {
+    PushTask(new EnumerateJoinOrder(leaf_group_id, context_));
+  }
+  // The groups of the new joins need stats before they're costed
+  PushTask(new DeriveStats(
+      GetMemo().GetGroupByID(group_id_)->GetLogicalExpression(), ExprSet{},
+      context_));
+}
+
+void EnumerateJoinOrder::CollectJoinGraph(
+    GroupID group_id, std::vector<GroupID> &leaf_groups,
+    std::vector<AnnotatedExpression> &predicates) {
+  auto group_expr = GetMemo().GetGroupByID(group_id)->GetLogicalExpression();
+  if (group_expr->Op().GetType() != OpType::InnerJoin) {
+    leaf_groups.push_back(group_id);
+    return;
+  }
+  auto &join_predicates =
+      group_expr->Op().As<LogicalInnerJoin>()->join_predicates;
+  predicates.insert(predicates.end(), join_predicates.begin(),
+                    join_predicates.end());
+  for (size_t child_group_idx = 0;
+       child_group_idx < group_expr->GetChildrenGroupsSize();
+       child_group_idx++) {
+    CollectJoinGraph(group_expr->GetChildGroupId(child_group_idx), leaf_groups,
+                     predicates);
+  }
+}
 }  // namespace optimizer
 }  // namespace peloton
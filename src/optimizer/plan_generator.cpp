@@ -26,6 +26,7 @@
 #include "planner/index_scan_plan.h"
 #include "planner/insert_plan.h"
 #include "planner/limit_plan.h"
+#include "planner/merge_join_plan.h"
 #include "planner/nested_loop_join_plan.h"
 #include "planner/order_by_plan.h"
 #include "planner/projection_plan.h"
@@ -151,7 +152,7 @@ void PlanGenerator::Visit(const PhysicalHashGroupBy *op) {
 void PlanGenerator::Visit(const PhysicalSortGroupBy *op) {
   auto having_predicates =
       expression::ExpressionUtil::JoinAnnotatedExprs(op->having);
-  BuildAggregatePlan(AggregateType::HASH, &op->columns,
+  BuildAggregatePlan(AggregateType::SORTED, &op->columns,
                      std::move(having_predicates));
 }
 
@@ -353,6 +354,42 @@ void PlanGenerator::Visit(const PhysicalRightHashJoin *) {}
 
 void PlanGenerator::Visit(const PhysicalOuterHashJoin *) {}
 
+void PlanGenerator::Visit(const PhysicalInnerMergeJoin *op) {
+  std::unique_ptr<const planner::ProjectInfo> proj_info;
+  std::shared_ptr<const catalog::Schema> proj_schema;
+  GenerateProjectionForJoin(proj_info, proj_schema);
+
+  auto join_predicate =
+      expression::ExpressionUtil::JoinAnnotatedExprs(op->join_predicates);
+  expression::ExpressionUtil::EvaluateExpression(children_expr_map_,
+                                                 join_predicate.get());
+  expression::ExpressionUtil::ConvertToTvExpr(join_predicate.get(),
+                                              children_expr_map_);
+
+  // The clauses are evaluated against both children, so the right keys refer
+  // to the second tuple
+  vector<planner::MergeJoinPlan::JoinClause> join_clauses;
+  for (size_t i = 0; i < op->left_keys.size(); i++) {
+    auto left_key = op->left_keys[i]->Copy();
+    auto right_key = op->right_keys[i]->Copy();
+    expression::ExpressionUtil::EvaluateExpression(children_expr_map_,
+                                                   left_key);
+    expression::ExpressionUtil::EvaluateExpression(children_expr_map_,
+                                                   right_key);
+    join_clauses.emplace_back(left_key, right_key, false);
+  }
+
+  unique_ptr<const expression::AbstractExpression> predicate(
+      join_predicate.release());
+  auto join_plan = unique_ptr<planner::AbstractPlan>(new planner::MergeJoinPlan(
+      JoinType::INNER, move(predicate), move(proj_info), proj_schema,
+      join_clauses));
+
+  join_plan->AddChild(move(children_plans_[0]));
+  join_plan->AddChild(move(children_plans_[1]));
+  output_plan_ = move(join_plan);
+}
+
 void PlanGenerator::Visit(const PhysicalInsert *op) {
   unique_ptr<planner::AbstractPlan> insert_plan(new planner::InsertPlan(
       storage::StorageManager::GetInstance()->GetTableWithOid(
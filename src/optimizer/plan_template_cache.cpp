@@ -0,0 +1,543 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_template_cache.cpp
+//
+// Identification: src/optimizer/plan_template_cache.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/plan_template_cache.h"
+
+#include <algorithm>
+
+#include "catalog/table_catalog.h"
+#include "common/exception.h"
+#include "expression/function_expression.h"
+#include "expression/parameter_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "expression/constant_value_expression.h"
+#include "optimizer/operator_expression.h"
+#include "optimizer/operators.h"
+#include "optimizer/properties.h"
+#include "optimizer/property_set.h"
+#include "optimizer/stats/stats_storage.h"
+#include "parser/update_statement.h"
+#include "settings/settings_manager.h"
+#include "storage/data_table.h"
+#include "storage/storage_manager.h"
+
+namespace peloton {
+namespace optimizer {
+
+namespace {
+
+// Strings are prefixed with their length, so that no alias or constant can
+// make two different trees look the same
+void AppendString(const std::string &str, std::string &key) {
+  key.append(std::to_string(str.size()));
+  key.push_back(':');
+  key.append(str);
+}
+
+void AppendNumber(int64_t number, std::string &key) {
+  key.append(std::to_string(number));
+  key.push_back(',');
+}
+
+bool AppendExpression(const expression::AbstractExpression *expr,
+                      std::string &key) {
+  if (expr == nullptr) {
+    key.push_back('_');
+    return true;
+  }
+  auto expr_type = expr->GetExpressionType();
+  AppendNumber(static_cast<int>(expr_type), key);
+  AppendNumber(static_cast<int>(expr->GetValueType()), key);
+
+  switch (expr_type) {
+    case ExpressionType::VALUE_TUPLE: {
+      auto tv_expr =
+          static_cast<const expression::TupleValueExpression *>(expr);
+      if (!tv_expr->GetIsBound()) {
+        return false;
+      }
+      auto &bound_oid = tv_expr->GetBoundOid();
+      AppendNumber(std::get<0>(bound_oid), key);
+      AppendNumber(std::get<1>(bound_oid), key);
+      AppendNumber(std::get<2>(bound_oid), key);
+      AppendString(tv_expr->GetTableName(), key);
+      // Columns of derived tables are all bound to the same oids, only
+      // their names tell them apart
+      AppendString(tv_expr->GetColumnName(), key);
+      break;
+    }
+    case ExpressionType::VALUE_CONSTANT: {
+      auto value =
+          static_cast<const expression::ConstantValueExpression *>(expr)
+              ->GetValue();
+      key.push_back(value.IsNull() ? 'n' : 'v');
+      AppendString(value.ToString(), key);
+      break;
+    }
+    case ExpressionType::VALUE_PARAMETER:
+      AppendNumber(
+          static_cast<const expression::ParameterValueExpression *>(expr)
+              ->GetValueIdx(),
+          key);
+      break;
+    case ExpressionType::FUNCTION: {
+      auto func_expr =
+          static_cast<const expression::FunctionExpression *>(expr);
+      // A UDF can be replaced without touching the tables of the query
+      if (func_expr->IsUDF()) {
+        return false;
+      }
+      AppendString(func_expr->GetFuncName(), key);
+      break;
+    }
+    case ExpressionType::AGGREGATE_COUNT:
+    case ExpressionType::AGGREGATE_COUNT_STAR:
+    case ExpressionType::AGGREGATE_SUM:
+    case ExpressionType::AGGREGATE_MIN:
+    case ExpressionType::AGGREGATE_MAX:
+    case ExpressionType::AGGREGATE_AVG:
+      key.push_back(expr->distinct_ ? 'd' : 'a');
+      break;
+    case ExpressionType::OPERATOR_PLUS:
+    case ExpressionType::OPERATOR_MINUS:
+    case ExpressionType::OPERATOR_MULTIPLY:
+    case ExpressionType::OPERATOR_DIVIDE:
+    case ExpressionType::OPERATOR_CONCAT:
+    case ExpressionType::OPERATOR_MOD:
+    case ExpressionType::OPERATOR_CAST:
+    case ExpressionType::OPERATOR_NOT:
+    case ExpressionType::OPERATOR_IS_NULL:
+    case ExpressionType::OPERATOR_IS_NOT_NULL:
+    case ExpressionType::OPERATOR_UNARY_MINUS:
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+    case ExpressionType::COMPARE_LIKE:
+    case ExpressionType::COMPARE_NOTLIKE:
+    case ExpressionType::COMPARE_IN:
+    case ExpressionType::COMPARE_DISTINCT_FROM:
+    case ExpressionType::CONJUNCTION_AND:
+    case ExpressionType::CONJUNCTION_OR:
+    case ExpressionType::STAR:
+      // Nothing but the type and the children
+      break;
+    default:
+      // Subqueries, case expressions and the like carry more than their
+      // children, leave them out
+      return false;
+  }
+
+  key.push_back('(');
+  for (size_t idx = 0; idx < expr->GetChildrenSize(); idx++) {
+    if (!AppendExpression(expr->GetChild(idx), key)) {
+      return false;
+    }
+  }
+  key.push_back(')');
+  return true;
+}
+
+bool AppendPredicates(const std::vector<AnnotatedExpression> &predicates,
+                      std::string &key) {
+  key.push_back('[');
+  for (auto &predicate : predicates) {
+    if (!AppendExpression(predicate.expr.get(), key)) {
+      return false;
+    }
+  }
+  key.push_back(']');
+  return true;
+}
+
+bool AppendTable(const std::shared_ptr<catalog::TableCatalogObject> &table,
+                 std::string &key,
+                 std::vector<PlanTemplateCache::TableRef> &tables) {
+  if (table == nullptr) {
+    key.push_back('_');
+    return true;
+  }
+  AppendNumber(table->GetDatabaseOid(), key);
+  AppendNumber(table->GetTableOid(), key);
+  tables.emplace_back(table->GetDatabaseOid(), table->GetTableOid());
+  return true;
+}
+
+bool AppendOperator(const OperatorExpression &tree, std::string &key,
+                    std::vector<PlanTemplateCache::TableRef> &tables) {
+  auto &op = tree.Op();
+  AppendNumber(static_cast<int>(op.GetType()), key);
+
+  bool success = true;
+  switch (op.GetType()) {
+    case OpType::Get: {
+      auto get = op.As<LogicalGet>();
+      success = AppendTable(get->table, key, tables) &&
+                AppendPredicates(get->predicates, key);
+      AppendString(get->table_alias, key);
+      key.push_back(get->is_for_update ? 'u' : 'r');
+      break;
+    }
+    case OpType::LogicalQueryDerivedGet: {
+      auto get = op.As<LogicalQueryDerivedGet>();
+      AppendString(get->table_alias, key);
+      // Visit the aliases in a stable order
+      std::vector<std::string> aliases;
+      for (auto &alias_expr : get->alias_to_expr_map) {
+        aliases.push_back(alias_expr.first);
+      }
+      std::sort(aliases.begin(), aliases.end());
+      for (auto &alias : aliases) {
+        AppendString(alias, key);
+        success &= AppendExpression(get->alias_to_expr_map.at(alias).get(), key);
+      }
+      break;
+    }
+    case OpType::LogicalProjection:
+      for (auto &expr : op.As<LogicalProjection>()->expressions) {
+        success &= AppendExpression(expr.get(), key);
+      }
+      break;
+    case OpType::LogicalFilter:
+      success = AppendPredicates(op.As<LogicalFilter>()->predicates, key);
+      break;
+    case OpType::LogicalMarkJoin:
+      success = AppendPredicates(op.As<LogicalMarkJoin>()->join_predicates, key);
+      break;
+    case OpType::LogicalDependentJoin:
+      success =
+          AppendPredicates(op.As<LogicalDependentJoin>()->join_predicates, key);
+      break;
+    case OpType::LogicalSingleJoin:
+      success =
+          AppendPredicates(op.As<LogicalSingleJoin>()->join_predicates, key);
+      break;
+    case OpType::LogicalJoin:
+      AppendNumber(static_cast<int>(op.As<LogicalJoin>()->type), key);
+      success = AppendPredicates(op.As<LogicalJoin>()->join_predicates, key);
+      break;
+    case OpType::InnerJoin:
+      success =
+          AppendPredicates(op.As<LogicalInnerJoin>()->join_predicates, key);
+      break;
+    case OpType::LeftJoin:
+      success =
+          AppendExpression(op.As<LogicalLeftJoin>()->join_predicate.get(), key);
+      break;
+    case OpType::RightJoin:
+      success = AppendExpression(
+          op.As<LogicalRightJoin>()->join_predicate.get(), key);
+      break;
+    case OpType::OuterJoin:
+      success = AppendExpression(
+          op.As<LogicalOuterJoin>()->join_predicate.get(), key);
+      break;
+    case OpType::SemiJoin:
+      success =
+          AppendExpression(op.As<LogicalSemiJoin>()->join_predicate.get(), key);
+      break;
+    case OpType::LogicalAggregateAndGroupBy: {
+      auto aggregate = op.As<LogicalAggregateAndGroupBy>();
+      for (auto &column : aggregate->columns) {
+        success &= AppendExpression(column.get(), key);
+      }
+      success &= AppendPredicates(aggregate->having, key);
+      break;
+    }
+    case OpType::LogicalInsert: {
+      auto insert = op.As<LogicalInsert>();
+      success = AppendTable(insert->target_table, key, tables);
+      if (insert->columns != nullptr) {
+        for (auto &column : *insert->columns) {
+          AppendString(column, key);
+        }
+      }
+      key.push_back('|');
+      if (insert->values != nullptr) {
+        for (auto &tuple : *insert->values) {
+          key.push_back('(');
+          for (auto &value : tuple) {
+            success &= AppendExpression(value.get(), key);
+          }
+          key.push_back(')');
+        }
+      }
+      break;
+    }
+    case OpType::LogicalInsertSelect:
+      success =
+          AppendTable(op.As<LogicalInsertSelect>()->target_table, key, tables);
+      break;
+    case OpType::LogicalDelete:
+      success = AppendTable(op.As<LogicalDelete>()->target_table, key, tables);
+      break;
+    case OpType::LogicalUpdate: {
+      auto update = op.As<LogicalUpdate>();
+      success = AppendTable(update->target_table, key, tables);
+      if (update->updates != nullptr) {
+        for (auto &clause : *update->updates) {
+          AppendString(clause->column, key);
+          success &= AppendExpression(clause->value.get(), key);
+        }
+      }
+      break;
+    }
+    case OpType::LogicalLimit:
+      AppendNumber(op.As<LogicalLimit>()->offset, key);
+      AppendNumber(op.As<LogicalLimit>()->limit, key);
+      break;
+    case OpType::LogicalDistinct:
+      break;
+    default:
+      return false;
+  }
+  if (!success) {
+    return false;
+  }
+
+  key.push_back('{');
+  for (auto &child : tree.Children()) {
+    if (!AppendOperator(*child, key, tables)) {
+      return false;
+    }
+  }
+  key.push_back('}');
+  return true;
+}
+
+// Reads the current number of rows of a table, returns false if it's gone.
+// Versions left behind by updates and deletes don't count.
+bool GetTableSize(const PlanTemplateCache::TableRef &table, size_t &size) {
+  try {
+    size = storage::StorageManager::GetInstance()
+               ->GetTableWithOid(table.first, table.second)
+               ->GetLiveTupleCount();
+    return true;
+  } catch (CatalogException &e) {
+    return false;
+  }
+}
+
+}  // namespace
+
+PlanTemplateCache &PlanTemplateCache::GetInstance() {
+  static PlanTemplateCache plan_template_cache;
+  return plan_template_cache;
+}
+
+bool PlanTemplateCache::GetKey(
+    const OperatorExpression &tree,
+    const std::vector<expression::AbstractExpression *> &output_exprs,
+    const PropertySet &required_props, std::string &key,
+    std::vector<TableRef> &tables) {
+  key.clear();
+  tables.clear();
+  if (!AppendOperator(tree, key, tables)) {
+    return false;
+  }
+
+  key.push_back('|');
+  for (auto expr : output_exprs) {
+    if (!AppendExpression(expr, key)) {
+      return false;
+    }
+  }
+
+  key.push_back('|');
+  for (auto &property : required_props.Properties()) {
+    if (property->Type() != PropertyType::SORT) {
+      return false;
+    }
+    auto sort = property->As<PropertySort>();
+    for (size_t idx = 0; idx < sort->GetSortColumnSize(); idx++) {
+      key.push_back(sort->GetSortAscending(idx) ? 'a' : 'd');
+      if (!AppendExpression(sort->GetSortColumn(idx), key)) {
+        return false;
+      }
+    }
+  }
+
+  std::sort(tables.begin(), tables.end());
+  tables.erase(std::unique(tables.begin(), tables.end()), tables.end());
+  return true;
+}
+
+std::shared_ptr<planner::AbstractPlan> PlanTemplateCache::Acquire(
+    const std::string &key, uint64_t &version, uint64_t &stats_version) {
+  std::lock_guard<std::mutex> lock(cache_lock_);
+  version = version_;
+  stats_version = StatsStorage::GetInstance()->GetVersion();
+
+  auto entry = entries_.find(key);
+  if (entry == entries_.end() || entry->second.plans.empty()) {
+    miss_count_++;
+    return nullptr;
+  }
+
+  // The plans may no longer be the cheapest ones
+  if (entry->second.stats_version != stats_version ||
+      HasDrifted(entry->second)) {
+    Erase(entry);
+    reoptimize_count_++;
+    miss_count_++;
+    return nullptr;
+  }
+
+  lru_list_.splice(lru_list_.begin(), lru_list_, entry->second.lru_position);
+  auto plan = std::move(entry->second.plans.back());
+  entry->second.plans.pop_back();
+  hit_count_++;
+  return MakeLease(key, std::move(plan), entry->second.tables,
+                   entry->second.stats_version, entry->second.table_sizes,
+                   version);
+}
+
+std::shared_ptr<planner::AbstractPlan> PlanTemplateCache::Lease(
+    const std::string &key, std::unique_ptr<planner::AbstractPlan> plan,
+    const std::vector<TableRef> &tables, uint64_t version,
+    uint64_t stats_version) {
+  std::vector<size_t> table_sizes;
+  for (auto &table : tables) {
+    size_t size = 0;
+    if (!GetTableSize(table, size)) {
+      return std::shared_ptr<planner::AbstractPlan>(std::move(plan));
+    }
+    table_sizes.push_back(size);
+  }
+  return MakeLease(key, std::move(plan), tables, stats_version, table_sizes,
+                   version);
+}
+
+std::shared_ptr<planner::AbstractPlan> PlanTemplateCache::MakeLease(
+    const std::string &key, std::unique_ptr<planner::AbstractPlan> plan,
+    const std::vector<TableRef> &tables, uint64_t stats_version,
+    const std::vector<size_t> &table_sizes, uint64_t version) {
+  return std::shared_ptr<planner::AbstractPlan>(
+      plan.release(), [key, tables, stats_version, table_sizes,
+                       version](planner::AbstractPlan *raw_plan) {
+        PlanTemplateCache::GetInstance().Release(
+            key, std::unique_ptr<planner::AbstractPlan>(raw_plan), tables,
+            stats_version, table_sizes, version);
+      });
+}
+
+void PlanTemplateCache::Release(const std::string &key,
+                                std::unique_ptr<planner::AbstractPlan> plan,
+                                const std::vector<TableRef> &tables,
+                                uint64_t stats_version,
+                                const std::vector<size_t> &table_sizes,
+                                uint64_t version) {
+  std::lock_guard<std::mutex> lock(cache_lock_);
+  // The plan may be built on a table that no longer exists
+  if (version != version_ ||
+      stats_version != StatsStorage::GetInstance()->GetVersion()) {
+    return;
+  }
+
+  auto result = entries_.emplace(key, Entry());
+  auto &entry = result.first->second;
+  if (result.second) {
+    lru_list_.push_front(key);
+    entry.lru_position = lru_list_.begin();
+
+    size_t capacity = settings::SettingsManager::GetInt(
+        settings::SettingId::plan_template_cache_size);
+    while (entries_.size() > capacity && lru_list_.size() > 1) {
+      entries_.erase(lru_list_.back());
+      lru_list_.pop_back();
+    }
+  } else if (!entry.plans.empty() && entry.stats_version != stats_version) {
+    // Plans picked with other stats are around, keep those
+    return;
+  }
+
+  if (entry.plans.empty()) {
+    entry.tables = tables;
+    entry.table_sizes = table_sizes;
+    entry.stats_version = stats_version;
+  } else if (entry.plans.size() >= kMaxPlansPerKey) {
+    return;
+  }
+  entry.plans.push_back(std::move(plan));
+}
+
+bool PlanTemplateCache::HasDrifted(const Entry &entry) {
+  double drift_ratio = settings::SettingsManager::GetDouble(
+      settings::SettingId::plan_template_drift_ratio);
+  for (size_t idx = 0; idx < entry.tables.size(); idx++) {
+    size_t size = 0;
+    if (!GetTableSize(entry.tables[idx], size)) {
+      return true;
+    }
+    // Tables that were empty when the plans were picked count as one row,
+    // so that they drift as soon as they're loaded
+    double old_size = std::max<size_t>(entry.table_sizes[idx], 1);
+    double new_size = std::max<size_t>(size, 1);
+    if (std::max(old_size, new_size) > drift_ratio * std::min(old_size, new_size)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void PlanTemplateCache::Erase(
+    std::unordered_map<std::string, Entry>::iterator entry) {
+  lru_list_.erase(entry->second.lru_position);
+  entries_.erase(entry);
+}
+
+void PlanTemplateCache::InvalidateTableOids(const std::set<oid_t> &table_ids) {
+  std::lock_guard<std::mutex> lock(cache_lock_);
+  version_++;
+
+  for (auto entry = entries_.begin(); entry != entries_.end();) {
+    bool invalid = false;
+    for (auto &table : entry->second.tables) {
+      if (table_ids.count(table.second) != 0) {
+        invalid = true;
+        break;
+      }
+    }
+    if (invalid) {
+      lru_list_.erase(entry->second.lru_position);
+      entry = entries_.erase(entry);
+    } else {
+      ++entry;
+    }
+  }
+}
+
+size_t PlanTemplateCache::GetSize() {
+  std::lock_guard<std::mutex> lock(cache_lock_);
+  return entries_.size();
+}
+
+size_t PlanTemplateCache::GetPlanCount(const std::string &key) {
+  std::lock_guard<std::mutex> lock(cache_lock_);
+  auto entry = entries_.find(key);
+  if (entry == entries_.end()) {
+    return 0;
+  }
+  return entry->second.plans.size();
+}
+
+void PlanTemplateCache::Clear() {
+  std::lock_guard<std::mutex> lock(cache_lock_);
+  entries_.clear();
+  lru_list_.clear();
+  version_++;
+}
+
+}  // namespace optimizer
+}  // namespace peloton
@@ -12,6 +12,7 @@
 
 #include "optimizer/rule_impls.h"
 #include "optimizer/group_expression.h"
+#include "settings/settings_manager.h"
 
 namespace peloton {
 namespace optimizer {
@@ -30,12 +31,18 @@ int Rule::Promise(GroupExpression *group_expr, OptimizeContext *context) const {
 RuleSet::RuleSet() {
   AddTransformationRule(new JoinCommutativity());
   AddTransformationRule(new InnerJoinCommutativity());
-  AddTransformationRule(new InnerJoinAssociativity());
+  // Join orders are picked by the EnumerateJoinOrder task when it's enabled,
+  // which is much cheaper than searching all orders with associativity
+  if (!settings::SettingsManager::GetBool(
+          settings::SettingId::join_order_enumeration)) {
+    AddTransformationRule(new InnerJoinAssociativity());
+  }
   AddImplementationRule(new LogicalDeleteToPhysical());
   AddImplementationRule(new LogicalUpdateToPhysical());
   AddImplementationRule(new LogicalInsertToPhysical());
   AddImplementationRule(new LogicalInsertSelectToPhysical());
   AddImplementationRule(new LogicalGroupByToHashGroupBy());
+  AddImplementationRule(new LogicalGroupByToSortGroupBy());
   AddImplementationRule(new LogicalAggregateToPhysical());
   AddImplementationRule(new GetToDummyScan());
   AddImplementationRule(new GetToSeqScan());
@@ -45,6 +52,7 @@ RuleSet::RuleSet() {
   AddImplementationRule(new JoinToHashJoin());
   AddImplementationRule(new InnerJoinToInnerNLJoin());
   AddImplementationRule(new InnerJoinToInnerHashJoin());
+  AddImplementationRule(new InnerJoinToInnerMergeJoin());
   AddImplementationRule(new ImplementDistinct());
   AddImplementationRule(new ImplementLimit());
 
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <memory>
 
 #include "catalog/column_catalog.h"
@@ -630,6 +631,42 @@ void LogicalGroupByToHashGroupBy::Transform(
   transformed.push_back(result);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// LogicalGroupByToSortGroupBy
+LogicalGroupByToSortGroupBy::LogicalGroupByToSortGroupBy() {
+  type_ = RuleType::AGGREGATE_TO_SORT_AGGREGATE;
+  match_pattern = std::make_shared<Pattern>(OpType::LogicalAggregateAndGroupBy);
+  std::shared_ptr<Pattern> child(std::make_shared<Pattern>(OpType::Leaf));
+  match_pattern->AddChild(child);
+}
+
+bool LogicalGroupByToSortGroupBy::Check(
+    std::shared_ptr<OperatorExpression> plan,
+    UNUSED_ATTRIBUTE OptimizeContext *context) const {
+  const LogicalAggregateAndGroupBy *agg_op =
+      plan->Op().As<LogicalAggregateAndGroupBy>();
+  if (agg_op->columns.empty()) return false;
+  // The child is sorted on the group by columns, which have to be columns it
+  // produces
+  for (auto &col : agg_op->columns) {
+    if (col->GetExpressionType() != ExpressionType::VALUE_TUPLE) return false;
+  }
+  return true;
+}
+
+void LogicalGroupByToSortGroupBy::Transform(
+    std::shared_ptr<OperatorExpression> input,
+    std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+    UNUSED_ATTRIBUTE OptimizeContext *context) const {
+  const LogicalAggregateAndGroupBy *agg_op =
+      input->Op().As<LogicalAggregateAndGroupBy>();
+  auto result = std::make_shared<OperatorExpression>(
+      PhysicalSortGroupBy::make(agg_op->columns, agg_op->having));
+  PL_ASSERT(input->Children().size() == 1);
+  result->PushChild(input->Children().at(0));
+  transformed.push_back(result);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// LogicalAggregateToPhysical
 LogicalAggregateToPhysical::LogicalAggregateToPhysical() {
@@ -903,6 +940,123 @@ void InnerJoinToInnerHashJoin::Transform(
   }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// InnerJoinToInnerMergeJoin
+InnerJoinToInnerMergeJoin::InnerJoinToInnerMergeJoin() {
+  type_ = RuleType::INNER_JOIN_TO_MERGE_JOIN;
+
+  std::shared_ptr<Pattern> left_child(std::make_shared<Pattern>(OpType::Leaf));
+  std::shared_ptr<Pattern> right_child(std::make_shared<Pattern>(OpType::Leaf));
+
+  match_pattern = std::make_shared<Pattern>(OpType::InnerJoin);
+  match_pattern->AddChild(left_child);
+  match_pattern->AddChild(right_child);
+}
+
+bool InnerJoinToInnerMergeJoin::Check(
+    UNUSED_ATTRIBUTE std::shared_ptr<OperatorExpression> plan,
+    UNUSED_ATTRIBUTE OptimizeContext *context) const {
+  return true;
+}
+
+// Find the order of the right keys of a merge join that starts with the key
+// columns of a unique index of the right child, in index order, so that the
+// index can provide the sort order. Returns false if the right child isn't a
+// single table unique on the keys. Runs of equal keys on the right then never
+// span more than one row, which MergeJoinExecutor relies on.
+static bool GetUniqueKeyOrder(
+    Group *right_group,
+    const std::vector<std::unique_ptr<expression::AbstractExpression>> &
+        right_keys,
+    std::vector<size_t> &key_order) {
+  if (right_group->GetTableAliases().size() != 1) return false;
+  const LogicalGet *get = nullptr;
+  for (auto &expr : right_group->GetLogicalExpressions()) {
+    if (expr->Op().GetType() == OpType::Get) {
+      get = expr->Op().As<LogicalGet>();
+      break;
+    }
+  }
+  if (get == nullptr || get->table == nullptr) return false;
+
+  std::vector<oid_t> key_col_ids;
+  for (auto &key : right_keys) {
+    auto tv_expr =
+        reinterpret_cast<const expression::TupleValueExpression *>(key.get());
+    if (tv_expr->GetTableName() != get->table_alias) return false;
+    key_col_ids.push_back(std::get<2>(tv_expr->GetBoundOid()));
+  }
+
+  for (auto &index_id_object_pair : get->table->GetIndexObjects()) {
+    auto &index = index_id_object_pair.second;
+    if (index->GetIndexConstraint() != IndexConstraintType::PRIMARY_KEY &&
+        index->GetIndexConstraint() != IndexConstraintType::UNIQUE)
+      continue;
+    std::vector<size_t> order;
+    std::vector<bool> used(key_col_ids.size(), false);
+    for (auto index_col_id : index->GetKeyAttrs()) {
+      auto it =
+          std::find(key_col_ids.begin(), key_col_ids.end(), index_col_id);
+      if (it == key_col_ids.end()) break;
+      order.push_back(it - key_col_ids.begin());
+      used[order.back()] = true;
+    }
+    if (order.size() != index->GetKeyAttrs().size()) continue;
+    for (size_t i = 0; i < used.size(); i++) {
+      if (!used[i]) order.push_back(i);
+    }
+    key_order = std::move(order);
+    return true;
+  }
+  return false;
+}
+
+void InnerJoinToInnerMergeJoin::Transform(
+    std::shared_ptr<OperatorExpression> input,
+    std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+    OptimizeContext *context) const {
+  const LogicalInnerJoin *inner_join = input->Op().As<LogicalInnerJoin>();
+
+  auto children = input->Children();
+  PL_ASSERT(children.size() == 2);
+  auto left_group_id = children[0]->Op().As<LeafOperator>()->origin_group;
+  auto right_group_id = children[1]->Op().As<LeafOperator>()->origin_group;
+  auto right_group = context->metadata->memo.GetGroupByID(right_group_id);
+  auto &left_group_alias =
+      context->metadata->memo.GetGroupByID(left_group_id)->GetTableAliases();
+  auto &right_group_alias = right_group->GetTableAliases();
+  std::vector<std::unique_ptr<expression::AbstractExpression>> left_keys;
+  std::vector<std::unique_ptr<expression::AbstractExpression>> right_keys;
+
+  util::ExtractEquiJoinKeys(inner_join->join_predicates, left_keys, right_keys,
+                            left_group_alias, right_group_alias);
+
+  PL_ASSERT(right_keys.size() == left_keys.size());
+  if (left_keys.empty()) return;
+  // Keys are compared as they are while merging
+  for (size_t i = 0; i < left_keys.size(); i++) {
+    if (left_keys[i]->GetValueType() != right_keys[i]->GetValueType()) return;
+  }
+  std::vector<size_t> key_order;
+  if (!GetUniqueKeyOrder(right_group, right_keys, key_order)) return;
+
+  std::vector<std::unique_ptr<expression::AbstractExpression>> sorted_left_keys;
+  std::vector<std::unique_ptr<expression::AbstractExpression>>
+      sorted_right_keys;
+  for (auto idx : key_order) {
+    sorted_left_keys.push_back(std::move(left_keys[idx]));
+    sorted_right_keys.push_back(std::move(right_keys[idx]));
+  }
+
+  auto result_plan =
+      std::make_shared<OperatorExpression>(PhysicalInnerMergeJoin::make(
+          inner_join->join_predicates, sorted_left_keys, sorted_right_keys));
+  result_plan->PushChild(children[0]);
+  result_plan->PushChild(children[1]);
+
+  transformed.push_back(result_plan);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// ImplementDistinct
 ImplementDistinct::ImplementDistinct() {
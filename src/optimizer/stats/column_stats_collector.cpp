@@ -51,6 +51,43 @@ void ColumnStatsCollector::AddValue(const type::Value &value) {
   topk_.Add(value);
 }
 
+void ColumnStatsCollector::Merge(const ColumnStatsCollector &other) {
+  PL_ASSERT(column_id_ == other.column_id_);
+  PL_ASSERT(column_type_ == other.column_type_);
+  total_count_ += other.total_count_;
+  null_count_ += other.null_count_;
+  hll_.Merge(other.hll_);
+  hist_.Merge(other.hist_);
+  topk_.Merge(other.topk_);
+}
+
+std::vector<ColumnStatsCollector::ValueFrequencyPair>
+ColumnStatsCollector::GetCommonValueAndFrequency() {
+  std::vector<ValueFrequencyPair> common_vals = topk_.GetAllOrderedMaxFirst();
+  if (sample_ratio_ < 1.0) {
+    for (auto &val_freq : common_vals) {
+      val_freq.second /= sample_ratio_;
+    }
+  }
+  return common_vals;
+}
+
+uint64_t ColumnStatsCollector::GetCardinality() {
+  uint64_t cardinality = hll_.EstimateCardinality();
+  if (sample_ratio_ == 1.0 || total_count_ == 0) {
+    return cardinality;
+  }
+  // A sample only tells us how many distinct values it saw. If almost every
+  // sampled value is distinct the column is likely unique and the distinct
+  // count scales with the table; otherwise assume the sample has already seen
+  // most of the domain.
+  double distinct_ratio = static_cast<double>(cardinality) / total_count_;
+  if (distinct_ratio >= 1.0 - hll_.RelativeError()) {
+    return static_cast<uint64_t>(cardinality / sample_ratio_);
+  }
+  return cardinality;
+}
+
 double ColumnStatsCollector::GetFracNull() {
   if (total_count_ == 0) {
     LOG_TRACE("Cannot calculate stats for table size 0.");
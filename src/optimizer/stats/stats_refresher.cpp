@@ -0,0 +1,181 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// stats_refresher.cpp
+//
+// Identification: src/optimizer/stats/stats_refresher.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/stats/stats_refresher.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "catalog/catalog_defaults.h"
+#include "codegen/query_cache.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/statement_cache_manager.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "optimizer/stats/stats_storage.h"
+#include "settings/settings_manager.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/storage_manager.h"
+#include "threadpool/mono_queue_pool.h"
+
+namespace peloton {
+namespace optimizer {
+
+StatsRefresher &StatsRefresher::GetInstance() {
+  static StatsRefresher stats_refresher;
+  return stats_refresher;
+}
+
+StatsRefresher::StatsRefresher() : refresher_stop_(true) {}
+
+void StatsRefresher::Start() {
+  // Set signal
+  refresher_stop_ = false;
+
+  // Launch thread
+  refresher_thread_ = std::thread(&StatsRefresher::Run, this);
+
+  LOG_INFO("Started stats refresher");
+}
+
+void StatsRefresher::Stop() {
+  // Stop checking
+  refresher_stop_ = true;
+
+  // Stop thread
+  if (refresher_thread_.joinable()) {
+    refresher_thread_.join();
+  }
+
+  LOG_INFO("Stopped stats refresher");
+}
+
+void StatsRefresher::Run() {
+  // Sleep in short steps so that Stop() does not wait for a whole interval
+  const int sleep_step = 10;
+  while (refresher_stop_ == false) {
+    CheckTables();
+    int interval = settings::SettingsManager::GetInt(
+        settings::SettingId::stats_refresh_interval);
+    for (int slept = 0; slept < interval && refresher_stop_ == false;
+         slept += sleep_step) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(sleep_step));
+    }
+  }
+}
+
+size_t StatsRefresher::CheckTables() {
+  auto storage_manager = storage::StorageManager::GetInstance();
+  auto &pool = threadpool::MonoQueuePool::GetBrainInstance();
+  size_t refresh_count = 0;
+
+  oid_t database_count = storage_manager->GetDatabaseCount();
+  for (oid_t db_offset = 0; db_offset < database_count; db_offset++) {
+    auto database = storage_manager->GetDatabaseWithOffset(db_offset);
+    if (database->GetOid() == CATALOG_DATABASE_OID) {
+      continue;
+    }
+    oid_t table_count = database->GetTableCount();
+    for (oid_t table_offset = 0; table_offset < table_count; table_offset++) {
+      auto table = database->GetTable(table_offset);
+      if (IsStale(table) == false) {
+        continue;
+      }
+
+      oid_t database_oid = database->GetOid();
+      oid_t table_oid = table->GetOid();
+      {
+        std::lock_guard<std::mutex> lock(refresher_mutex_);
+        // Skip tables whose refresh has not finished yet
+        if (pending_tables_.insert(table_oid).second == false) {
+          continue;
+        }
+      }
+
+      LOG_TRACE("Queueing stats refresh of table %s",
+                table->GetName().c_str());
+      pool.SubmitTask([this, database_oid, table_oid] {
+        RefreshTable(database_oid, table_oid);
+      });
+      refresh_count++;
+    }
+  }
+  return refresh_count;
+}
+
+bool StatsRefresher::IsStale(storage::DataTable *table) {
+  size_t modification_count = table->GetModificationCount();
+  AnalyzeMark mark{0, 0};
+  {
+    std::lock_guard<std::mutex> lock(refresher_mutex_);
+    auto itr = analyze_marks_.find(table->GetOid());
+    if (itr != analyze_marks_.end()) {
+      mark = itr->second;
+    }
+  }
+
+  size_t churn = modification_count - mark.modification_count;
+  double threshold = settings::SettingsManager::GetDouble(
+      settings::SettingId::stats_refresh_threshold);
+  return churn >= threshold * std::max(mark.num_rows, kMinRefreshRows);
+}
+
+ResultType StatsRefresher::RefreshTable(oid_t database_oid, oid_t table_oid) {
+  ResultType result = ResultType::FAILURE;
+  try {
+    auto table = storage::StorageManager::GetInstance()->GetTableWithOid(
+        database_oid, table_oid);
+
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    result = StatsStorage::GetInstance()->AnalyzeStatsForTable(table, txn);
+    if (result == ResultType::SUCCESS) {
+      result = txn_manager.CommitTransaction(txn);
+    } else {
+      txn_manager.AbortTransaction(txn);
+    }
+  } catch (CatalogException &e) {
+    // The table was dropped before we got to it
+    LOG_TRACE("Cannot refresh stats of table %u: %s", table_oid, e.what());
+  }
+
+  if (result == ResultType::SUCCESS) {
+    // Plans built on the old stats may no longer be the cheapest ones
+    if (StatementCacheManager::GetStmtCacheManager().get()) {
+      StatementCacheManager::GetStmtCacheManager()->InvalidateTableOid(
+          table_oid);
+    }
+    codegen::QueryCache::Instance().Remove(table_oid);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(refresher_mutex_);
+    pending_tables_.erase(table_oid);
+  }
+  return result;
+}
+
+void StatsRefresher::RecordAnalyze(storage::DataTable *table,
+                                   size_t modification_count,
+                                   size_t num_rows) {
+  std::lock_guard<std::mutex> lock(refresher_mutex_);
+  analyze_marks_[table->GetOid()] = AnalyzeMark{modification_count, num_rows};
+}
+
+void StatsRefresher::DeregisterTable(oid_t table_oid) {
+  std::lock_guard<std::mutex> lock(refresher_mutex_);
+  analyze_marks_.erase(table_oid);
+}
+
+}  // namespace optimizer
+}  // namespace peloton
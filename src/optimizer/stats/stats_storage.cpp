@@ -16,6 +16,7 @@
 #include "catalog/column_stats_catalog.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "optimizer/stats/column_stats.h"
+#include "optimizer/stats/stats_refresher.h"
 #include "optimizer/stats/table_stats.h"
 #include "storage/storage_manager.h"
 #include "type/ephemeral_pool.h"
@@ -123,6 +124,7 @@ void StatsStorage::InsertOrUpdateColumnStats(
       database_id, table_id, column_id, num_rows, cardinality, frac_null,
       most_common_vals, most_common_freqs, histogram_bounds, column_name,
       has_index, pool_.get(), txn);
+  version_++;
 
   if (single_statement_txn) {
     txn_manager.CommitTransaction(txn);
@@ -283,10 +285,14 @@ ResultType StatsStorage::AnalyzeStatsForAllTables(
     for (oid_t table_offset = 0; table_offset < table_count; table_offset++) {
       auto table = database->GetTable(table_offset);
       LOG_TRACE("Analyzing table: %s", table->GetName().c_str());
+      size_t modification_count = table->GetModificationCount();
       std::unique_ptr<TableStatsCollector> table_stats_collector(
           new TableStatsCollector(table));
       table_stats_collector->CollectColumnStats();
       InsertOrUpdateTableStats(table, table_stats_collector.get(), txn);
+      StatsRefresher::GetInstance().RecordAnalyze(
+          table, modification_count,
+          table_stats_collector->GetActiveTupleCount());
     }
   }
   return ResultType::SUCCESS;
@@ -303,10 +309,15 @@ ResultType StatsStorage::AnalyzeStatsForTable(
               table->GetName().c_str());
     return ResultType::FAILURE;
   }
+  // Read the modification count first so that changes made while scanning
+  // count towards the next refresh.
+  size_t modification_count = table->GetModificationCount();
   std::unique_ptr<TableStatsCollector> table_stats_collector(
       new TableStatsCollector(table));
   table_stats_collector->CollectColumnStats();
   InsertOrUpdateTableStats(table, table_stats_collector.get(), txn);
+  StatsRefresher::GetInstance().RecordAnalyze(
+      table, modification_count, table_stats_collector->GetActiveTupleCount());
   return ResultType::SUCCESS;
 }
 
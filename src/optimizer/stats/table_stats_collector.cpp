@@ -12,12 +12,16 @@
 
 #include "optimizer/stats/table_stats_collector.h"
 
+#include <algorithm>
 #include <memory>
+#include <random>
+#include <thread>
 
 #include "common/macros.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_header.h"
 #include "common/internal_types.h"
+#include "settings/settings_manager.h"
 #include "type/value.h"
 
 namespace peloton {
@@ -27,11 +31,22 @@ TableStatsCollector::TableStatsCollector(storage::DataTable *table)
     : table_(table),
       column_stats_collectors_{},
       active_tuple_count_{0},
-      column_count_{0} {}
+      sampled_tuple_count_{0},
+      column_count_{0},
+      worker_count_{0} {}
 
 TableStatsCollector::~TableStatsCollector() {}
 
 void TableStatsCollector::CollectColumnStats() {
+  size_t max_worker_count = settings::SettingsManager::GetInt(
+      settings::SettingId::analyze_worker_count);
+  double sample_rate = settings::SettingsManager::GetDouble(
+      settings::SettingId::analyze_sample_rate);
+  CollectColumnStats(max_worker_count, sample_rate);
+}
+
+void TableStatsCollector::CollectColumnStats(size_t max_worker_count,
+                                             double sample_rate) {
   schema_ = table_->GetSchema();
   column_count_ = schema_->GetColumnCount();
 
@@ -40,16 +55,100 @@ void TableStatsCollector::CollectColumnStats() {
     return;
   }
 
-  InitColumnStatsCollectors();
+  InitColumnStatsCollectors(column_stats_collectors_);
+
+  std::vector<oid_t> tile_group_offsets = SampleTileGroups(sample_rate);
+  if (tile_group_offsets.empty()) {
+    return;
+  }
+
+  // Size the worker count by the amount of work so that small tables are
+  // still analyzed inline on the calling thread.
+  size_t tile_group_count = tile_group_offsets.size();
+  worker_count_ = std::max<size_t>(
+      1, std::min(max_worker_count, tile_group_count / kMinTileGroupsPerWorker));
+  LOG_TRACE("Analyzing %lu tile groups of %s with %lu workers",
+            tile_group_count, table_->GetName().c_str(), worker_count_);
+
+  if (worker_count_ == 1) {
+    CollectTileGroupStats(tile_group_offsets, 0, tile_group_count,
+                          column_stats_collectors_);
+  } else {
+    // Partition the tile groups into contiguous ranges, one per worker.
+    std::vector<ColumnStatsCollectors> worker_collectors(worker_count_);
+    std::vector<std::thread> workers;
+    size_t partition_size = tile_group_count / worker_count_;
+    for (size_t worker_id = 0; worker_id < worker_count_; worker_id++) {
+      size_t begin = worker_id * partition_size;
+      size_t end = (worker_id == worker_count_ - 1) ? tile_group_count
+                                                     : begin + partition_size;
+      InitColumnStatsCollectors(worker_collectors[worker_id]);
+      workers.emplace_back(&TableStatsCollector::CollectTileGroupStats, this,
+                           std::cref(tile_group_offsets), begin, end,
+                           std::ref(worker_collectors[worker_id]));
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+
+    // Merge the thread-local sketches into the table's collectors.
+    for (auto &collectors : worker_collectors) {
+      for (oid_t column_id = 0; column_id < column_count_; column_id++) {
+        column_stats_collectors_[column_id]->Merge(*collectors[column_id]);
+      }
+    }
+  }
 
+  if (sampled_tuple_count_ < active_tuple_count_) {
+    double sample_ratio =
+        static_cast<double>(sampled_tuple_count_) / active_tuple_count_;
+    for (auto &column_stats_collector : column_stats_collectors_) {
+      column_stats_collector->SetSampleRatio(sample_ratio);
+    }
+  }
+}
+
+/**
+ * SampleTileGroups - Pick the offsets of the tile groups to scan. The active
+ * tuple count is read from every tile group header since it is cheap, but only
+ * the picked tile groups have their tuples visited.
+ */
+std::vector<oid_t> TableStatsCollector::SampleTileGroups(double sample_rate) {
+  std::vector<oid_t> tile_group_offsets;
   size_t tile_group_count = table_->GetTileGroupCount();
-  // Collect stats for all tile groups.
+  // Use a fixed seed so that repeated ANALYZEs of a table are comparable.
+  std::mt19937 generator(table_->GetOid());
+  std::uniform_real_distribution<double> distribution(0.0, 1.0);
+
   for (size_t offset = 0; offset < tile_group_count; offset++) {
+    auto tile_group = table_->GetTileGroup(offset);
+    size_t tuple_count = tile_group->GetHeader()->GetActiveTupleCount();
+    active_tuple_count_ += tuple_count;
+    if (sample_rate >= 1.0 || distribution(generator) < sample_rate) {
+      tile_group_offsets.push_back(offset);
+      sampled_tuple_count_ += tuple_count;
+    }
+  }
+
+  // Always look at some data, even if the sample rate is tiny.
+  if (tile_group_offsets.empty() && tile_group_count > 0) {
+    oid_t offset = generator() % tile_group_count;
+    tile_group_offsets.push_back(offset);
+    sampled_tuple_count_ +=
+        table_->GetTileGroup(offset)->GetHeader()->GetActiveTupleCount();
+  }
+  return tile_group_offsets;
+}
+
+void TableStatsCollector::CollectTileGroupStats(
+    const std::vector<oid_t> &tile_group_offsets, size_t begin, size_t end,
+    ColumnStatsCollectors &collectors) {
+  // Collect stats for all tile groups in the range.
+  for (size_t idx = begin; idx < end; idx++) {
     std::shared_ptr<storage::TileGroup> tile_group =
-        table_->GetTileGroup(offset);
+        table_->GetTileGroup(tile_group_offsets[idx]);
     storage::TileGroupHeader *tile_group_header = tile_group->GetHeader();
     oid_t tuple_count = tile_group->GetAllocatedTupleCount();
-    active_tuple_count_ += tile_group_header->GetActiveTupleCount();
     // Collect stats for all tuples in the tile group.
     for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
       txn_id_t tuple_txn_id = tile_group_header->GetTransactionId(tuple_id);
@@ -57,27 +156,28 @@ void TableStatsCollector::CollectColumnStats() {
         // Collect stats for all columns.
         for (oid_t column_id = 0; column_id < column_count_; column_id++) {
           type::Value value = tile_group->GetValue(tuple_id, column_id);
-          column_stats_collectors_[column_id]->AddValue(value);
+          collectors[column_id]->AddValue(value);
         } /* column */
       }
     } /* tuple */
   }   /* tile group */
 }
 
-void TableStatsCollector::InitColumnStatsCollectors() {
+void TableStatsCollector::InitColumnStatsCollectors(
+    ColumnStatsCollectors &collectors) {
   oid_t database_id = table_->GetDatabaseOid();
   oid_t table_id = table_->GetOid();
   for (oid_t column_id = 0; column_id < column_count_; column_id++) {
     std::unique_ptr<ColumnStatsCollector> colstats(new ColumnStatsCollector(
         database_id, table_id, column_id, schema_->GetType(column_id),
         table_->GetName()+"."+schema_->GetColumn(column_id).GetName()));
-    column_stats_collectors_.push_back(std::move(colstats));
+    collectors.push_back(std::move(colstats));
   }
 
   // Set indexes in the column stats collectors.
   for (auto &column_set : table_->GetIndexColumns()) {
     auto column_id = *(column_set.begin());
-    column_stats_collectors_[column_id]->SetColumnIndexed();
+    collectors[column_id]->SetColumnIndexed();
   }
 }
 
@@ -147,6 +147,20 @@ std::unique_ptr<planner::AbstractPlan> CreateCopyPlan(
   std::string table_name(copy_stmt->cpy_table->GetTableName());
   bool deserialize_parameters = false;
 
+  if (copy_stmt->type == CopyType::IMPORT_CSV ||
+      copy_stmt->type == CopyType::IMPORT_TSV) {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    auto target_table = catalog::Catalog::GetInstance()->GetTableWithName(
+        copy_stmt->cpy_table->GetDatabaseName(), table_name, txn);
+    txn_manager.CommitTransaction(txn);
+
+    // The file is loaded straight into new tile groups, so there is no child
+    return std::unique_ptr<planner::AbstractPlan>(
+        new planner::CopyPlan(target_table, copy_stmt->file_path,
+                              copy_stmt->type, copy_stmt->delimiter));
+  }
+
   // If we're copying the query metric table, then we need to handle the
   // deserialization of prepared stmt parameters
   if (table_name == QUERY_METRICS_CATALOG_NAME) {
@@ -154,7 +168,7 @@ std::unique_ptr<planner::AbstractPlan> CreateCopyPlan(
     deserialize_parameters = true;
   }
 
-  std::unique_ptr<planner::AbstractPlan> copy_plan(
+  std::unique_ptr<planner::CopyPlan> copy_plan(
       new planner::CopyPlan(copy_stmt->file_path, deserialize_parameters));
 
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
@@ -164,6 +178,12 @@ std::unique_ptr<planner::AbstractPlan> CreateCopyPlan(
       copy_stmt->cpy_table->GetTableName(), txn);
   txn_manager.CommitTransaction(txn);
 
+  // The table is exported straight from its tile groups unless the parameters
+  // have to be deserialized, which is done on the output of the scan
+  copy_plan->copy_type = copy_stmt->type;
+  copy_plan->delimiter = copy_stmt->delimiter;
+  copy_plan->target_table = target_table;
+
   std::unique_ptr<planner::SeqScanPlan> select_plan(
       new planner::SeqScanPlan(target_table, nullptr, {}, false));
 
@@ -171,7 +191,7 @@ std::unique_ptr<planner::AbstractPlan> CreateCopyPlan(
 
   // Attach it to the copy plan
   copy_plan->AddChild(std::move(select_plan));
-  return copy_plan;
+  return std::unique_ptr<planner::AbstractPlan>(std::move(copy_plan));
 }
 
 std::unordered_map<std::string, std::shared_ptr<expression::AbstractExpression>>
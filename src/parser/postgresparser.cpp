@@ -12,6 +12,9 @@
 
 #include "parser/postgresparser.h"
 
+#include <cerrno>
+#include <limits>
+
 #include "expression/aggregate_expression.h"
 #include "expression/case_expression.h"
 #include "expression/comparison_expression.h"
@@ -1453,19 +1456,40 @@ parser::PrepareStatement *PostgresParser::PrepareTransform(PrepareStmt *root) {
   return result;
 }
 
-// TODO: Only support COPY TABLE TO FILE and DELIMITER option
+// TODO: Only support COPY TABLE TO/FROM FILE with DELIMITER and FORMAT options
 parser::CopyStatement *PostgresParser::CopyTransform(CopyStmt *root) {
-  auto result = new CopyStatement(peloton::CopyType::EXPORT_OTHER);
+  auto result = new CopyStatement(root->is_from ? peloton::CopyType::IMPORT_CSV
+                                                : peloton::CopyType::EXPORT_OTHER);
   result->cpy_table.reset(RangeVarTransform(root->relation));
   result->file_path = root->filename;
-  for (auto cell = root->options->head; cell != NULL; cell = cell->next) {
-    auto def_elem = reinterpret_cast<DefElem *>(cell->data.ptr_value);
-    if (strcmp(def_elem->defname, "delimiter") == 0) {
-      auto delimiter = reinterpret_cast<value *>(def_elem->arg)->val.str;
-      result->delimiter = *delimiter;
-      break;
+  bool text_format = false;
+  bool has_delimiter = false;
+  if (root->options != nullptr) {
+    for (auto cell = root->options->head; cell != NULL; cell = cell->next) {
+      auto def_elem = reinterpret_cast<DefElem *>(cell->data.ptr_value);
+      if (strcmp(def_elem->defname, "delimiter") == 0) {
+        auto delimiter = reinterpret_cast<value *>(def_elem->arg)->val.str;
+        result->delimiter = *delimiter;
+        has_delimiter = true;
+      } else if (strcmp(def_elem->defname, "format") == 0) {
+        auto format = reinterpret_cast<value *>(def_elem->arg)->val.str;
+        text_format = (strcmp(format, "text") == 0);
+        if (root->is_from == false && strcmp(format, "binary") == 0) {
+          result->type = peloton::CopyType::EXPORT_BINARY;
+        } else if (root->is_from == false && strcmp(format, "csv") == 0) {
+          result->type = peloton::CopyType::EXPORT_CSV;
+        }
+      }
     }
   }
+  // The text format is tab-separated unless told otherwise
+  if (text_format && has_delimiter == false) {
+    result->delimiter = '\t';
+  }
+  // Tab-separated files use the text format's backslash escapes
+  if (root->is_from && (text_format || result->delimiter == '\t')) {
+    result->type = peloton::CopyType::IMPORT_TSV;
+  }
   return result;
 }
 
@@ -1918,5 +1942,215 @@ std::unique_ptr<parser::SQLStatementList> PostgresParser::BuildParseTree(
   return sql_stmt;
 }
 
+bool PostgresParser::ParameterizeQuery(const std::string &query,
+                                       std::string &parameterized_query,
+                                       std::vector<type::Value> &params) {
+  parameterized_query.clear();
+  params.clear();
+
+  // The first keyword tells the statement type
+  size_t type_begin = query.find_first_not_of(" \t\n\r\f\v(");
+  if (type_begin == std::string::npos) {
+    return false;
+  }
+  size_t type_end = type_begin;
+  while (type_end < query.size() &&
+         isalpha(static_cast<unsigned char>(query[type_end]))) {
+    type_end++;
+  }
+  std::string type =
+      StringUtil::Upper(query.substr(type_begin, type_end - type_begin));
+  if (type != "SELECT" && type != "INSERT" && type != "UPDATE" &&
+      type != "DELETE") {
+    return false;
+  }
+
+  // The normalizer replaces every constant with a '?' and copies the rest of
+  // the query, so walking both strings finds the text of each constant
+  auto result = pg_query_normalize(query.c_str());
+  if (result.error) {
+    pg_query_free_normalize_result(result);
+    return false;
+  }
+  std::string normalized = result.normalized_query;
+  pg_query_free_normalize_result(result);
+
+  // Only the literals of the clauses whose values are bound when the plan
+  // executes become parameters: the WHERE clause, the VALUES of an INSERT and
+  // the SET of an UPDATE. Everything after a clause the optimizer plans with
+  // its values, like LIMIT, is left as it is.
+  bool bindable = false;
+  bool stopped = false;
+  bool quoted = false;
+  std::string word;
+  auto end_word = [&]() {
+    if (word.empty()) {
+      return;
+    }
+    auto keyword = StringUtil::Upper(word);
+    word.clear();
+    if (keyword == "WHERE") {
+      bindable = (type != "INSERT");
+    } else if (keyword == "VALUES") {
+      bindable = (type == "INSERT");
+    } else if (keyword == "SET") {
+      bindable = (type == "UPDATE");
+    } else if (keyword == "ORDER" || keyword == "GROUP" ||
+               keyword == "HAVING" || keyword == "LIMIT" ||
+               keyword == "OFFSET" || keyword == "RETURNING") {
+      stopped = true;
+    }
+  };
+
+  size_t pos = 0;
+  for (size_t i = 0; i < normalized.size(); i++) {
+    char c = normalized[i];
+    if (pos < query.size() && query[pos] == c) {
+      pos++;
+      parameterized_query.push_back(c);
+      if (c == '"') {
+        quoted = !quoted;
+      }
+      if (quoted) {
+        continue;
+      }
+      if (isalnum(static_cast<unsigned char>(c)) || c == '_') {
+        word.push_back(c);
+        continue;
+      }
+      end_word();
+
+      // Keywords in comments or further statements would throw off the
+      // clause tracking above
+      char next = (i + 1 < normalized.size()) ? normalized[i + 1] : '\0';
+      if ((c == '-' && next == '-') || (c == '/' && next == '*')) {
+        return false;
+      }
+      if (c == ';' &&
+          normalized.find_first_not_of(" \t\n\r\f\v;", i) !=
+              std::string::npos) {
+        return false;
+      }
+      continue;
+    }
+
+    if (c != '?' || quoted) {
+      return false;
+    }
+    size_t length = LiteralLength(query, pos);
+    if (length == 0) {
+      return false;
+    }
+    end_word();
+    std::string literal = query.substr(pos, length);
+    pos += length;
+
+    if (!bindable || stopped) {
+      parameterized_query.append(literal);
+      continue;
+    }
+    try {
+      params.push_back(LiteralValue(literal));
+    } catch (std::exception &e) {
+      return false;
+    }
+    parameterized_query.append("$" + std::to_string(params.size()));
+  }
+
+  return pos == query.size();
+}
+
+size_t PostgresParser::LiteralLength(const std::string &query, size_t pos) {
+  size_t end = pos;
+
+  // Strings, where '' is an escaped quote
+  if (query[end] == '\'') {
+    end++;
+    while (true) {
+      end = query.find('\'', end);
+      if (end == std::string::npos) {
+        return 0;
+      }
+      if (end + 1 < query.size() && query[end + 1] == '\'') {
+        end += 2;
+        continue;
+      }
+      return end + 1 - pos;
+    }
+  }
+
+  // Numbers, including the sign the normalizer folds into negative ones
+  if (query[end] == '-') {
+    end++;
+    while (end < query.size() &&
+           isspace(static_cast<unsigned char>(query[end]))) {
+      end++;
+    }
+  }
+  size_t digits = 0;
+  while (end < query.size() &&
+         isdigit(static_cast<unsigned char>(query[end]))) {
+    end++;
+    digits++;
+  }
+  if (end < query.size() && query[end] == '.') {
+    end++;
+    while (end < query.size() &&
+           isdigit(static_cast<unsigned char>(query[end]))) {
+      end++;
+      digits++;
+    }
+  }
+  if (digits == 0) {
+    return 0;
+  }
+  if (end < query.size() && (query[end] == 'e' || query[end] == 'E')) {
+    size_t exponent = end + 1;
+    if (exponent < query.size() &&
+        (query[exponent] == '+' || query[exponent] == '-')) {
+      exponent++;
+    }
+    if (exponent < query.size() &&
+        isdigit(static_cast<unsigned char>(query[exponent]))) {
+      end = exponent;
+      while (end < query.size() &&
+             isdigit(static_cast<unsigned char>(query[end]))) {
+        end++;
+      }
+    }
+  }
+  return end - pos;
+}
+
+type::Value PostgresParser::LiteralValue(const std::string &literal) {
+  if (literal[0] == '\'') {
+    std::string value;
+    for (size_t i = 1; i + 1 < literal.size(); i++) {
+      value.push_back(literal[i]);
+      if (literal[i] == '\'') {
+        i++;
+      }
+    }
+    return type::ValueFactory::GetVarcharValue(value);
+  }
+
+  bool negative = (literal[0] == '-');
+  std::string number =
+      literal.substr(literal.find_first_not_of("- \t\n\r\f\v"));
+
+  // Like the Postgres lexer, read integers that don't fit into 32 bits as
+  // floats
+  if (number.find_first_not_of("0123456789") == std::string::npos) {
+    errno = 0;
+    auto magnitude = strtoll(number.c_str(), nullptr, 10);
+    if (errno == 0 && magnitude <= std::numeric_limits<int32_t>::max()) {
+      return type::ValueFactory::GetIntegerValue(
+          static_cast<int32_t>(negative ? -magnitude : magnitude));
+    }
+  }
+  double value = std::stod(number);
+  return type::ValueFactory::GetDecimalValue(negative ? -value : value);
+}
+
 }  // namespace parser
 }  // namespace peloton
@@ -0,0 +1,48 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// access_counter_array.cpp
+//
+// Identification: src/statistics/access_counter_array.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "statistics/access_counter_array.h"
+
+namespace peloton {
+namespace stats {
+
+AccessCounterArray::AccessCounterArray()
+    : chunks_(new std::atomic<AccessCounters *>[kNumChunks]) {
+  for (size_t i = 0; i < kNumChunks; i++) {
+    chunks_[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+AccessCounterArray::~AccessCounterArray() {
+  for (size_t i = 0; i < kNumChunks; i++) {
+    delete[] chunks_[i].load(std::memory_order_relaxed);
+  }
+}
+
+AccessCounters *AccessCounterArray::AllocateChunk(size_t chunk_id) {
+  // Only the owning thread allocates, so nobody else can race us here
+  auto *chunk = new AccessCounters[kChunkSize];
+  chunks_[chunk_id].store(chunk, std::memory_order_release);
+  return chunk;
+}
+
+void AccessCounterArray::Reset() {
+  ForEach([](AccessCounters &counters) {
+    counters.reads.store(0, std::memory_order_relaxed);
+    counters.updates.store(0, std::memory_order_relaxed);
+    counters.inserts.store(0, std::memory_order_relaxed);
+    counters.deletes.store(0, std::memory_order_relaxed);
+  });
+}
+
+}  // namespace stats
+}  // namespace peloton
@@ -34,27 +34,41 @@ BackendStatsContext::GetBackendContextMap() {
 }
 
 BackendStatsContext* BackendStatsContext::GetInstance() {
-  // Each thread gets a backend stats context
+  // Each thread gets a backend stats context. Remember it, so the accesses it
+  // counts don't look it up in the map every time.
+  static thread_local BackendStatsContext* context = nullptr;
+  if (context != nullptr) {
+    return context;
+  }
+
   std::thread::id this_id = std::this_thread::get_id();
   std::shared_ptr<BackendStatsContext> result(nullptr);
   auto& stats_context_map = GetBackendContextMap();
   if (stats_context_map.Find(this_id, result) == false) {
-    result.reset(new BackendStatsContext(LATENCY_MAX_HISTORY_THREAD, true));
+    result.reset(new BackendStatsContext(true));
     stats_context_map.Insert(this_id, result);
   }
-  return result.get();
+  context = result.get();
+  return context;
 }
 
-BackendStatsContext::BackendStatsContext(size_t max_latency_history,
-                                         bool regiser_to_aggregator)
-    : txn_latencies_(MetricType::LATENCY, max_latency_history) {
+BackendStatsContext::BackendStatsContext(bool register_to_aggregator) {
   std::thread::id this_id = std::this_thread::get_id();
   thread_id_ = this_id;
 
-  is_registered_to_aggregator_ = regiser_to_aggregator;
+  // The histograms only take memory once a query of their type completes
+  for (size_t i = 0; i <= static_cast<size_t>(QueryType::QUERY_CREATE_VIEW);
+       i++) {
+    query_latencies_.emplace_back(new LatencyMetric(
+        MetricType::LATENCY,
+        "QUERY LATENCY (" + QueryTypeToString(static_cast<QueryType>(i)) +
+            ")"));
+  }
+
+  is_registered_to_aggregator_ = register_to_aggregator;
 
   // Register to the global aggregator
-  if (regiser_to_aggregator == true)
+  if (register_to_aggregator == true)
     StatsAggregator::GetInstance().RegisterContext(thread_id_, this);
 }
 
@@ -107,57 +121,39 @@ LatencyMetric& BackendStatsContext::GetTxnLatencyMetric() {
   return txn_latencies_;
 }
 
-void BackendStatsContext::IncrementTableReads(oid_t tile_group_id) {
-  oid_t table_id =
-      catalog::Manager::GetInstance().GetTileGroup(tile_group_id)->GetTableId();
-  oid_t database_id = catalog::Manager::GetInstance()
-                          .GetTileGroup(tile_group_id)
-                          ->GetDatabaseId();
-  auto table_metric = GetTableMetric(database_id, table_id);
-  PL_ASSERT(table_metric != nullptr);
-  table_metric->GetTableAccess().IncrementReads();
+LatencyMetric& BackendStatsContext::GetQueryLatencyMetric(
+    QueryType query_type) {
+  size_t offset = static_cast<size_t>(query_type);
+  if (offset >= query_latencies_.size()) {
+    offset = static_cast<size_t>(QueryType::QUERY_OTHER);
+  }
+  return *query_latencies_[offset];
+}
+
+void BackendStatsContext::IncrementTableReads(oid_t tile_group_id,
+                                              int64_t count) {
+  AccessCounters::Add(GetTableCounters(tile_group_id).reads, count);
   if (ongoing_query_metric_ != nullptr) {
-    ongoing_query_metric_->GetQueryAccess().IncrementReads();
+    ongoing_query_metric_->GetQueryAccess().IncrementReads(count);
   }
 }
 
 void BackendStatsContext::IncrementTableInserts(oid_t tile_group_id) {
-  oid_t table_id =
-      catalog::Manager::GetInstance().GetTileGroup(tile_group_id)->GetTableId();
-  oid_t database_id = catalog::Manager::GetInstance()
-                          .GetTileGroup(tile_group_id)
-                          ->GetDatabaseId();
-  auto table_metric = GetTableMetric(database_id, table_id);
-  PL_ASSERT(table_metric != nullptr);
-  table_metric->GetTableAccess().IncrementInserts();
+  AccessCounters::Add(GetTableCounters(tile_group_id).inserts, 1);
   if (ongoing_query_metric_ != nullptr) {
     ongoing_query_metric_->GetQueryAccess().IncrementInserts();
   }
 }
 
 void BackendStatsContext::IncrementTableUpdates(oid_t tile_group_id) {
-  oid_t table_id =
-      catalog::Manager::GetInstance().GetTileGroup(tile_group_id)->GetTableId();
-  oid_t database_id = catalog::Manager::GetInstance()
-                          .GetTileGroup(tile_group_id)
-                          ->GetDatabaseId();
-  auto table_metric = GetTableMetric(database_id, table_id);
-  PL_ASSERT(table_metric != nullptr);
-  table_metric->GetTableAccess().IncrementUpdates();
+  AccessCounters::Add(GetTableCounters(tile_group_id).updates, 1);
   if (ongoing_query_metric_ != nullptr) {
     ongoing_query_metric_->GetQueryAccess().IncrementUpdates();
   }
 }
 
 void BackendStatsContext::IncrementTableDeletes(oid_t tile_group_id) {
-  oid_t table_id =
-      catalog::Manager::GetInstance().GetTileGroup(tile_group_id)->GetTableId();
-  oid_t database_id = catalog::Manager::GetInstance()
-                          .GetTileGroup(tile_group_id)
-                          ->GetDatabaseId();
-  auto table_metric = GetTableMetric(database_id, table_id);
-  PL_ASSERT(table_metric != nullptr);
-  table_metric->GetTableAccess().IncrementDeletes();
+  AccessCounters::Add(GetTableCounters(tile_group_id).deletes, 1);
   if (ongoing_query_metric_ != nullptr) {
     ongoing_query_metric_->GetQueryAccess().IncrementDeletes();
   }
@@ -165,48 +161,29 @@ void BackendStatsContext::IncrementTableDeletes(oid_t tile_group_id) {
 
 void BackendStatsContext::IncrementIndexReads(size_t read_count,
                                               index::IndexMetadata* metadata) {
-  oid_t index_id = metadata->GetOid();
-  oid_t table_id = metadata->GetTableOid();
-  oid_t database_id = metadata->GetDatabaseOid();
-  auto index_metric = GetIndexMetric(database_id, table_id, index_id);
-  PL_ASSERT(index_metric != nullptr);
-  index_metric->GetIndexAccess().IncrementReads(read_count);
+  AccessCounters::Add(GetIndexCounters(metadata).reads, read_count);
 }
 
 void BackendStatsContext::IncrementIndexInserts(
     index::IndexMetadata* metadata) {
-  oid_t index_id = metadata->GetOid();
-  oid_t table_id = metadata->GetTableOid();
-  oid_t database_id = metadata->GetDatabaseOid();
-  auto index_metric = GetIndexMetric(database_id, table_id, index_id);
-  PL_ASSERT(index_metric != nullptr);
-  index_metric->GetIndexAccess().IncrementInserts();
+  AccessCounters::Add(GetIndexCounters(metadata).inserts, 1);
 }
 
 void BackendStatsContext::IncrementIndexUpdates(
     index::IndexMetadata* metadata) {
-  oid_t index_id = metadata->GetOid();
-  oid_t table_id = metadata->GetTableOid();
-  oid_t database_id = metadata->GetDatabaseOid();
-  auto index_metric = GetIndexMetric(database_id, table_id, index_id);
-  PL_ASSERT(index_metric != nullptr);
-  index_metric->GetIndexAccess().IncrementUpdates();
+  AccessCounters::Add(GetIndexCounters(metadata).updates, 1);
 }
 
 void BackendStatsContext::IncrementIndexDeletes(
     size_t delete_count, index::IndexMetadata* metadata) {
-  oid_t index_id = metadata->GetOid();
-  oid_t table_id = metadata->GetTableOid();
-  oid_t database_id = metadata->GetDatabaseOid();
-  auto index_metric = GetIndexMetric(database_id, table_id, index_id);
-  PL_ASSERT(index_metric != nullptr);
-  index_metric->GetIndexAccess().IncrementDeletes(delete_count);
+  AccessCounters::Add(GetIndexCounters(metadata).deletes, delete_count);
 }
 
 void BackendStatsContext::IncrementTxnCommitted(oid_t database_id) {
   auto database_metric = GetDatabaseMetric(database_id);
   PL_ASSERT(database_metric != nullptr);
   database_metric->IncrementTxnCommitted();
+  AccessCounters::Add(txns_committed_, 1);
   CompleteQueryMetric();
 }
 
@@ -214,6 +191,7 @@ void BackendStatsContext::IncrementTxnAborted(oid_t database_id) {
   auto database_metric = GetDatabaseMetric(database_id);
   PL_ASSERT(database_metric != nullptr);
   database_metric->IncrementTxnAborted();
+  AccessCounters::Add(txns_aborted_, 1);
   CompleteQueryMetric();
 }
 
@@ -223,6 +201,7 @@ void BackendStatsContext::InitQueryMetric(
   // TODO currently all queries belong to DEFAULT_DB
   ongoing_query_metric_.reset(new QueryMetric(
       MetricType::QUERY, statement->GetQueryString(), params, DEFAULT_DB_ID));
+  ongoing_query_type_ = statement->GetQueryType();
 }
 
 //===--------------------------------------------------------------------===//
@@ -232,7 +211,14 @@ void BackendStatsContext::InitQueryMetric(
 void BackendStatsContext::Aggregate(BackendStatsContext& source) {
   // Aggregate all global metrics
   txn_latencies_.Aggregate(source.txn_latencies_);
-  txn_latencies_.ComputeLatencies();
+  commit_latencies_.Aggregate(source.commit_latencies_);
+  compile_latencies_.Aggregate(source.compile_latencies_);
+  optimize_latencies_.Aggregate(source.optimize_latencies_);
+  for (size_t i = 0; i < query_latencies_.size(); i++) {
+    query_latencies_[i]->Aggregate(*source.query_latencies_[i]);
+  }
+  AccessCounters::Add(txns_committed_, source.GetTxnsCommitted());
+  AccessCounters::Add(txns_aborted_, source.GetTxnsAborted());
 
   // Aggregate all per-database metrics
   for (auto& database_item : source.database_metrics_) {
@@ -245,16 +231,28 @@ void BackendStatsContext::Aggregate(BackendStatsContext& source) {
                    table_item.second->GetTableId())
         ->Aggregate(*table_item.second);
   }
+  source.table_counters_.ForEach([this](const AccessCounters& counters) {
+    counters.AggregateInto(
+        GetTableMetric(counters.database_id, counters.table_id)
+            ->GetTableAccess());
+  });
 
   // Aggregate all per-index metrics
-  for (auto id : index_ids_) {
+  source.index_id_lock.Lock();
+  std::vector<oid_t> source_index_ids(source.index_ids_.begin(),
+                                      source.index_ids_.end());
+  source.index_id_lock.Unlock();
+  for (auto id : source_index_ids) {
     std::shared_ptr<IndexMetric> index_metric;
-    index_metrics_.Find(id, index_metric);
-    auto database_oid = index_metric->GetDatabaseId();
-    auto table_oid = index_metric->GetTableId();
-    index_metric->Aggregate(
-        *(source.GetIndexMetric(database_oid, table_oid, id)));
+    source.index_metrics_.Find(id, index_metric);
+    GetIndexMetric(index_metric->GetDatabaseId(), index_metric->GetTableId(),
+                   id)->Aggregate(*index_metric);
   }
+  source.index_counters_.ForEach([this](const AccessCounters& counters) {
+    counters.AggregateInto(GetIndexMetric(counters.database_id,
+                                          counters.table_id, counters.oid)
+                               ->GetIndexAccess());
+  });
 
   // Aggregate all per-query metrics
   std::shared_ptr<QueryMetric> query_metric;
@@ -267,6 +265,16 @@ void BackendStatsContext::Aggregate(BackendStatsContext& source) {
 
 void BackendStatsContext::Reset() {
   txn_latencies_.Reset();
+  commit_latencies_.Reset();
+  compile_latencies_.Reset();
+  optimize_latencies_.Reset();
+  for (auto& query_latencies : query_latencies_) {
+    query_latencies->Reset();
+  }
+  txns_committed_.store(0, std::memory_order_relaxed);
+  txns_aborted_.store(0, std::memory_order_relaxed);
+  table_counters_.Reset();
+  index_counters_.Reset();
 
   for (auto& database_item : database_metrics_) {
     database_item.second->Reset();
@@ -321,10 +329,28 @@ void BackendStatsContext::Reset() {
   }
 }
 
+void BackendStatsContext::ComputeLatencies() {
+  txn_latencies_.ComputeLatencies();
+  commit_latencies_.ComputeLatencies();
+  compile_latencies_.ComputeLatencies();
+  optimize_latencies_.ComputeLatencies();
+  for (auto& query_latencies : query_latencies_) {
+    query_latencies->ComputeLatencies();
+  }
+}
+
 std::string BackendStatsContext::ToString() const {
   std::stringstream ss;
 
   ss << txn_latencies_.GetInfo() << std::endl;
+  ss << commit_latencies_.GetInfo() << std::endl;
+  ss << compile_latencies_.GetInfo() << std::endl;
+  ss << optimize_latencies_.GetInfo() << std::endl;
+  for (auto& query_latencies : query_latencies_) {
+    if (query_latencies->GetLatencyMeasurements().count_ != 0) {
+      ss << query_latencies->GetInfo() << std::endl;
+    }
+  }
 
   for (auto& database_item : database_metrics_) {
     oid_t database_id = database_item.second->GetDatabaseId();
@@ -363,12 +389,36 @@ std::string BackendStatsContext::ToString() const {
 void BackendStatsContext::CompleteQueryMetric() {
   if (ongoing_query_metric_ != nullptr) {
     ongoing_query_metric_->GetProcessorMetric().RecordTime();
-    ongoing_query_metric_->GetQueryLatency().RecordLatency();
+    ongoing_query_metric_->RecordLatency();
+    GetQueryLatencyMetric(ongoing_query_type_)
+        .RecordLatency(ongoing_query_metric_->GetLatency());
     completed_query_metrics_.Enqueue(ongoing_query_metric_);
     ongoing_query_metric_.reset();
     LOG_TRACE("Ongoing query completed");
   }
 }
 
+AccessCounters& BackendStatsContext::GetTableCounters(oid_t tile_group_id) {
+  // Accesses mostly come in runs over the same tile group, so its table is
+  // only looked up when the tile group changes
+  if (tile_group_id != cached_tile_group_id_) {
+    auto tile_group =
+        catalog::Manager::GetInstance().GetTileGroup(tile_group_id);
+    PL_ASSERT(tile_group != nullptr);
+    oid_t table_id = tile_group->GetTableId();
+    cached_table_counters_ = &table_counters_.GetCounters(
+        tile_group->GetDatabaseId(), table_id, table_id);
+    cached_tile_group_id_ = tile_group_id;
+  }
+  return *cached_table_counters_;
+}
+
+AccessCounters& BackendStatsContext::GetIndexCounters(
+    index::IndexMetadata* metadata) {
+  return index_counters_.GetCounters(metadata->GetDatabaseOid(),
+                                     metadata->GetTableOid(),
+                                     metadata->GetOid());
+}
+
 }  // namespace stats
 }  // namespace peloton
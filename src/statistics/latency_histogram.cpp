@@ -0,0 +1,151 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// latency_histogram.cpp
+//
+// Identification: src/statistics/latency_histogram.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "statistics/latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace peloton {
+namespace stats {
+
+LatencyHistogram::LatencyHistogram() {}
+
+LatencyHistogram::LatencyHistogram(const LatencyHistogram &other) {
+  Merge(other);
+}
+
+LatencyHistogram &LatencyHistogram::operator=(const LatencyHistogram &other) {
+  if (this != &other) {
+    Reset();
+    Merge(other);
+  }
+  return *this;
+}
+
+LatencyHistogram::~LatencyHistogram() {
+  delete[] buckets_.load(std::memory_order_relaxed);
+}
+
+std::atomic<uint64_t> *LatencyHistogram::GetBuckets() {
+  auto *buckets = buckets_.load(std::memory_order_relaxed);
+  if (buckets == nullptr) {
+    buckets = new std::atomic<uint64_t>[kNumBuckets];
+    for (size_t i = 0; i < kNumBuckets; i++) {
+      buckets[i].store(0, std::memory_order_relaxed);
+    }
+    buckets_.store(buckets, std::memory_order_release);
+  }
+  return buckets;
+}
+
+uint64_t LatencyHistogram::GetBucketValue(size_t index) {
+  if (index < kSubBucketCount) {
+    return index;
+  }
+  uint64_t offset = index - kSubBucketCount;
+  uint64_t shift = offset / kSubBucketHalfCount + 1;
+  uint64_t low = (offset % kSubBucketHalfCount + kSubBucketHalfCount) << shift;
+  return low + ((1ull << shift) >> 1);
+}
+
+void LatencyHistogram::Record(double latency_ms) {
+  double latency_us = std::max(0.0, std::round(latency_ms * 1000.0));
+  uint64_t value = static_cast<uint64_t>(
+      std::min(latency_us, static_cast<double>(kMaxValue)));
+  Add(GetBuckets()[GetBucketIndex(value)], 1);
+  Add(sum_us_, value);
+  Add(count_, 1);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram &source) {
+  auto *source_buckets = source.buckets_.load(std::memory_order_acquire);
+  if (source_buckets == nullptr) {
+    return;
+  }
+  // Read the count first, so a concurrent record never makes the count larger
+  // than the sum of the buckets
+  uint64_t count = source.count_.load(std::memory_order_relaxed);
+  uint64_t sum_us = source.sum_us_.load(std::memory_order_relaxed);
+
+  auto *buckets = GetBuckets();
+  uint64_t bucket_total = 0;
+  for (size_t i = 0; i < kNumBuckets; i++) {
+    uint64_t bucket_count = source_buckets[i].load(std::memory_order_relaxed);
+    if (bucket_count != 0) {
+      Add(buckets[i], bucket_count);
+      bucket_total += bucket_count;
+    }
+  }
+  Add(count_, std::min(count, bucket_total));
+  Add(sum_us_, sum_us);
+}
+
+void LatencyHistogram::Subtract(const LatencyHistogram &earlier) {
+  auto *earlier_buckets = earlier.buckets_.load(std::memory_order_acquire);
+  auto *buckets = buckets_.load(std::memory_order_relaxed);
+  if (earlier_buckets == nullptr || buckets == nullptr) {
+    return;
+  }
+  // Counts can only be lower if this histogram was reset since, in which
+  // case they're clamped at zero
+  auto subtract = [](std::atomic<uint64_t> &counter, uint64_t count) {
+    uint64_t value = counter.load(std::memory_order_relaxed);
+    counter.store(value > count ? value - count : 0, std::memory_order_relaxed);
+  };
+  for (size_t i = 0; i < kNumBuckets; i++) {
+    subtract(buckets[i], earlier_buckets[i].load(std::memory_order_relaxed));
+  }
+  subtract(count_, earlier.count_.load(std::memory_order_relaxed));
+  subtract(sum_us_, earlier.sum_us_.load(std::memory_order_relaxed));
+}
+
+void LatencyHistogram::Reset() {
+  auto *buckets = buckets_.load(std::memory_order_relaxed);
+  if (buckets != nullptr) {
+    for (size_t i = 0; i < kNumBuckets; i++) {
+      buckets[i].store(0, std::memory_order_relaxed);
+    }
+  }
+  count_.store(0, std::memory_order_relaxed);
+  sum_us_.store(0, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::GetPercentile(double fraction) const {
+  auto *buckets = buckets_.load(std::memory_order_acquire);
+  uint64_t count = GetCount();
+  if (buckets == nullptr || count == 0) {
+    return 0.0;
+  }
+
+  // The rank of the latency we're after, counting from one
+  double rank = std::ceil(std::min(std::max(fraction, 0.0), 1.0) * count);
+  uint64_t target = std::max(static_cast<uint64_t>(rank), uint64_t{1});
+
+  uint64_t seen = 0;
+  size_t last_bucket = 0;
+  for (size_t i = 0; i < kNumBuckets; i++) {
+    uint64_t bucket_count = buckets[i].load(std::memory_order_relaxed);
+    if (bucket_count == 0) {
+      continue;
+    }
+    seen += bucket_count;
+    last_bucket = i;
+    if (seen >= target) {
+      break;
+    }
+  }
+  return GetBucketValue(last_bucket) / 1000.0;
+}
+
+}  // namespace stats
+}  // namespace peloton
@@ -0,0 +1,235 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// metrics_registry.cpp
+//
+// Identification: src/statistics/metrics_registry.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "statistics/metrics_registry.h"
+
+#include <limits>
+#include <sstream>
+
+#include "codegen/query_cache.h"
+#include "common/timer.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "gc/gc_manager_factory.h"
+#include "optimizer/plan_template_cache.h"
+#include "settings/settings_manager.h"
+#include "statistics/stats_aggregator.h"
+#include "threadpool/mono_queue_pool.h"
+
+namespace peloton {
+namespace stats {
+
+namespace {
+
+// Calls func with the stats context of every worker thread. The aggregator
+// (and thus the contexts) only exists when stats are collected.
+void ForEachStatsContext(std::function<void(BackendStatsContext &)> func) {
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) == StatsType::INVALID) {
+    return;
+  }
+  StatsAggregator::GetInstance().ForEachContext(func);
+}
+
+}  // namespace
+
+MetricsRegistry::MetricsRegistry() {}
+
+MetricsRegistry &MetricsRegistry::GetInstance() {
+  static MetricsRegistry metrics_registry;
+  return metrics_registry;
+}
+
+void MetricsRegistry::Register(const std::string &name, Metric metric) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  metrics_[name] = std::move(metric);
+}
+
+void MetricsRegistry::RegisterCounter(const std::string &name,
+                                      const std::string &help,
+                                      ValueFunc func) {
+  Register(name, {MetricKind::COUNTER, help, std::move(func), nullptr});
+}
+
+void MetricsRegistry::RegisterGauge(const std::string &name,
+                                    const std::string &help, ValueFunc func) {
+  Register(name, {MetricKind::GAUGE, help, std::move(func), nullptr});
+}
+
+void MetricsRegistry::RegisterSummary(const std::string &name,
+                                      const std::string &help,
+                                      HistogramFunc func) {
+  Register(name, {MetricKind::SUMMARY, help, nullptr, std::move(func)});
+}
+
+void MetricsRegistry::Unregister(const std::string &name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  metrics_.erase(name);
+}
+
+void MetricsRegistry::RegisterDefaultMetrics() {
+  RegisterCounter("peloton_txn_committed_total", "Transactions committed",
+                  [] {
+                    int64_t count = 0;
+                    ForEachStatsContext([&](BackendStatsContext &context) {
+                      count += context.GetTxnsCommitted();
+                    });
+                    return static_cast<double>(count);
+                  });
+  RegisterCounter("peloton_txn_aborted_total", "Transactions aborted", [] {
+    int64_t count = 0;
+    ForEachStatsContext([&](BackendStatsContext &context) {
+      count += context.GetTxnsAborted();
+    });
+    return static_cast<double>(count);
+  });
+
+  RegisterSummary("peloton_txn_latency_ms", "Transaction latency",
+                  [](LatencyHistogram &histogram) {
+                    ForEachStatsContext([&](BackendStatsContext &context) {
+                      histogram.Merge(
+                          context.GetTxnLatencyMetric().GetHistogram());
+                    });
+                  });
+  RegisterSummary("peloton_commit_latency_ms", "Transaction commit latency",
+                  [](LatencyHistogram &histogram) {
+                    ForEachStatsContext([&](BackendStatsContext &context) {
+                      histogram.Merge(
+                          context.GetCommitLatencyMetric().GetHistogram());
+                    });
+                  });
+  RegisterSummary("peloton_compile_time_ms", "Time taken to JIT compile plans",
+                  [](LatencyHistogram &histogram) {
+                    ForEachStatsContext([&](BackendStatsContext &context) {
+                      histogram.Merge(
+                          context.GetCompileLatencyMetric().GetHistogram());
+                    });
+                  });
+  RegisterSummary("peloton_optimize_time_ms",
+                  "Time taken to pick plans for queries",
+                  [](LatencyHistogram &histogram) {
+                    ForEachStatsContext([&](BackendStatsContext &context) {
+                      histogram.Merge(
+                          context.GetOptimizeLatencyMetric().GetHistogram());
+                    });
+                  });
+
+  RegisterGauge("peloton_gc_unlink_queue_size",
+                "Committed transactions waiting to be garbage collected", [] {
+                  return static_cast<double>(
+                      gc::GCManagerFactory::GetInstance().GetUnlinkQueueSize());
+                });
+  RegisterGauge("peloton_epoch_lag",
+                "Epochs between the current and the last expired epoch", [] {
+                  return static_cast<double>(
+                      concurrency::EpochManagerFactory::GetInstance()
+                          .GetEpochLag());
+                });
+
+  RegisterCounter("peloton_query_cache_hits_total",
+                  "Compiled query cache lookups that found a query", [] {
+                    return static_cast<double>(
+                        codegen::QueryCache::Instance().GetHitCount());
+                  });
+  RegisterCounter("peloton_query_cache_misses_total",
+                  "Compiled query cache lookups that missed", [] {
+                    return static_cast<double>(
+                        codegen::QueryCache::Instance().GetMissCount());
+                  });
+  RegisterGauge("peloton_query_cache_entries", "Compiled queries cached", [] {
+    return static_cast<double>(codegen::QueryCache::Instance().GetCount());
+  });
+
+  RegisterCounter("peloton_plan_template_cache_hits_total",
+                  "Optimizations that reused a cached plan", [] {
+                    return static_cast<double>(
+                        optimizer::PlanTemplateCache::GetInstance()
+                            .GetHitCount());
+                  });
+  RegisterCounter("peloton_plan_template_cache_misses_total",
+                  "Optimizations that found no cached plan to reuse", [] {
+                    return static_cast<double>(
+                        optimizer::PlanTemplateCache::GetInstance()
+                            .GetMissCount());
+                  });
+  RegisterCounter("peloton_plan_template_cache_reoptimizations_total",
+                  "Cached plans dropped because stats or table sizes changed",
+                  [] {
+                    return static_cast<double>(
+                        optimizer::PlanTemplateCache::GetInstance()
+                            .GetReoptimizeCount());
+                  });
+  RegisterGauge("peloton_plan_template_cache_entries",
+                "Operator trees with cached plans", [] {
+                  return static_cast<double>(
+                      optimizer::PlanTemplateCache::GetInstance().GetSize());
+                });
+
+  RegisterGauge("peloton_task_queue_size",
+                "Tasks waiting for a worker of the query thread pool", [] {
+                  return static_cast<double>(
+                      threadpool::MonoQueuePool::GetInstance()
+                          .GetTaskQueueSize());
+                });
+}
+
+std::string MetricsRegistry::Scrape() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Timer<std::ratio<1, 1000>> timer;
+  timer.Start();
+
+  std::ostringstream ss;
+  ss.precision(std::numeric_limits<double>::digits10);
+
+  auto write_summary = [&ss](const std::string &name,
+                             const LatencyHistogram &histogram) {
+    ss << "# TYPE " << name << " summary\n";
+    for (double quantile : {0.5, 0.99, 0.999}) {
+      ss << name << "{quantile=\"" << quantile << "\"} "
+         << histogram.GetPercentile(quantile) << "\n";
+    }
+    ss << name << "_sum " << histogram.GetSum() << "\n";
+    ss << name << "_count " << histogram.GetCount() << "\n";
+  };
+
+  for (auto &metric_item : metrics_) {
+    auto &name = metric_item.first;
+    auto &metric = metric_item.second;
+    ss << "# HELP " << name << " " << metric.help << "\n";
+    switch (metric.kind) {
+      case MetricKind::COUNTER:
+        ss << "# TYPE " << name << " counter\n";
+        ss << name << " " << metric.value_func() << "\n";
+        break;
+      case MetricKind::GAUGE:
+        ss << "# TYPE " << name << " gauge\n";
+        ss << name << " " << metric.value_func() << "\n";
+        break;
+      case MetricKind::SUMMARY: {
+        LatencyHistogram histogram;
+        metric.histogram_func(histogram);
+        write_summary(name, histogram);
+        break;
+      }
+    }
+  }
+
+  // The cost of collecting the metrics above, leaving out rendering the
+  // scrape times themselves
+  timer.Stop();
+  scrape_times_.Record(timer.GetDuration());
+  ss << "# HELP peloton_metrics_scrape_time_ms Time taken to collect metrics\n";
+  write_summary("peloton_metrics_scrape_time_ms", scrape_times_);
+  return ss.str();
+}
+
+}  // namespace stats
+}  // namespace peloton
@@ -27,8 +27,8 @@ namespace peloton {
 namespace stats {
 
 StatsAggregator::StatsAggregator(int64_t aggregation_interval_ms)
-    : stats_history_(0, false),
-      aggregated_stats_(LATENCY_MAX_HISTORY_AGGREGATOR, false),
+    : stats_history_(false),
+      aggregated_stats_(false),
       aggregation_interval_ms_(aggregation_interval_ms),
       thread_number_(0),
       total_prev_txn_committed_(0) {
@@ -86,6 +86,7 @@ void StatsAggregator::Aggregate(int64_t &interval_cnt, double &alpha,
     }
   }
   aggregated_stats_.Aggregate(stats_history_);
+  aggregated_stats_.ComputeLatencies();
   LOG_TRACE("%s\n", aggregated_stats_.ToString().c_str());
 
   int64_t current_txns_committed = 0;
@@ -145,7 +146,7 @@ void StatsAggregator::UpdateQueryMetrics(int64_t time_stamp,
     auto updates = table_access.GetUpdates();
     auto deletes = table_access.GetDeletes();
     auto inserts = table_access.GetInserts();
-    auto latency = query_metric->GetQueryLatency().GetFirstLatencyValue();
+    auto latency = query_metric->GetLatency();
     auto cpu_system = query_metric->GetProcessorMetric().GetSystemDuration();
     auto cpu_user = query_metric->GetProcessorMetric().GetUserDuration();
 
@@ -231,7 +232,7 @@ void StatsAggregator::UpdateTableMetrics(storage::Database *database,
     auto table_oid = table->GetOid();
     auto table_metrics =
         aggregated_stats_.GetTableMetric(database_oid, table_oid);
-    auto table_access = table_metrics->GetTableAccess();
+    auto &table_access = table_metrics->GetTableAccess();
     auto reads = table_access.GetReads();
     auto updates = table_access.GetUpdates();
     auto deletes = table_access.GetDeletes();
@@ -261,14 +262,15 @@ void StatsAggregator::UpdateIndexMetrics(storage::Database *database,
     auto index_metric =
         aggregated_stats_.GetIndexMetric(database_oid, table_oid, index_oid);
 
-    auto index_access = index_metric->GetIndexAccess();
+    auto &index_access = index_metric->GetIndexAccess();
     auto reads = index_access.GetReads();
     auto deletes = index_access.GetDeletes();
     auto inserts = index_access.GetInserts();
+    auto memory_bytes = index->GetMemoryFootprint();
 
     catalog::IndexMetricsCatalog::GetInstance()->InsertIndexMetrics(
         database_oid, table_oid, index_oid, reads, deletes, inserts, time_stamp,
-        pool_.get(), txn);
+        memory_bytes, pool_.get(), txn);
   }
 }
 
@@ -313,6 +315,19 @@ void StatsAggregator::RegisterContext(std::thread::id id_,
   LOG_DEBUG("Stats aggregator hash map size: %ld", backend_stats_.size());
 }
 
+void StatsAggregator::ForEachContext(
+    std::function<void(BackendStatsContext &)> func) {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  std::thread::id this_id = aggregator_thread_.get_id();
+  for (auto &val : backend_stats_) {
+    // Exclude the txn stats generated by the aggregator thread
+    if (val.first != this_id) {
+      func(*val.second);
+    }
+  }
+  func(stats_history_);
+}
+
 // Unregister a BackendStatsContext. Currently we directly reuse the thread id
 // instead of explicitly unregistering it.
 void StatsAggregator::UnregisterContext(std::thread::id id) {
@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// cold_storage_manager.cpp
+//
+// Identification: src/storage/cold_storage_manager.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/cold_storage_manager.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "common/logger.h"
+#include "common/macros.h"
+#include "settings/settings_manager.h"
+
+namespace peloton {
+namespace storage {
+
+ColdStorageManager &ColdStorageManager::GetInstance() {
+  static ColdStorageManager cold_storage_manager;
+  return cold_storage_manager;
+}
+
+ColdStorageManager::ColdStorageManager()
+    : page_size_(sysconf(_SC_PAGESIZE)) {}
+
+ColdStorageManager::~ColdStorageManager() { Reset(); }
+
+ColdStorageManager::Segment *ColdStorageManager::GetSegment(
+    const oid_t &table_id) {
+  auto entry = segments_.find(table_id);
+  if (entry != segments_.end()) {
+    return &entry->second;
+  }
+
+  std::string path = settings::SettingsManager::GetString(
+                         settings::SettingId::cold_storage_directory) +
+                     "/peloton_cold_" + std::to_string(table_id) + "_XXXXXX";
+  std::vector<char> path_buffer(path.begin(), path.end());
+  path_buffer.push_back('\0');
+
+  int fd = mkstemp(path_buffer.data());
+  if (fd < 0) {
+    LOG_ERROR("Could not create segment file %s: %s", path.c_str(),
+              strerror(errno));
+    return nullptr;
+  }
+  // the mappings keep the file alive until they are gone
+  unlink(path_buffer.data());
+
+  auto &segment = segments_[table_id];
+  segment.fd = fd;
+  segment.size = 0;
+  segment.segment_id = next_segment_id_++;
+  return &segment;
+}
+
+char *ColdStorageManager::Evict(const oid_t &table_id, const char *data,
+                                const size_t &size) {
+  std::lock_guard<std::mutex> lock(segments_lock_);
+  auto segment = GetSegment(table_id);
+  if (segment == nullptr) {
+    return nullptr;
+  }
+
+  // mappings must start at a page boundary
+  size_t offset = (segment->size + page_size_ - 1) / page_size_ * page_size_;
+  size_t written = 0;
+  while (written < size) {
+    auto result = pwrite(segment->fd, data + written, size - written,
+                         offset + written);
+    if (result < 0) {
+      if (errno == EINTR) continue;
+      LOG_ERROR("Could not write segment of table %u: %s", table_id,
+                strerror(errno));
+      return nullptr;
+    }
+    written += result;
+  }
+
+  void *address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                       segment->fd, offset);
+  if (address == MAP_FAILED) {
+    LOG_ERROR("Could not map segment of table %u: %s", table_id,
+              strerror(errno));
+    return nullptr;
+  }
+
+  segment->size = offset + size;
+  mappings_[reinterpret_cast<char *>(address)] = {table_id, segment->segment_id,
+                                                  offset};
+  evicted_size_ += size;
+  LOG_TRACE("Evicted %zu bytes of table %u at offset %zu", size, table_id,
+            offset);
+  return reinterpret_cast<char *>(address);
+}
+
+void ColdStorageManager::Release(char *address, const size_t &size) {
+  if (munmap(address, size) != 0) {
+    LOG_ERROR("Could not unmap cold data: %s", strerror(errno));
+  }
+
+  std::lock_guard<std::mutex> lock(segments_lock_);
+  auto mapping = mappings_.find(address);
+  if (mapping == mappings_.end()) {
+    return;
+  }
+  evicted_size_ -= size;
+
+  // the segment of a dropped table is freed along with its last mapping
+  auto segment = segments_.find(mapping->second.table_id);
+  if (segment != segments_.end() &&
+      segment->second.segment_id == mapping->second.segment_id) {
+#ifdef FALLOC_FL_PUNCH_HOLE
+    // no other mapping shares the pages, since every one starts at a page
+    // boundary
+    if (fallocate(segment->second.fd,
+                  FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                  mapping->second.offset, size) != 0) {
+      LOG_DEBUG("Could not free segment space of table %u: %s",
+                mapping->second.table_id, strerror(errno));
+    }
+#endif
+  }
+  mappings_.erase(mapping);
+}
+
+void ColdStorageManager::DropTable(const oid_t &table_id) {
+  std::lock_guard<std::mutex> lock(segments_lock_);
+  auto entry = segments_.find(table_id);
+  if (entry == segments_.end()) {
+    return;
+  }
+  close(entry->second.fd);
+  segments_.erase(entry);
+}
+
+void ColdStorageManager::Reset() {
+  std::lock_guard<std::mutex> lock(segments_lock_);
+  for (auto &entry : segments_) {
+    close(entry.second.fd);
+  }
+  segments_.clear();
+  mappings_.clear();
+  evicted_size_ = 0;
+}
+
+}  // namespace storage
+}  // namespace peloton
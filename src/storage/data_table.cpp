@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <mutex>
 #include <utility>
 
@@ -29,6 +30,7 @@
 #include "index/index.h"
 #include "logging/log_manager.h"
 #include "storage/abstract_table.h"
+#include "storage/cold_storage_manager.h"
 #include "storage/data_table.h"
 #include "storage/database.h"
 #include "storage/storage_manager.h"
@@ -113,6 +115,9 @@ DataTable::~DataTable() {
     }
   }
 
+  // the tile groups unmap their evicted data once they are gone
+  ColdStorageManager::GetInstance().DropTable(table_oid);
+
   // clean up foreign keys
   for (auto foreign_key : foreign_keys_) {
     delete foreign_key;
@@ -236,13 +241,25 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple) {
   // check if there are recycled tuple slots
   auto &gc_manager = gc::GCManagerFactory::GetInstance();
   auto free_item_pointer = gc_manager.ReturnFreeSlot(this->table_oid);
-  if (free_item_pointer.IsNull() == false) {
+  while (free_item_pointer.IsNull() == false) {
+    auto tile_group =
+        catalog::Manager::GetInstance().GetTileGroup(free_item_pointer.block);
+
+    // the slot was recycled before its tile group became immutable, e.g.
+    // because the tile group is being compacted. drop it.
+    if (tile_group == nullptr ||
+        tile_group->GetHeader()->GetImmutability() == true ||
+        free_item_pointer.offset >= tile_group->GetAllocatedTupleCount()) {
+      free_item_pointer = gc_manager.ReturnFreeSlot(this->table_oid);
+      continue;
+    }
+
     // when inserting a tuple
     if (tuple != nullptr) {
-      auto tile_group =
-          catalog::Manager::GetInstance().GetTileGroup(free_item_pointer.block);
       tile_group->CopyTuple(tuple, free_item_pointer.offset);
     }
+    // the tile group had a hole, so it may become all-visible again
+    gc_manager.RegisterFreezeCandidate(free_item_pointer.block);
     return free_item_pointer;
   }
   //====================================================
@@ -270,6 +287,10 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple) {
   // then create a new tile group
   if (tuple_slot == tile_group->GetAllocatedTupleCount() - 1) {
     AddDefaultTileGroup(active_tile_group_id);
+
+    // the tile group is full; it becomes all-visible once its versions are
+    // older than every active transaction
+    gc_manager.RegisterFreezeCandidate(tile_group_id);
   }
 
   LOG_TRACE("tile group count: %lu, tile group id: %u, address: %p",
@@ -832,6 +853,8 @@ bool DataTable::CheckForeignKeyConstraints(
  */
 void DataTable::IncreaseTupleCount(const size_t &amount) {
   number_of_tuples_ += amount;
+  // Every insert, update and delete claims a new version slot through here
+  modification_count_.fetch_add(amount, std::memory_order_relaxed);
   dirty_ = true;
 }
 
@@ -870,6 +893,39 @@ bool DataTable::IsDirty() const { return dirty_; }
  */
 void DataTable::ResetDirty() { dirty_ = false; }
 
+/**
+ * @brief Get the number of modifications made to this table
+ * @return number of inserted, updated or deleted tuple versions
+ */
+size_t DataTable::GetModificationCount() const {
+  return modification_count_.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Increase the number of committed rows in this table
+ * @param amount amount to increase
+ */
+void DataTable::IncreaseLiveTupleCount(const size_t &amount) {
+  live_tuple_count_.fetch_add(amount, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Decrease the number of committed rows in this table
+ * @param amount amount to decrease
+ */
+void DataTable::DecreaseLiveTupleCount(const size_t &amount) {
+  live_tuple_count_.fetch_sub(amount, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the number of rows committed transactions inserted and didn't
+ * delete
+ * @return number of live rows
+ */
+size_t DataTable::GetLiveTupleCount() const {
+  return live_tuple_count_.load(std::memory_order_relaxed);
+}
+
 //===--------------------------------------------------------------------===//
 // TILE GROUP
 //===--------------------------------------------------------------------===//
@@ -936,6 +992,28 @@ oid_t DataTable::AddDefaultTileGroup(const size_t &active_tile_group_id) {
   return tile_group_id;
 }
 
+std::shared_ptr<TileGroup> DataTable::AppendTileGroup() {
+  std::shared_ptr<TileGroup> tile_group(
+      GetTileGroupWithLayout(GetTileGroupLayout()));
+  PL_ASSERT(tile_group.get());
+
+  oid_t tile_group_id = tile_group->GetTileGroupId();
+  tile_groups_.Append(tile_group_id);
+
+  // add tile group metadata in locator
+  catalog::Manager::GetInstance().AddTileGroup(tile_group_id, tile_group);
+
+  // we must guarantee that the compiler always add tile group before adding
+  // tile_group_count_.
+  COMPILER_MEMORY_FENCE;
+
+  tile_group_count_++;
+
+  LOG_TRACE("Appended tile group : %u ", tile_group_id);
+
+  return tile_group;
+}
+
 void DataTable::AddTileGroupWithOidForRecovery(const oid_t &tile_group_id) {
   PL_ASSERT(tile_group_id);
 
@@ -1266,10 +1344,10 @@ void SetTransformedTileGroup(storage::TileGroup *orig_tile_group,
     }
   }
 
-  // Finally, copy over the tile header
+  // Finally, copy over the versions
   auto header = orig_tile_group->GetHeader();
   auto new_header = new_tile_group->GetHeader();
-  *new_header = *header;
+  new_header->CopyRelocatedVersions(*header);
 }
 
 storage::TileGroup *DataTable::TransformTileGroup(
@@ -1286,6 +1364,10 @@ storage::TileGroup *DataTable::TransformTileGroup(
   // Get orig tile group from catalog
   auto &catalog_manager = catalog::Manager::GetInstance();
   auto tile_group = catalog_manager.GetTileGroup(tile_group_id);
+  if (tile_group == nullptr) {
+    return nullptr;
+  }
+
   auto diff = tile_group->GetSchemaDifference(default_partition_);
 
   // Check threshold for transformation
@@ -1293,6 +1375,14 @@ storage::TileGroup *DataTable::TransformTileGroup(
     return nullptr;
   }
 
+  // Only all-visible tile groups are transformed, since their tuples do not
+  // change while they are copied. A transaction acquiring ownership of a
+  // tuple cancels the transformation.
+  auto header = tile_group->GetHeader();
+  if (header->BeginRelocate() == false) {
+    return nullptr;
+  }
+
   LOG_TRACE("Transforming tile group : %u", tile_group_offset);
 
   // Get the schema for the new transformed tile group
@@ -1310,13 +1400,50 @@ storage::TileGroup *DataTable::TransformTileGroup(
   // Set the transformed tile group column-at-a-time
   SetTransformedTileGroup(tile_group.get(), new_tile_group.get());
 
-  // Set the location of the new tile group
-  // and clean up the orig tile group
+  if (header->FinishRelocate() == false) {
+    LOG_TRACE("Tile group %u was modified while transforming", tile_group_id);
+    return nullptr;
+  }
+
+  // Set the location of the new tile group. Transactions that already hold
+  // the orig tile group keep reading it, and fail to modify it.
   catalog_manager.AddTileGroup(tile_group_id, new_tile_group);
 
+  // Any transaction that read the orig tile group began before this one, so
+  // its commit id bounds theirs. Writers with a smaller commit id abort.
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  cid_t reader_cid = std::max(txn->GetCommitId(),
+                              header->GetAllVisibleReaderCommitId());
+  txn_manager.CommitTransaction(txn);
+  new_tile_group->GetHeader()->SetRelocatedReaderCommitId(reader_cid);
+
+  // Let the GC mark the new tile group all-visible again
+  gc::GCManagerFactory::GetInstance().RegisterFreezeCandidate(tile_group_id);
+
   return new_tile_group.get();
 }
 
+void DataTable::ReleaseTileGroup(const oid_t &tile_group_id) {
+  auto &catalog_manager = catalog::Manager::GetInstance();
+  auto tile_group = catalog_manager.GetTileGroup(tile_group_id);
+  if (tile_group == nullptr) {
+    return;
+  }
+
+  // The tile group keeps its offset in the table, so that concurrent scans
+  // neither skip nor revisit tile groups. Only its storage is released, once
+  // the transactions that still hold it are done. The replacement has a
+  // single slot that is never handed out.
+  std::shared_ptr<storage::TileGroup> empty_tile_group(
+      TileGroupFactory::GetTileGroup(
+          tile_group->GetDatabaseId(), tile_group->GetTableId(),
+          tile_group_id, this, tile_group->GetTileSchemas(),
+          tile_group->GetColumnMap(), 1));
+  empty_tile_group->GetHeader()->SetImmutability();
+  catalog_manager.AddTileGroup(tile_group_id, empty_tile_group);
+}
+
 void DataTable::RecordLayoutSample(const tuning::Sample &sample) {
   // Add layout sample
   {
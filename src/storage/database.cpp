@@ -18,6 +18,7 @@
 #include "common/logger.h"
 #include "gc/gc_manager_factory.h"
 #include "index/index.h"
+#include "optimizer/stats/stats_refresher.h"
 #include "storage/database.h"
 #include "storage/table_factory.h"
 
@@ -87,6 +88,9 @@ void Database::DropTableWithOid(const oid_t table_oid) {
     // Deregister table from Query Cache manager
     codegen::QueryCache::Instance().Remove(table_oid);
 
+    // Deregister table from the stats refresher
+    optimizer::StatsRefresher::GetInstance().DeregisterTable(table_oid);
+
     oid_t table_offset = 0;
     for (auto table : tables) {
       if (table->GetOid() == table_oid) {
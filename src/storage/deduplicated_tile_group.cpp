@@ -0,0 +1,292 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// deduplicated_tile_group.cpp
+//
+// Identification: src/storage/deduplicated_tile_group.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/deduplicated_tile_group.h"
+
+#include <algorithm>
+#include <cstring>
+#include <set>
+
+#include "common/logger.h"
+#include "common/macros.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/zone_map_manager.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace storage {
+
+// Varlen entries hold their length followed by the data
+static inline uint32_t GetVarlenLength(const char *varlen) {
+  return *reinterpret_cast<const uint32_t *>(varlen);
+}
+
+// Order varlen data by length, then by bytes
+static inline int CompareVarlen(const char *left, uint32_t left_len,
+                                const char *right, uint32_t right_len) {
+  if (left_len != right_len) return (left_len < right_len) ? -1 : 1;
+  return memcmp(left, right, left_len);
+}
+
+struct VarlenLess {
+  bool operator()(const char *left, const char *right) const {
+    return CompareVarlen(left + sizeof(uint32_t), GetVarlenLength(left),
+                         right + sizeof(uint32_t), GetVarlenLength(right)) < 0;
+  }
+};
+
+static bool IsIntegerType(type::TypeId type_id) {
+  return type_id == type::TypeId::TINYINT ||
+         type_id == type::TypeId::SMALLINT ||
+         type_id == type::TypeId::INTEGER || type_id == type::TypeId::BIGINT;
+}
+
+// Whether comparing the values needs neither a cast nor a string conversion
+static bool IsDirectlyComparable(const type::Value &left,
+                                 const type::Value &right) {
+  auto is_numeric = [](type::TypeId type_id) {
+    return IsIntegerType(type_id) || type_id == type::TypeId::DECIMAL;
+  };
+  return left.GetTypeId() == right.GetTypeId() ||
+         (is_numeric(left.GetTypeId()) && is_numeric(right.GetTypeId()));
+}
+
+std::shared_ptr<const DeduplicatedTileGroup> DeduplicatedTileGroup::Deduplicate(
+    TileGroup *tile_group, const DeduplicatedTileGroup *previous,
+    std::vector<RetiredVarlen> &retired) {
+  std::shared_ptr<DeduplicatedTileGroup> deduplicated(
+      new DeduplicatedTileGroup());
+  oid_t column_count = tile_group->GetColumnMap().size();
+  deduplicated->columns_.resize(column_count);
+
+  for (oid_t column_id = 0; column_id < column_count; column_id++) {
+    oid_t tile_offset, tile_column_id;
+    tile_group->LocateTileAndColumn(column_id, tile_offset, tile_column_id);
+    auto tile_schema = tile_group->GetTile(tile_offset)->GetSchema();
+    auto type_id = tile_schema->GetType(tile_column_id);
+
+    if ((type_id == type::TypeId::VARCHAR ||
+         type_id == type::TypeId::VARBINARY) &&
+        tile_schema->IsInlined(tile_column_id) == false) {
+      deduplicated->DeduplicateVarlenColumn(tile_group, column_id, previous,
+                                       retired);
+    } else if (type_id != type::TypeId::BOOLEAN) {
+      deduplicated->ComputeFixedColumnBounds(tile_group, column_id);
+    }
+  }
+
+  LOG_TRACE("Deduplicated tile group %u, saving %zu bytes",
+            tile_group->GetTileGroupId(), deduplicated->saved_bytes_);
+  return deduplicated;
+}
+
+void DeduplicatedTileGroup::DeduplicateVarlenColumn(
+    TileGroup *tile_group, oid_t column_id,
+    const DeduplicatedTileGroup *previous,
+    std::vector<RetiredVarlen> &retired) {
+  auto &column = columns_[column_id];
+  oid_t tile_offset, tile_column_id;
+  tile_group->LocateTileAndColumn(column_id, tile_offset, tile_column_id);
+  auto tile = tile_group->GetTileReference(tile_offset);
+  auto tile_schema = tile->GetSchema();
+  auto type_id = tile_schema->GetType(tile_column_id);
+  size_t offset = tile_schema->GetOffset(tile_column_id);
+  oid_t tuple_count = tile_group->GetHeader()->GetCurrentNextTupleSlot();
+
+  // Transactions may read the fields while they are pointed to the entries,
+  // so a column is only deduplicated if every field can be stored atomically
+  std::set<const char *> referenced;
+  size_t field_count = 0;
+  bool aligned = true;
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    const char *field = tile->GetTupleLocation(tuple_id) + offset;
+    if (reinterpret_cast<uintptr_t>(field) % alignof(const char *) != 0) {
+      aligned = false;
+    }
+    const char *varlen = *reinterpret_cast<const char *const *>(field);
+    if (varlen == nullptr) continue;
+    referenced.insert(varlen);
+    field_count++;
+  }
+
+  // Entries of the previous deduplication are kept if they are still used, so
+  // the fields pointing to them stay as they are
+  std::set<const char *> candidates(referenced);
+  std::set<const char *, VarlenLess> distinct;
+  if (previous != nullptr && column_id < previous->columns_.size()) {
+    for (auto entry : previous->columns_[column_id].distinct) {
+      candidates.insert(entry);
+      if (referenced.count(entry) != 0) distinct.insert(entry);
+    }
+  }
+  for (auto varlen : referenced) {
+    distinct.insert(varlen);
+  }
+
+  column.analyzed = true;
+  for (auto entry : distinct) {
+    auto data = entry + sizeof(uint32_t);
+    auto len = GetVarlenLength(entry);
+    auto value =
+        (type_id == type::TypeId::VARCHAR)
+            ? type::ValueFactory::GetVarcharValue(data, len, true)
+            : type::ValueFactory::GetVarbinaryValue(
+                  reinterpret_cast<const unsigned char *>(data), len, true);
+    if (column.has_values == false) {
+      column.has_values = true;
+      column.min = value.Copy();
+      column.max = value.Copy();
+      continue;
+    }
+    if (value.CompareLessThan(column.min) == CmpBool::CmpTrue) {
+      column.min = value.Copy();
+    } else if (value.CompareGreaterThan(column.max) == CmpBool::CmpTrue) {
+      column.max = value.Copy();
+    }
+  }
+
+  // The layout of the tile group never changes, so neither did the column
+  // have previous entries
+  if (aligned == false) {
+    PL_ASSERT(previous == nullptr || column_id >= previous->columns_.size() ||
+              previous->columns_[column_id].distinct.empty());
+    return;
+  }
+
+  // Retire whatever is not a distinct entry. Without duplicates this is
+  // only the unused entries of the previous deduplication.
+  for (auto varlen : candidates) {
+    auto entry = distinct.find(varlen);
+    if (entry != distinct.end() && *entry == varlen) continue;
+    retired.emplace_back(tile, const_cast<char *>(varlen));
+    saved_bytes_ += GetVarlenLength(varlen) + sizeof(uint32_t);
+  }
+  // Every field has its own value, so there is nothing to share
+  if (distinct.size() == field_count) {
+    return;
+  }
+
+  // Point every field to its entry, with a single store each
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    auto field = reinterpret_cast<const char **>(
+        tile->GetTupleLocation(tuple_id) + offset);
+    if (*field == nullptr) continue;
+    __atomic_store_n(field, *distinct.find(*field), __ATOMIC_RELAXED);
+  }
+
+  column.encoding = ColumnEncoding::DEDUPLICATED;
+  column.distinct.assign(distinct.begin(), distinct.end());
+  entries_.insert(distinct.begin(), distinct.end());
+}
+
+void DeduplicatedTileGroup::ComputeFixedColumnBounds(TileGroup *tile_group,
+                                                     oid_t column_id) {
+  auto &column = columns_[column_id];
+  oid_t tuple_count = tile_group->GetHeader()->GetCurrentNextTupleSlot();
+
+  column.analyzed = true;
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    auto value = tile_group->GetValue(tuple_id, column_id);
+    if (value.IsNull()) continue;
+    if (column.has_values == false) {
+      column.has_values = true;
+      column.min = value.Copy();
+      column.max = value.Copy();
+      continue;
+    }
+    if (value.CompareLessThan(column.min) == CmpBool::CmpTrue) {
+      column.min = value.Copy();
+    } else if (value.CompareGreaterThan(column.max) == CmpBool::CmpTrue) {
+      column.max = value.Copy();
+    }
+  }
+}
+
+const char *DeduplicatedTileGroup::LookupEntry(
+    oid_t column_id, const type::Value &value) const {
+  auto &column = columns_[column_id];
+  PL_ASSERT(column.encoding == ColumnEncoding::DEDUPLICATED);
+  if (value.IsNull()) return nullptr;
+
+  const char *data = value.GetData();
+  uint32_t len = value.GetLength();
+  auto entry = std::lower_bound(
+      column.distinct.begin(), column.distinct.end(), data,
+      [len](const char *entry, const char *data) {
+        return CompareVarlen(entry + sizeof(uint32_t), GetVarlenLength(entry),
+                             data, len) < 0;
+      });
+  if (entry == column.distinct.end() ||
+      CompareVarlen((*entry) + sizeof(uint32_t), GetVarlenLength(*entry), data,
+                    len) != 0) {
+    return nullptr;
+  }
+  return *entry;
+}
+
+bool DeduplicatedTileGroup::ShouldScan(const PredicateInfo *predicates,
+                                       int32_t num_predicates) const {
+  for (int32_t i = 0; i < num_predicates; i++) {
+    auto &predicate = predicates[i];
+    if (predicate.col_id < 0 ||
+        static_cast<size_t>(predicate.col_id) >= columns_.size()) {
+      continue;
+    }
+    auto &column = columns_[predicate.col_id];
+    auto &value = predicate.predicate_value;
+    if (column.analyzed == false || value.IsNull()) continue;
+
+    // Comparisons with null are never true
+    if (column.has_values == false) return false;
+    if (IsDirectlyComparable(value, column.min) == false) continue;
+
+    switch (predicate.comparison_operator) {
+      case static_cast<int>(ExpressionType::COMPARE_EQUAL):
+        if (column.encoding == ColumnEncoding::DEDUPLICATED &&
+            value.GetTypeId() == column.min.GetTypeId()) {
+          if (LookupEntry(predicate.col_id, value) == nullptr) return false;
+        } else if (value.CompareLessThan(column.min) == CmpBool::CmpTrue ||
+                   value.CompareGreaterThan(column.max) == CmpBool::CmpTrue) {
+          return false;
+        }
+        break;
+      case static_cast<int>(ExpressionType::COMPARE_LESSTHAN):
+        if (value.CompareGreaterThan(column.min) != CmpBool::CmpTrue) {
+          return false;
+        }
+        break;
+      case static_cast<int>(ExpressionType::COMPARE_LESSTHANOREQUALTO):
+        if (value.CompareGreaterThanEquals(column.min) != CmpBool::CmpTrue) {
+          return false;
+        }
+        break;
+      case static_cast<int>(ExpressionType::COMPARE_GREATERTHAN):
+        if (value.CompareLessThan(column.max) != CmpBool::CmpTrue) {
+          return false;
+        }
+        break;
+      case static_cast<int>(ExpressionType::COMPARE_GREATERTHANOREQUALTO):
+        if (value.CompareLessThanEquals(column.max) != CmpBool::CmpTrue) {
+          return false;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  return true;
+}
+
+}  // namespace storage
+}  // namespace peloton
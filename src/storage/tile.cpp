@@ -21,6 +21,7 @@
 #include "type/ephemeral_pool.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "storage/backend_manager.h"
+#include "storage/cold_storage_manager.h"
 #include "storage/tile.h"
 #include "storage/tile_group_header.h"
 #include "storage/tuple.h"
@@ -39,6 +40,7 @@ Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
       backend_type(backend_type),
       schema(tuple_schema),
       data(NULL),
+      evicted(false),
       tile_group(tile_group),
       pool(NULL),
       num_tuple_slots(tuple_count),
@@ -74,7 +76,11 @@ Tile::~Tile() {
   // auto &storage_manager = storage::StorageManager::GetInstance();
   // storage_manager.Release(backend_type, data);
 
-  delete[] data;
+  if (evicted) {
+    ColdStorageManager::GetInstance().Release(data, tile_size);
+  } else {
+    delete[] data;
+  }
   data = NULL;
 
   // reclaim the tile memory (UNINLINED data)
@@ -484,6 +490,25 @@ void Tile::Sync() {
   // storage_manager.Sync(backend_type, data, tile_size);
 }
 
+//===--------------------------------------------------------------------===//
+// Cold Storage
+//===--------------------------------------------------------------------===//
+
+char *Tile::Evict() {
+  if (evicted) return nullptr;
+
+  char *mapped_data =
+      ColdStorageManager::GetInstance().Evict(table_id, data, tile_size);
+  if (mapped_data == nullptr) return nullptr;
+
+  // readers that loaded the old pointer keep reading the heap copy, which
+  // holds the same data
+  char *heap_data = data;
+  __atomic_store_n(&data, mapped_data, __ATOMIC_RELEASE);
+  evicted = true;
+  return heap_data;
+}
+
 //===--------------------------------------------------------------------===//
 // Utilities
 //===--------------------------------------------------------------------===//
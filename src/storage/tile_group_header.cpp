@@ -23,6 +23,7 @@
 #include "concurrency/transaction_manager_factory.h"
 #include "gc/gc_manager.h"
 #include "logging/log_manager.h"
+#include "settings/settings_manager.h"
 #include "storage/backend_manager.h"
 #include "type/value.h"
 #include "storage/tuple.h"
@@ -35,9 +36,14 @@ TileGroupHeader::TileGroupHeader(const BackendType &backend_type,
     : backend_type(backend_type),
       tile_group(nullptr),
       data(nullptr),
+      mvcc_data(nullptr),
       num_tuple_slots(tuple_count),
       next_tuple_slot(0),
-      tile_header_lock() {
+      tile_header_lock(),
+      all_visible_state(AllVisibleState::MUTABLE),
+      all_visible_reader_cid(0),
+      accessed(true),
+      freeze_queued(false) {
   header_size = num_tuple_slots * header_entry_size;
 
   // allocate storage space for header
@@ -50,6 +56,22 @@ TileGroupHeader::TileGroupHeader(const BackendType &backend_type,
   // zero out the data
   PL_MEMSET(data, 0, header_size);
 
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::columnar_mvcc_header)) {
+    // Keep the fields read by visibility checks in dense arrays
+    size_t column_size = num_tuple_slots * sizeof(cid_t);
+    mvcc_data = new char[num_tuple_slots * mvcc_column_entry_size];
+    txn_id_column = mvcc_data;
+    begin_cid_column = txn_id_column + column_size;
+    end_cid_column = begin_cid_column + column_size;
+    mvcc_stride = sizeof(cid_t);
+  } else {
+    txn_id_column = data + txn_id_offset;
+    begin_cid_column = data + begin_cid_offset;
+    end_cid_column = data + end_cid_offset;
+    mvcc_stride = header_entry_size;
+  }
+
   // Set MVCC Initial Value
   for (oid_t tuple_slot_id = START_OID; tuple_slot_id < num_tuple_slots;
        tuple_slot_id++) {
@@ -70,6 +92,32 @@ TileGroupHeader::~TileGroupHeader() {
   // storage_manager.Release(backend_type, data);
   delete[] data;
   data = nullptr;
+  delete[] mvcc_data;
+  mvcc_data = nullptr;
+}
+
+void TileGroupHeader::CopyRelocatedVersions(const TileGroupHeader &other) {
+  PL_ASSERT(num_tuple_slots == other.num_tuple_slots);
+
+  // The headers may use different MVCC layouts, so copy field by field
+  oid_t tuple_count = other.GetCurrentNextTupleSlot();
+  for (oid_t tuple_slot_id = START_OID; tuple_slot_id < tuple_count;
+       tuple_slot_id++) {
+    SetTransactionId(tuple_slot_id, INITIAL_TXN_ID);
+    SetBeginCommitId(tuple_slot_id, other.GetBeginCommitId(tuple_slot_id));
+    SetEndCommitId(tuple_slot_id, other.GetEndCommitId(tuple_slot_id));
+    SetNextItemPointer(tuple_slot_id, other.GetNextItemPointer(tuple_slot_id));
+    SetPrevItemPointer(tuple_slot_id, other.GetPrevItemPointer(tuple_slot_id));
+    SetIndirection(tuple_slot_id, other.GetIndirection(tuple_slot_id));
+    PL_MEMSET(GetReservedFieldRef(tuple_slot_id), 0, reserved_size);
+  }
+  next_tuple_slot = tuple_count;
+  immutable = other.immutable;
+
+  // Concurrency control uses the reserved fields to order writers after
+  // readers. Until the readers of the other header are accounted for, every
+  // writer must back off.
+  all_visible_reader_cid = MAX_CID;
 }
 
 //===--------------------------------------------------------------------===//
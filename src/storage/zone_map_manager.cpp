@@ -15,8 +15,11 @@
 #include "catalog/zone_map_catalog.h"
 #include "catalog/database_catalog.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "storage/deduplicated_tile_group.h"
 #include "storage/storage_manager.h"
 #include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
 #include "type/ephemeral_pool.h"
 #include "storage/zone_map_manager.h"
 
@@ -199,6 +202,18 @@ ZoneMapManager::GetResultVectorAsZoneMap(
 bool ZoneMapManager::ShouldScanTileGroup(
     storage::PredicateInfo *parsed_predicates, int32_t num_predicates,
     storage::DataTable *table, int64_t tile_group_idx) {
+  // Deduplicated tile groups keep their value ranges and shared entries in
+  // memory, which saves the catalog lookups
+  if (num_predicates > 0) {
+    auto tile_group = table->GetTileGroup(tile_group_idx);
+    if (tile_group != nullptr && tile_group->GetHeader()->IsAllVisible()) {
+      auto dedup = tile_group->GetDedup();
+      if (dedup != nullptr) {
+        return dedup->ShouldScan(parsed_predicates, num_predicates);
+      }
+    }
+  }
+
   for (int32_t i = 0; i < num_predicates; i++) {
     // Extract the col_id, operator and predicate_value
     int col_id = parsed_predicates[i].col_id;
@@ -398,6 +398,72 @@ bool TrafficCop::BindParamsForCachePlan(
   return true;
 }
 
+std::shared_ptr<Statement> TrafficCop::PrepareSharedStatement(
+    const std::string &query_string,
+    std::unique_ptr<parser::SQLStatementList> sql_stmt_list,
+    const size_t thread_id) {
+  LOG_TRACE("Prepare Shared Statement query: %s", query_string.c_str());
+  StatementType stmt_type = sql_stmt_list->GetStatement(0)->GetType();
+  QueryType query_type =
+      StatementTypeToQueryType(stmt_type, sql_stmt_list->GetStatement(0));
+  std::shared_ptr<Statement> statement = std::make_shared<Statement>(
+      "unamed", query_type, query_string, std::move(sql_stmt_list));
+
+  // The optimizer and GenerateTupleDescriptor() read the catalog through the
+  // transaction on top of the stack
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction(thread_id);
+  tcop_txn_state_.emplace(txn, ResultType::SUCCESS);
+  try {
+    auto plan = optimizer_->BuildPelotonPlanTree(
+        statement->GetStmtParseTreeList(), default_database_name_, txn);
+    statement->SetPlanTree(plan);
+    statement->SetReferencedTables(
+        planner::PlanUtil::GetTablesReferenced(plan.get()));
+
+    if (query_type == QueryType::QUERY_SELECT) {
+      auto tuple_descriptor = GenerateTupleDescriptor(
+          statement->GetStmtParseTreeList()->GetStatement(0));
+      statement->SetTupleDescriptor(tuple_descriptor);
+    }
+  } catch (Exception &e) {
+    error_message_ = e.what();
+    tcop_txn_state_.pop();
+    txn_manager.AbortTransaction(txn);
+    return nullptr;
+  }
+  tcop_txn_state_.pop();
+  txn_manager.CommitTransaction(txn);
+  return statement;
+}
+
+void TrafficCop::BindParamsForSharedPlan(std::vector<type::Value> param_values,
+                                         const std::string &query_string,
+                                         const size_t thread_id) {
+  if (tcop_txn_state_.empty()) {
+    single_statement_txn_ = true;
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction(thread_id);
+    // this shouldn't happen
+    if (txn == nullptr) {
+      LOG_ERROR("Begin txn failed");
+    }
+    // initialize the current result as success
+    tcop_txn_state_.emplace(txn, ResultType::SUCCESS);
+  } else {
+    single_statement_txn_ = false;
+  }
+
+  if (settings::SettingsManager::GetBool(settings::SettingId::brain)) {
+    tcop_txn_state_.top().first->AddQueryString(query_string.c_str());
+  }
+
+  if (param_values.size() > 0) {
+    statement_->GetPlanTree()->SetParameterValues(&param_values);
+  }
+  SetParamVal(std::move(param_values));
+}
+
 void TrafficCop::GetTableColumns(parser::TableRef *from_table,
                                  std::vector<catalog::Column> &target_columns) {
   if (from_table == nullptr) return;
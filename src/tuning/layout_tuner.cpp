@@ -15,10 +15,12 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <chrono>
 
 #include "catalog/schema.h"
 #include "common/logger.h"
 #include "common/timer.h"
+#include "settings/settings_manager.h"
 #include "storage/data_table.h"
 
 namespace peloton {
@@ -150,18 +152,53 @@ void LayoutTuner::UpdateDefaultPartition(storage::DataTable* table) {
   table->SetDefaultLayout(layout);
 }
 
+oid_t LayoutTuner::TransformTileGroups(storage::DataTable* table,
+                                       oid_t max_count) {
+  oid_t tile_group_count = table->GetTileGroupCount();
+  auto& offset = transform_offsets[table];
+  oid_t transformed_count = 0;
+
+  // Tile groups that are not all-visible yet are retried on the next pass
+  for (oid_t scan_itr = 0; scan_itr < transform_scan_count &&
+                           scan_itr < tile_group_count &&
+                           transformed_count < max_count;
+       scan_itr++) {
+    if (offset >= tile_group_count) {
+      offset = 0;
+    }
+
+    LOG_TRACE("Transforming tile group at offset: %u", offset);
+    if (table->TransformTileGroup(offset, theta) != nullptr) {
+      transformed_count++;
+    }
+    offset++;
+  }
+
+  return transformed_count;
+}
+
 void LayoutTuner::Tune() {
-  Timer<std::milli> timer;
+  auto last_time = std::chrono::steady_clock::now();
+  double transform_budget = 0;
+
   // Continue till signal is not false
   while (layout_tuning_stop == false) {
+    // Refill the transform budget, allowing bursts of up to a second
+    double transform_rate = settings::SettingsManager::GetInt(
+        settings::SettingId::layout_tuner_transform_rate);
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed = now - last_time;
+    last_time = now;
+    transform_budget = std::min(
+        transform_budget + transform_rate * elapsed.count(), transform_rate);
+
     // Go over all tables
     for (auto table : tables) {
       // Transform
-      auto tile_group_count = table->GetTileGroupCount();
-      auto tile_group_offset = rand() % tile_group_count;
-
-      LOG_TRACE("Transforming tile group at offset: %lu", tile_group_offset);
-      table->TransformTileGroup(tile_group_offset, theta);
+      if (transform_budget >= 1) {
+        transform_budget -= TransformTileGroups(
+            table, static_cast<oid_t>(transform_budget));
+      }
 
       // Update partitioning periodically
       UpdateDefaultPartition(table);
@@ -195,6 +232,7 @@ void LayoutTuner::ClearTables() {
   {
     std::lock_guard<std::mutex> lock(layout_tuner_mutex);
     tables.clear();
+    transform_offsets.clear();
   }
 }
 
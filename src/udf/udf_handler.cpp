@@ -14,12 +14,45 @@ std::shared_ptr<codegen::CodeContext> UDFHandler::Execute(
   return Compile(txn, func_name, func_body, args_name, args_type, ret_type);
 }
 
+llvm::Function *UDFHandler::LinkFunction(
+    peloton::codegen::CodeGen &codegen,
+    const expression::FunctionExpression &func_expr) {
+  // The code_context associated with the UDF
+  auto func_context = func_expr.GetFuncContext();
+
+  auto *func_ptr = codegen.GetCodeContext().LinkFunction(
+      *func_context, func_context->GetUDF());
+  if (func_ptr != nullptr &&
+      func_ptr->getFunctionType() == GetFunctionType(codegen, func_expr)) {
+    return func_ptr;
+  }
+
+  return RegisterExternalFunction(codegen, func_expr);
+}
+
 llvm::Function *UDFHandler::RegisterExternalFunction(
     peloton::codegen::CodeGen &codegen,
     const expression::FunctionExpression &func_expr) {
   // The code_context associated with the UDF
   auto func_context = func_expr.GetFuncContext();
 
+  auto *fn_type = GetFunctionType(codegen, func_expr);
+
+  // Construct the function prototype
+  auto *func_ptr = llvm::Function::Create(
+      fn_type, llvm::Function::ExternalLinkage, func_expr.GetFuncName(),
+      &(codegen.GetCodeContext().GetModule()));
+
+  // Register the Function Prototype in this context
+  codegen.GetCodeContext().RegisterExternalFunction(
+      func_ptr, func_context->GetRawFunctionPointer(func_context->GetUDF()));
+
+  return func_ptr;
+}
+
+llvm::FunctionType *UDFHandler::GetFunctionType(
+    peloton::codegen::CodeGen &codegen,
+    const expression::FunctionExpression &func_expr) {
   // Construct the new functionType in this context
   llvm::Type *llvm_ret_type =
       GetCodegenParamType(func_expr.GetValueType(), codegen);
@@ -36,18 +69,7 @@ llvm::Function *UDFHandler::RegisterExternalFunction(
     ++iterator_arg_type;
   }
 
-  auto *fn_type = llvm::FunctionType::get(llvm_ret_type, llvm_args, false);
-
-  // Construct the function prototype
-  auto *func_ptr = llvm::Function::Create(
-      fn_type, llvm::Function::ExternalLinkage, func_expr.GetFuncName(),
-      &(codegen.GetCodeContext().GetModule()));
-
-  // Register the Function Prototype in this context
-  codegen.GetCodeContext().RegisterExternalFunction(
-      func_ptr, func_context->GetRawFunctionPointer(func_context->GetUDF()));
-
-  return func_ptr;
+  return llvm::FunctionType::get(llvm_ret_type, llvm_args, false);
 }
 
 std::shared_ptr<codegen::CodeContext> UDFHandler::Compile(
@@ -87,6 +109,11 @@ std::shared_ptr<codegen::CodeContext> UDFHandler::Compile(
   // Parse UDF and generate the AST
   parser->ParseUDF(cg, fb, func_body, func_name, args_type);
 
+  // Keep the IR around, so queries calling the UDF can inline it. The context
+  // is cached with the proc in function::PlpgsqlFunctions, so this happens
+  // once per UDF.
+  code_context->SaveBitcode();
+
   // Optimize and JIT compile all functions created in this context
   code_context->Compile();
 
@@ -87,5 +87,56 @@ TEST_F(FunctionBuilderTest, ConstructNestedFunction) {
   ASSERT_EQ(fn(1), 44);
 }
 
+TEST_F(FunctionBuilderTest, LinkFunctionFromOtherContext) {
+  // Build @test in one context, the way UDFs are compiled, then link it into
+  // another context and call it from @main there:
+  // define i32 @main(i32 %a) {
+  //  %x = call i32 test(i32 %a)
+  //  ret i32 %x
+  // }
+
+  uint32_t magic_num = 44;
+
+  codegen::CodeContext test_context;
+  {
+    codegen::CodeGen cg{test_context};
+    codegen::FunctionBuilder test{
+        test_context, "test", cg.Int32Type(), {{"a", cg.Int32Type()}}};
+    {
+      auto *arg_a = test.GetArgumentByPosition(0);
+      auto *ret = cg->CreateMul(arg_a, cg.Const32(magic_num));
+      test.ReturnAndFinish(ret);
+    }
+    test_context.SetUDF(test.GetFunction());
+  }
+  test_context.SaveBitcode();
+  ASSERT_TRUE(test_context.Compile());
+
+  codegen::CodeContext code_context;
+  codegen::CodeGen cg{code_context};
+  auto *test_func =
+      code_context.LinkFunction(test_context, test_context.GetUDF());
+  ASSERT_NE(nullptr, test_func);
+  EXPECT_EQ(&code_context.GetModule(), test_func->getParent());
+
+  // Linking the function again reuses the definition
+  EXPECT_EQ(test_func,
+            code_context.LinkFunction(test_context, test_context.GetUDF()));
+
+  codegen::FunctionBuilder main{
+      code_context, "main", cg.Int32Type(), {{"a", cg.Int32Type()}}};
+  {
+    auto *main_arg = main.GetArgumentByPosition(0);
+    auto *ret = cg.CallFunc(test_func, {main_arg});
+    main.ReturnAndFinish(ret);
+  }
+
+  ASSERT_TRUE(code_context.Compile());
+
+  typedef int (*func_t)(uint32_t);
+  func_t fn = (func_t) code_context.GetRawFunctionPointer(main.GetFunction());
+  ASSERT_EQ(fn(2), 88);
+}
+
 }  // namespace test
 }  // namespace peloton
\ No newline at end of file
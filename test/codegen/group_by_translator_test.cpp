@@ -455,5 +455,165 @@ TEST_F(GroupByTranslatorTest, MinAndMax) {
               CmpBool::CmpTrue);
 }
 
+TEST_F(GroupByTranslatorTest, GlobalAggregationWithInputPredicate) {
+  //
+  // SELECT SUM(a), COUNT(b), MIN(b), MAX(a), AVG(a) FROM table WHERE a > 20;
+  //
+
+  LOG_INFO(
+      "Query: SELECT SUM(a), COUNT(b), MIN(b), MAX(a), AVG(a) FROM table1 "
+      "WHERE a > 20;");
+
+  // 1) Set up projection (just a direct map)
+  DirectMapList direct_map_list = {{0, {1, 0}},
+                                   {1, {1, 1}},
+                                   {2, {1, 2}},
+                                   {3, {1, 3}},
+                                   {4, {1, 4}}};
+  std::unique_ptr<planner::ProjectInfo> proj_info{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+
+  // 2) Setup the aggregates
+  auto *a_col =
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0);
+  auto *b_col =
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1);
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms = {
+      {ExpressionType::AGGREGATE_SUM, a_col},
+      {ExpressionType::AGGREGATE_COUNT, b_col},
+      {ExpressionType::AGGREGATE_MIN, b_col->Copy()},
+      {ExpressionType::AGGREGATE_MAX, a_col->Copy()},
+      {ExpressionType::AGGREGATE_AVG, a_col->Copy()}};
+
+  // 3) No grouping
+  std::vector<oid_t> gb_cols = {};
+
+  // 4) The output schema
+  std::shared_ptr<const catalog::Schema> output_schema{
+      new catalog::Schema({{type::TypeId::INTEGER, 4, "SUM_A"},
+                           {type::TypeId::BIGINT, 8, "COUNT_B"},
+                           {type::TypeId::INTEGER, 4, "MIN_B"},
+                           {type::TypeId::INTEGER, 4, "MAX_A"},
+                           {type::TypeId::DECIMAL, 8, "AVG_A"}})};
+
+  // 5) Finally, the aggregation node
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(proj_info), nullptr, std::move(agg_terms), std::move(gb_cols),
+      output_schema, AggregateType::HASH)};
+
+  // 6) The predicate, which leaves a number of rows that isn't a multiple of
+  //    the lanes the aggregation is unrolled into
+  auto *a_exp =
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0);
+  auto *const_20 = ConstIntExpr(20).release();
+  auto *a_gt_20 = new expression::ComparisonExpression(
+      ExpressionType::COMPARE_GREATERTHAN, a_exp, const_20);
+
+  // 7) The scan that feeds the aggregation
+  std::unique_ptr<planner::AbstractPlan> scan_plan{
+      new planner::SeqScanPlan(&GetTestTable(TestTableId()), a_gt_20, {0, 1})};
+
+  agg_plan->AddChild(std::move(scan_plan));
+
+  // Do binding
+  planner::BindingContext context;
+  agg_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1, 2, 3, 4}, context};
+
+  // Compile it all
+  CompileAndExecute(*agg_plan, buffer);
+
+  // There should only be a single output row
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(1, results.size());
+
+  // Rows 3 to 9 pass the predicate: 'a' is 30, 40, ..., 90 and 'b' is 31, 41,
+  // ..., 91
+  EXPECT_TRUE(results[0].GetValue(0).CompareEquals(
+                  type::ValueFactory::GetBigIntValue(420)) ==
+              CmpBool::CmpTrue);
+  EXPECT_TRUE(results[0].GetValue(1).CompareEquals(
+                  type::ValueFactory::GetBigIntValue(7)) == CmpBool::CmpTrue);
+  EXPECT_TRUE(results[0].GetValue(2).CompareEquals(
+                  type::ValueFactory::GetBigIntValue(31)) == CmpBool::CmpTrue);
+  EXPECT_TRUE(results[0].GetValue(3).CompareEquals(
+                  type::ValueFactory::GetBigIntValue(90)) == CmpBool::CmpTrue);
+  EXPECT_TRUE(results[0].GetValue(4).CompareEquals(
+                  type::ValueFactory::GetDecimalValue(60.0)) ==
+              CmpBool::CmpTrue);
+}
+
+TEST_F(GroupByTranslatorTest, SortedGroupingWithOutputPredicate) {
+  //
+  // SELECT a, sum(b) as x FROM table GROUP BY a WHERE x > 50;
+  //
+  // The table is scanned in the order of 'a', so its groups can be aggregated
+  // one at a time.
+  //
+
+  LOG_INFO("Query: SELECT a, sum(b) as x FROM table GROUP BY a WHERE x > 50;");
+
+  // 1) Set up projection (just a direct map)
+  DirectMapList direct_map_list = {{0, {0, 0}}, {1, {1, 0}}};
+  std::unique_ptr<planner::ProjectInfo> proj_info{
+      new planner::ProjectInfo(TargetList(), std::move(direct_map_list))};
+
+  // 2) Setup the sum over 'b'
+  auto *tve_expr =
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1);
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms = {
+      {ExpressionType::AGGREGATE_SUM, tve_expr}};
+
+  // 3) The grouping column
+  std::vector<oid_t> gb_cols = {0};
+
+  // 4) The output schema
+  std::shared_ptr<const catalog::Schema> output_schema{
+      new catalog::Schema({{type::TypeId::INTEGER, 4, "COL_A"},
+                           {type::TypeId::INTEGER, 4, "SUM(COL_B)"}})};
+
+  // 5) The predicate on the sum aggregate
+  auto *x_exp =
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1);
+  auto *const_50 = new expression::ConstantValueExpression(
+      type::ValueFactory::GetIntegerValue(50));
+  ExpressionPtr x_gt_50{
+      new expression::ComparisonExpression(ExpressionType::COMPARE_GREATERTHAN,
+                                           x_exp, const_50)};
+
+  // 6) Finally, the aggregation node
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(proj_info), std::move(x_gt_50), std::move(agg_terms),
+      std::move(gb_cols), output_schema, AggregateType::SORTED)};
+
+  // 7) The scan that feeds the aggregation
+  std::unique_ptr<planner::AbstractPlan> scan_plan{
+      new planner::SeqScanPlan(&GetTestTable(TestTableId()), nullptr, {0, 1})};
+
+  agg_plan->AddChild(std::move(scan_plan));
+
+  // Do binding
+  planner::BindingContext context;
+  agg_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+
+  // Compile it all
+  CompileAndExecute(*agg_plan, buffer);
+
+  // Check results. Every group has a single row, and the groups come out in
+  // the order of their keys.
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(5, results.size());
+  for (size_t i = 0; i < results.size(); i++) {
+    int32_t a = results[i].GetValue(0).GetAs<int32_t>();
+    EXPECT_EQ(static_cast<int32_t>(10 * (i + 5)), a);
+    EXPECT_EQ(a + 1, results[i].GetValue(1).GetAs<int32_t>());
+  }
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -0,0 +1,161 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// merge_join_translator_test.cpp
+//
+// Identification: test/codegen/merge_join_translator_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/query_compiler.h"
+#include "common/harness.h"
+#include "expression/comparison_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/merge_join_plan.h"
+#include "planner/seq_scan_plan.h"
+
+#include "codegen/testing_codegen_util.h"
+
+namespace peloton {
+namespace test {
+
+class MergeJoinTranslatorTest : public PelotonCodeGenTest {
+ public:
+  MergeJoinTranslatorTest() : PelotonCodeGenTest() {
+    // Load the test tables. Both are loaded in the order of their first
+    // column, so scanning them produces tuples sorted on it.
+    uint32_t num_rows = 10;
+    LoadTestTable(LeftTableId(), 2 * num_rows);
+    LoadTestTable(RightTableId(), 8 * num_rows);
+  }
+
+  oid_t LeftTableId() const { return test_table_oids[0]; }
+
+  oid_t RightTableId() const { return test_table_oids[1]; }
+
+  storage::DataTable &GetLeftTable() const {
+    return GetTestTable(LeftTableId());
+  }
+
+  storage::DataTable &GetRightTable() const {
+    return GetTestTable(RightTableId());
+  }
+
+  std::unique_ptr<planner::MergeJoinPlan> MakeJoinPlan(
+      std::unique_ptr<const expression::AbstractExpression> &&predicate) {
+    // Projection: [left_table.a, right_table.a, left_table.b, right_table.c]
+    DirectMapList direct_map_list = {
+        {0, {0, 0}}, {1, {1, 0}}, {2, {0, 1}}, {3, {1, 2}}};
+    std::unique_ptr<const planner::ProjectInfo> projection{
+        new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+
+    // Output schema
+    auto schema = std::shared_ptr<const catalog::Schema>(
+        new catalog::Schema({TestingExecutorUtil::GetColumnInfo(0),
+                             TestingExecutorUtil::GetColumnInfo(0),
+                             TestingExecutorUtil::GetColumnInfo(1),
+                             TestingExecutorUtil::GetColumnInfo(2)}));
+
+    // Join on left_table.a = right_table.a
+    std::vector<planner::MergeJoinPlan::JoinClause> join_clauses;
+    join_clauses.emplace_back(
+        ColRefExpr(type::TypeId::INTEGER, true, 0).release(),
+        ColRefExpr(type::TypeId::INTEGER, false, 0).release(), false);
+
+    std::unique_ptr<planner::MergeJoinPlan> mj_plan{new planner::MergeJoinPlan(
+        JoinType::INNER, std::move(predicate), std::move(projection), schema,
+        join_clauses)};
+
+    std::unique_ptr<planner::AbstractPlan> left_scan{
+        new planner::SeqScanPlan(&GetLeftTable(), nullptr, {0, 1, 2})};
+    std::unique_ptr<planner::AbstractPlan> right_scan{
+        new planner::SeqScanPlan(&GetRightTable(), nullptr, {0, 1, 2})};
+    mj_plan->AddChild(std::move(left_scan));
+    mj_plan->AddChild(std::move(right_scan));
+    return mj_plan;
+  }
+};
+
+TEST_F(MergeJoinTranslatorTest, SingleMergeJoinColumnTest) {
+  //
+  // SELECT
+  //   left_table.a, right_table.a, left_table.b, right_table.c,
+  // FROM
+  //   left_table
+  // JOIN
+  //   right_table ON left_table.a = right_table.a
+  //
+  auto mj_plan = MakeJoinPlan(nullptr);
+
+  // Do binding
+  planner::BindingContext context;
+  mj_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1, 2, 3}, context};
+
+  // COMPILE and run
+  CompileAndExecute(*mj_plan, buffer);
+
+  // Check results
+  const auto &results = buffer.GetOutputTuples();
+  // The left table has 20 rows, the right has 80, all of the left ones match
+  ASSERT_EQ(20, results.size());
+  for (size_t i = 0; i < results.size(); i++) {
+    const auto &tuple = results[i];
+    EXPECT_EQ(type::TypeId::INTEGER, tuple.GetValue(0).GetTypeId());
+
+    // Check that the joins keys are actually equal
+    EXPECT_EQ(CmpBool::CmpTrue,
+              tuple.GetValue(0).CompareEquals(tuple.GetValue(1)));
+
+    // The output comes in the order of the keys
+    if (i > 0) {
+      EXPECT_EQ(CmpBool::CmpTrue,
+                results[i - 1].GetValue(0).CompareLessThan(tuple.GetValue(0)));
+    }
+  }
+}
+
+TEST_F(MergeJoinTranslatorTest, MergeJoinWithPredicateTest) {
+  //
+  // SELECT
+  //   left_table.a, right_table.a, left_table.b, right_table.c,
+  // FROM
+  //   left_table
+  // JOIN
+  //   right_table ON left_table.a = right_table.a
+  // WHERE
+  //   left_table.a >= 50
+  //
+  auto predicate = CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, true, 0),
+                              ConstIntExpr(50));
+  auto mj_plan = MakeJoinPlan(std::move(predicate));
+
+  // Do binding
+  planner::BindingContext context;
+  mj_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1, 2, 3}, context};
+
+  // COMPILE and run
+  CompileAndExecute(*mj_plan, buffer);
+
+  // Check results. Column a holds multiples of ten, so the first five rows of
+  // the left table don't pass the predicate.
+  const auto &results = buffer.GetOutputTuples();
+  EXPECT_EQ(15, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_EQ(CmpBool::CmpTrue,
+              tuple.GetValue(0).CompareEquals(tuple.GetValue(1)));
+    EXPECT_EQ(CmpBool::CmpTrue, tuple.GetValue(0).CompareGreaterThanEquals(
+                                    type::ValueFactory::GetIntegerValue(50)));
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
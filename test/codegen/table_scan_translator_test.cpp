@@ -297,6 +297,88 @@ TEST_F(TableScanTranslatorTest, ScanWithConjunctionPredicate) {
                                      type::ValueFactory::GetIntegerValue(21)));
 }
 
+TEST_F(TableScanTranslatorTest, ScanColumnarTableWithConjunctionPredicate) {
+  // Switch the table to a columnar layout before loading it. The first tile
+  // group was created with the row layout, so the scan sees both layouts.
+  oid_t table_id = test_table_oids[1];
+  auto &table = GetTestTable(table_id);
+  table.SetLayoutType(LayoutType::COLUMN);
+  LoadTestTable(table_id, 2500);
+
+  //
+  // SELECT a, b FROM table where (a >= 50 AND c < 24003) OR b = 24991;
+  //
+
+  // a >= 50
+  ExpressionPtr a_gte_50 =
+      CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(50));
+
+  // c < 24003
+  ExpressionPtr c_lt_24003 =
+      CmpLtExpr(ColRefExpr(type::TypeId::DECIMAL, 2), ConstIntExpr(24003));
+
+  // b = 24991
+  ExpressionPtr b_eq_24991 =
+      CmpEqExpr(ColRefExpr(type::TypeId::INTEGER, 1), ConstIntExpr(24991));
+
+  auto *conj_and = new expression::ConjunctionExpression(
+      ExpressionType::CONJUNCTION_AND, a_gte_50.release(),
+      c_lt_24003.release());
+  auto *conj_or = new expression::ConjunctionExpression(
+      ExpressionType::CONJUNCTION_OR, conj_and, b_eq_24991.release());
+
+  planner::SeqScanPlan scan{&table, conj_or, {0, 1}};
+
+  planner::BindingContext context;
+  scan.PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+
+  CompileAndExecute(scan, buffer);
+
+  // Rows 5 through 2400, and row 2499
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(2397, results.size());
+  for (uint32_t i = 0; i < results.size() - 1; i++) {
+    EXPECT_EQ(CmpBool::CmpTrue,
+              results[i].GetValue(0).CompareEquals(
+                  type::ValueFactory::GetIntegerValue(10 * (i + 5))));
+  }
+  EXPECT_EQ(CmpBool::CmpTrue, results.back().GetValue(1).CompareEquals(
+                                  type::ValueFactory::GetIntegerValue(24991)));
+}
+
+TEST_F(TableScanTranslatorTest, ScanColumnarTableWithNulls) {
+  oid_t table_id = test_table_oids[1];
+  auto &table = GetTestTable(table_id);
+  table.SetLayoutType(LayoutType::COLUMN);
+  LoadTestTable(table_id, 1500);
+
+  // Insert 10 rows where b is NULL
+  const bool insert_nulls = true;
+  LoadTestTable(table_id, 10, insert_nulls);
+
+  //
+  // SELECT a, b FROM table where b >= 0;
+  //
+
+  ExpressionPtr b_gte_0 =
+      CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 1), ConstIntExpr(0));
+
+  planner::SeqScanPlan scan{&table, b_gte_0.release(), {0, 1}};
+
+  planner::BindingContext context;
+  scan.PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+
+  CompileAndExecute(scan, buffer);
+
+  // None of the NULL rows should qualify
+  const auto &results = buffer.GetOutputTuples();
+  EXPECT_EQ(1500, results.size());
+}
+
 TEST_F(TableScanTranslatorTest, ScanWithAddPredicate) {
   //
   // SELECT a, b FROM table where b = a + 1;
@@ -887,6 +887,7 @@ TEST_F(InternalTypesTests, CopyTypeTest) {
   std::vector<CopyType> list = {
       CopyType::INVALID,    CopyType::IMPORT_CSV,    CopyType::IMPORT_TSV,
       CopyType::EXPORT_CSV, CopyType::EXPORT_STDOUT, CopyType::EXPORT_OTHER,
+      CopyType::EXPORT_BINARY,
   };
 
   // Make sure that ToString and FromString work
@@ -0,0 +1,170 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// shared_plan_cache_test.cpp
+//
+// Identification: test/common/shared_plan_cache_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/shared_plan_cache.h"
+#include "common/statement.h"
+#include "common/statement_cache_manager.h"
+#include "type/value_factory.h"
+
+#include "common/harness.h"
+
+namespace peloton {
+namespace test {
+
+class SharedPlanCacheTests : public PelotonTest {};
+
+TEST_F(SharedPlanCacheTests, AcquireReleaseTest) {
+  auto &shared_plan_cache = SharedPlanCache::GetInstance();
+  shared_plan_cache.Clear();
+
+  std::string query = "SELECT * FROM test WHERE a = $1";
+  auto key = SharedPlanCache::GetKey(
+      DEFAULT_DB_NAME, query, {type::ValueFactory::GetIntegerValue(1)});
+  // The types of the parameters are part of the key
+  EXPECT_NE(key, SharedPlanCache::GetKey(
+                     DEFAULT_DB_NAME, query,
+                     {type::ValueFactory::GetVarcharValue("1")}));
+  // So is the database the table names are resolved in
+  EXPECT_NE(key, SharedPlanCache::GetKey(
+                     "other_database", query,
+                     {type::ValueFactory::GetIntegerValue(1)}));
+
+  uint64_t version;
+  bool cacheable;
+  EXPECT_EQ(nullptr, shared_plan_cache.Acquire(key, version, cacheable));
+  EXPECT_TRUE(cacheable);
+
+  // Two connections plan the query at the same time and both hand their
+  // statements back
+  auto statement1 = std::make_shared<Statement>("unamed", query);
+  auto statement2 = std::make_shared<Statement>("unamed", query);
+  statement1->SetReferencedTables({0});
+  statement2->SetReferencedTables({0});
+  shared_plan_cache.Release(key, statement1, version);
+  shared_plan_cache.Release(key, statement2, version);
+  EXPECT_EQ(1, shared_plan_cache.GetSize());
+  EXPECT_EQ(2, shared_plan_cache.GetStatementCount(key));
+
+  // Each statement is handed to one connection at a time
+  auto acquired1 = shared_plan_cache.Acquire(key, version, cacheable);
+  auto acquired2 = shared_plan_cache.Acquire(key, version, cacheable);
+  EXPECT_NE(nullptr, acquired1);
+  EXPECT_NE(nullptr, acquired2);
+  EXPECT_NE(acquired1, acquired2);
+  EXPECT_EQ(nullptr, shared_plan_cache.Acquire(key, version, cacheable));
+  shared_plan_cache.Release(key, acquired1, version);
+  shared_plan_cache.Release(key, acquired2, version);
+  EXPECT_EQ(2, shared_plan_cache.GetStatementCount(key));
+
+  // An uncacheable query is remembered
+  std::string other_key =
+      SharedPlanCache::GetKey(DEFAULT_DB_NAME, "SELECT 1",
+                              std::vector<type::Value>());
+  shared_plan_cache.MarkUncacheable(other_key);
+  EXPECT_EQ(nullptr, shared_plan_cache.Acquire(other_key, version, cacheable));
+  EXPECT_FALSE(cacheable);
+
+  shared_plan_cache.Clear();
+}
+
+TEST_F(SharedPlanCacheTests, InvalidateTest) {
+  auto &shared_plan_cache = SharedPlanCache::GetInstance();
+  shared_plan_cache.Clear();
+  StatementCacheManager::Init();
+  auto statement_cache_manager = StatementCacheManager::GetStmtCacheManager();
+
+  std::string query = "SELECT * FROM test WHERE a = $1";
+  auto key = SharedPlanCache::GetKey(
+      DEFAULT_DB_NAME, query, {type::ValueFactory::GetIntegerValue(1)});
+
+  uint64_t version;
+  bool cacheable;
+  shared_plan_cache.Acquire(key, version, cacheable);
+  auto statement = std::make_shared<Statement>("unamed", query);
+  statement->SetReferencedTables({0});
+  shared_plan_cache.Release(key, statement, version);
+
+  // Invalidating another table keeps the statement
+  statement_cache_manager->InvalidateTableOid(1);
+  EXPECT_EQ(1, shared_plan_cache.GetStatementCount(key));
+
+  // A statement acquired before an invalidation is not taken back
+  auto acquired = shared_plan_cache.Acquire(key, version, cacheable);
+  EXPECT_NE(nullptr, acquired);
+  statement_cache_manager->InvalidateTableOid(1);
+  shared_plan_cache.Release(key, acquired, version);
+  EXPECT_EQ(0, shared_plan_cache.GetStatementCount(key));
+
+  // Invalidating the referenced table drops the statement
+  shared_plan_cache.Acquire(key, version, cacheable);
+  shared_plan_cache.Release(key, statement, version);
+  EXPECT_EQ(1, shared_plan_cache.GetStatementCount(key));
+  statement_cache_manager->InvalidateTableOid(0);
+  EXPECT_EQ(0, shared_plan_cache.GetSize());
+
+  // A query that failed to plan is skipped until the catalog changes
+  shared_plan_cache.Acquire(key, version, cacheable);
+  shared_plan_cache.MarkUnplannable(key, version);
+  EXPECT_EQ(nullptr, shared_plan_cache.Acquire(key, version, cacheable));
+  EXPECT_FALSE(cacheable);
+  statement_cache_manager->InvalidateTableOid(1);
+  EXPECT_EQ(nullptr, shared_plan_cache.Acquire(key, version, cacheable));
+  EXPECT_TRUE(cacheable);
+
+  // Failing to plan against an older catalog is not remembered
+  uint64_t old_version = version;
+  statement_cache_manager->InvalidateTableOid(1);
+  shared_plan_cache.MarkUnplannable(key, old_version);
+  shared_plan_cache.Acquire(key, version, cacheable);
+  EXPECT_TRUE(cacheable);
+
+  shared_plan_cache.Clear();
+}
+
+TEST_F(SharedPlanCacheTests, LeaseTest) {
+  auto &shared_plan_cache = SharedPlanCache::GetInstance();
+  shared_plan_cache.Clear();
+
+  // Prepared statements are keyed by their parameter type oids
+  std::string query = "SELECT * FROM test WHERE a = $1";
+  std::vector<int32_t> param_types = {
+      static_cast<int32_t>(PostgresValueType::INTEGER)};
+  auto key = SharedPlanCache::GetKey(DEFAULT_DB_NAME, query, param_types);
+  EXPECT_NE(key, SharedPlanCache::GetKey(DEFAULT_DB_NAME, query,
+                                         std::vector<int32_t>()));
+  EXPECT_NE(key, SharedPlanCache::GetKey("other_database", query,
+                                         param_types));
+
+  uint64_t version;
+  bool cacheable;
+  EXPECT_EQ(nullptr, shared_plan_cache.Acquire(key, version, cacheable));
+  auto statement = std::make_shared<Statement>("unamed", query);
+  auto *raw_statement = statement.get();
+
+  // The statement goes back to the cache once every copy of the lease, e.g.
+  // the ones held by two portals, is gone
+  auto lease = shared_plan_cache.Lease(key, std::move(statement), version);
+  auto lease_copy = lease;
+  EXPECT_EQ(raw_statement, lease.get());
+  lease.reset();
+  EXPECT_EQ(0, shared_plan_cache.GetStatementCount(key));
+  lease_copy.reset();
+  EXPECT_EQ(1, shared_plan_cache.GetStatementCount(key));
+
+  auto acquired = shared_plan_cache.Acquire(key, version, cacheable);
+  EXPECT_EQ(raw_statement, acquired.get());
+
+  shared_plan_cache.Clear();
+}
+
+}  // namespace test
+}  // namespace peloton
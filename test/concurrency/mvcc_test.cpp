@@ -14,6 +14,7 @@
 #include "concurrency/testing_transaction_util.h"
 
 #include "gc/gc_manager_factory.h"
+#include "settings/settings_manager.h"
 
 namespace peloton {
 
@@ -166,5 +167,69 @@ TEST_F(MVCCTests, VersionChainTest) {
   }
 }
 
+// The batched visibility check must agree with the per-tuple one for both
+// tile group header layouts
+TEST_F(MVCCTests, FilterVisibleTest) {
+  LOG_INFO("FilterVisibleTest");
+
+  concurrency::TransactionManagerFactory::Configure(
+      ProtocolType::TIMESTAMP_ORDERING, IsolationLevelType::SERIALIZABLE,
+      ConflictAvoidanceType::ABORT);
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  for (bool columnar : {false, true}) {
+    settings::SettingsManager::SetBool(
+        settings::SettingId::columnar_mvcc_header, columnar);
+
+    const int num_key = 10;
+    storage::DataTable *table = TestingTransactionUtil::CreateTable(num_key);
+    EXPECT_EQ(columnar, table->GetTileGroup(0)->GetHeader()->IsColumnarMVCC());
+
+    // committed update and delete
+    auto txn = txn_manager.BeginTransaction();
+    EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table, 1, 100));
+    EXPECT_TRUE(TestingTransactionUtil::ExecuteDelete(txn, table, 2));
+    EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+    // uncommitted update and insert, seen by both the writer and a reader
+    auto writer = txn_manager.BeginTransaction();
+    EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(writer, table, 3, 300));
+    EXPECT_TRUE(TestingTransactionUtil::ExecuteInsert(writer, table, 20, 20));
+    auto reader = txn_manager.BeginTransaction();
+
+    size_t visible_count = 0;
+    for (auto check_txn : {writer, reader}) {
+      for (oid_t tg_offset = 0; tg_offset < table->GetTileGroupCount();
+           tg_offset++) {
+        auto tile_group_header = table->GetTileGroup(tg_offset)->GetHeader();
+        oid_t tid_end = tile_group_header->GetCurrentNextTupleSlot();
+
+        std::vector<uint32_t> expected;
+        for (oid_t tuple_id = 0; tuple_id < tid_end; tuple_id++) {
+          if (txn_manager.IsVisible(check_txn, tile_group_header, tuple_id) ==
+              VisibilityType::OK) {
+            expected.push_back(tuple_id);
+          }
+        }
+
+        std::vector<uint32_t> selection_vector(tid_end);
+        uint32_t count = txn_manager.FilterVisible(
+            check_txn, tile_group_header, 0, tid_end, selection_vector.data());
+        selection_vector.resize(count);
+        EXPECT_EQ(expected, selection_vector);
+        visible_count += count;
+      }
+    }
+    // the writer sees its own insert, the reader doesn't
+    EXPECT_EQ(2 * (num_key - 1) + 1, visible_count);
+
+    txn_manager.AbortTransaction(writer);
+    txn_manager.CommitTransaction(reader);
+  }
+
+  settings::SettingsManager::SetBool(settings::SettingId::columnar_mvcc_header,
+                                     false);
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 #include <cstdio>
+#include <cstring>
+#include <fstream>
 #include "sql/testing_sql_util.h"
 
 #include "catalog/catalog.h"
@@ -23,6 +25,7 @@
 #include "optimizer/rule.h"
 #include "parser/postgresparser.h"
 #include "planner/seq_scan_plan.h"
+#include "settings/settings_manager.h"
 #include "traffic_cop/traffic_cop.h"
 
 #include "gtest/gtest.h"
@@ -153,5 +156,245 @@ TEST_F(CopyTests, Copying) {
   txn_manager.CommitTransaction(txn);
 }
 
+TEST_F(CopyTests, Importing) {
+  auto catalog = catalog::Catalog::GetInstance();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b DECIMAL, c VARCHAR);");
+
+  // Write a csv file that is large enough to be loaded by several threads,
+  // with quoted fields and nulls
+  const int num_tuples = 60000;
+  {
+    std::ofstream csv_file("./copy_input.csv");
+    for (int i = 0; i < num_tuples; i++) {
+      csv_file << i << ",";
+      if (i % 10 != 0) csv_file << i * 0.5;
+      csv_file << ",\"str," << i << " \"\"quoted\"\"\"\n";
+    }
+  }
+  auto worker_count =
+      settings::SettingsManager::GetInt(settings::SettingId::copy_worker_count);
+  settings::SettingsManager::SetInt(settings::SettingId::copy_worker_count, 4);
+
+  EXPECT_EQ(ResultType::SUCCESS,
+            TestingSQLUtil::ExecuteSQLQuery(
+                "COPY test FROM './copy_input.csv' DELIMITER ',';"));
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT COUNT(*) FROM test;", {std::to_string(num_tuples)});
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a, b, c FROM test WHERE a = 7;", {"7|3.5|str,7 \"quoted\""});
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT COUNT(*) FROM test WHERE b IS NULL;",
+      {std::to_string(num_tuples / 10)});
+
+  // Duplicate keys fail the whole import
+  EXPECT_EQ(ResultType::FAILURE,
+            TestingSQLUtil::ExecuteSQLQuery(
+                "COPY test FROM './copy_input.csv' DELIMITER ',';"));
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT COUNT(*) FROM test;", {std::to_string(num_tuples)});
+
+  // The text format uses backslash escapes and only \N for null, so an empty
+  // field is an empty string
+  TestingSQLUtil::ExecuteSQLQuery("CREATE TABLE test2(a INT, b VARCHAR);");
+  {
+    std::ofstream tsv_file("./copy_input.tsv");
+    tsv_file << "1\tfoo\\tbar\n2\t\\N\n3\tback\\\\slash\r\n4\t\n";
+  }
+  EXPECT_EQ(ResultType::SUCCESS,
+            TestingSQLUtil::ExecuteSQLQuery(
+                "COPY test2 FROM './copy_input.tsv' WITH (FORMAT text);"));
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a, b FROM test2 WHERE b IS NOT NULL;",
+      {"1|foo\tbar", "3|back\\slash", "4|"});
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM test2 WHERE b IS NULL;", {"2"});
+
+  std::remove("./copy_input.csv");
+  std::remove("./copy_input.tsv");
+  settings::SettingsManager::SetInt(settings::SettingId::copy_worker_count,
+                                    worker_count);
+
+  txn = txn_manager.BeginTransaction();
+  catalog->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(CopyTests, ImportingDuplicateKeys) {
+  auto catalog = catalog::Catalog::GetInstance();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b INT);");
+  auto worker_count =
+      settings::SettingsManager::GetInt(settings::SettingId::copy_worker_count);
+  settings::SettingsManager::SetInt(settings::SettingId::copy_worker_count, 4);
+
+  // A duplicate key within a file loaded by one thread
+  {
+    std::ofstream csv_file("./copy_input.csv");
+    csv_file << "1,1\n2,2\n1,3\n";
+  }
+  EXPECT_EQ(ResultType::FAILURE,
+            TestingSQLUtil::ExecuteSQLQuery(
+                "COPY test FROM './copy_input.csv' DELIMITER ',';"));
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult("SELECT COUNT(*) FROM test;",
+                                                {"0"});
+
+  // A duplicate key in the last part of a file loaded by several threads, of
+  // the key in the first part
+  const int num_tuples = 200000;
+  {
+    std::ofstream csv_file("./copy_input.csv");
+    for (int i = 0; i < num_tuples; i++) {
+      csv_file << i << "," << i << "\n";
+    }
+    csv_file << 0 << "," << num_tuples << "\n";
+  }
+  EXPECT_EQ(ResultType::FAILURE,
+            TestingSQLUtil::ExecuteSQLQuery(
+                "COPY test FROM './copy_input.csv' DELIMITER ',';"));
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult("SELECT COUNT(*) FROM test;",
+                                                {"0"});
+
+  std::remove("./copy_input.csv");
+  settings::SettingsManager::SetInt(settings::SettingId::copy_worker_count,
+                                    worker_count);
+
+  txn = txn_manager.BeginTransaction();
+  catalog->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(CopyTests, Exporting) {
+  auto catalog = catalog::Catalog::GetInstance();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  TestingSQLUtil::ExecuteSQLQuery("CREATE TABLE test(a INT, b VARCHAR);");
+
+  // Load enough tile groups to be exported by several threads
+  const int num_tuples = 60000;
+  {
+    std::ofstream csv_file("./copy_input.csv");
+    for (int i = 0; i < num_tuples; i++) {
+      csv_file << -i << ",";
+      if (i % 10 != 0) csv_file << "s" << i;
+      csv_file << "\n";
+    }
+  }
+  auto worker_count =
+      settings::SettingsManager::GetInt(settings::SettingId::copy_worker_count);
+  settings::SettingsManager::SetInt(settings::SettingId::copy_worker_count, 4);
+  EXPECT_EQ(ResultType::SUCCESS,
+            TestingSQLUtil::ExecuteSQLQuery(
+                "COPY test FROM './copy_input.csv' DELIMITER ',';"));
+  TestingSQLUtil::ExecuteSQLQuery("DELETE FROM test WHERE a = -7;");
+
+  // Rows are written in no particular order, so count them instead
+  EXPECT_EQ(ResultType::SUCCESS,
+            TestingSQLUtil::ExecuteSQLQuery(
+                "COPY test TO './copy_output.csv' DELIMITER ',';"));
+  {
+    std::ifstream csv_file("./copy_output.csv");
+    std::string line;
+    int line_count = 0, null_count = 0;
+    bool found_row = false, found_deleted = false;
+    while (std::getline(csv_file, line)) {
+      line_count++;
+      if (line.compare(line.size() - 3, 3, ",\\N") == 0) null_count++;
+      if (line == "-11,s11") found_row = true;
+      if (line == "-7,s7") found_deleted = true;
+    }
+    EXPECT_EQ(num_tuples - 1, line_count);
+    EXPECT_EQ(num_tuples / 10, null_count);
+    EXPECT_TRUE(found_row);
+    EXPECT_FALSE(found_deleted);
+  }
+
+  // The binary format starts with the column count and types
+  EXPECT_EQ(ResultType::SUCCESS,
+            TestingSQLUtil::ExecuteSQLQuery(
+                "COPY test TO './copy_output.bin' WITH (FORMAT binary);"));
+  {
+    std::ifstream bin_file("./copy_output.bin", std::ios::binary);
+    std::string magic(strlen(executor::CopyExecutor::kBinaryExportMagic), 0);
+    uint32_t column_count = 0;
+    bin_file.read(&magic[0], magic.size());
+    bin_file.read(reinterpret_cast<char *>(&column_count),
+                  sizeof(column_count));
+    EXPECT_EQ(executor::CopyExecutor::kBinaryExportMagic, magic);
+    EXPECT_EQ(2, column_count);
+    EXPECT_EQ(static_cast<char>(type::TypeId::INTEGER), bin_file.get());
+    EXPECT_EQ(static_cast<char>(type::TypeId::VARCHAR), bin_file.get());
+  }
+
+  std::remove("./copy_input.csv");
+  std::remove("./copy_output.csv");
+  std::remove("./copy_output.bin");
+  settings::SettingsManager::SetInt(settings::SettingId::copy_worker_count,
+                                    worker_count);
+
+  txn = txn_manager.BeginTransaction();
+  catalog->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(CopyTests, ExportingRoundTrip) {
+  auto catalog = catalog::Catalog::GetInstance();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // Values with delimiters, quotes, backslashes and tabs, an empty string and
+  // a null
+  TestingSQLUtil::ExecuteSQLQuery("CREATE TABLE test(a INT, b VARCHAR);");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "INSERT INTO test VALUES (1, 'x,y'), (2, 'say \"hi\"'), "
+      "(3, 'back\\slash'), (4, 'a\tb'), (5, ''), (6, NULL);");
+  std::vector<std::string> expected{"1|x,y", "2|say \"hi\"", "3|back\\slash",
+                                    "4|a\tb", "5|"};
+
+  // Each format reads back what it wrote
+  std::vector<std::pair<std::string, std::string>> formats{
+      {"test_text", "DELIMITER ',', FORMAT text"},
+      {"test_tsv", "FORMAT text"},
+      {"test_csv", "DELIMITER ',', FORMAT csv"}};
+  for (auto &format : formats) {
+    auto &table_name = format.first;
+    EXPECT_EQ(ResultType::SUCCESS,
+              TestingSQLUtil::ExecuteSQLQuery(
+                  "COPY test TO './copy_output.txt' WITH (" + format.second +
+                  ");"));
+    TestingSQLUtil::ExecuteSQLQuery("CREATE TABLE " + table_name +
+                                    "(a INT, b VARCHAR);");
+    EXPECT_EQ(ResultType::SUCCESS,
+              TestingSQLUtil::ExecuteSQLQuery(
+                  "COPY " + table_name + " FROM './copy_output.txt' WITH (" +
+                  format.second + ");"));
+    TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+        "SELECT a, b FROM " + table_name + " WHERE b IS NOT NULL;", expected);
+    TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+        "SELECT a FROM " + table_name + " WHERE b IS NULL;", {"6"});
+  }
+
+  std::remove("./copy_output.txt");
+
+  txn = txn_manager.BeginTransaction();
+  catalog->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
 }  // namespace test
 }  // namespace peloton
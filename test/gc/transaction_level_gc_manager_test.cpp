@@ -17,8 +17,11 @@
 #include "concurrency/epoch_manager.h"
 
 #include "catalog/catalog.h"
+#include "settings/settings_manager.h"
 #include "storage/data_table.h"
+#include "storage/tile.h"
 #include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
 #include "storage/database.h"
 #include "storage/storage_manager.h"
 
@@ -486,5 +489,302 @@ TEST_F(TransactionLevelGCManagerTests, ImmutabilityTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+// full tile groups become all-visible, and writes thaw them
+TEST_F(TransactionLevelGCManagerTests, AllVisibleTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+  gc_manager.Reset();
+  settings::SettingsManager::SetBool(settings::SettingId::tile_group_freezing,
+                                     true);
+
+  auto storage_manager = storage::StorageManager::GetInstance();
+  // create database
+  auto database = TestingExecutorUtil::InitializeDatabase("AllVisibleDB");
+  oid_t db_id = database->GetOid();
+  EXPECT_TRUE(storage_manager->HasDatabase(db_id));
+
+  // five full tile groups, plus an empty one
+  const int num_key = 25;
+  const size_t tuples_per_tilegroup = 5;
+  std::unique_ptr<storage::DataTable> table(TestingTransactionUtil::CreateTable(
+      num_key, "TABLE1", db_id, INVALID_OID, 1234, true, tuples_per_tilegroup));
+  EXPECT_EQ((num_key / tuples_per_tilegroup) + 1, table->GetTileGroupCount());
+
+  // each full tile group is queued once, however often it is registered
+  auto last_tile_group = table->GetTileGroup(num_key / tuples_per_tilegroup);
+  for (oid_t i = 0; i < num_key / tuples_per_tilegroup; i++) {
+    EXPECT_TRUE(table->GetTileGroup(i)->GetHeader()->IsFreezeQueued());
+  }
+  EXPECT_FALSE(last_tile_group->GetHeader()->IsFreezeQueued());
+  gc_manager.RegisterFreezeCandidate(last_tile_group->GetTileGroupId());
+  gc_manager.RegisterFreezeCandidate(last_tile_group->GetTileGroupId());
+  EXPECT_TRUE(last_tile_group->GetHeader()->IsFreezeQueued());
+  EXPECT_FALSE(last_tile_group->GetHeader()->MarkFreezeQueued());
+
+  // once the inserting transactions have expired, the full tile groups can be
+  // frozen
+  epoch_manager.SetCurrentEpochId(2);
+  auto expired_eid = epoch_manager.GetExpiredEpochId();
+  EXPECT_EQ(1, expired_eid);
+  EXPECT_LE(5, gc_manager.Freeze(expired_eid));
+  for (oid_t i = 0; i < num_key / tuples_per_tilegroup; i++) {
+    EXPECT_TRUE(table->GetTileGroup(i)->GetHeader()->IsAllVisible());
+    EXPECT_FALSE(table->GetTileGroup(i)->GetHeader()->IsFreezeQueued());
+  }
+  // the tile group that is not full is released from the queue
+  EXPECT_FALSE(last_tile_group->GetHeader()->IsAllVisible());
+  EXPECT_FALSE(last_tile_group->GetHeader()->IsFreezeQueued());
+
+  // scans read frozen tile groups without per-tuple checks, except when they
+  // have to lock the tuples
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto tile_group_header = table->GetTileGroup(1)->GetHeader();
+  EXPECT_TRUE(txn_manager.PerformAllVisibleRead(txn, tile_group_header));
+  EXPECT_FALSE(txn_manager.PerformAllVisibleRead(txn, tile_group_header, true));
+  EXPECT_FALSE(
+      txn_manager.PerformAllVisibleRead(txn, last_tile_group->GetHeader()));
+  txn_manager.CommitTransaction(txn);
+
+  // deleting a tuple from the 1st tile group thaws it
+  auto ret = DeleteTuple(table.get(), 2);
+  EXPECT_TRUE(ret == ResultType::SUCCESS);
+  EXPECT_FALSE(table->GetTileGroup(0)->GetHeader()->IsAllVisible());
+  EXPECT_TRUE(table->GetTileGroup(1)->GetHeader()->IsAllVisible());
+
+  // the deleted version keeps the tile group from being frozen again
+  epoch_manager.SetCurrentEpochId(3);
+  expired_eid = epoch_manager.GetExpiredEpochId();
+  gc_manager.Freeze(expired_eid);
+  EXPECT_FALSE(table->GetTileGroup(0)->GetHeader()->IsAllVisible());
+
+  settings::SettingsManager::SetBool(settings::SettingId::tile_group_freezing,
+                                     false);
+  gc_manager.StopGC();
+  gc::GCManagerFactory::Configure(0);
+
+  table.release();
+  // DROP!
+  TestingExecutorUtil::DeleteDatabase("AllVisibleDB");
+
+  txn = txn_manager.BeginTransaction();
+  EXPECT_THROW(
+      catalog::Catalog::GetInstance()->GetDatabaseObject("AllVisibleDB", txn),
+      CatalogException);
+  txn_manager.CommitTransaction(txn);
+}
+
+// with freezing off, filling tile groups does not queue them
+TEST_F(TransactionLevelGCManagerTests, FreezingDisabledTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+  gc_manager.Reset();
+
+  auto storage_manager = storage::StorageManager::GetInstance();
+  // create database
+  auto database = TestingExecutorUtil::InitializeDatabase("FreezingOffDB");
+  oid_t db_id = database->GetOid();
+  EXPECT_TRUE(storage_manager->HasDatabase(db_id));
+
+  const int num_key = 25;
+  const size_t tuples_per_tilegroup = 5;
+  std::unique_ptr<storage::DataTable> table(TestingTransactionUtil::CreateTable(
+      num_key, "TABLE1", db_id, INVALID_OID, 1234, true, tuples_per_tilegroup));
+  for (oid_t i = 0; i < table->GetTileGroupCount(); i++) {
+    EXPECT_FALSE(table->GetTileGroup(i)->GetHeader()->IsFreezeQueued());
+  }
+
+  epoch_manager.SetCurrentEpochId(2);
+  EXPECT_EQ(0, gc_manager.Freeze(epoch_manager.GetExpiredEpochId()));
+  for (oid_t i = 0; i < table->GetTileGroupCount(); i++) {
+    EXPECT_FALSE(table->GetTileGroup(i)->GetHeader()->IsAllVisible());
+  }
+
+  gc_manager.StopGC();
+  gc::GCManagerFactory::Configure(0);
+
+  table.release();
+  // DROP!
+  TestingExecutorUtil::DeleteDatabase("FreezingOffDB");
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_THROW(
+      catalog::Catalog::GetInstance()->GetDatabaseObject("FreezingOffDB", txn),
+      CatalogException);
+  txn_manager.CommitTransaction(txn);
+}
+
+// tuples are moved out of sparse tile groups, which are then released
+TEST_F(TransactionLevelGCManagerTests, CompactionTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+  gc_manager.Reset();
+  settings::SettingsManager::SetBool(
+      settings::SettingId::tile_group_compaction, true);
+  settings::SettingsManager::SetDouble(
+      settings::SettingId::tile_group_compaction_threshold, 0.5);
+
+  auto storage_manager = storage::StorageManager::GetInstance();
+  // create database
+  auto database = TestingExecutorUtil::InitializeDatabase("CompactionDB");
+  oid_t db_id = database->GetOid();
+  EXPECT_TRUE(storage_manager->HasDatabase(db_id));
+
+  // five full tile groups, plus an empty one
+  const int num_key = 25;
+  const size_t tuples_per_tilegroup = 5;
+  std::unique_ptr<storage::DataTable> table(TestingTransactionUtil::CreateTable(
+      num_key, "TABLE1", db_id, INVALID_OID, 1234, true, tuples_per_tilegroup));
+  auto tile_group_count = table->GetTileGroupCount();
+
+  std::vector<int> results;
+  auto ret = SelectTuple(table.get(), 4, results);
+  EXPECT_TRUE(ret == ResultType::SUCCESS);
+  EXPECT_EQ(1, results.size());
+  int value = results[0];
+
+  // leave a single tuple in the 1st tile group
+  for (int key = 0; key < 4; key++) {
+    ret = DeleteTuple(table.get(), key);
+    EXPECT_TRUE(ret == ResultType::SUCCESS);
+  }
+
+  // once the deleted versions are reclaimed, the tile group is compacted
+  auto tile_group_header = table->GetTileGroup(0)->GetHeader();
+  epoch_manager.SetCurrentEpochId(2);
+  auto expired_eid = epoch_manager.GetExpiredEpochId();
+  gc_manager.Unlink(0, expired_eid);
+  epoch_manager.SetCurrentEpochId(3);
+  expired_eid = epoch_manager.GetExpiredEpochId();
+  gc_manager.Reclaim(0, expired_eid);
+  EXPECT_EQ(1, gc_manager.Compact(expired_eid));
+  EXPECT_TRUE(tile_group_header->GetImmutability());
+
+  // the moved version is reclaimed, and the empty tile group released
+  for (eid_t eid = 4; eid <= 6; eid++) {
+    epoch_manager.SetCurrentEpochId(eid);
+    expired_eid = epoch_manager.GetExpiredEpochId();
+    gc_manager.Reclaim(0, expired_eid);
+    gc_manager.Unlink(0, expired_eid);
+    gc_manager.Compact(expired_eid);
+  }
+  EXPECT_EQ(1, table->GetTileGroup(0)->GetAllocatedTupleCount());
+  EXPECT_EQ(tile_group_count, table->GetTileGroupCount());
+
+  // the tuple is still found through the index
+  ret = SelectTuple(table.get(), 4, results);
+  EXPECT_TRUE(ret == ResultType::SUCCESS);
+  EXPECT_EQ(1, results.size());
+  EXPECT_EQ(value, results[0]);
+
+  settings::SettingsManager::SetBool(
+      settings::SettingId::tile_group_compaction, false);
+  settings::SettingsManager::SetDouble(
+      settings::SettingId::tile_group_compaction_threshold, 0.1);
+  gc_manager.StopGC();
+  gc::GCManagerFactory::Configure(0);
+
+  table.release();
+  // DROP!
+  TestingExecutorUtil::DeleteDatabase("CompactionDB");
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_THROW(
+      catalog::Catalog::GetInstance()->GetDatabaseObject("CompactionDB", txn),
+      CatalogException);
+  txn_manager.CommitTransaction(txn);
+}
+
+// the data of tile groups that are not accessed is moved to cold storage
+TEST_F(TransactionLevelGCManagerTests, ColdStorageTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+  gc_manager.Reset();
+  settings::SettingsManager::SetBool(settings::SettingId::cold_storage, true);
+  settings::SettingsManager::SetInt(settings::SettingId::cold_storage_threshold,
+                                    0);
+
+  auto storage_manager = storage::StorageManager::GetInstance();
+  // create database
+  auto database = TestingExecutorUtil::InitializeDatabase("ColdStorageDB");
+  oid_t db_id = database->GetOid();
+  EXPECT_TRUE(storage_manager->HasDatabase(db_id));
+
+  // five full tile groups, plus an empty one
+  const int num_key = 25;
+  const size_t tuples_per_tilegroup = 5;
+  std::unique_ptr<storage::DataTable> table(TestingTransactionUtil::CreateTable(
+      num_key, "TABLE1", db_id, INVALID_OID, 1234, true, tuples_per_tilegroup));
+
+  std::vector<int> results;
+  auto ret = SelectTuple(table.get(), 2, results);
+  EXPECT_TRUE(ret == ResultType::SUCCESS);
+  EXPECT_EQ(1, results.size());
+  int value = results[0];
+
+  // every tile group was accessed since it was frozen
+  epoch_manager.SetCurrentEpochId(2);
+  auto expired_eid = epoch_manager.GetExpiredEpochId();
+  EXPECT_LE(5, gc_manager.Freeze(expired_eid));
+  gc_manager.Evict(expired_eid);
+  for (oid_t i = 0; i < num_key / tuples_per_tilegroup; i++) {
+    EXPECT_FALSE(table->GetTileGroup(i)->GetTile(0)->IsEvicted());
+  }
+
+  // only the 2nd tile group is accessed again
+  ret = SelectTuple(table.get(), 7, results);
+  EXPECT_TRUE(ret == ResultType::SUCCESS);
+  EXPECT_LE(4, gc_manager.Evict(expired_eid));
+  for (oid_t i = 0; i < num_key / tuples_per_tilegroup; i++) {
+    EXPECT_EQ(i != 1, table->GetTileGroup(i)->GetTile(0)->IsEvicted());
+    EXPECT_TRUE(table->GetTileGroup(i)->GetHeader()->IsAllVisible());
+    EXPECT_FALSE(table->GetTileGroup(i)->GetHeader()->GetImmutability());
+  }
+
+  // evicted tuples are read back from the segment, and can still be updated
+  ret = SelectTuple(table.get(), 2, results);
+  EXPECT_TRUE(ret == ResultType::SUCCESS);
+  EXPECT_EQ(1, results.size());
+  EXPECT_EQ(value, results[0]);
+  ret = UpdateTuple(table.get(), 2);
+  EXPECT_TRUE(ret == ResultType::SUCCESS);
+  EXPECT_FALSE(table->GetTileGroup(0)->GetHeader()->IsAllVisible());
+
+  // the heap copies are freed once no reader can hold them
+  epoch_manager.SetCurrentEpochId(3);
+  gc_manager.Evict(epoch_manager.GetExpiredEpochId());
+
+  settings::SettingsManager::SetBool(settings::SettingId::cold_storage, false);
+  settings::SettingsManager::SetInt(settings::SettingId::cold_storage_threshold,
+                                    60000);
+  gc_manager.StopGC();
+  gc::GCManagerFactory::Configure(0);
+
+  table.release();
+  // DROP!
+  TestingExecutorUtil::DeleteDatabase("ColdStorageDB");
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_THROW(
+      catalog::Catalog::GetInstance()->GetDatabaseObject("ColdStorageDB", txn),
+      CatalogException);
+  txn_manager.CommitTransaction(txn);
+}
+
 }  // namespace test
 }  // namespace peloton
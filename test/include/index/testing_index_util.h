@@ -50,6 +50,10 @@ class TestingIndexUtil {
 
   static void NonUniqueKeyMultiThreadedStressTest2(IndexType index_type);
 
+  static void MemoryFootprintTest(IndexType index_type);
+
+  static void ScanKeysTest(IndexType index_type);
+
   //===--------------------------------------------------------------------===//
   // Utility Methods
   //===--------------------------------------------------------------------===//
@@ -15,6 +15,7 @@
 
 #include "index/art_index.h"
 #include "index/testing_index_util.h"
+#include "settings/settings_manager.h"
 #include "type/value_factory.h"
 
 namespace peloton {
@@ -50,10 +51,12 @@ using IndexPtr = std::unique_ptr<index::Index, void (*)(index::Index *)>;
 
 class ArtIndexForTest : public index::ArtIndex {
   const Table &data_;
+  std::atomic<uint64_t> load_count_{0};
 
   static void LoadKey(void *ctx, TID tid, art::Key &key) {
     auto *index = reinterpret_cast<ArtIndexForTest *>(ctx);
     auto *ip = reinterpret_cast<const ItemPointer *>(tid);
+    index->load_count_++;
     ASSERT_TRUE(ip->offset < index->data_.size());
     index->ConstructArtKey(*index->data_[ip->offset].GetKey(), key);
   }
@@ -64,6 +67,9 @@ class ArtIndexForTest : public index::ArtIndex {
     // The key loading function loads from an in-memory vector
     SetLoadKeyFunc(LoadKey, reinterpret_cast<void *>(this));
   }
+
+  // The number of keys loaded from the backing vector so far
+  uint64_t GetLoadCount() const { return load_count_; }
 };
 
 // The base test class
@@ -325,5 +331,131 @@ TEST_F(ArtIndexTests, NonUniqueKeyMultiThreadedStressTest) {
   }
 }
 
+TEST_F(ArtIndexTests, MemoryFootprintTest) {
+  uint32_t scale_factor = 100;
+  GenerateTestInput(scale_factor);
+
+  // INDEX
+  auto &index = GetTestIndex();
+  auto &art_index = static_cast<index::ArtIndex &>(index);
+  auto &test_data = GetTestData();
+
+  // An empty tree only holds its root
+  size_t empty_footprint = index.GetMemoryFootprint();
+  EXPECT_EQ(sizeof(art::Node256), empty_footprint);
+  EXPECT_FALSE(index.NeedGC());
+
+  LaunchParallelTest(1, ArtIndexTests::InsertHelper, &index, &test_data);
+
+  // Each distinct key lives in some inner node, and the (x, b) keys need an
+  // external leaf to hold their three values
+  size_t loaded_footprint = index.GetMemoryFootprint();
+  EXPECT_LT(empty_footprint, loaded_footprint);
+  EXPECT_LT(0, art_index.GetMemoryUsage(art::MemoryClass::N4));
+  EXPECT_LT(0, art_index.GetMemoryUsage(art::MemoryClass::Leaf));
+
+  // Remove everything. The replaced and removed nodes are unlinked, but are
+  // only reclaimed by garbage collection.
+  for (const auto &entry : test_data) {
+    index.DeleteEntry(entry.GetKey(), entry.GetVal());
+  }
+  EXPECT_EQ(0, art_index.GetMemoryUsage(art::MemoryClass::Leaf));
+
+  if (index.NeedGC()) {
+    index.PerformGC();
+  }
+  EXPECT_FALSE(index.NeedGC());
+  EXPECT_EQ(empty_footprint, index.GetMemoryFootprint());
+}
+
+TEST_F(ArtIndexTests, InlineKeyTest) {
+  uint32_t scale_factor = 10;
+  GenerateTestInput(scale_factor);
+
+  // Keys are only stored inline if the setting is on when the index is built
+  EXPECT_FALSE(
+      static_cast<ArtIndexForTest &>(GetTestIndex()).StoresKeysInline());
+  settings::SettingsManager::SetBool(settings::SettingId::art_inline_keys,
+                                     true);
+  auto index_ptr = CreateTestIndex();
+  settings::SettingsManager::SetBool(settings::SettingId::art_inline_keys,
+                                     false);
+
+  // INDEX
+  auto &index = static_cast<ArtIndexForTest &>(*index_ptr);
+  auto &test_data = GetTestData();
+  ASSERT_TRUE(index.StoresKeysInline());
+
+  LaunchParallelTest(1, ArtIndexTests::InsertHelper, &index, &test_data);
+
+  // Short keys are checked against the copy stored in their leaf
+  std::vector<ItemPointer *> location_ptrs;
+  uint64_t load_count = index.GetLoadCount();
+  for (uint32_t scale = 1; scale <= scale_factor; scale++) {
+    auto key = CreateIndexKey(100 * scale, "b");
+    index.ScanKey(key.get(), location_ptrs);
+    EXPECT_EQ(3, location_ptrs.size());
+    location_ptrs.clear();
+
+    key = CreateIndexKey(400 * scale, "d");
+    index.ScanKey(key.get(), location_ptrs);
+    EXPECT_EQ(1, location_ptrs.size());
+    location_ptrs.clear();
+  }
+  EXPECT_EQ(load_count, index.GetLoadCount());
+
+  // Long keys still have to be loaded
+  auto long_key = CreateIndexKey(500, StringUtil::Repeat("e", 1000));
+  index.ScanKey(long_key.get(), location_ptrs);
+  EXPECT_EQ(1, location_ptrs.size());
+  location_ptrs.clear();
+  EXPECT_LT(load_count, index.GetLoadCount());
+
+  // Removing the last value of a key unlinks its leaf
+  for (const auto &entry : test_data) {
+    EXPECT_TRUE(index.DeleteEntry(entry.GetKey(), entry.GetVal()));
+  }
+  index.ScanAllKeys(location_ptrs);
+  EXPECT_EQ(0, location_ptrs.size());
+  EXPECT_EQ(0, index.GetMemoryUsage(art::MemoryClass::Leaf));
+}
+
+TEST_F(ArtIndexTests, ScanKeysTest) {
+  uint32_t scale_factor = 100;
+  GenerateTestInput(scale_factor);
+
+  // INDEX
+  auto &index = GetTestIndex();
+  auto &test_data = GetTestData();
+
+  LaunchParallelTest(1, ArtIndexTests::InsertHelper, &index, &test_data);
+
+  // Probe every key backwards, plus some missing ones
+  std::vector<const storage::Tuple *> probes;
+  for (auto iter = test_data.rbegin(); iter != test_data.rend(); ++iter) {
+    probes.push_back(iter->GetKey());
+  }
+  std::vector<KeyPtr> missing_keys;
+  for (uint32_t scale = 1; scale <= scale_factor; scale++) {
+    missing_keys.push_back(CreateIndexKey(100 * scale, "f"));
+    probes.push_back(missing_keys.back().get());
+  }
+
+  std::vector<std::vector<ItemPointer *>> results;
+  index.ScanKeys(probes, results);
+  ASSERT_EQ(probes.size(), results.size());
+
+  std::vector<ItemPointer *> location_ptrs;
+  for (size_t i = 0; i < probes.size(); i++) {
+    index.ScanKey(probes[i], location_ptrs);
+    std::sort(location_ptrs.begin(), location_ptrs.end());
+    std::sort(results[i].begin(), results[i].end());
+    EXPECT_EQ(location_ptrs, results[i]);
+    location_ptrs.clear();
+  }
+  EXPECT_EQ(3, results[test_data.size() - 2].size());
+  EXPECT_EQ(0, results.back().size());
+}
+
 }  // namespace test
-}  // namespace peloton
\ No newline at end of file
+}  // namespace peloton
@@ -65,5 +65,13 @@ TEST_F(BwTreeIndexTests, NonUniqueKeyMultiThreadedStressTest2) {
   TestingIndexUtil::NonUniqueKeyMultiThreadedStressTest2(IndexType::BWTREE);
 }
 
+TEST_F(BwTreeIndexTests, MemoryFootprintTest) {
+  TestingIndexUtil::MemoryFootprintTest(IndexType::BWTREE);
+}
+
+TEST_F(BwTreeIndexTests, ScanKeysTest) {
+  TestingIndexUtil::ScanKeysTest(IndexType::BWTREE);
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -663,6 +663,78 @@ void TestingIndexUtil::NonUniqueKeyMultiThreadedStressTest2(
   location_ptrs.clear();
 }
 
+void TestingIndexUtil::MemoryFootprintTest(const IndexType index_type) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+
+  // INDEX
+  std::unique_ptr<index::Index, void (*)(index::Index *)> index(
+      TestingIndexUtil::BuildIndex(index_type, false), DestroyIndex);
+
+  // Even an empty index holds its root
+  size_t empty_footprint = index->GetMemoryFootprint();
+  EXPECT_LT(0, empty_footprint);
+
+  // The footprint grows with the number of keys
+  size_t scale_factor = 1000;
+  LaunchParallelTest(1, TestingIndexUtil::InsertHelper, index.get(), pool,
+                     scale_factor);
+  size_t loaded_footprint = index->GetMemoryFootprint();
+  EXPECT_LT(empty_footprint, loaded_footprint);
+
+  // Deleting keys and reclaiming garbage must not grow it without bound
+  LaunchParallelTest(1, TestingIndexUtil::DeleteHelper, index.get(), pool,
+                     scale_factor);
+  if (index->NeedGC()) {
+    index->PerformGC();
+  }
+  EXPECT_GE(2 * loaded_footprint, index->GetMemoryFootprint());
+}
+
+void TestingIndexUtil::ScanKeysTest(const IndexType index_type) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+
+  // INDEX
+  std::unique_ptr<index::Index, void (*)(index::Index *)> index(
+      TestingIndexUtil::BuildIndex(index_type, false), DestroyIndex);
+  const catalog::Schema *key_schema = index->GetKeySchema();
+
+  size_t scale_factor = 100;
+  LaunchParallelTest(1, TestingIndexUtil::InsertHelper, index.get(), pool,
+                     scale_factor);
+
+  // Probe existing and missing keys, out of order and with duplicates
+  std::vector<std::unique_ptr<storage::Tuple>> keys;
+  for (size_t scale = scale_factor; scale >= 1; scale--) {
+    for (const char *col_b : {"b", "a", "f"}) {
+      std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+      key->SetValue(0, type::ValueFactory::GetIntegerValue(100 * scale), pool);
+      key->SetValue(1, type::ValueFactory::GetVarcharValue(col_b), pool);
+      keys.push_back(std::move(key));
+    }
+  }
+  std::vector<const storage::Tuple *> probes;
+  for (const auto &key : keys) {
+    probes.push_back(key.get());
+  }
+  probes.push_back(keys.front().get());
+
+  std::vector<std::vector<ItemPointer *>> results;
+  index->ScanKeys(probes, results);
+  ASSERT_EQ(probes.size(), results.size());
+
+  // Every probe must see exactly what a single key lookup sees
+  std::vector<ItemPointer *> location_ptrs;
+  for (size_t i = 0; i < probes.size(); i++) {
+    index->ScanKey(probes[i], location_ptrs);
+    std::sort(location_ptrs.begin(), location_ptrs.end());
+    std::sort(results[i].begin(), results[i].end());
+    EXPECT_EQ(location_ptrs, results[i]);
+    location_ptrs.clear();
+  }
+  EXPECT_LT(0, results.front().size());
+  EXPECT_EQ(results.front(), results.back());
+}
+
 std::unique_ptr<index::IndexMetadata> TestingIndexUtil::BuildTestIndexMetadata(
     const IndexType index_type, const bool unique_keys) {
   LOG_DEBUG("Build index type: %s [unique_keys=%s]",
@@ -18,6 +18,7 @@
 #include "network/postgres_protocol_handler.h"
 #include "util/string_util.h"
 #include "network/connection_handle_factory.h"
+#include "settings/settings_manager.h"
 
 namespace peloton {
 namespace test {
@@ -79,6 +80,48 @@ void *PrepareStatementTest(int port) {
   return NULL;
 }
 
+/**
+ * The same prepared statement on two databases must read the table of each
+ */
+void *SharedPlanDatabaseTest(int port) {
+  try {
+    pqxx::connection C1(StringUtil::Format(
+        "host=127.0.0.1 port=%d user=default_database sslmode=disable", port));
+    pqxx::nontransaction N1(C1);
+    N1.exec("CREATE DATABASE prepare_db;");
+    N1.exec("DROP TABLE IF EXISTS prepare_table;");
+    N1.exec("CREATE TABLE prepare_table(id INT, name VARCHAR(100));");
+    N1.exec("INSERT INTO prepare_table VALUES (1, 'default');");
+
+    pqxx::connection C2(StringUtil::Format(
+        "host=127.0.0.1 port=%d user=default_database dbname=prepare_db "
+        "sslmode=disable",
+        port));
+    pqxx::nontransaction N2(C2);
+    N2.exec("CREATE TABLE prepare_table(id INT, name VARCHAR(100));");
+    N2.exec("INSERT INTO prepare_table VALUES (1, 'other');");
+
+    C1.prepare("searchstmt", "SELECT name FROM prepare_table WHERE id=$1;");
+    C2.prepare("searchstmt", "SELECT name FROM prepare_table WHERE id=$1;");
+
+    // Execute twice on each connection, so that the second run of each
+    // binds a cached plan
+    for (int i = 0; i < 2; i++) {
+      pqxx::result R1 = N1.prepared("searchstmt")(1).exec();
+      EXPECT_EQ(1, R1.size());
+      EXPECT_EQ("default", R1[0][0].as<std::string>());
+
+      pqxx::result R2 = N2.prepared("searchstmt")(1).exec();
+      EXPECT_EQ(1, R2.size());
+      EXPECT_EQ("other", R2[0][0].as<std::string>());
+    }
+  } catch (const std::exception &e) {
+    LOG_INFO("[SharedPlanDatabaseTest] Exception occurred: %s", e.what());
+    EXPECT_TRUE(false);
+  }
+  return NULL;
+}
+
 TEST_F(PrepareStmtTests, PrepareStatementTest) {
 
   peloton::PelotonInit::Initialize();
@@ -100,5 +143,29 @@ TEST_F(PrepareStmtTests, PrepareStatementTest) {
   LOG_DEBUG("Peloton has shut down");
 }
 
+TEST_F(PrepareStmtTests, SharedPlanDatabaseTest) {
+  peloton::PelotonInit::Initialize();
+  LOG_INFO("Server initialized");
+  settings::SettingsManager::SetBool(settings::SettingId::shared_plan_cache,
+                                     true);
+  peloton::network::PelotonServer server;
+
+  int port = 15721;
+  try {
+    server.SetPort(port);
+    server.SetupServer();
+  } catch (peloton::ConnectionException &exception) {
+    LOG_INFO("[LaunchServer] exception when launching server");
+  }
+  std::thread serverThread([&]() { server.ServerLoop(); });
+  SharedPlanDatabaseTest(port);
+  server.Close();
+  serverThread.join();
+  settings::SettingsManager::SetBool(settings::SettingId::shared_plan_cache,
+                                     false);
+  peloton::PelotonInit::Shutdown();
+  LOG_DEBUG("Peloton has shut down");
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -19,6 +19,7 @@
 #include <pqxx/pqxx> /* libpqxx is used to instantiate C++ client */
 #include "network/postgres_protocol_handler.h"
 #include "network/connection_handle_factory.h"
+#include "settings/settings_manager.h"
 
 #define NUM_THREADS 1
 
@@ -88,6 +89,52 @@ void *SimpleQueryTest(int port) {
   return NULL;
 }
 
+/**
+ * Shared plan cache test
+ * The same query sent to two databases must read the table of each
+ */
+void *SharedPlanDatabaseTest(int port) {
+  try {
+    pqxx::connection C1(StringUtil::Format(
+        "host=127.0.0.1 port=%d user=default_database sslmode=disable "
+        "application_name=psql",
+        port));
+    pqxx::nontransaction N1(C1);
+    N1.exec("CREATE DATABASE shared_plan_db;");
+    N1.exec("DROP TABLE IF EXISTS shared_plan;");
+    N1.exec("CREATE TABLE shared_plan(id INT, name VARCHAR(100));");
+    N1.exec("INSERT INTO shared_plan VALUES (1, 'default');");
+
+    pqxx::connection C2(StringUtil::Format(
+        "host=127.0.0.1 port=%d user=default_database dbname=shared_plan_db "
+        "sslmode=disable application_name=psql",
+        port));
+    pqxx::nontransaction N2(C2);
+    N2.exec("CREATE TABLE shared_plan(id INT, name VARCHAR(100));");
+    N2.exec("INSERT INTO shared_plan VALUES (1, 'other');");
+
+    // Run the query twice on each connection, so that the second run of
+    // each uses a cached plan
+    for (int i = 0; i < 2; i++) {
+      pqxx::result R1 =
+          N1.exec("SELECT name FROM shared_plan WHERE id = 1;");
+      EXPECT_EQ(1, R1.size());
+      EXPECT_EQ("default", R1[0][0].as<std::string>());
+
+      pqxx::result R2 =
+          N2.exec("SELECT name FROM shared_plan WHERE id = 1;");
+      EXPECT_EQ(1, R2.size());
+      EXPECT_EQ("other", R2[0][0].as<std::string>());
+    }
+  } catch (const std::exception &e) {
+    LOG_INFO("[SharedPlanDatabaseTest] Exception occurred: %s", e.what());
+    EXPECT_TRUE(false);
+  }
+
+  LOG_INFO("[SharedPlanDatabaseTest] Client has closed");
+  return NULL;
+}
+
 /**
  * rollback test
  * YINGJUN: rewrite wanted.
@@ -186,6 +233,32 @@ TEST_F(SimpleQueryTests, SimpleQueryTest) {
   LOG_INFO("Peloton has shut down");
 }
 
+TEST_F(SimpleQueryTests, SharedPlanDatabaseTest) {
+  peloton::PelotonInit::Initialize();
+  LOG_INFO("Server initialized");
+  settings::SettingsManager::SetBool(settings::SettingId::shared_plan_cache,
+                                     true);
+  peloton::network::PelotonServer server;
+
+  int port = 15721;
+  try {
+    server.SetPort(port);
+    server.SetupServer();
+  } catch (peloton::ConnectionException &exception) {
+    LOG_INFO("[LaunchServer] exception when launching server");
+  }
+  std::thread serverThread([&]() { server.ServerLoop(); });
+
+  SharedPlanDatabaseTest(port);
+
+  server.Close();
+  serverThread.join();
+  settings::SettingsManager::SetBool(settings::SettingId::shared_plan_cache,
+                                     false);
+  peloton::PelotonInit::Shutdown();
+  LOG_INFO("Peloton has shut down");
+}
+
 ///**
 // * Scalability test
 // * Open 2 servers in threads concurrently
@@ -77,5 +77,20 @@ TEST_F(CountMinSketchTests, SimpleCountMinSketchMixTest) {
   sketch.Remove("1", 3);
   EXPECT_EQ(sketch.size, 3);
 }
+
+TEST_F(CountMinSketchTests, MergeTest) {
+  CountMinSketch sketch_1(10, 20, 0);
+  CountMinSketch sketch_2(10, 20, 0);
+
+  sketch_1.Add(1, 10);
+  sketch_1.Add("5", 5);
+  sketch_2.Add(1, 7);
+  sketch_2.Add(4, 1000000);
+
+  sketch_1.Merge(sketch_2);
+  EXPECT_EQ(sketch_1.EstimateItemCount(1), 17);
+  EXPECT_EQ(sketch_1.EstimateItemCount("5"), 5);
+  EXPECT_EQ(sketch_1.EstimateItemCount(4), 1000000);
+}
 }
 }
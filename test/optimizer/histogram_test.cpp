@@ -141,5 +141,30 @@ TEST_F(HistogramTests, SumTest) {
   EXPECT_EQ(h.Sum(6), 1);
 }
 
+// Merging histograms of two halves should match the histogram of the whole.
+TEST_F(HistogramTests, MergeTest) {
+  Histogram h_1{};
+  Histogram h_2{};
+  int n = 100000;
+  std::default_random_engine generator;
+  std::uniform_int_distribution<int> distribution(1, 100);
+  for (int i = 0; i < n; i++) {
+    int number = distribution(generator);
+    if (i % 2 == 0) {
+      h_1.Update(number);
+    } else {
+      h_2.Update(number);
+    }
+  }
+  h_1.Merge(h_2);
+  EXPECT_EQ(h_1.GetTotalValueCount(), n);
+  EXPECT_EQ(h_1.GetMinValue(), 1);
+  EXPECT_EQ(h_1.GetMaxValue(), 100);
+  std::vector<double> res = h_1.Uniform();
+  for (int i = 1; i < 100; i++) {
+    EXPECT_EQ(i, std::floor(res[i - 1]));
+  }
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -163,5 +163,26 @@ TEST_F(HyperLogLogTests, DataTypeTest) {
   hll.EstimateCardinality();
 }
 
+// Merging two HLLs over disjoint halves should estimate the union.
+TEST_F(HyperLogLogTests, MergeTest) {
+  HyperLogLog hll_1{};
+  HyperLogLog hll_2{};
+  int threshold = 100000;
+  int ratio = 10;
+  double error = hll_1.RelativeError();
+  for (int i = 1; i <= threshold; i++) {
+    type::Value v = type::ValueFactory::GetIntegerValue(i / ratio);
+    if (i % 2 == 0) {
+      hll_1.Update(v);
+    } else {
+      hll_2.Update(v);
+    }
+  }
+  hll_1.Merge(hll_2);
+  uint64_t cardinality = hll_1.EstimateCardinality();
+  EXPECT_LE(cardinality, threshold / ratio * (1 + error));
+  EXPECT_GE(cardinality, threshold / ratio * (1 - error));
+}
+
 }  // namespace test
 }  // namespace peloton
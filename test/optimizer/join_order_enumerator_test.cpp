@@ -0,0 +1,174 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// join_order_enumerator_test.cpp
+//
+// Identification: test/optimizer/join_order_enumerator_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/join_order_enumerator.h"
+
+#include <random>
+#include <unordered_map>
+
+#include "common/harness.h"
+
+namespace peloton {
+namespace test {
+
+using optimizer::JoinOrderEnumerator;
+using RelationSet = JoinOrderEnumerator::RelationSet;
+
+class JoinOrderEnumeratorTests : public PelotonTest {};
+
+namespace {
+
+struct TestPredicate {
+  RelationSet relations;
+  double selectivity;
+  bool is_equi_join;
+};
+
+// Finds the cost of the cheapest tree without cross products by trying every
+// split of every connected set
+double BruteForceCost(const std::vector<double> &cardinalities,
+                      const std::vector<TestPredicate> &predicates) {
+  std::unordered_map<RelationSet, double> costs, sizes;
+  for (size_t i = 0; i < cardinalities.size(); i++) {
+    costs[RelationSet{1} << i] = cardinalities[i];
+    sizes[RelationSet{1} << i] = cardinalities[i];
+  }
+  RelationSet all = (RelationSet{1} << cardinalities.size()) - 1;
+  // Supersets are numerically larger than their subsets
+  for (RelationSet set = 1; set <= all; set++) {
+    for (RelationSet left = (set - 1) & set; left != 0;
+         left = (left - 1) & set) {
+      RelationSet right = set ^ left;
+      if (costs.count(left) == 0 || costs.count(right) == 0) continue;
+      bool connected = false, is_equi_join = false;
+      double size = sizes[left] * sizes[right];
+      for (auto &predicate : predicates) {
+        if ((predicate.relations & ~set) == 0 &&
+            (predicate.relations & left) != 0 &&
+            (predicate.relations & right) != 0) {
+          connected = true;
+          is_equi_join |= predicate.is_equi_join;
+          size *= predicate.selectivity;
+        }
+      }
+      if (!connected) continue;
+      double cost = costs[left] + costs[right] +
+                    (is_equi_join ? sizes[left] + sizes[right]
+                                  : sizes[left] * sizes[right]);
+      if (costs.count(set) == 0 || cost < costs[set]) {
+        costs[set] = cost;
+      }
+      sizes[set] = size;
+    }
+  }
+  return costs[all];
+}
+
+// Checks that the chosen plans form a binary tree over all relations and
+// returns its number of joins
+size_t CheckTree(const JoinOrderEnumerator &enumerator, RelationSet relations) {
+  auto &node = enumerator.GetJoinNode(relations);
+  EXPECT_EQ(relations, node.relations);
+  if (node.left == 0) {
+    EXPECT_EQ(0, node.right);
+    EXPECT_EQ(0, relations & (relations - 1));
+    return 0;
+  }
+  EXPECT_EQ(0, node.left & node.right);
+  EXPECT_EQ(relations, node.left | node.right);
+  return 1 + CheckTree(enumerator, node.left) +
+         CheckTree(enumerator, node.right);
+}
+
+}  // namespace
+
+TEST_F(JoinOrderEnumeratorTests, ChainTest) {
+  // A (1000) - B (10) - C (1000), where joining A and C first would be a
+  // cross product
+  JoinOrderEnumerator enumerator;
+  enumerator.AddRelation(1000);
+  enumerator.AddRelation(10);
+  enumerator.AddRelation(1000);
+  enumerator.AddPredicate(0b011, 0.001, true);
+  enumerator.AddPredicate(0b110, 0.001, true);
+  enumerator.Enumerate(12);
+
+  auto &root = enumerator.GetJoinNode(0b111);
+  EXPECT_EQ(0b111, root.relations);
+  EXPECT_DOUBLE_EQ(10, root.cardinality);
+  EXPECT_EQ(2, CheckTree(enumerator, 0b111));
+  // The first join must be connected to B
+  auto first_join = (root.left & (root.left - 1)) != 0 ? root.left : root.right;
+  EXPECT_NE(0, first_join & 0b010);
+
+  // DPccp emits (n^3 - n) / 6 pairs for a chain, each pair once
+  EXPECT_EQ(4, enumerator.GetPairCount());
+}
+
+TEST_F(JoinOrderEnumeratorTests, DPMatchesBruteForceTest) {
+  std::mt19937 generator(0);
+  for (int round = 0; round < 100; round++) {
+    size_t num_relations = 2 + generator() % 8;
+    std::vector<double> cardinalities;
+    std::vector<TestPredicate> predicates;
+    JoinOrderEnumerator enumerator;
+    for (size_t i = 0; i < num_relations; i++) {
+      cardinalities.push_back(1 + generator() % 10000);
+      enumerator.AddRelation(cardinalities.back());
+    }
+    // A random spanning tree plus a few more edges
+    for (size_t i = 1; i < num_relations + generator() % 4; i++) {
+      size_t left = i < num_relations ? i : generator() % num_relations;
+      size_t right = generator() % (i < num_relations ? i : num_relations);
+      if (left == right) continue;
+      predicates.push_back({(RelationSet{1} << left) | (RelationSet{1} << right),
+                            1.0 / (1 + generator() % 1000),
+                            generator() % 2 == 0});
+      enumerator.AddPredicate(predicates.back().relations,
+                              predicates.back().selectivity,
+                              predicates.back().is_equi_join);
+    }
+
+    enumerator.EnumerateDP();
+    double cost = BruteForceCost(cardinalities, predicates);
+    EXPECT_NEAR(cost, enumerator.GetCost(), cost * 1e-9);
+    EXPECT_EQ(num_relations - 1,
+              CheckTree(enumerator, enumerator.GetAllRelations()));
+
+    // Greedy can't beat the optimal plan
+    enumerator.EnumerateGreedy();
+    EXPECT_GE(enumerator.GetCost(), cost * (1 - 1e-9));
+    EXPECT_EQ(num_relations - 1,
+              CheckTree(enumerator, enumerator.GetAllRelations()));
+  }
+}
+
+TEST_F(JoinOrderEnumeratorTests, GreedyFallbackTest) {
+  // Disconnected join graphs need a cross product, which only greedy allows
+  JoinOrderEnumerator enumerator;
+  for (int i = 0; i < 4; i++) {
+    enumerator.AddRelation(100 * (i + 1));
+  }
+  enumerator.AddPredicate(0b0011, 0.01, true);
+  enumerator.AddPredicate(0b1100, 0.01, true);
+  EXPECT_FALSE(enumerator.IsConnected());
+  enumerator.Enumerate(12);
+
+  auto &root = enumerator.GetJoinNode(0b1111);
+  EXPECT_EQ(3, CheckTree(enumerator, 0b1111));
+  // The connected pairs are joined before the cross product
+  EXPECT_TRUE((root.left == 0b0011 && root.right == 0b1100) ||
+              (root.left == 0b1100 && root.right == 0b0011));
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -76,6 +76,33 @@ TEST_F(OperatorTests, OperatorHashAndEqualTest) {
     EXPECT_EQ(l_group_by.Hash(), r_group_by.Hash());
     EXPECT_TRUE(l_group_by == r_group_by);
   }
+
+  //===--------------------------------------------------------------------===//
+  // InnerMergeJoin
+  //===--------------------------------------------------------------------===//
+  // The order of the keys is the sort order of the children, so it matters
+  auto make_merge_join = [&](std::vector<oid_t> key_cols) {
+    std::vector<std::unique_ptr<expression::AbstractExpression>> left_keys;
+    std::vector<std::unique_ptr<expression::AbstractExpression>> right_keys;
+    for (auto col : key_cols) {
+      auto left_key = new expression::TupleValueExpression("l");
+      left_key->SetBoundOid(0, 0, col);
+      left_keys.emplace_back(left_key);
+      auto right_key = new expression::TupleValueExpression("r");
+      right_key->SetBoundOid(0, 1, col);
+      right_keys.emplace_back(right_key);
+    }
+    return PhysicalInnerMergeJoin::make(havings, left_keys, right_keys);
+  };
+  Operator l_merge_join = make_merge_join({1, 2});
+  Operator r_merge_join = make_merge_join({1, 2});
+  EXPECT_EQ(l_merge_join.Hash(), r_merge_join.Hash());
+  EXPECT_TRUE(l_merge_join == r_merge_join);
+
+  r_merge_join = make_merge_join({2, 1});
+  EXPECT_FALSE(l_merge_join == r_merge_join);
+  r_merge_join = make_merge_join({1});
+  EXPECT_FALSE(l_merge_join == r_merge_join);
 }
 
 }  // namespace test
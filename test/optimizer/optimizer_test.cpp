@@ -29,6 +29,7 @@
 #include "sql/testing_sql_util.h"
 #include "planner/seq_scan_plan.h"
 #include "planner/abstract_join_plan.h"
+#include "planner/aggregate_plan.h"
 #include "planner/hash_join_plan.h"
 #include "binder/bind_node_visitor.h"
 #include "traffic_cop/traffic_cop.h"
@@ -56,6 +57,29 @@ class OptimizerTests : public PelotonTest {
     return group->GetLogicalExpressions()[0].get();
   }
 
+  // Collect the nodes of the plan tree with the given type
+  void CollectPlans(const planner::AbstractPlan *plan, PlanNodeType type,
+                    std::vector<const planner::AbstractPlan *> &plans) {
+    if (plan->GetPlanNodeType() == type) {
+      plans.push_back(plan);
+    }
+    for (auto &child : plan->GetChildren()) {
+      CollectPlans(child.get(), type, plans);
+    }
+  }
+
+  // Collect the scans of the plan tree, whatever access method they use
+  void CollectScans(const planner::AbstractPlan *plan,
+                    std::vector<const planner::AbstractScan *> &scans) {
+    auto scan = dynamic_cast<const planner::AbstractScan *>(plan);
+    if (scan != nullptr) {
+      scans.push_back(scan);
+    }
+    for (auto &child : plan->GetChildren()) {
+      CollectScans(child.get(), scans);
+    }
+  }
+
   virtual void TearDown() override {
     // TODO don't assume that all tests will need a test database
     // Destroy test database
@@ -269,15 +293,16 @@ TEST_F(OptimizerTests, PredicatePushDownTest) {
   auto &child_plan = plan->GetChildren();
   EXPECT_EQ(2, child_plan.size());
 
-  auto l_plan = dynamic_cast<planner::SeqScanPlan *>(child_plan[0].get());
-  auto r_plan = dynamic_cast<planner::SeqScanPlan *>(
-      child_plan[1]->GetChildren()[0].get());
-  planner::SeqScanPlan *test_plan = l_plan;
-  planner::SeqScanPlan *test1_plan = r_plan;
+  // Both tables are joined on their primary key, so they may be read through
+  // the index in key order
+  std::vector<const planner::AbstractScan *> scans;
+  CollectScans(plan.get(), scans);
+  ASSERT_EQ(2, scans.size());
+  auto test_plan = scans[0];
+  auto test1_plan = scans[1];
 
-  if (l_plan->GetTable()->GetName() == "test1") {
-    test_plan = r_plan;
-    test1_plan = l_plan;
+  if (test_plan->GetTable()->GetName() == "test1") {
+    std::swap(test_plan, test1_plan);
   }
 
   auto test_predicate = test_plan->GetPredicate();
@@ -285,17 +310,120 @@ TEST_F(OptimizerTests, PredicatePushDownTest) {
   auto test1_predicate = test1_plan->GetPredicate();
   EXPECT_EQ(ExpressionType::COMPARE_EQUAL,
             test1_predicate->GetExpressionType());
-  auto tv = dynamic_cast<expression::TupleValueExpression *>(
-      test1_predicate->GetModifiableChild(0));
+  auto tv = dynamic_cast<const expression::TupleValueExpression *>(
+      test1_predicate->GetChild(0));
   EXPECT_TRUE(tv != nullptr);
   EXPECT_EQ("test1", tv->GetTableName());
   EXPECT_EQ("b", tv->GetColumnName());
-  auto constant = dynamic_cast<expression::ConstantValueExpression *>(
-      test1_predicate->GetModifiableChild(1));
+  auto constant = dynamic_cast<const expression::ConstantValueExpression *>(
+      test1_predicate->GetChild(1));
   EXPECT_TRUE(constant != nullptr);
   EXPECT_EQ(22, constant->GetValue().GetAs<int>());
 }
 
+TEST_F(OptimizerTests, UnorderedInputTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b INT, c INT);");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test1(a INT PRIMARY KEY, b INT, c INT);");
+
+  auto &peloton_parser = parser::PostgresParser::GetInstance();
+  optimizer::Optimizer optimizer;
+
+  // Only test1 can be read in the order of the join key, sorting test for a
+  // merge join costs more than hashing
+  auto stmt = peloton_parser.BuildParseTree(
+      "SELECT test.a, test1.b FROM test, test1 WHERE test.b = test1.a");
+  txn = txn_manager.BeginTransaction();
+  auto plan = optimizer.BuildPelotonPlanTree(stmt, DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  std::vector<const planner::AbstractPlan *> plans;
+  CollectPlans(plan.get(), PlanNodeType::HASHJOIN, plans);
+  EXPECT_EQ(1, plans.size());
+  plans.clear();
+  CollectPlans(plan.get(), PlanNodeType::MERGEJOIN, plans);
+  EXPECT_EQ(0, plans.size());
+  plans.clear();
+  CollectPlans(plan.get(), PlanNodeType::ORDERBY, plans);
+  EXPECT_EQ(0, plans.size());
+
+  // The same goes for grouping
+  stmt = peloton_parser.BuildParseTree(
+      "SELECT b, COUNT(c) FROM test GROUP BY b");
+  txn = txn_manager.BeginTransaction();
+  plan = optimizer.BuildPelotonPlanTree(stmt, DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  plans.clear();
+  CollectPlans(plan.get(), PlanNodeType::AGGREGATE_V2, plans);
+  ASSERT_EQ(1, plans.size());
+  EXPECT_EQ(AggregateType::HASH,
+            static_cast<const planner::AggregatePlan *>(plans[0])
+                ->GetAggregateStrategy());
+  plans.clear();
+  CollectPlans(plan.get(), PlanNodeType::ORDERBY, plans);
+  EXPECT_EQ(0, plans.size());
+}
+
+TEST_F(OptimizerTests, IndexOrderedInputTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b INT, c INT);");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test1(a INT PRIMARY KEY, b INT, c INT);");
+
+  auto &peloton_parser = parser::PostgresParser::GetInstance();
+  optimizer::Optimizer optimizer;
+
+  // Both primary key indexes deliver the inputs in the order of a, so they
+  // are merged without sorting
+  auto stmt = peloton_parser.BuildParseTree(
+      "SELECT test.b, test1.b FROM test, test1 WHERE test.a = test1.a");
+  txn = txn_manager.BeginTransaction();
+  auto plan = optimizer.BuildPelotonPlanTree(stmt, DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  std::vector<const planner::AbstractPlan *> plans;
+  CollectPlans(plan.get(), PlanNodeType::MERGEJOIN, plans);
+  EXPECT_EQ(1, plans.size());
+  plans.clear();
+  CollectPlans(plan.get(), PlanNodeType::HASHJOIN, plans);
+  EXPECT_EQ(0, plans.size());
+  plans.clear();
+  CollectPlans(plan.get(), PlanNodeType::ORDERBY, plans);
+  EXPECT_EQ(0, plans.size());
+  plans.clear();
+  CollectPlans(plan.get(), PlanNodeType::INDEXSCAN, plans);
+  EXPECT_EQ(2, plans.size());
+
+  // Groups on the key come out of the index one after the other
+  stmt = peloton_parser.BuildParseTree(
+      "SELECT a, COUNT(c) FROM test GROUP BY a");
+  txn = txn_manager.BeginTransaction();
+  plan = optimizer.BuildPelotonPlanTree(stmt, DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  plans.clear();
+  CollectPlans(plan.get(), PlanNodeType::AGGREGATE_V2, plans);
+  ASSERT_EQ(1, plans.size());
+  EXPECT_EQ(AggregateType::SORTED,
+            static_cast<const planner::AggregatePlan *>(plans[0])
+                ->GetAggregateStrategy());
+  plans.clear();
+  CollectPlans(plan.get(), PlanNodeType::ORDERBY, plans);
+  EXPECT_EQ(0, plans.size());
+}
+
 TEST_F(OptimizerTests, PushFilterThroughJoinTest) {
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
   auto txn = txn_manager.BeginTransaction();
@@ -0,0 +1,252 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_template_cache_test.cpp
+//
+// Identification: test/optimizer/plan_template_cache_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "binder/bind_node_visitor.h"
+#include "catalog/catalog.h"
+#include "common/statement_cache_manager.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "optimizer/operator_expression.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/plan_template_cache.h"
+#include "optimizer/property_set.h"
+#include "optimizer/query_to_operator_transformer.h"
+#include "parser/postgresparser.h"
+#include "settings/settings_manager.h"
+#include "sql/testing_sql_util.h"
+
+namespace peloton {
+namespace test {
+
+using optimizer::PlanTemplateCache;
+
+class PlanTemplateCacheTests : public PelotonTest {
+ protected:
+  virtual void SetUp() override {
+    PelotonTest::SetUp();
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+    txn_manager.CommitTransaction(txn);
+    TestingSQLUtil::ExecuteSQLQuery(
+        "CREATE TABLE test(a INT PRIMARY KEY, b INT, c INT);");
+    TestingSQLUtil::ExecuteSQLQuery(
+        "CREATE TABLE test1(a INT PRIMARY KEY, b INT, c INT);");
+    PlanTemplateCache::GetInstance().Clear();
+    settings::SettingsManager::SetBool(
+        settings::SettingId::plan_template_cache, true);
+  }
+
+  virtual void TearDown() override {
+    settings::SettingsManager::SetBool(
+        settings::SettingId::plan_template_cache, false);
+    PlanTemplateCache::GetInstance().Clear();
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+    txn_manager.CommitTransaction(txn);
+    PelotonTest::TearDown();
+  }
+
+  // Returns whether the query can be cached, and its key
+  bool GetKey(const std::string &query, std::string &key) {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    auto stmt = parser::PostgresParser::GetInstance().BuildParseTree(query);
+    auto parse_tree = stmt->GetStatement(0);
+    binder::BindNodeVisitor binder(txn, DEFAULT_DB_NAME);
+    binder.BindNameToNode(parse_tree);
+
+    optimizer::QueryToOperatorTransformer converter(txn);
+    auto tree = converter.ConvertToOpExpression(parse_tree);
+    std::vector<expression::AbstractExpression *> output_exprs;
+    for (auto &expr :
+         reinterpret_cast<parser::SelectStatement *>(parse_tree)->select_list) {
+      output_exprs.push_back(expr.get());
+    }
+    std::vector<PlanTemplateCache::TableRef> tables;
+    bool cacheable = PlanTemplateCache::GetKey(
+        *tree, output_exprs, optimizer::PropertySet(), key, tables);
+    txn_manager.CommitTransaction(txn);
+    return cacheable;
+  }
+
+  std::shared_ptr<planner::AbstractPlan> Optimize(const std::string &query) {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    auto stmt = parser::PostgresParser::GetInstance().BuildParseTree(query);
+    optimizer::Optimizer optimizer;
+    auto plan = optimizer.BuildPelotonPlanTree(stmt, DEFAULT_DB_NAME, txn);
+    txn_manager.CommitTransaction(txn);
+    return plan;
+  }
+};
+
+TEST_F(PlanTemplateCacheTests, KeyTest) {
+  std::string key1, key2;
+  EXPECT_TRUE(GetKey("SELECT a FROM test WHERE b = $1", key1));
+  EXPECT_TRUE(GetKey("SELECT a FROM test WHERE b = $1", key2));
+  EXPECT_EQ(key1, key2);
+
+  // Different constants, columns, tables and parameter slots. Constants are
+  // built into the plans, simple queries only share them because their
+  // literals are turned into parameters before they are optimized.
+  EXPECT_TRUE(GetKey("SELECT a FROM test WHERE b = 1", key1));
+  EXPECT_TRUE(GetKey("SELECT a FROM test WHERE b = 2", key2));
+  EXPECT_NE(key1, key2);
+  EXPECT_TRUE(GetKey("SELECT a FROM test WHERE c = 1", key2));
+  EXPECT_NE(key1, key2);
+  EXPECT_TRUE(GetKey("SELECT a FROM test1 WHERE b = 1", key2));
+  EXPECT_NE(key1, key2);
+  EXPECT_TRUE(GetKey("SELECT a FROM test WHERE b = $1 AND c = $2", key1));
+  EXPECT_TRUE(GetKey("SELECT a FROM test WHERE b = $2 AND c = $1", key2));
+  EXPECT_NE(key1, key2);
+
+  // Output columns are part of the key
+  EXPECT_TRUE(GetKey("SELECT a FROM test WHERE b = 1", key1));
+  EXPECT_TRUE(GetKey("SELECT c FROM test WHERE b = 1", key2));
+  EXPECT_NE(key1, key2);
+
+  // Joins
+  EXPECT_TRUE(
+      GetKey("SELECT test.a FROM test, test1 WHERE test.a = test1.a", key1));
+  EXPECT_TRUE(
+      GetKey("SELECT test.a FROM test, test1 WHERE test.a = test1.b", key2));
+  EXPECT_NE(key1, key2);
+
+  // Columns of a derived table
+  EXPECT_TRUE(GetKey("SELECT s.a FROM (SELECT b AS a, c AS b FROM test) s",
+                     key1));
+  EXPECT_TRUE(GetKey("SELECT s.b FROM (SELECT b AS a, c AS b FROM test) s",
+                     key2));
+  EXPECT_NE(key1, key2);
+}
+
+TEST_F(PlanTemplateCacheTests, ReuseTest) {
+  auto &cache = PlanTemplateCache::GetInstance();
+  const std::string query = "SELECT a FROM test WHERE b = 1";
+  auto hits = cache.GetHitCount();
+
+  auto plan = Optimize(query);
+  ASSERT_NE(nullptr, plan);
+  EXPECT_EQ(1, cache.GetSize());
+  // Leased until released
+  std::string key;
+  EXPECT_TRUE(GetKey(query, key));
+  EXPECT_EQ(0, cache.GetPlanCount(key));
+  auto first = plan.get();
+  plan.reset();
+  EXPECT_EQ(1, cache.GetPlanCount(key));
+
+  // The same plan is handed out again
+  plan = Optimize(query);
+  EXPECT_EQ(first, plan.get());
+  EXPECT_EQ(hits + 1, cache.GetHitCount());
+
+  // While it's in use another one is picked, and both are kept
+  auto other_plan = Optimize(query);
+  EXPECT_NE(first, other_plan.get());
+  plan.reset();
+  other_plan.reset();
+  EXPECT_EQ(2, cache.GetPlanCount(key));
+
+  // Only so many idle plans are kept per key
+  const size_t max_plans = PlanTemplateCache::kMaxPlansPerKey;
+  std::vector<std::shared_ptr<planner::AbstractPlan>> plans;
+  for (size_t i = 0; i < max_plans + 2; i++) {
+    plans.push_back(Optimize(query));
+  }
+  plans.clear();
+  EXPECT_EQ(max_plans, cache.GetPlanCount(key));
+
+  // Different constants don't share plans
+  plan = Optimize("SELECT a FROM test WHERE b = 2");
+  EXPECT_NE(first, plan.get());
+  plan.reset();
+  EXPECT_EQ(2, cache.GetSize());
+}
+
+TEST_F(PlanTemplateCacheTests, InvalidateTest) {
+  auto &cache = PlanTemplateCache::GetInstance();
+  const std::string query = "SELECT a FROM test WHERE b = 1";
+  std::string key;
+  EXPECT_TRUE(GetKey(query, key));
+
+  Optimize(query);
+  EXPECT_EQ(1, cache.GetPlanCount(key));
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto table = catalog::Catalog::GetInstance()->GetTableWithName(
+      DEFAULT_DB_NAME, "test", txn);
+  txn_manager.CommitTransaction(txn);
+  std::set<oid_t> table_ids{table->GetOid()};
+  cache.InvalidateTableOids(table_ids);
+  EXPECT_EQ(0, cache.GetSize());
+
+  // Plans leased before an invalidation aren't cached again
+  auto plan = Optimize(query);
+  cache.InvalidateTableOids(table_ids);
+  plan.reset();
+  EXPECT_EQ(0, cache.GetSize());
+}
+
+TEST_F(PlanTemplateCacheTests, CreateIndexTest) {
+  auto &cache = PlanTemplateCache::GetInstance();
+  const std::string query = "SELECT a FROM test WHERE b = 1";
+  StatementCacheManager::Init();
+
+  Optimize(query);
+  EXPECT_EQ(1, cache.GetSize());
+
+  // The new index may make a better plan
+  TestingSQLUtil::ExecuteSQLQuery("CREATE INDEX test_b ON test(b);");
+  EXPECT_EQ(0, cache.GetSize());
+}
+
+TEST_F(PlanTemplateCacheTests, DriftTest) {
+  auto &cache = PlanTemplateCache::GetInstance();
+  const std::string query = "SELECT a FROM test WHERE b = 1";
+  auto reoptimizations = cache.GetReoptimizeCount();
+
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (1, 1, 1);");
+  Optimize(query);
+  Optimize(query);
+  EXPECT_EQ(reoptimizations, cache.GetReoptimizeCount());
+
+  // The table grew past the drift ratio, so the plan is picked again
+  for (int i = 2; i <= 10; i++) {
+    TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (" +
+                                    std::to_string(i) + ", 1, 1);");
+  }
+  Optimize(query);
+  EXPECT_EQ(reoptimizations + 1, cache.GetReoptimizeCount());
+  Optimize(query);
+  EXPECT_EQ(reoptimizations + 1, cache.GetReoptimizeCount());
+
+  // Updates leave the number of rows as it is, however many versions they
+  // create
+  for (int i = 0; i < 10; i++) {
+    TestingSQLUtil::ExecuteSQLQuery("UPDATE test SET c = c + 1;");
+  }
+  Optimize(query);
+  EXPECT_EQ(reoptimizations + 1, cache.GetReoptimizeCount());
+
+  // Deleting most of them is a drift again
+  TestingSQLUtil::ExecuteSQLQuery("DELETE FROM test WHERE a > 1;");
+  Optimize(query);
+  EXPECT_EQ(reoptimizations + 2, cache.GetReoptimizeCount());
+}
+
+}  // namespace test
+}  // namespace peloton
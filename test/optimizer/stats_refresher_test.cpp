@@ -0,0 +1,163 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// stats_refresher_test.cpp
+//
+// Identification: test/optimizer/stats_refresher_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "catalog/catalog.h"
+#include "common/statement_cache_manager.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/plan_template_cache.h"
+#include "optimizer/stats/stats_refresher.h"
+#include "optimizer/stats/stats_storage.h"
+#include "optimizer/stats/table_stats.h"
+#include "parser/postgresparser.h"
+#include "settings/settings_manager.h"
+#include "sql/testing_sql_util.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace test {
+
+using namespace optimizer;
+
+class StatsRefresherTests : public PelotonTest {
+ protected:
+  virtual void SetUp() override {
+    PelotonTest::SetUp();
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+    txn_manager.CommitTransaction(txn);
+    StatementCacheManager::Init();
+    PlanTemplateCache::GetInstance().Clear();
+    settings::SettingsManager::SetBool(
+        settings::SettingId::plan_template_cache, true);
+  }
+
+  virtual void TearDown() override {
+    settings::SettingsManager::SetBool(
+        settings::SettingId::plan_template_cache, false);
+    PlanTemplateCache::GetInstance().Clear();
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+    txn_manager.CommitTransaction(txn);
+    PelotonTest::TearDown();
+  }
+};
+
+namespace {
+
+// Insert rows (a, b) with a = first_key + i and b = b_start + i % b_range
+void LoadTuples(int first_key, int tuple_count, int b_start, int b_range) {
+  const int batch_size = 500;
+  for (int batch = 0; batch < tuple_count; batch += batch_size) {
+    std::string query = "INSERT INTO test VALUES ";
+    for (int i = batch; i < std::min(batch + batch_size, tuple_count); i++) {
+      if (i != batch) query += ", ";
+      query += "(" + std::to_string(first_key + i) + ", " +
+               std::to_string(b_start + i % b_range) + ")";
+    }
+    query += ";";
+    TestingSQLUtil::ExecuteSQLQuery(query);
+  }
+}
+
+size_t GetAnalyzedRowCount(storage::DataTable *table) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto table_stats = StatsStorage::GetInstance()->GetTableStats(
+      table->GetDatabaseOid(), table->GetOid(), txn);
+  txn_manager.CommitTransaction(txn);
+  return table_stats->num_rows;
+}
+
+// The type of the scan the optimizer picks for the query
+PlanNodeType GetScanType(const std::string &query) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto stmt = parser::PostgresParser::GetInstance().BuildParseTree(query);
+  optimizer::Optimizer optimizer;
+  auto plan = optimizer.BuildPelotonPlanTree(stmt, DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  const planner::AbstractPlan *node = plan.get();
+  while (node->GetPlanNodeType() != PlanNodeType::SEQSCAN &&
+         node->GetPlanNodeType() != PlanNodeType::INDEXSCAN) {
+    EXPECT_EQ(1, node->GetChildrenSize());
+    node = node->GetChild(0);
+  }
+  return node->GetPlanNodeType();
+}
+
+}  // namespace
+
+// The table doubles in size after it was analyzed. The refresher must notice
+// the churn, bring the row count the optimizer costs plans with up to date
+// and drop the plans picked with the old stats.
+TEST_F(StatsRefresherTests, RefreshAfterBulkLoadTest) {
+  const int tuple_count = 2 * StatsRefresher::kMinRefreshRows;
+  const std::string query = "SELECT a FROM test WHERE b < 1000";
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b INT);");
+  TestingSQLUtil::ExecuteSQLQuery("CREATE INDEX test_b ON test(b);");
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto data_table = catalog::Catalog::GetInstance()->GetTableWithName(
+      DEFAULT_DB_NAME, "test", txn);
+  txn_manager.CommitTransaction(txn);
+  oid_t database_oid = data_table->GetDatabaseOid();
+  oid_t table_oid = data_table->GetOid();
+
+  auto &refresher = StatsRefresher::GetInstance();
+  auto &cache = PlanTemplateCache::GetInstance();
+
+  // A freshly loaded table has never been analyzed
+  LoadTuples(0, tuple_count, 0, 500);
+  EXPECT_TRUE(refresher.IsStale(data_table));
+
+  EXPECT_EQ(refresher.RefreshTable(database_oid, table_oid),
+            ResultType::SUCCESS);
+  EXPECT_FALSE(refresher.IsStale(data_table));
+  EXPECT_EQ(GetAnalyzedRowCount(data_table), tuple_count);
+
+  // Every row passes the predicate, so reading them through the index only
+  // adds the cost of the index lookup
+  EXPECT_EQ(PlanNodeType::SEQSCAN, GetScanType(query));
+  EXPECT_EQ(1, cache.GetSize());
+
+  // Shift the data: the stats now under-count the table by half, and only
+  // the rows analyzed before pass the predicate
+  LoadTuples(tuple_count, tuple_count, 1000, tuple_count);
+  EXPECT_TRUE(refresher.IsStale(data_table));
+  EXPECT_EQ(GetAnalyzedRowCount(data_table), tuple_count);
+  EXPECT_EQ(1, cache.GetSize());
+
+  EXPECT_EQ(refresher.RefreshTable(database_oid, table_oid),
+            ResultType::SUCCESS);
+  EXPECT_FALSE(refresher.IsStale(data_table));
+  EXPECT_EQ(GetAnalyzedRowCount(data_table), 2 * tuple_count);
+
+  // The cached plan is gone, and with half of the rows filtered out the
+  // index is now cheaper
+  EXPECT_EQ(0, cache.GetSize());
+  EXPECT_EQ(PlanNodeType::INDEXSCAN, GetScanType(query));
+
+  // Refreshing a table that is gone is not an error for the caller
+  EXPECT_EQ(refresher.RefreshTable(database_oid, INVALID_OID),
+            ResultType::FAILURE);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -143,5 +143,52 @@ TEST_F(TableStatsCollectorTests, MultiColumnTableTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+// Parallel and sampled collection should agree with a serial full scan.
+TEST_F(TableStatsCollectorTests, ParallelSampledTest) {
+  const int tuple_count = 10000;
+  const int tuple_per_tilegroup = 100;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuple_per_tilegroup, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuple_count, false,
+                                     false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  TableStatsCollector serial_stats{data_table.get()};
+  serial_stats.CollectColumnStats(1, 1.0);
+  EXPECT_EQ(serial_stats.GetWorkerCount(), 1);
+  EXPECT_EQ(serial_stats.GetActiveTupleCount(), tuple_count);
+  EXPECT_EQ(serial_stats.GetSampledTupleCount(), tuple_count);
+
+  TableStatsCollector parallel_stats{data_table.get()};
+  parallel_stats.CollectColumnStats(4, 1.0);
+  EXPECT_EQ(parallel_stats.GetWorkerCount(), 4);
+  EXPECT_EQ(parallel_stats.GetActiveTupleCount(), tuple_count);
+
+  // Merged sketches over the same tuples give the same answers.
+  ColumnStatsCollector *serial_a = serial_stats.GetColumnStats(0);
+  ColumnStatsCollector *parallel_a = parallel_stats.GetColumnStats(0);
+  EXPECT_EQ(parallel_a->GetCardinality(), serial_a->GetCardinality());
+  EXPECT_EQ(parallel_a->GetFracNull(), serial_a->GetFracNull());
+  EXPECT_EQ(parallel_a->GetHistogramBound().size(),
+            serial_a->GetHistogramBound().size());
+
+  TableStatsCollector sampled_stats{data_table.get()};
+  sampled_stats.CollectColumnStats(4, 0.2);
+  EXPECT_EQ(sampled_stats.GetActiveTupleCount(), tuple_count);
+  EXPECT_LT(sampled_stats.GetSampledTupleCount(), tuple_count);
+  EXPECT_GT(sampled_stats.GetSampledTupleCount(), 0);
+
+  // Column a is unique, so the sampled distinct count is scaled up.
+  ColumnStatsCollector *sampled_a = sampled_stats.GetColumnStats(0);
+  double error = 0.2;
+  EXPECT_GE(sampled_a->GetCardinality(), tuple_count * (1 - error));
+  EXPECT_LE(sampled_a->GetCardinality(), tuple_count * (1 + error));
+  LOG_TRACE("Full scan cardinality: %lu, sampled cardinality: %lu",
+            serial_a->GetCardinality(), sampled_a->GetCardinality());
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -165,5 +165,37 @@ TEST_F(TopKElementsTests, UniformTest) {
 
   top_k_elements.PrintAllOrderedMaxFirst();
 }
+
+TEST_F(TopKElementsTests, MergeTest) {
+  CountMinSketch sketch(1000, 1000, 0);
+
+  const int k = 3;
+  TopKElements top_k_1(sketch, k);
+  TopKElements top_k_2(sketch, k);
+
+  // Item 1 is not among the top 3 of either side, but it is the most
+  // frequent item overall. It is still a candidate on both sides, so the
+  // merge finds it.
+  top_k_1.Add(1, 40);
+  top_k_1.Add(2, 50);
+  top_k_1.Add(3, 60);
+  top_k_1.Add("a", 70);
+  top_k_2.Add(1, 40);
+  top_k_2.Add(4, 45);
+  top_k_2.Add(5, 55);
+  top_k_2.Add("b", 65);
+
+  top_k_1.Merge(top_k_2);
+  EXPECT_EQ(top_k_1.tkq.get_size(), k);
+  EXPECT_EQ(top_k_1.cmsketch.EstimateItemCount(1), 80);
+
+  auto entries = top_k_1.RetrieveAllOrderedMaxFirst();
+  ASSERT_EQ(entries.size(), k);
+  EXPECT_EQ(entries[0].approx_top_elem.int_item, 1);
+  EXPECT_EQ(entries[0].approx_count, 80);
+  EXPECT_EQ(entries[1].approx_top_elem.str_item, "a");
+  EXPECT_EQ(entries[1].approx_count, 70);
+  EXPECT_EQ(entries[2].approx_top_elem.str_item, "b");
+}
 }
 }
@@ -1220,5 +1220,49 @@ TEST_F(PostgresParserTests, TypeCastTest) {
   }
 }
 
+TEST_F(PostgresParserTests, ParameterizeQueryTest) {
+  std::string parameterized_query;
+  std::vector<type::Value> params;
+
+  // Literals in the WHERE clause become parameters, LIMIT keeps its value
+  EXPECT_TRUE(parser::PostgresParser::ParameterizeQuery(
+      "SELECT a, 1 FROM foo WHERE b = -5 AND c = 'it''s' LIMIT 10;",
+      parameterized_query, params));
+  EXPECT_EQ("SELECT a, 1 FROM foo WHERE b = $1 AND c = $2 LIMIT 10;",
+            parameterized_query);
+  ASSERT_EQ(2, params.size());
+  EXPECT_EQ(type::TypeId::INTEGER, params[0].GetTypeId());
+  EXPECT_EQ(-5, params[0].GetAs<int32_t>());
+  EXPECT_EQ(type::TypeId::VARCHAR, params[1].GetTypeId());
+  EXPECT_EQ("it's", params[1].ToString());
+
+  // Integers that don't fit into 32 bits are read as decimals
+  EXPECT_TRUE(parser::PostgresParser::ParameterizeQuery(
+      "UPDATE foo SET a = 1.5 WHERE b = 99999999999", parameterized_query,
+      params));
+  EXPECT_EQ("UPDATE foo SET a = $1 WHERE b = $2", parameterized_query);
+  ASSERT_EQ(2, params.size());
+  EXPECT_EQ(type::TypeId::DECIMAL, params[0].GetTypeId());
+  EXPECT_EQ(type::TypeId::DECIMAL, params[1].GetTypeId());
+
+  EXPECT_TRUE(parser::PostgresParser::ParameterizeQuery(
+      "INSERT INTO foo VALUES (1, 'a')", parameterized_query, params));
+  EXPECT_EQ("INSERT INTO foo VALUES ($1, $2)", parameterized_query);
+  EXPECT_EQ(2, params.size());
+
+  // Statements other than DML, several statements, comments and literals
+  // that aren't numbers or strings are not parameterized
+  EXPECT_FALSE(parser::PostgresParser::ParameterizeQuery(
+      "CREATE TABLE foo (a INT)", parameterized_query, params));
+  EXPECT_FALSE(parser::PostgresParser::ParameterizeQuery(
+      "SELECT * FROM foo WHERE a = 1; SELECT 2", parameterized_query, params));
+  EXPECT_FALSE(parser::PostgresParser::ParameterizeQuery(
+      "SELECT * FROM foo WHERE a = 1 -- one", parameterized_query, params));
+  EXPECT_FALSE(parser::PostgresParser::ParameterizeQuery(
+      "SELECT * FROM foo WHERE a = TRUE", parameterized_query, params));
+  EXPECT_FALSE(parser::PostgresParser::ParameterizeQuery(
+      "SELECT * FROM", parameterized_query, params));
+}
+
 }  // namespace test
 }  // namespace peloton
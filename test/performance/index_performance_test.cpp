@@ -19,7 +19,9 @@
 #include "common/logger.h"
 #include "common/platform.h"
 #include "common/timer.h"
+#include "index/art_index.h"
 #include "index/index_factory.h"
+#include "settings/settings_manager.h"
 #include "storage/tuple.h"
 #include "type/value_factory.h"
 
@@ -369,6 +371,189 @@ TEST_F(IndexPerformanceTests, BwTreeMultiThreadedTest) {
   TestIndexPerformance(IndexType::BWTREE);
 }
 
+//===--------------------------------------------------------------------===//
+// Point Lookup Performance Tests
+//===--------------------------------------------------------------------===//
+
+/*
+ * LookupTestData - Keys of num_col BIGINT columns, which BwTree stores in a
+ * CompactIntsKey<num_col>, together with one value per key.
+ *
+ * An ART index that doesn't store its keys loads them back from here, which
+ * stands in for materializing the key from the table.
+ */
+struct LookupTestData {
+  std::unique_ptr<catalog::Schema> tuple_schema;
+  index::ArtIndex *art_index = nullptr;
+  std::vector<std::unique_ptr<storage::Tuple>> keys;
+  std::vector<ItemPointer> items;
+
+  static void LoadKey(void *ctx, TID tid, art::Key &key) {
+    auto *data = reinterpret_cast<const LookupTestData *>(ctx);
+    auto *ip = reinterpret_cast<const ItemPointer *>(tid);
+    data->art_index->ConstructArtKey(*data->keys[ip->offset], key);
+  }
+};
+
+static index::Index *BuildLookupIndex(const IndexType index_type,
+                                      const oid_t num_col,
+                                      LookupTestData &data) {
+  std::vector<catalog::Column> columns;
+  std::vector<oid_t> key_attrs;
+  for (oid_t col = 0; col < num_col; col++) {
+    columns.emplace_back(type::TypeId::BIGINT,
+                         type::Type::GetTypeSize(type::TypeId::BIGINT),
+                         std::string(1, 'A' + col), true);
+    key_attrs.push_back(col);
+  }
+
+  auto *lookup_key_schema = new catalog::Schema(columns);
+  lookup_key_schema->SetIndexedColumns(key_attrs);
+  data.tuple_schema.reset(new catalog::Schema(columns));
+
+  auto *index_metadata = new index::IndexMetadata(
+      "lookup_index", 126, INVALID_OID, INVALID_OID, index_type,
+      IndexConstraintType::DEFAULT, data.tuple_schema.get(), lookup_key_schema,
+      key_attrs, true);
+
+  auto *index = index::IndexFactory::GetIndex(index_metadata);
+  EXPECT_TRUE(index != nullptr);
+
+  if (index_type == IndexType::ART) {
+    data.art_index = static_cast<index::ArtIndex *>(index);
+    data.art_index->SetLoadKeyFunc(LookupTestData::LoadKey, &data);
+  }
+  return index;
+}
+
+/*
+ * LookupTest() - Each thread looks up every key once, starting at its own
+ * offset so that threads don't walk the tree in lock step
+ */
+static void LookupTest(index::Index *index, const LookupTestData *data,
+                       size_t num_thread, uint64_t thread_id) {
+  std::vector<ItemPointer *> location_ptrs;
+  size_t num_key = data->keys.size();
+  size_t start = thread_id * (num_key / num_thread);
+  for (size_t i = 0; i < num_key; i++) {
+    index->ScanKey(data->keys[(start + i) % num_key].get(), location_ptrs);
+    EXPECT_EQ(1, location_ptrs.size());
+    location_ptrs.clear();
+  }
+}
+
+/*
+ * TestLookupPerformance() - Point lookups of num_col-column integer keys
+ *
+ * With inline_keys unset, ART loads keys for every lookup that ends above the
+ * last key byte
+ */
+static void TestLookupPerformance(const IndexType index_type,
+                                  const oid_t num_col, const bool inline_keys) {
+  settings::SettingsManager::SetBool(settings::SettingId::art_inline_keys,
+                                     inline_keys);
+
+  LookupTestData data;
+  std::unique_ptr<index::Index> index(
+      BuildLookupIndex(index_type, num_col, data));
+
+  size_t num_thread = 4;
+  size_t num_key = 1024 * 256;
+
+  for (size_t i = 0; i < num_key; i++) {
+    std::unique_ptr<storage::Tuple> key(
+        new storage::Tuple(index->GetKeySchema(), true));
+    for (oid_t col = 0; col < num_col; col++) {
+      // Spread keys over all columns so no column is a constant prefix
+      key->SetValue(col, type::ValueFactory::GetBigIntValue(
+                             static_cast<int64_t>(i * (col + 1))),
+                    nullptr);
+    }
+    data.keys.push_back(std::move(key));
+    data.items.emplace_back(0, static_cast<oid_t>(i));
+  }
+  for (size_t i = 0; i < num_key; i++) {
+    EXPECT_TRUE(index->InsertEntry(data.keys[i].get(), &data.items[i]));
+  }
+
+  Timer<> timer;
+  timer.Start();
+
+  LaunchParallelTest(num_thread, LookupTest, index.get(), &data, num_thread);
+
+  timer.Stop();
+  LOG_INFO("LookupTest :: Type=%s; Columns=%u; InlineKeys=%d; Duration=%.2lf",
+           IndexTypeToString(index_type).c_str(), num_col, inline_keys,
+           timer.GetDuration());
+
+  settings::SettingsManager::SetBool(settings::SettingId::art_inline_keys,
+                                     false);
+}
+
+/*
+ * TestScanKeysPerformance() - Probes an index with an IN-list of num_probe
+ * random keys, once key by key and once as a batch
+ */
+static void TestScanKeysPerformance(const IndexType index_type,
+                                    const size_t num_probe) {
+  LookupTestData data;
+  std::unique_ptr<index::Index> index(BuildLookupIndex(index_type, 1, data));
+
+  size_t num_key = 1024 * 1024;
+  for (size_t i = 0; i < num_key; i++) {
+    std::unique_ptr<storage::Tuple> key(
+        new storage::Tuple(index->GetKeySchema(), true));
+    key->SetValue(0, type::ValueFactory::GetBigIntValue(i), nullptr);
+    data.keys.push_back(std::move(key));
+    data.items.emplace_back(0, static_cast<oid_t>(i));
+  }
+  for (size_t i = 0; i < num_key; i++) {
+    EXPECT_TRUE(index->InsertEntry(data.keys[i].get(), &data.items[i]));
+  }
+
+  std::vector<const storage::Tuple *> probes;
+  for (size_t i = 0; i < num_probe; i++) {
+    probes.push_back(data.keys[std::rand() % num_key].get());
+  }
+
+  Timer<> timer;
+  timer.Start();
+  std::vector<ItemPointer *> location_ptrs;
+  for (auto *probe : probes) {
+    index->ScanKey(probe, location_ptrs);
+  }
+  timer.Stop();
+  EXPECT_EQ(num_probe, location_ptrs.size());
+  LOG_INFO("ScanKey :: Type=%s; Probes=%lu; Duration=%.2lf",
+           IndexTypeToString(index_type).c_str(), num_probe,
+           timer.GetDuration());
+
+  timer.Reset();
+  timer.Start();
+  std::vector<std::vector<ItemPointer *>> results;
+  index->ScanKeys(probes, results);
+  timer.Stop();
+  EXPECT_EQ(num_probe, results.size());
+  LOG_INFO("ScanKeys :: Type=%s; Probes=%lu; Duration=%.2lf",
+           IndexTypeToString(index_type).c_str(), num_probe,
+           timer.GetDuration());
+}
+
+TEST_F(IndexPerformanceTests, ScanKeysTest) {
+  for (size_t num_probe : {1000, 100000}) {
+    TestScanKeysPerformance(IndexType::BWTREE, num_probe);
+    TestScanKeysPerformance(IndexType::ART, num_probe);
+  }
+}
+
+TEST_F(IndexPerformanceTests, PointLookupTest) {
+  for (oid_t num_col = 1; num_col <= 4; num_col++) {
+    TestLookupPerformance(IndexType::BWTREE, num_col, false);
+    TestLookupPerformance(IndexType::ART, num_col, false);
+    TestLookupPerformance(IndexType::ART, num_col, true);
+  }
+}
+
 // TEST_F(IndexPerformanceTests, BTreeMultiThreadedTest) {
 //  TestIndexPerformance(IndexType::BTREE);
 //}
@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// join_order_performance_test.cpp
+//
+// Identification: test/performance/join_order_performance_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include <random>
+
+#include "common/logger.h"
+#include "common/timer.h"
+#include "optimizer/join_order_enumerator.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Join Order Performance Tests
+//===--------------------------------------------------------------------===//
+
+class JoinOrderPerformanceTests : public PelotonTest {};
+
+using optimizer::JoinOrderEnumerator;
+using RelationSet = JoinOrderEnumerator::RelationSet;
+
+enum class JoinGraphShape { CHAIN, STAR, CLIQUE };
+
+const char *ShapeName(JoinGraphShape shape) {
+  switch (shape) {
+    case JoinGraphShape::CHAIN:
+      return "chain";
+    case JoinGraphShape::STAR:
+      return "star";
+    case JoinGraphShape::CLIQUE:
+      return "clique";
+  }
+  return "";
+}
+
+// Builds a join of the given shape over tables of random sizes, with an
+// equi-join predicate on every edge
+void BuildJoinGraph(JoinOrderEnumerator &enumerator, JoinGraphShape shape,
+                    size_t num_tables) {
+  std::mt19937 generator(num_tables);
+  for (size_t i = 0; i < num_tables; i++) {
+    enumerator.AddRelation(10 + generator() % 1000000);
+  }
+  auto add_edge = [&](size_t left, size_t right) {
+    enumerator.AddPredicate((RelationSet{1} << left) | (RelationSet{1} << right),
+                            1.0 / (10 + generator() % 100000), true);
+  };
+  for (size_t i = 1; i < num_tables; i++) {
+    switch (shape) {
+      case JoinGraphShape::CHAIN:
+        add_edge(i - 1, i);
+        break;
+      case JoinGraphShape::STAR:
+        add_edge(0, i);
+        break;
+      case JoinGraphShape::CLIQUE:
+        for (size_t j = 0; j < i; j++) {
+          add_edge(j, i);
+        }
+        break;
+    }
+  }
+}
+
+TEST_F(JoinOrderPerformanceTests, EnumerationTest) {
+  for (auto shape : {JoinGraphShape::CHAIN, JoinGraphShape::STAR,
+                     JoinGraphShape::CLIQUE}) {
+    for (size_t num_tables = 4; num_tables <= 16; num_tables += 4) {
+      JoinOrderEnumerator enumerator;
+      BuildJoinGraph(enumerator, shape, num_tables);
+
+      Timer<std::milli> timer;
+      timer.Start();
+      enumerator.EnumerateDP();
+      timer.Stop();
+      double dp_cost = enumerator.GetCost();
+      LOG_INFO("%s of %zu tables: DP took %.3f ms over %zu pairs, cost %.0f",
+               ShapeName(shape), num_tables, timer.GetDuration(),
+               enumerator.GetPairCount(), dp_cost);
+
+      timer.Reset();
+      timer.Start();
+      enumerator.EnumerateGreedy();
+      timer.Stop();
+      LOG_INFO("%s of %zu tables: greedy took %.3f ms over %zu pairs, "
+               "cost %.0f (%.2fx DP)",
+               ShapeName(shape), num_tables, timer.GetDuration(),
+               enumerator.GetPairCount(), enumerator.GetCost(),
+               enumerator.GetCost() / dp_cost);
+
+      EXPECT_GE(enumerator.GetCost(), dp_cost * (1 - 1e-9));
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
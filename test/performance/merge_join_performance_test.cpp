@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// merge_join_performance_test.cpp
+//
+// Identification: test/performance/merge_join_performance_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "codegen/query_compiler.h"
+#include "common/logger.h"
+#include "common/timer.h"
+#include "planner/hash_join_plan.h"
+#include "planner/hash_plan.h"
+#include "planner/merge_join_plan.h"
+#include "planner/seq_scan_plan.h"
+
+#include "codegen/testing_codegen_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Merge Join Performance Tests
+//===--------------------------------------------------------------------===//
+
+class MergeJoinPerformanceTests : public PelotonCodeGenTest {
+ public:
+  MergeJoinPerformanceTests() : PelotonCodeGenTest() {
+    // Both tables are loaded in the order of their first column, so they're
+    // clustered on the join key
+    LoadTestTable(LeftTableId(), kNumRows);
+    LoadTestTable(RightTableId(), kNumRows);
+  }
+
+  oid_t LeftTableId() const { return test_table_oids[0]; }
+
+  oid_t RightTableId() const { return test_table_oids[1]; }
+
+  // SELECT left_table.a, right_table.b FROM left_table JOIN right_table
+  // ON left_table.a = right_table.a
+  std::unique_ptr<planner::AbstractPlan> MakeJoinPlan(bool merge) {
+    DirectMapList direct_map_list = {{0, {0, 0}}, {1, {1, 1}}};
+    std::unique_ptr<const planner::ProjectInfo> projection{
+        new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+    auto schema = std::shared_ptr<const catalog::Schema>(
+        new catalog::Schema({TestingExecutorUtil::GetColumnInfo(0),
+                             TestingExecutorUtil::GetColumnInfo(1)}));
+
+    std::unique_ptr<planner::AbstractPlan> left_scan{new planner::SeqScanPlan(
+        &GetTestTable(LeftTableId()), nullptr, {0, 1})};
+    std::unique_ptr<planner::AbstractPlan> right_scan{new planner::SeqScanPlan(
+        &GetTestTable(RightTableId()), nullptr, {0, 1})};
+
+    if (merge) {
+      std::vector<planner::MergeJoinPlan::JoinClause> join_clauses;
+      join_clauses.emplace_back(
+          ColRefExpr(type::TypeId::INTEGER, true, 0).release(),
+          ColRefExpr(type::TypeId::INTEGER, false, 0).release(), false);
+      std::unique_ptr<planner::AbstractPlan> mj_plan{new planner::MergeJoinPlan(
+          JoinType::INNER, nullptr, std::move(projection), schema,
+          join_clauses)};
+      mj_plan->AddChild(std::move(left_scan));
+      mj_plan->AddChild(std::move(right_scan));
+      return mj_plan;
+    }
+
+    std::vector<ConstExpressionPtr> left_hash_keys;
+    left_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+    std::vector<ConstExpressionPtr> right_hash_keys;
+    right_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+    std::vector<ConstExpressionPtr> hash_keys;
+    hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+
+    std::unique_ptr<planner::AbstractPlan> hj_plan{new planner::HashJoinPlan(
+        JoinType::INNER, nullptr, std::move(projection), schema,
+        left_hash_keys, right_hash_keys, true)};
+    std::unique_ptr<planner::AbstractPlan> hash_plan{
+        new planner::HashPlan(hash_keys)};
+    hash_plan->AddChild(std::move(right_scan));
+    hj_plan->AddChild(std::move(left_scan));
+    hj_plan->AddChild(std::move(hash_plan));
+    return hj_plan;
+  }
+
+  // Runs the join the given number of times and returns the average time
+  // taken to execute it in ms, leaving out compilation
+  double RunJoin(bool merge, size_t repetitions) {
+    double total_ms = 0;
+    for (size_t i = 0; i < repetitions; i++) {
+      auto plan = MakeJoinPlan(merge);
+      planner::BindingContext context;
+      plan->PerformBinding(context);
+      codegen::BufferingConsumer buffer{{0, 1}, context};
+
+      Timer<std::milli> timer;
+      timer.Start();
+      auto stats = CompileAndExecute(*plan, buffer);
+      timer.Stop();
+      total_ms += timer.GetDuration() - stats.setup_ms - stats.ir_gen_ms -
+                  stats.jit_ms;
+      EXPECT_EQ(kNumRows, buffer.GetOutputTuples().size());
+    }
+    return total_ms / repetitions;
+  }
+
+  static constexpr uint32_t kNumRows = 500000;
+};
+
+constexpr uint32_t MergeJoinPerformanceTests::kNumRows;
+
+TEST_F(MergeJoinPerformanceTests, ClusteredJoinTest) {
+  const size_t repetitions = 5;
+  double hash_ms = RunJoin(false, repetitions);
+  double merge_ms = RunJoin(true, repetitions);
+  LOG_INFO("Joining two tables of %u rows clustered on the join key took "
+           "%.2f ms with a hash join and %.2f ms with a merge join (%.2fx)",
+           kNumRows, hash_ms, merge_ms, hash_ms / merge_ms);
+}
+
+}  // namespace test
+}  // namespace peloton
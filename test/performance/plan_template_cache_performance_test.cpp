@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_template_cache_performance_test.cpp
+//
+// Identification: test/performance/plan_template_cache_performance_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "catalog/catalog.h"
+#include "common/logger.h"
+#include "common/timer.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/plan_template_cache.h"
+#include "parser/postgresparser.h"
+#include "settings/settings_manager.h"
+#include "sql/testing_sql_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Plan Template Cache Performance Tests
+//===--------------------------------------------------------------------===//
+
+class PlanTemplateCachePerformanceTests : public PelotonTest {};
+
+// Optimizes each query the given number of times and returns the average time
+// taken per query in ms
+double OptimizeQueries(const std::vector<std::string> &queries,
+                       size_t repetitions) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto &peloton_parser = parser::PostgresParser::GetInstance();
+  Timer<std::milli> timer;
+  for (size_t i = 0; i < repetitions; i++) {
+    for (auto &query : queries) {
+      auto stmt = peloton_parser.BuildParseTree(query);
+      auto txn = txn_manager.BeginTransaction();
+      optimizer::Optimizer optimizer;
+      timer.Start();
+      auto plan = optimizer.BuildPelotonPlanTree(stmt, DEFAULT_DB_NAME, txn);
+      timer.Stop();
+      txn_manager.CommitTransaction(txn);
+      EXPECT_NE(nullptr, plan);
+    }
+  }
+  return timer.GetDuration() / (repetitions * queries.size());
+}
+
+TEST_F(PlanTemplateCachePerformanceTests, TPCCStatementsTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // The tables and statements of the TPC-C new order and stock level
+  // transactions
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE warehouse(w_id INT PRIMARY KEY, w_tax DECIMAL);");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE district(d_id INT, d_w_id INT, d_tax DECIMAL, "
+      "d_next_o_id INT, PRIMARY KEY(d_w_id, d_id));");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE customer(c_id INT, c_d_id INT, c_w_id INT, "
+      "c_discount DECIMAL, c_last VARCHAR(16), c_credit VARCHAR(2), "
+      "PRIMARY KEY(c_w_id, c_d_id, c_id));");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE item(i_id INT PRIMARY KEY, i_price DECIMAL, "
+      "i_name VARCHAR(24));");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE stock(s_i_id INT, s_w_id INT, s_quantity INT, "
+      "PRIMARY KEY(s_w_id, s_i_id));");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE order_line(ol_o_id INT, ol_d_id INT, ol_w_id INT, "
+      "ol_number INT, ol_i_id INT, ol_amount DECIMAL, "
+      "PRIMARY KEY(ol_w_id, ol_d_id, ol_o_id, ol_number));");
+
+  std::vector<std::string> queries = {
+      "SELECT w_tax FROM warehouse WHERE w_id = $1",
+      "SELECT d_tax, d_next_o_id FROM district WHERE d_w_id = $1 AND "
+      "d_id = $2",
+      "SELECT c_discount, c_last, c_credit FROM customer WHERE c_w_id = $1 "
+      "AND c_d_id = $2 AND c_id = $3",
+      "SELECT i_price, i_name FROM item WHERE i_id = $1",
+      "SELECT s_quantity FROM stock WHERE s_w_id = $1 AND s_i_id = $2",
+      "SELECT COUNT(DISTINCT s_i_id) FROM order_line, stock WHERE "
+      "ol_w_id = $1 AND ol_d_id = $2 AND ol_o_id < $3 AND ol_o_id >= $4 AND "
+      "s_w_id = $5 AND s_i_id = ol_i_id AND s_quantity < $6",
+      "SELECT c_id, c_last FROM customer, district, warehouse WHERE "
+      "c_w_id = w_id AND c_d_id = d_id AND d_w_id = w_id AND w_id = $1 "
+      "ORDER BY c_last"};
+  const size_t repetitions = 1000;
+
+  auto &cache = optimizer::PlanTemplateCache::GetInstance();
+  cache.Clear();
+  double uncached_ms = OptimizeQueries(queries, repetitions);
+
+  settings::SettingsManager::SetBool(settings::SettingId::plan_template_cache,
+                                     true);
+  auto hits = cache.GetHitCount();
+  double cached_ms = OptimizeQueries(queries, repetitions);
+  settings::SettingsManager::SetBool(settings::SettingId::plan_template_cache,
+                                     false);
+
+  LOG_INFO("Optimizing took %.4f ms per query without the plan template "
+           "cache and %.4f ms with it (%.1fx), %zu hits",
+           uncached_ms, cached_ms, uncached_ms / cached_ms,
+           static_cast<size_t>(cache.GetHitCount() - hits));
+  EXPECT_EQ(queries.size() * (repetitions - 1), cache.GetHitCount() - hits);
+  cache.Clear();
+
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+}  // namespace test
+}  // namespace peloton
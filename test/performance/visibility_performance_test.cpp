@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// visibility_performance_test.cpp
+//
+// Identification: test/performance/visibility_performance_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+#include "executor/testing_executor_util.h"
+
+#include "common/timer.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "settings/settings_manager.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Visibility Check Tests
+//===--------------------------------------------------------------------===//
+
+class VisibilityPerformanceTests : public PelotonTest {};
+
+// Time the visibility checks of a scan over every tuple in the table, and
+// return the number of visible tuples
+static size_t ScanVisibility(storage::DataTable *table, bool batched,
+                             double &duration) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction(IsolationLevelType::READ_ONLY);
+
+  Timer<> timer;
+  timer.Start();
+
+  size_t visible_count = 0;
+  std::vector<uint32_t> selection_vector;
+  for (oid_t tg_offset = 0; tg_offset < table->GetTileGroupCount();
+       tg_offset++) {
+    auto tile_group_header = table->GetTileGroup(tg_offset)->GetHeader();
+    oid_t tid_end = tile_group_header->GetCurrentNextTupleSlot();
+    selection_vector.resize(tid_end);
+
+    if (batched) {
+      visible_count += txn_manager.FilterVisible(
+          txn, tile_group_header, 0, tid_end, selection_vector.data());
+    } else {
+      for (oid_t tuple_id = 0; tuple_id < tid_end; tuple_id++) {
+        visible_count +=
+            (txn_manager.IsVisible(txn, tile_group_header, tuple_id) ==
+             VisibilityType::OK);
+      }
+    }
+  }
+
+  timer.Stop();
+  duration = timer.GetDuration();
+
+  txn_manager.CommitTransaction(txn);
+  return visible_count;
+}
+
+TEST_F(VisibilityPerformanceTests, ScanVisibilityTest) {
+  const int tuples_per_tilegroup = 10000;
+  const int tuple_count = 100 * tuples_per_tilegroup;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  for (bool columnar : {false, true}) {
+    settings::SettingsManager::SetBool(
+        settings::SettingId::columnar_mvcc_header, columnar);
+
+    std::unique_ptr<storage::DataTable> table(
+        TestingExecutorUtil::CreateTable(tuples_per_tilegroup, false));
+    auto txn = txn_manager.BeginTransaction();
+    TestingExecutorUtil::PopulateTable(table.get(), tuple_count, false, false,
+                                       false, txn);
+    txn_manager.CommitTransaction(txn);
+
+    for (bool batched : {false, true}) {
+      double duration = 0;
+      auto visible_count = ScanVisibility(table.get(), batched, duration);
+      EXPECT_EQ(static_cast<size_t>(tuple_count), visible_count);
+
+      LOG_INFO("%s header, %s check: %.2lf ms, %.2lf ns/tuple",
+               columnar ? "columnar" : "row",
+               batched ? "batched" : "per-tuple", duration * 1000,
+               duration * 1e9 / tuple_count);
+    }
+  }
+
+  settings::SettingsManager::SetBool(settings::SettingId::columnar_mvcc_header,
+                                     false);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// metrics_registry_test.cpp
+//
+// Identification: test/statistics/metrics_registry_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "statistics/metrics_registry.h"
+
+#include "common/harness.h"
+
+namespace peloton {
+namespace test {
+
+class MetricsRegistryTests : public PelotonTest {};
+
+TEST_F(MetricsRegistryTests, ScrapeTest) {
+  auto &registry = stats::MetricsRegistry::GetInstance();
+
+  int64_t count = 0;
+  registry.RegisterCounter("test_requests_total", "Requests handled",
+                           [&count] { return static_cast<double>(count); });
+  registry.RegisterGauge("test_queue_size", "Queued requests",
+                         [] { return 7.0; });
+  registry.RegisterSummary("test_latency_ms", "Request latency",
+                           [](stats::LatencyHistogram &histogram) {
+                             for (int i = 0; i < 100; i++) {
+                               histogram.Record(10.0);
+                             }
+                           });
+
+  count = 12345678;
+  std::string scrape = registry.Scrape();
+  EXPECT_NE(std::string::npos,
+            scrape.find("# HELP test_requests_total Requests handled\n"
+                        "# TYPE test_requests_total counter\n"
+                        "test_requests_total 12345678\n"));
+  EXPECT_NE(std::string::npos,
+            scrape.find("# TYPE test_queue_size gauge\n"
+                        "test_queue_size 7\n"));
+  EXPECT_NE(std::string::npos, scrape.find("# TYPE test_latency_ms summary\n"
+                                           "test_latency_ms{quantile=\"0.5\"} "
+                                           "10"));
+  EXPECT_NE(std::string::npos, scrape.find("test_latency_ms_sum 1000\n"));
+  EXPECT_NE(std::string::npos, scrape.find("test_latency_ms_count 100\n"));
+  // Every scrape measures itself
+  EXPECT_NE(std::string::npos,
+            scrape.find("peloton_metrics_scrape_time_ms_count 1\n"));
+
+  // Values are read at scrape time
+  count++;
+  EXPECT_NE(std::string::npos,
+            registry.Scrape().find("test_requests_total 12345679\n"));
+
+  registry.Unregister("test_requests_total");
+  registry.Unregister("test_queue_size");
+  registry.Unregister("test_latency_ms");
+  EXPECT_EQ(std::string::npos, registry.Scrape().find("test_"));
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -22,7 +22,9 @@
 
 #include "executor/executor_context.h"
 #include "executor/insert_executor.h"
+#include "statistics/access_counter_array.h"
 #include "statistics/backend_stats_context.h"
+#include "statistics/latency_histogram.h"
 #include "statistics/stats_aggregator.h"
 #include "traffic_cop/traffic_cop.h"
 
@@ -104,7 +106,7 @@ void TransactionTest(storage::Database *database, storage::DataTable *table,
 
     // Record database stat
     for (int i = 0; i < NUM_DB_COMMIT; i++) {
-      context->GetOnGoingQueryMetric()->GetQueryLatency().RecordLatency();
+      context->GetOnGoingQueryMetric()->RecordLatency();
       context->IncrementTxnCommitted(db_oid);
     }
     for (int i = 0; i < NUM_DB_ABORT; i++) {
@@ -113,6 +115,81 @@ void TransactionTest(storage::Database *database, storage::DataTable *table,
   }
 }
 
+TEST_F(StatsTests, AccessCounterArrayTest) {
+  stats::AccessCounterArray counter_array;
+  oid_t database_id = 1 | DATABASE_OID_MASK;
+  oid_t table_id = 100 | TABLE_OID_MASK;
+  oid_t other_table_id = 5000 | TABLE_OID_MASK;
+
+  auto &counters = counter_array.GetCounters(database_id, table_id, table_id);
+  stats::AccessCounters::Add(counters.reads, 3);
+  stats::AccessCounters::Add(counters.deletes, 1);
+  EXPECT_EQ(&counters,
+            &counter_array.GetCounters(database_id, table_id, table_id));
+  auto &other_counters = counter_array.GetCounters(database_id, other_table_id,
+                                                   other_table_id);
+  stats::AccessCounters::Add(other_counters.inserts, 2);
+
+  // Only the tables that were counted are visited
+  stats::AccessMetric table_access{MetricType::ACCESS};
+  size_t num_tables = 0;
+  counter_array.ForEach([&](const stats::AccessCounters &counters) {
+    EXPECT_EQ(database_id, counters.database_id);
+    EXPECT_TRUE(counters.table_id == table_id ||
+                counters.table_id == other_table_id);
+    counters.AggregateInto(table_access);
+    num_tables++;
+  });
+  EXPECT_EQ(2, num_tables);
+  EXPECT_EQ(3, table_access.GetReads());
+  EXPECT_EQ(0, table_access.GetUpdates());
+  EXPECT_EQ(2, table_access.GetInserts());
+  EXPECT_EQ(1, table_access.GetDeletes());
+
+  counter_array.Reset();
+  EXPECT_EQ(0, counters.reads.load());
+  EXPECT_EQ(0, other_counters.inserts.load());
+}
+
+TEST_F(StatsTests, LatencyHistogramTest) {
+  stats::LatencyHistogram histogram;
+  EXPECT_EQ(0, histogram.GetCount());
+  EXPECT_EQ(0.0, histogram.GetPercentile(0.5));
+
+  // 1ms to 1000ms, percentiles are within the error of a bucket
+  for (int i = 1; i <= 1000; i++) {
+    histogram.Record(i);
+  }
+  EXPECT_EQ(1000, histogram.GetCount());
+  EXPECT_NEAR(500500.0, histogram.GetSum(), 0.001);
+  EXPECT_NEAR(1.0, histogram.GetMin(), 0.03);
+  EXPECT_NEAR(500.0, histogram.GetPercentile(0.5), 500.0 * 0.03);
+  EXPECT_NEAR(990.0, histogram.GetPercentile(0.99), 990.0 * 0.03);
+  EXPECT_NEAR(999.0, histogram.GetPercentile(0.999), 999.0 * 0.03);
+  EXPECT_NEAR(1000.0, histogram.GetMax(), 1000.0 * 0.03);
+
+  // Merging another thread's latencies shifts the percentiles
+  stats::LatencyHistogram other;
+  for (int i = 0; i < 1000; i++) {
+    other.Record(2000.0);
+  }
+  stats::LatencyHistogram merged;
+  merged.Merge(histogram);
+  merged.Merge(other);
+  EXPECT_EQ(2000, merged.GetCount());
+  EXPECT_NEAR(1000.0, merged.GetPercentile(0.5), 1000.0 * 0.03);
+  EXPECT_NEAR(2000.0, merged.GetPercentile(0.75), 2000.0 * 0.03);
+
+  // Subtracting an earlier copy leaves the latencies recorded since
+  merged.Subtract(histogram);
+  EXPECT_EQ(1000, merged.GetCount());
+  EXPECT_NEAR(2000.0, merged.GetMin(), 2000.0 * 0.03);
+
+  merged.Reset();
+  EXPECT_EQ(0, merged.GetCount());
+  EXPECT_EQ(0.0, merged.GetMax());
+}
+
 TEST_F(StatsTests, MultiThreadStatsTest) {
   auto catalog = catalog::Catalog::GetInstance();
   catalog->Bootstrap();
@@ -18,7 +18,9 @@
 #include "storage/tile_group.h"
 #include "storage/database.h"
 
+#include "catalog/manager.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "storage/tile_group_header.h"
 
 namespace peloton {
 namespace test {
@@ -41,37 +43,122 @@ TEST_F(DataTableTests, TransformTileGroupTest) {
                                    true, txn);
   txn_manager.CommitTransaction(txn);
 
+  auto &catalog_manager = catalog::Manager::GetInstance();
+  auto tile_group_id = data_table->GetTileGroup(0)->GetTileGroupId();
+  std::vector<type::Value> values;
+  for (int tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    values.push_back(data_table->GetTileGroup(0)->GetValue(tuple_itr, 3));
+  }
+
+  // Only all-visible tile groups are transformed. The GC is not running, so
+  // freeze the tile group by hand.
+  auto freeze = [&]() {
+    auto header = catalog_manager.GetTileGroup(tile_group_id)->GetHeader();
+    EXPECT_TRUE(header->BeginFreeze());
+    EXPECT_TRUE(header->FinishFreeze());
+  };
+
   // Create the new column map
   storage::column_map_type column_map;
   column_map[0] = std::make_pair(0, 0);
   column_map[1] = std::make_pair(0, 1);
   column_map[2] = std::make_pair(1, 0);
   column_map[3] = std::make_pair(1, 1);
+  data_table->SetDefaultLayout(column_map);
 
   auto theta = 0.0;
 
   // Transform the tile group
-  data_table->TransformTileGroup(0, theta);
+  EXPECT_EQ(nullptr, data_table->TransformTileGroup(0, theta));
+  freeze();
+  EXPECT_NE(nullptr, data_table->TransformTileGroup(0, theta));
 
   // Create the another column map
   column_map[0] = std::make_pair(0, 0);
   column_map[1] = std::make_pair(0, 1);
   column_map[2] = std::make_pair(0, 2);
   column_map[3] = std::make_pair(1, 0);
+  data_table->SetDefaultLayout(column_map);
 
   // Transform the tile group
-  data_table->TransformTileGroup(0, theta);
+  freeze();
+  EXPECT_NE(nullptr, data_table->TransformTileGroup(0, theta));
 
   // Create the another column map
   column_map[0] = std::make_pair(0, 0);
   column_map[1] = std::make_pair(1, 0);
   column_map[2] = std::make_pair(1, 1);
   column_map[3] = std::make_pair(1, 2);
+  data_table->SetDefaultLayout(column_map);
 
   // Transform the tile group
-  data_table->TransformTileGroup(0, theta);
+  freeze();
+  EXPECT_NE(nullptr, data_table->TransformTileGroup(0, theta));
+
+  // The tile group is swapped in with its tuples unchanged
+  auto tile_group = catalog_manager.GetTileGroup(tile_group_id);
+  EXPECT_EQ(column_map, tile_group->GetColumnMap());
+  EXPECT_EQ(tuple_count, tile_group->GetActiveTupleCount());
+  for (int tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    EXPECT_EQ(CmpBool::CmpTrue,
+              tile_group->GetValue(tuple_itr, 3).CompareEquals(
+                  values[tuple_itr]));
+  }
 }
 
+TEST_F(DataTableTests, TransformTileGroupOwnershipTest) {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuple_count, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuple_count, false, false,
+                                   true, txn);
+  txn_manager.CommitTransaction(txn);
+
+  storage::column_map_type column_map;
+  column_map[0] = std::make_pair(0, 0);
+  column_map[1] = std::make_pair(0, 1);
+  column_map[2] = std::make_pair(1, 0);
+  column_map[3] = std::make_pair(1, 1);
+  data_table->SetDefaultLayout(column_map);
+
+  auto orig_tile_group = data_table->GetTileGroup(0);
+  auto orig_header = orig_tile_group->GetHeader();
+  EXPECT_TRUE(orig_header->BeginFreeze());
+  EXPECT_TRUE(orig_header->FinishFreeze());
+
+  // A writer that began before the transformation can modify neither copy
+  auto old_txn = txn_manager.BeginTransaction();
+  auto new_tile_group = data_table->TransformTileGroup(0, 0.0);
+  EXPECT_NE(nullptr, new_tile_group);
+  EXPECT_TRUE(orig_header->IsRelocated());
+  EXPECT_FALSE(orig_header->IsAllVisible());
+  EXPECT_FALSE(
+      txn_manager.AcquireOwnership(old_txn, orig_header, 0));
+  EXPECT_EQ(INITIAL_TXN_ID, orig_header->GetTransactionId(0));
+  EXPECT_FALSE(txn_manager.AcquireOwnership(
+      old_txn, new_tile_group->GetHeader(), 0));
+  txn_manager.AbortTransaction(old_txn);
+
+  // A writer that began after it modifies the new tile group
+  auto new_txn = txn_manager.BeginTransaction();
+  EXPECT_FALSE(txn_manager.AcquireOwnership(new_txn, orig_header, 0));
+  EXPECT_TRUE(txn_manager.AcquireOwnership(
+      new_txn, new_tile_group->GetHeader(), 0));
+  txn_manager.YieldOwnership(new_txn, new_tile_group->GetHeader(), 0);
+  txn_manager.CommitTransaction(new_txn);
+
+  // Thawing cancels a transformation in progress
+  auto header = new_tile_group->GetHeader();
+  EXPECT_TRUE(header->BeginFreeze());
+  EXPECT_TRUE(header->FinishFreeze());
+  EXPECT_TRUE(header->BeginRelocate());
+  EXPECT_TRUE(header->ClearAllVisible());
+  EXPECT_FALSE(header->FinishRelocate());
+  EXPECT_FALSE(header->IsRelocated());
+}
 
 TEST_F(DataTableTests, GlobalTableTest) {
   const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
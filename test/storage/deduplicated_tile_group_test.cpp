@@ -0,0 +1,211 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// deduplicated_tile_group_test.cpp
+//
+// Identification: test/storage/deduplicated_tile_group_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "catalog/manager.h"
+#include "catalog/schema.h"
+#include "storage/deduplicated_tile_group.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_factory.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+#include "storage/zone_map_manager.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Deduplicated Tile Group Tests
+//===--------------------------------------------------------------------===//
+
+class DeduplicatedTileGroupTests : public PelotonTest {};
+
+TEST_F(DeduplicatedTileGroupTests, DeduplicationTest) {
+  // The integers are as wide as a pointer, so every string field is aligned
+  catalog::Column column1(type::TypeId::BIGINT,
+                          type::Type::GetTypeSize(type::TypeId::BIGINT), "A",
+                          true);
+  catalog::Column column2(type::TypeId::VARCHAR, 25, "B", false);
+  std::vector<catalog::Schema> schemas = {
+      catalog::Schema({column1, column2})};
+  std::map<oid_t, std::pair<oid_t, oid_t>> column_map;
+  column_map[0] = std::make_pair(0, 0);
+  column_map[1] = std::make_pair(0, 1);
+
+  const int tuple_count = 100;
+  const int distinct_count = 4;
+  std::shared_ptr<storage::TileGroup> tile_group(
+      storage::TileGroupFactory::GetTileGroup(
+          INVALID_OID, INVALID_OID,
+          TestingHarness::GetInstance().GetNextTileGroupId(), nullptr, schemas,
+          column_map, tuple_count));
+
+  // Low-cardinality strings, with every 10th one null
+  std::unique_ptr<storage::Tuple> tuple(
+      new storage::Tuple(&schemas[0], true));
+  for (int i = 0; i < tuple_count; i++) {
+    tuple->SetValue(0, type::ValueFactory::GetBigIntValue(100 + i), nullptr);
+    if (i % 10 == 0) {
+      tuple->SetValue(
+          1, type::ValueFactory::GetNullValueByType(type::TypeId::VARCHAR),
+          nullptr);
+    } else {
+      tuple->SetValue(1,
+                      type::ValueFactory::GetVarcharValue(
+                          "value " + std::to_string(i % distinct_count)),
+                      nullptr);
+    }
+    tile_group->InsertTuple(tuple.get());
+  }
+
+  std::vector<storage::DeduplicatedTileGroup::RetiredVarlen> retired;
+  auto dedup = storage::DeduplicatedTileGroup::Deduplicate(tile_group.get(),
+                                                           nullptr, retired);
+
+  // Every non-null string but one per value is freed
+  int non_null_count = tuple_count - tuple_count / 10;
+  EXPECT_EQ(non_null_count - distinct_count, retired.size());
+  EXPECT_LT(0, dedup->GetSavedBytes());
+
+  auto &string_column = dedup->GetColumn(1);
+  EXPECT_EQ(storage::DeduplicatedTileGroup::ColumnEncoding::DEDUPLICATED,
+            string_column.encoding);
+  EXPECT_EQ(distinct_count, string_column.distinct.size());
+
+  // The values are unchanged, and equal values share their entry
+  auto entry = dedup->LookupEntry(
+      1, type::ValueFactory::GetVarcharValue("value 1"));
+  EXPECT_NE(nullptr, entry);
+  EXPECT_TRUE(dedup->IsSharedEntry(entry));
+  EXPECT_EQ(nullptr, dedup->LookupEntry(
+                         1, type::ValueFactory::GetVarcharValue("value 9")));
+  auto tile = tile_group->GetTile(0);
+  size_t offset = tile->GetSchema()->GetOffset(1);
+  for (int i = 0; i < tuple_count; i++) {
+    auto value = tile_group->GetValue(i, 1);
+    if (i % 10 == 0) {
+      EXPECT_TRUE(value.IsNull());
+      continue;
+    }
+    EXPECT_EQ("value " + std::to_string(i % distinct_count),
+              value.ToString());
+    auto field = *reinterpret_cast<const char *const *>(
+        tile->GetTupleLocation(i) + offset);
+    EXPECT_EQ(i % distinct_count == 1, field == entry);
+  }
+
+  // Integers are left as they are, but their bounds are known
+  auto &int_column = dedup->GetColumn(0);
+  EXPECT_EQ(storage::DeduplicatedTileGroup::ColumnEncoding::NONE,
+            int_column.encoding);
+  EXPECT_EQ(100, int_column.min.GetAs<int64_t>());
+  EXPECT_EQ(199, int_column.max.GetAs<int64_t>());
+
+  // Predicates no tuple satisfies are detected without scanning
+  std::vector<storage::PredicateInfo> predicates(1);
+  predicates[0].col_id = 1;
+  predicates[0].comparison_operator =
+      static_cast<int>(ExpressionType::COMPARE_EQUAL);
+  predicates[0].predicate_value =
+      type::ValueFactory::GetVarcharValue("value 9");
+  EXPECT_FALSE(dedup->ShouldScan(predicates.data(), 1));
+  predicates[0].predicate_value =
+      type::ValueFactory::GetVarcharValue("value 3");
+  EXPECT_TRUE(dedup->ShouldScan(predicates.data(), 1));
+  predicates[0].col_id = 0;
+  predicates[0].comparison_operator =
+      static_cast<int>(ExpressionType::COMPARE_GREATERTHAN);
+  predicates[0].predicate_value = type::ValueFactory::GetBigIntValue(199);
+  EXPECT_FALSE(dedup->ShouldScan(predicates.data(), 1));
+  predicates[0].predicate_value = type::ValueFactory::GetBigIntValue(198);
+  EXPECT_TRUE(dedup->ShouldScan(predicates.data(), 1));
+
+  // Deduplicating again keeps the entries and retires nothing new
+  std::vector<storage::DeduplicatedTileGroup::RetiredVarlen> retired_again;
+  auto dedup_again = storage::DeduplicatedTileGroup::Deduplicate(
+      tile_group.get(), dedup.get(), retired_again);
+  EXPECT_EQ(0, retired_again.size());
+  EXPECT_EQ(entry,
+            dedup_again->LookupEntry(
+                1, type::ValueFactory::GetVarcharValue("value 1")));
+
+  // A thawed tile group is no longer scanned as deduplicated, but the GC still
+  // knows which strings are shared
+  tile_group->SetDedup(dedup);
+  tile_group->SetDedup(nullptr);
+  EXPECT_EQ(nullptr, tile_group->GetDedup());
+  EXPECT_EQ(dedup, tile_group->GetLastDedup());
+
+  for (auto &varlen : retired) {
+    varlen.first->GetPool()->Free(varlen.second);
+  }
+}
+
+TEST_F(DeduplicatedTileGroupTests, UnalignedColumnTest) {
+  // The strings follow a 4-byte integer, so half of the fields are not
+  // aligned and cannot be rewritten with a single store
+  catalog::Column column1(type::TypeId::INTEGER,
+                          type::Type::GetTypeSize(type::TypeId::INTEGER), "A",
+                          true);
+  catalog::Column column2(type::TypeId::VARCHAR, 25, "B", false);
+  std::vector<catalog::Schema> schemas = {
+      catalog::Schema({column1, column2})};
+  std::map<oid_t, std::pair<oid_t, oid_t>> column_map;
+  column_map[0] = std::make_pair(0, 0);
+  column_map[1] = std::make_pair(0, 1);
+
+  const int tuple_count = 10;
+  std::shared_ptr<storage::TileGroup> tile_group(
+      storage::TileGroupFactory::GetTileGroup(
+          INVALID_OID, INVALID_OID,
+          TestingHarness::GetInstance().GetNextTileGroupId(), nullptr, schemas,
+          column_map, tuple_count));
+
+  std::unique_ptr<storage::Tuple> tuple(
+      new storage::Tuple(&schemas[0], true));
+  for (int i = 0; i < tuple_count; i++) {
+    tuple->SetValue(0, type::ValueFactory::GetIntegerValue(i), nullptr);
+    tuple->SetValue(1, type::ValueFactory::GetVarcharValue("value"), nullptr);
+    tile_group->InsertTuple(tuple.get());
+  }
+
+  std::vector<storage::DeduplicatedTileGroup::RetiredVarlen> retired;
+  auto dedup = storage::DeduplicatedTileGroup::Deduplicate(tile_group.get(),
+                                                           nullptr, retired);
+
+  // The strings are left alone, but their bounds are still known
+  auto &string_column = dedup->GetColumn(1);
+  EXPECT_EQ(0, retired.size());
+  EXPECT_NE(storage::DeduplicatedTileGroup::ColumnEncoding::DEDUPLICATED,
+            string_column.encoding);
+  EXPECT_TRUE(string_column.distinct.empty());
+  EXPECT_TRUE(string_column.analyzed);
+
+  std::vector<storage::PredicateInfo> predicates(1);
+  predicates[0].col_id = 1;
+  predicates[0].comparison_operator =
+      static_cast<int>(ExpressionType::COMPARE_EQUAL);
+  predicates[0].predicate_value = type::ValueFactory::GetVarcharValue("other");
+  EXPECT_FALSE(dedup->ShouldScan(predicates.data(), 1));
+  predicates[0].predicate_value = type::ValueFactory::GetVarcharValue("value");
+  EXPECT_TRUE(dedup->ShouldScan(predicates.data(), 1));
+
+  for (int i = 0; i < tuple_count; i++) {
+    EXPECT_EQ("value", tile_group->GetValue(i, 1).ToString());
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
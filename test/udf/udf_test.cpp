@@ -76,6 +76,50 @@ TEST_F(UDFTest, SimpleExpressionTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+TEST_F(UDFTest, MultipleCallTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  catalog::Catalog::GetInstance()->Bootstrap();
+  txn_manager.CommitTransaction(txn);
+  // Create a txn
+  txn = txn_manager.BeginTransaction();
+
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE OR REPLACE FUNCTION increment(i double)"
+      " RETURNS double AS $$ BEGIN RETURN i + 1; END;"
+      " $$ LANGUAGE plpgsql;");
+
+  TestingSQLUtil::ExecuteSQLQuery("CREATE TABLE foo(income double);");
+
+  TestingSQLUtil::ExecuteSQLQuery("INSERT into foo values(10.0);");
+
+  TestingSQLUtil::ExecuteSQLQuery("INSERT into foo values(20.0);");
+
+  txn_manager.CommitTransaction(txn);
+  // The UDF body is linked into the query once and inlined at every call
+  std::vector<ResultValue> result;
+  std::vector<FieldInfo> tuple_descriptor;
+  std::string error_message;
+  int rows_affected;
+  std::string testQuery =
+      "select increment(income), increment(increment(income)) from foo;";
+
+  TestingSQLUtil::ExecuteSQLQuery(testQuery.c_str(), result, tuple_descriptor,
+                                  rows_affected, error_message);
+  std::vector<double> outputs = {11.0, 12.0, 21.0, 22.0};
+  for (int i = 0; i < 4; i++) {
+    std::string result_income(
+        TestingSQLUtil::GetResultValueAsString(result, (i)));
+    double income = std::stod(result_income);
+    EXPECT_DOUBLE_EQ(income, (outputs[i]));
+  }
+  // free the database just created
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
 TEST_F(UDFTest, ComplexExpressionTest) {
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
   auto txn = txn_manager.BeginTransaction();
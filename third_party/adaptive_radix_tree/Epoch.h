@@ -3,6 +3,8 @@
 
 #include <atomic>
 #include <array>
+#include <limits>
+#include <mutex>
 
 #include "libcuckoo/cuckoohash_map.hh"
 
@@ -10,13 +12,20 @@ namespace art {
 
 using Deleter = void (*)(void *);
 
+// The classes of memory a tree accounts for. The node classes share their
+// numeric value with NodeType so one can be cast to the other.
+enum class MemoryClass : uint8_t { N4 = 0, N16 = 1, N48 = 2, N256 = 3, Leaf };
+
+static constexpr std::size_t numMemoryClasses = 5;
+
 struct Garbage {
   void *n;
   Deleter deleter_func;
+  std::size_t size;
 
-  Garbage() : n(nullptr), deleter_func() {}
-  Garbage(void *_n, Deleter _deleter_func)
-      : n(_n), deleter_func(_deleter_func) {
+  Garbage() : n(nullptr), deleter_func(), size(0) {}
+  Garbage(void *_n, Deleter _deleter_func, std::size_t _size)
+      : n(_n), deleter_func(_deleter_func), size(_size) {
     assert(n);
     assert(deleter_func);
   }
@@ -42,14 +51,19 @@ class DeletionList {
   std::size_t deletitionListCount = 0;
 
  public:
-  std::atomic<uint64_t> localEpoch;
+  // A thread outside of any epoch does not hold back reclamation
+  std::atomic<uint64_t> localEpoch{std::numeric_limits<uint64_t>::max()};
   size_t thresholdCounter{0};
 
+  // Protects the list against a concurrent Epoch::collectGarbage()
+  std::mutex latch;
+
   ~DeletionList();
 
   LabelDelete *head();
 
-  void add(void *n, Deleter deleter_func, uint64_t globalEpoch);
+  void add(void *n, Deleter deleter_func, std::size_t size,
+           uint64_t globalEpoch);
 
   void remove(LabelDelete *label, LabelDelete *prev);
 
@@ -89,19 +103,56 @@ class Epoch {
 
   size_t startGCThreshhold;
 
+  // Bytes held by reachable nodes of each class, and bytes of nodes that have
+  // been unlinked but not yet reclaimed
+  std::array<std::atomic<int64_t>, numMemoryClasses> liveBytes;
+  std::atomic<int64_t> retiredBytes{0};
+
+  uint64_t getOldestEpoch();
+
+  // Free all garbage in the list unlinked before the provided epoch
+  std::size_t reclaim(DeletionList &deletionList, uint64_t oldestEpoch);
+
  public:
-  Epoch(size_t startGCThreshhold) : startGCThreshhold(startGCThreshhold) {}
+  Epoch(size_t startGCThreshhold) : startGCThreshhold(startGCThreshhold) {
+    for (auto &bytes : liveBytes) {
+      bytes.store(0);
+    }
+  }
 
   ~Epoch();
 
   void enterEpoch(ThreadInfo &threadInfo);
 
-  void markNodeForDeletion(void *n, ThreadInfo &threadInfo);
+  // Leave the current epoch without attempting to reclaim garbage
+  void exitEpoch(ThreadInfo &threadInfo);
+
+  // Account for a newly allocated node of the given class
+  void trackAllocation(MemoryClass memoryClass, std::size_t size);
+
+  // Undo the accounting of a node that was freed without ever being published
+  void untrackAllocation(MemoryClass memoryClass, std::size_t size);
+
+  // Unlink a node of the given class and size. Its memory is reclaimed once
+  // every thread has left the epoch it was unlinked in.
+  void markNodeForDeletion(void *n, MemoryClass memoryClass, std::size_t size,
+                           ThreadInfo &threadInfo);
   void markNodeForDeletion(void *n, Deleter deleter_func,
+                           MemoryClass memoryClass, std::size_t size,
                            ThreadInfo &threadInfo);
 
   void exitEpochAndCleanup(ThreadInfo &threadInfo);
 
+  // Advance the epoch and reclaim all safe garbage from every thread. Returns
+  // the number of nodes freed.
+  std::size_t collectGarbage();
+
+  // Bytes held by reachable nodes of the given class
+  uint64_t getLiveBytes(MemoryClass memoryClass) const;
+
+  // Bytes held by unlinked nodes awaiting reclamation
+  uint64_t getRetiredBytes() const;
+
   void showDeleteRatio();
 
   DeletionList &getDeletionList();
@@ -121,12 +172,17 @@ class EpochGuard {
 };
 
 class EpochGuardReadonly {
+  ThreadInfo &threadEpochInfo;
+
  public:
-  EpochGuardReadonly(ThreadInfo &threadEpochInfo) {
+  EpochGuardReadonly(ThreadInfo &threadEpochInfo)
+      : threadEpochInfo(threadEpochInfo) {
     threadEpochInfo.getEpoch().enterEpoch(threadEpochInfo);
   }
 
-  ~EpochGuardReadonly() {}
+  ~EpochGuardReadonly() {
+    threadEpochInfo.getEpoch().exitEpoch(threadEpochInfo);
+  }
 };
 
 inline ThreadInfo::~ThreadInfo() {
@@ -37,7 +37,8 @@ void DeletionList::remove(LabelDelete *label, LabelDelete *prev) {
   deleted += label->nodesCount;
 }
 
-void DeletionList::add(void *n, Deleter deleter_func, uint64_t globalEpoch) {
+void DeletionList::add(void *n, Deleter deleter_func, std::size_t size,
+                       uint64_t globalEpoch) {
   deletitionListCount++;
   LabelDelete *label;
   if (headDeletionList != nullptr &&
@@ -54,7 +55,7 @@ void DeletionList::add(void *n, Deleter deleter_func, uint64_t globalEpoch) {
     label->next = headDeletionList;
     headDeletionList = label;
   }
-  label->nodes[label->nodesCount] = Garbage{n, deleter_func};
+  label->nodes[label->nodesCount] = Garbage{n, deleter_func, size};
   label->nodesCount++;
   label->epoch = globalEpoch;
 
@@ -69,20 +70,78 @@ void Epoch::enterEpoch(ThreadInfo &threadInfo) {
                                                 std::memory_order_release);
 }
 
+void Epoch::exitEpoch(ThreadInfo &threadInfo) {
+  threadInfo.getDeletionList().localEpoch.store(
+      std::numeric_limits<uint64_t>::max(), std::memory_order_release);
+}
+
 namespace {
 void stdOperatorDelete(void *n) {
   operator delete(n);
 }
 }  // anonymous namespace
 
-void Epoch::markNodeForDeletion(void *n, ThreadInfo &threadInfo) {
-  markNodeForDeletion(n, stdOperatorDelete, threadInfo);
+void Epoch::trackAllocation(MemoryClass memoryClass, std::size_t size) {
+  liveBytes[static_cast<std::size_t>(memoryClass)].fetch_add(
+      size, std::memory_order_relaxed);
+}
+
+void Epoch::untrackAllocation(MemoryClass memoryClass, std::size_t size) {
+  liveBytes[static_cast<std::size_t>(memoryClass)].fetch_sub(
+      size, std::memory_order_relaxed);
+}
+
+void Epoch::markNodeForDeletion(void *n, MemoryClass memoryClass,
+                                std::size_t size, ThreadInfo &threadInfo) {
+  markNodeForDeletion(n, stdOperatorDelete, memoryClass, size, threadInfo);
 }
 
 void Epoch::markNodeForDeletion(void *n, Deleter deleter_func,
+                                MemoryClass memoryClass, std::size_t size,
                                 ThreadInfo &threadInfo) {
-  threadInfo.getDeletionList().add(n, deleter_func, currentEpoch.load());
-  threadInfo.getDeletionList().thresholdCounter++;
+  liveBytes[static_cast<std::size_t>(memoryClass)].fetch_sub(
+      size, std::memory_order_relaxed);
+  retiredBytes.fetch_add(size, std::memory_order_relaxed);
+
+  DeletionList &deletionList = threadInfo.getDeletionList();
+  {
+    std::lock_guard<std::mutex> lock(deletionList.latch);
+    deletionList.add(n, deleter_func, size, currentEpoch.load());
+  }
+  deletionList.thresholdCounter++;
+}
+
+uint64_t Epoch::getOldestEpoch() {
+  uint64_t oldestEpoch = std::numeric_limits<uint64_t>::max();
+  auto locked_table = deletionLists.lock_table();
+  for (auto &iter : locked_table) {
+    auto e = iter.second->localEpoch.load();
+    if (e < oldestEpoch) {
+      oldestEpoch = e;
+    }
+  }
+  return oldestEpoch;
+}
+
+std::size_t Epoch::reclaim(DeletionList &deletionList, uint64_t oldestEpoch) {
+  std::size_t freed = 0;
+  LabelDelete *cur = deletionList.head(), *next, *prev = nullptr;
+  while (cur != nullptr) {
+    next = cur->next;
+
+    if (cur->epoch < oldestEpoch) {
+      for (std::size_t i = 0; i < cur->nodesCount; ++i) {
+        retiredBytes.fetch_sub(cur->nodes[i].size, std::memory_order_relaxed);
+        cur->nodes[i].Delete();
+      }
+      freed += cur->nodesCount;
+      deletionList.remove(cur, prev);
+    } else {
+      prev = cur;
+    }
+    cur = next;
+  }
+  return freed;
 }
 
 void Epoch::exitEpochAndCleanup(ThreadInfo &threadInfo) {
@@ -90,41 +149,46 @@ void Epoch::exitEpochAndCleanup(ThreadInfo &threadInfo) {
   if ((deletionList.thresholdCounter & (64 - 1)) == 1) {
     currentEpoch++;
   }
-  if (deletionList.thresholdCounter > startGCThreshhold) {
-    if (deletionList.size() == 0) {
-      deletionList.thresholdCounter = 0;
-      return;
-    }
-    deletionList.localEpoch.store(std::numeric_limits<uint64_t>::max());
 
-    uint64_t oldestEpoch = std::numeric_limits<uint64_t>::max();
+  // We're done with the tree, our epoch must not hold back reclamation
+  exitEpoch(threadInfo);
+
+  if (deletionList.thresholdCounter > startGCThreshhold) {
+    uint64_t oldestEpoch = getOldestEpoch();
     {
-      auto locked_table = deletionLists.lock_table();
-      for (auto &iter : locked_table) {
-        auto &dl = iter.second;
-        auto e = dl->localEpoch.load();
-        if (e < oldestEpoch) {
-          oldestEpoch = e;
-        }
-      }
+      std::lock_guard<std::mutex> lock(deletionList.latch);
+      reclaim(deletionList, oldestEpoch);
     }
+    deletionList.thresholdCounter = 0;
+  }
+}
 
-    LabelDelete *cur = deletionList.head(), *next, *prev = nullptr;
-    while (cur != nullptr) {
-      next = cur->next;
+std::size_t Epoch::collectGarbage() {
+  // Nodes unlinked in the current epoch become collectable once every thread
+  // that may still see them has moved on to the next one
+  currentEpoch++;
 
-      if (cur->epoch < oldestEpoch) {
-        for (std::size_t i = 0; i < cur->nodesCount; ++i) {
-          cur->nodes[i].Delete();
-        }
-        deletionList.remove(cur, prev);
-      } else {
-        prev = cur;
-      }
-      cur = next;
-    }
-    deletionList.thresholdCounter = 0;
+  uint64_t oldestEpoch = getOldestEpoch();
+
+  std::size_t freed = 0;
+  auto locked_table = deletionLists.lock_table();
+  for (auto &iter : locked_table) {
+    auto *deletionList = iter.second;
+    std::lock_guard<std::mutex> lock(deletionList->latch);
+    freed += reclaim(*deletionList, oldestEpoch);
   }
+  return freed;
+}
+
+uint64_t Epoch::getLiveBytes(MemoryClass memoryClass) const {
+  auto bytes = liveBytes[static_cast<std::size_t>(memoryClass)].load(
+      std::memory_order_relaxed);
+  return bytes < 0 ? 0 : static_cast<uint64_t>(bytes);
+}
+
+uint64_t Epoch::getRetiredBytes() const {
+  auto bytes = retiredBytes.load(std::memory_order_relaxed);
+  return bytes < 0 ? 0 : static_cast<uint64_t>(bytes);
 }
 
 Epoch::~Epoch() {
@@ -165,6 +165,8 @@ bool LeafNode::insertGrow(Node *n, TID val,
 
     // We need to create a new external leaf
     auto *newLeaf = LeafNode::create(4);
+    threadInfo.getEpoch().trackAllocation(MemoryClass::Leaf,
+                                          newLeaf->getSize());
     newLeaf->insertNoDupCheck(tid);
     newLeaf->insertNoDupCheck(val);
     Node::change(parent, parentKey, setExternal(newLeaf));
@@ -199,14 +201,18 @@ bool LeafNode::insertGrow(Node *n, TID val,
       return false;
     }
 
-    auto *newLeaf = LeafNode::create(leaf->capacity * 2);
+    auto *newLeaf =
+        LeafNode::create(leaf->capacity * 2, leaf->getKey(), leaf->keyLen);
+    threadInfo.getEpoch().trackAllocation(MemoryClass::Leaf,
+                                          newLeaf->getSize());
     leaf->copyTo(newLeaf);
     bool inserted = newLeaf->insert(val);
 
     Node::change(parent, parentKey, setExternal(newLeaf));
 
     leaf->writeUnlockObsolete();
-    threadInfo.getEpoch().markNodeForDeletion(leaf, doDeleteLeaf, threadInfo);
+    threadInfo.getEpoch().markNodeForDeletion(
+        leaf, doDeleteLeaf, MemoryClass::Leaf, leaf->getSize(), threadInfo);
     parent->writeUnlock();
 
     return inserted;
@@ -250,8 +256,16 @@ bool LeafNode::removeShrink(Node *n, TID val, uint8_t parentKey, Node *parent,
     return false;
   }
 
-  // If the leaf is under-full, we'll inline the remaining TID into the parent
-  if (leaf->count == 2) {
+  // A leaf storing its key is unlinked by Tree::remove() once its last TID is
+  // removed. If we get here, a concurrent removal beat us to it.
+  if (leaf->hasKey() && leaf->count == 1) {
+    needRestart = true;
+    return false;
+  }
+
+  // If the leaf is under-full, we'll inline the remaining TID into the parent.
+  // Leaves storing their key are kept so lookups never need to load it.
+  if (leaf->count == 2 && !leaf->hasKey()) {
     parent->upgradeToWriteLockOrRestart(pv, needRestart);
     if (needRestart) return false;
 
@@ -265,7 +279,8 @@ bool LeafNode::removeShrink(Node *n, TID val, uint8_t parentKey, Node *parent,
     Node::change(parent, parentKey, LeafNode::setInlined(second));
 
     leaf->writeUnlockObsolete();
-    threadInfo.getEpoch().markNodeForDeletion(leaf, doDeleteLeaf, threadInfo);
+    threadInfo.getEpoch().markNodeForDeletion(
+        leaf, doDeleteLeaf, MemoryClass::Leaf, leaf->getSize(), threadInfo);
     parent->writeUnlock();
     return true;
   }
@@ -281,10 +296,31 @@ bool LeafNode::removeShrink(Node *n, TID val, uint8_t parentKey, Node *parent,
   return true;
 }
 
-LeafNode *LeafNode::create(uint32_t capacity) {
-  void *mem = malloc(sizeof(LeafNode) + (sizeof(TID) * capacity));
+LeafNode *LeafNode::lockSoleValue(Node *n, TID val, bool &needRestart) {
+  if (!isExternal(n)) {
+    return nullptr;
+  }
+
+  auto *leaf = getExternal(n);
+  uint64_t v = leaf->readLockOrRestart(needRestart);
+  if (needRestart) return nullptr;
+
+  if (!leaf->hasKey() || leaf->count != 1 || leaf->vals[0] != val) {
+    leaf->readUnlockOrRestart(v, needRestart);
+    return nullptr;
+  }
+
+  leaf->upgradeToWriteLockOrRestart(v, needRestart);
+  if (needRestart) return nullptr;
+
+  return leaf;
+}
+
+LeafNode *LeafNode::create(uint32_t capacity, const uint8_t *key,
+                           uint32_t keyLen) {
+  void *mem = malloc(getSize(capacity, keyLen));
   assert(mem);
-  return new (mem) LeafNode(capacity);
+  return new (mem) LeafNode(capacity, key, keyLen);
 }
 
 //===----------------------------------------------------------------------===//
@@ -293,9 +329,12 @@ LeafNode *LeafNode::create(uint32_t capacity) {
 //
 //===----------------------------------------------------------------------===//
 
-LeafNode::LeafNode(uint32_t _capacity)
-    : lock(0), count(0), capacity(_capacity) {
+LeafNode::LeafNode(uint32_t _capacity, const uint8_t *key, uint32_t _keyLen)
+    : lock(0), count(0), capacity(_capacity), keyLen(_keyLen) {
   memset(vals, 0, sizeof(TID) * capacity);
+  if (keyLen > 0) {
+    memcpy(vals + capacity, key, keyLen);
+  }
 }
 
 TID LeafNode::getAnyNoLock() const {
@@ -19,6 +19,10 @@ enum class NodeType : uint8_t { N4 = 0, N16 = 1, N48 = 2, N256 = 3 };
 
 static constexpr uint32_t maxStoredPrefixLength = 11;
 
+// Keys up to this length may be stored in their leaf rather than re-loaded
+// through the tree's key loader. This covers four 8-byte integer columns.
+static constexpr uint32_t maxInlineKeyLength = 32;
+
 using Prefix = uint8_t[maxStoredPrefixLength];
 
 class OptimisticRWLock {
@@ -133,6 +137,15 @@ class Node {
 
   static void deleteNode(Node *node);
 
+  //===--------------------------------------------------------------------===//
+  // MEMORY ACCOUNTING
+  //===--------------------------------------------------------------------===//
+
+  static MemoryClass getMemoryClass(const Node *node);
+
+  // The number of bytes allocated for the given (non-leaf) node
+  static std::size_t getSize(const Node *node);
+
   //===--------------------------------------------------------------------===//
   // NODE ACCESS
   //===--------------------------------------------------------------------===//
@@ -143,7 +156,8 @@ class Node {
   // Get any child of the current node.
   static Node *getAnyChild(const Node *n);
 
-  static TID getAnyChildTid(const Node *n, bool &needRestart);
+  // Get any leaf below the current node.
+  static const Node *getAnyChildLeaf(const Node *n, bool &needRestart);
 
   static std::tuple<Node *, uint8_t> getSecondChild(Node *node, uint8_t k);
 
@@ -378,10 +392,14 @@ class Node256 : public Node {
 };
 
 class LeafNode {
+  friend class Tree;
+
  private:
   OptimisticRWLock lock;
   uint32_t count;
   uint32_t capacity;
+  // Length of the key stored after the values, zero if the key isn't stored
+  uint32_t keyLen;
   TID vals[0];
 
  public:
@@ -409,11 +427,29 @@ class LeafNode {
                            uint64_t pv, bool &needRestart,
                            ThreadInfo &threadInfo);
 
-  static LeafNode *create(uint32_t capacity);
+  // If the given leaf stores its key and holds only the provided TID, return
+  // it write-locked. Removing that TID must unlink the leaf from its parent.
+  static LeafNode *lockSoleValue(Node *n, TID val, bool &needRestart);
+
+  static LeafNode *create(uint32_t capacity, const uint8_t *key = nullptr,
+                          uint32_t keyLen = 0);
+
+  // The number of bytes allocated for this leaf
+  std::size_t getSize() const { return getSize(capacity, keyLen); }
+  static std::size_t getSize(uint32_t capacity, uint32_t keyLen = 0) {
+    return sizeof(LeafNode) + (sizeof(TID) * capacity) + keyLen;
+  }
+
+  // Does this leaf store the key all its values map to?
+  bool hasKey() const { return keyLen != 0; }
+  const uint8_t *getKey() const {
+    return reinterpret_cast<const uint8_t *>(vals + capacity);
+  }
+  uint32_t getKeyLen() const { return keyLen; }
 
  private:
   // Private constructor, use factory method
-  explicit LeafNode(uint32_t capacity);
+  LeafNode(uint32_t capacity, const uint8_t *key, uint32_t keyLen);
 
   //===--------------------------------------------------------------------===//
   // LOCKING
@@ -193,6 +193,30 @@ void Node::deleteNode(Node *node) {
   __builtin_unreachable();
 }
 
+//===----------------------------------------------------------------------===//
+//
+// MEMORY ACCOUNTING
+//
+//===----------------------------------------------------------------------===//
+
+MemoryClass Node::getMemoryClass(const Node *node) {
+  return static_cast<MemoryClass>(node->getType());
+}
+
+std::size_t Node::getSize(const Node *node) {
+  switch (node->getType()) {
+    case NodeType::N4:
+      return sizeof(Node4);
+    case NodeType::N16:
+      return sizeof(Node16);
+    case NodeType::N48:
+      return sizeof(Node48);
+    case NodeType::N256:
+      return sizeof(Node256);
+  }
+  __builtin_unreachable();
+}
+
 //===----------------------------------------------------------------------===//
 //
 // NODE ACCESS
@@ -245,21 +269,21 @@ Node *Node::getAnyChild(const Node *node) {
   __builtin_unreachable();
 }
 
-TID Node::getAnyChildTid(const Node *n, bool &needRestart) {
+const Node *Node::getAnyChildLeaf(const Node *n, bool &needRestart) {
   const Node *nextNode = n;
 
   while (true) {
     const Node *node = nextNode;
     auto v = node->readLockOrRestart(needRestart);
-    if (needRestart) return 0;
+    if (needRestart) return nullptr;
 
     nextNode = getAnyChild(node);
     node->readUnlockOrRestart(v, needRestart);
-    if (needRestart) return 0;
+    if (needRestart) return nullptr;
 
     assert(nextNode != nullptr);
     if (isLeaf(nextNode)) {
-      return getLeaf(nextNode);
+      return nextNode;
     }
   }
 }
@@ -349,13 +373,16 @@ void Node::insertGrow(CurNodeType *n, uint64_t v, Node *parentNode,
   }
 
   auto nBig = new BiggerNodeType(n->getPrefix(), n->getPrefixLength());
+  threadInfo.getEpoch().trackAllocation(Node::getMemoryClass(nBig),
+                                        sizeof(BiggerNodeType));
   n->copyTo(nBig);
   nBig->insert(key, val);
 
   Node::change(parentNode, keyParent, Node::setNonLeaf(nBig));
 
   n->writeUnlockObsolete();
-  threadInfo.getEpoch().markNodeForDeletion(n, threadInfo);
+  threadInfo.getEpoch().markNodeForDeletion(
+      n, Node::getMemoryClass(n), sizeof(*n), threadInfo);
   parentNode->writeUnlock();
 }
 
@@ -386,13 +413,16 @@ void Node::removeAndShrink(CurNodeType *n, uint64_t v, Node *parentNode,
   }
 
   auto nSmall = new SmallerNodeType(n->getPrefix(), n->getPrefixLength());
+  threadInfo.getEpoch().trackAllocation(Node::getMemoryClass(nSmall),
+                                        sizeof(SmallerNodeType));
 
   n->copyTo(nSmall);
   nSmall->remove(key);
   Node::change(parentNode, keyParent, Node::setNonLeaf(nSmall));
 
   n->writeUnlockObsolete();
-  threadInfo.getEpoch().markNodeForDeletion(n, threadInfo);
+  threadInfo.getEpoch().markNodeForDeletion(
+      n, Node::getMemoryClass(n), sizeof(*n), threadInfo);
   parentNode->writeUnlock();
 }
 
@@ -437,7 +467,8 @@ void Node::removeAndShrink<Node4, Node4>(Node4 *n, uint64_t v, Node *parentNode,
     parentNode->writeUnlock();
 
     n->writeUnlockObsolete();
-    threadInfo.getEpoch().markNodeForDeletion(n, threadInfo);
+    threadInfo.getEpoch().markNodeForDeletion(
+      n, Node::getMemoryClass(n), sizeof(*n), threadInfo);
   } else {
     secondNodeN->writeLockOrRestart(needRestart);
     if (needRestart) {
@@ -454,7 +485,8 @@ void Node::removeAndShrink<Node4, Node4>(Node4 *n, uint64_t v, Node *parentNode,
     secondNodeN->writeUnlock();
 
     n->writeUnlockObsolete();
-    threadInfo.getEpoch().markNodeForDeletion(n, threadInfo);
+    threadInfo.getEpoch().markNodeForDeletion(
+      n, Node::getMemoryClass(n), sizeof(*n), threadInfo);
   }
 }
 
@@ -8,8 +8,13 @@
 
 namespace art {
 
-Tree::Tree(LoadKeyFunction loadKey, void *ctx)
-    : root(new Node256(nullptr, 0)), keyLoader(loadKey, ctx), epoch(256) {}
+Tree::Tree(LoadKeyFunction loadKey, void *ctx, bool _inlineKeys)
+    : root(new Node256(nullptr, 0)),
+      keyLoader(loadKey, ctx),
+      inlineKeys(_inlineKeys),
+      epoch(256) {
+  epoch.trackAllocation(MemoryClass::N256, sizeof(Node256));
+}
 
 Tree::~Tree() {
   Node::deleteChildren(root);
@@ -26,16 +31,63 @@ void yield(int count) {
   }
 }
 
-TID Tree::checkKey(const TID tid, const Key &k) const {
+void Tree::KeyLoader::load(const Node *leaf, Key &key) const {
+  if (LeafNode::isExternal(leaf)) {
+    // The key of a leaf never changes, so no lock is needed to read it
+    const auto *external = LeafNode::getExternal(leaf);
+    if (external->hasKey()) {
+      key.set(reinterpret_cast<const char *>(external->getKey()),
+              external->getKeyLen());
+      return;
+    }
+  }
+  loadKey(ctx, Node::getLeaf(leaf), key);
+}
+
+bool Tree::checkKey(const Node *leaf, const Key &k) const {
   Key kt;
-  keyLoader.load(tid, kt);
-  return (k == kt ? tid : 0);
+  keyLoader.load(leaf, kt);
+  return k == kt;
+}
+
+Node *Tree::newLeaf(const Key &k, TID tid) {
+  if (!inlineKeys || k.getKeyLen() > maxInlineKeyLength) {
+    return Node::setLeaf(tid);
+  }
+  auto *leaf = LeafNode::create(1, &k[0], k.getKeyLen());
+  epoch.trackAllocation(MemoryClass::Leaf, leaf->getSize());
+  leaf->insertNoDupCheck(tid);
+  return LeafNode::setExternal(leaf);
+}
+
+void Tree::discardLeaf(Node *leaf) {
+  if (LeafNode::isExternal(leaf)) {
+    epoch.untrackAllocation(MemoryClass::Leaf,
+                            LeafNode::getExternal(leaf)->getSize());
+    LeafNode::deleteLeaf(leaf);
+  }
 }
 
 void Tree::setLoadKeyFunc(Tree::LoadKeyFunction loadKey, void *ctx) {
   keyLoader.reset(loadKey, ctx);
 }
 
+uint64_t Tree::getMemoryUsage(MemoryClass memoryClass) const {
+  return epoch.getLiveBytes(memoryClass);
+}
+
+uint64_t Tree::getGarbageSize() const { return epoch.getRetiredBytes(); }
+
+uint64_t Tree::getMemoryFootprint() const {
+  uint64_t bytes = getGarbageSize();
+  for (std::size_t i = 0; i < numMemoryClasses; i++) {
+    bytes += getMemoryUsage(static_cast<MemoryClass>(i));
+  }
+  return bytes;
+}
+
+std::size_t Tree::collectGarbage() { return epoch.collectGarbage(); }
+
 bool Tree::lookup(const Key &k, std::vector<TID> &results,
                   ThreadInfo &threadEpochInfo) const {
   EpochGuardReadonly epochGuard(threadEpochInfo);
@@ -84,7 +136,7 @@ restart:
           if (needRestart) goto restart;
 
           if (level < k.getKeyLen() - 1 || optimisticPrefixMatch) {
-            if (checkKey(results[0], k) == 0) {
+            if (!checkKey(node, k)) {
               // Optimistic prefix match failed
               results.clear();
               return false;
@@ -104,6 +156,115 @@ restart:
   }
 }
 
+void Tree::lookupBatch(const Key *const keys[], std::size_t numKeys,
+                       std::vector<TID> results[],
+                       ThreadInfo &threadEpochInfo) const {
+  // Lookups that hit a concurrent modification. These are retried on their
+  // own once we've left the epoch.
+  std::vector<std::size_t> restarted;
+  {
+    EpochGuardReadonly epochGuard(threadEpochInfo);
+    for (std::size_t start = 0; start < numKeys; start += lookupBatchSize) {
+      Probe probes[lookupBatchSize];
+      std::size_t active = 0;
+      std::size_t end = std::min(start + lookupBatchSize, numKeys);
+      for (std::size_t i = start; i < end; i++) {
+        bool needRestart = false;
+        uint64_t v = root->readLockOrRestart(needRestart);
+        if (needRestart) {
+          restarted.push_back(i);
+          continue;
+        }
+        probes[active++] = Probe{i, root, v, nullptr, 0, false};
+      }
+
+      // Round-robin over the active lookups until all are done
+      while (active > 0) {
+        for (std::size_t j = 0; j < active;) {
+          Probe &probe = probes[j];
+          bool needRestart = false;
+          bool done = advanceProbe(probe, *keys[probe.idx], results[probe.idx],
+                                   needRestart);
+          if (needRestart) {
+            results[probe.idx].clear();
+            restarted.push_back(probe.idx);
+          }
+          if (done || needRestart) {
+            probes[j] = probes[--active];
+          } else {
+            j++;
+          }
+        }
+      }
+    }
+  }
+
+  for (auto idx : restarted) {
+    lookup(*keys[idx], results[idx], threadEpochInfo);
+  }
+}
+
+bool Tree::advanceProbe(Probe &probe, const Key &k, std::vector<TID> &results,
+                        bool &needRestart) const {
+  if (probe.next != nullptr) {
+    // Move to the child found, and prefetched, in the previous round
+    uint64_t nv = probe.next->readLockOrRestart(needRestart);
+    if (needRestart) return true;
+
+    probe.node->readUnlockOrRestart(probe.v, needRestart);
+    if (needRestart) return true;
+
+    probe.node = probe.next;
+    probe.v = nv;
+    probe.next = nullptr;
+  }
+
+  switch (checkPrefix(probe.node, k, probe.level)) {  // Increases level
+    case CheckPrefixResult::NoMatch:
+      probe.node->readUnlockOrRestart(probe.v, needRestart);
+      return true;
+    case CheckPrefixResult::OptimisticMatch:
+      probe.optimisticPrefixMatch = true;
+    // Fallthrough
+    case CheckPrefixResult::Match:
+      break;
+  }
+
+  if (k.getKeyLen() <= probe.level) {
+    return true;
+  }
+
+  Node *child = Node::getChild(k[probe.level], probe.node);
+  probe.node->checkOrRestart(probe.v, needRestart);
+  if (needRestart) return true;
+
+  if (child == nullptr) {
+    // Not found
+    return true;
+  }
+
+  if (Node::isLeaf(child)) {
+    probe.node->readUnlockOrRestart(probe.v, needRestart);
+    if (needRestart) return true;
+
+    LeafNode::readLeaf(child, results, needRestart);
+    if (needRestart) return true;
+
+    if (probe.level < k.getKeyLen() - 1 || probe.optimisticPrefixMatch) {
+      if (!checkKey(child, k)) {
+        // Optimistic prefix match failed
+        results.clear();
+      }
+    }
+    return true;
+  }
+
+  probe.level++;
+  probe.next = child;
+  __builtin_prefetch(child);
+  return false;
+}
+
 bool Tree::lookupRange(const Key &start, const Key &end, Key &continueKey,
                        std::vector<TID> &results, uint32_t softMaxResults,
                        ThreadInfo &threadEpochInfo) const {
@@ -117,7 +278,7 @@ bool Tree::lookupRange(const Key &start, const Key &end, Key &continueKey,
   }
 
   EpochGuard epochGuard(threadEpochInfo);
-  TID toContinue = 0;
+  const Node *toContinue = nullptr;
 
   // This function copies all leaves in the tree rooted at the provided node
   // into the result vector, stopping if the result size exceeds the limited
@@ -127,7 +288,7 @@ bool Tree::lookupRange(const Key &start, const Key &end, Key &continueKey,
                                                       bool &needRestart) {
         if (Node::isLeaf(node)) {
           if (results.size() >= softMaxResults) {
-            toContinue = Node::getLeaf(node);
+            toContinue = node;
             return;
           }
           LeafNode::readLeaf(node, results, needRestart);
@@ -141,7 +302,7 @@ bool Tree::lookupRange(const Key &start, const Key &end, Key &continueKey,
             const Node *n = std::get<1>(children[i]);
             copy(n, needRestart);
             if (needRestart) return;
-            if (toContinue != 0) {
+            if (toContinue != nullptr) {
               break;
             }
           }
@@ -223,7 +384,7 @@ bool Tree::lookupRange(const Key &start, const Key &end, Key &continueKey,
                 copy(n, needRestart);
                 if (needRestart) return;
               }
-              if (toContinue != 0) {
+              if (toContinue != nullptr) {
                 break;
               }
             }
@@ -300,7 +461,7 @@ bool Tree::lookupRange(const Key &start, const Key &end, Key &continueKey,
                 copy(n, needRestart);
                 if (needRestart) return;
               }
-              if (toContinue != 0) {
+              if (toContinue != nullptr) {
                 break;
               }
             }
@@ -375,7 +536,7 @@ restart:
               findEnd(n, k, level + 1, node, v, needRestart);
               if (needRestart) goto restart;
             }
-            if (toContinue) {
+            if (toContinue != nullptr) {
               break;
             }
           }
@@ -404,7 +565,7 @@ restart:
     }
     break;
   }
-  if (toContinue != 0) {
+  if (toContinue != nullptr) {
     keyLoader.load(toContinue, continueKey);
     return true;
   } else {
@@ -460,9 +621,10 @@ restart:
         // 1) Create a new node which will be parent of the current node. Set
         //    common prefix and level to this node.
         auto newNode = new Node4(node->getPrefix(), nextLevel - level);
+        epoch.trackAllocation(MemoryClass::N4, sizeof(Node4));
 
         // 2)  Add node and (*k, tid) as children
-        newNode->insert(k[nextLevel], Node::setLeaf(tid));
+        newNode->insert(k[nextLevel], newLeaf(k, tid));
         newNode->insert(nonMatchingKey, node);
 
         // 3) UpgradeToWriteLockOrRestart, update parentNode to point to the new
@@ -487,10 +649,13 @@ restart:
     if (needRestart) goto restart;
 
     if (nextNode == nullptr) {
+      Node *leaf = newLeaf(k, tid);
       Node::insertAndUnlock(node, v, parentNode, parentVersion, parentKey,
-                            nodeKey, Node::setLeaf(tid), needRestart,
-                            epochInfo);
-      if (needRestart) goto restart;
+                            nodeKey, leaf, needRestart, epochInfo);
+      if (needRestart) {
+        discardLeaf(leaf);
+        goto restart;
+      }
       return true;
     }
 
@@ -501,7 +666,7 @@ restart:
 
     if (Node::isLeaf(nextNode)) {
       Key key;
-      keyLoader.load(Node::getLeaf(nextNode), key);
+      keyLoader.load(nextNode, key);
 
       if (key == k) {
         bool inserted = LeafNode::insertGrow(nextNode, tid, predicate, k[level],
@@ -520,7 +685,8 @@ restart:
       }
 
       auto n4 = new Node4(&k[level], prefixLength);
-      n4->insert(k[level + prefixLength], Node::setLeaf(tid));
+      epoch.trackAllocation(MemoryClass::N4, sizeof(Node4));
+      n4->insert(k[level + prefixLength], newLeaf(k, tid));
       n4->insert(key[level + prefixLength], nextNode);
       Node::change(node, k[level - 1], Node::setNonLeaf(n4));
       node->writeUnlock();
@@ -572,21 +738,35 @@ restart:
           return false;
         }
         if (Node::isLeaf(nextNode)) {
+          // An external leaf storing its key whose only TID we're removing.
+          // It stays write-locked until it has been unlinked below.
+          LeafNode *soleLeaf = nullptr;
           if (LeafNode::isInlined(nextNode) && Node::getLeaf(nextNode) != tid) {
             return false;
           } else if (LeafNode::isExternal(nextNode)) {
-            return LeafNode::removeShrink(nextNode, tid, k[level], node, v,
-                                          needRestart, threadInfo);
+            soleLeaf = LeafNode::lockSoleValue(nextNode, tid, needRestart);
+            if (needRestart) goto restart;
+            if (soleLeaf == nullptr) {
+              bool removed =
+                  LeafNode::removeShrink(nextNode, tid, k[level], node, v,
+                                         needRestart, threadInfo);
+              if (needRestart) goto restart;
+              return removed;
+            }
           }
 
           assert(parentNode == nullptr || node->getCount() != 1);
           if (node->getCount() == 2 && parentNode != nullptr) {
             parentNode->upgradeToWriteLockOrRestart(parentVersion, needRestart);
-            if (needRestart) goto restart;
+            if (needRestart) {
+              if (soleLeaf != nullptr) soleLeaf->writeUnlock();
+              goto restart;
+            }
 
             node->upgradeToWriteLockOrRestart(v, needRestart);
             if (needRestart) {
               parentNode->writeUnlock();
+              if (soleLeaf != nullptr) soleLeaf->writeUnlock();
               goto restart;
             }
             // 1. check remaining entries
@@ -600,12 +780,14 @@ restart:
 
               parentNode->writeUnlock();
               node->writeUnlockObsolete();
-              epoch.markNodeForDeletion(node, threadInfo);
+              epoch.markNodeForDeletion(node, Node::getMemoryClass(node),
+                                        Node::getSize(node), threadInfo);
             } else {
               secondNodeN->writeLockOrRestart(needRestart);
               if (needRestart) {
                 node->writeUnlock();
                 parentNode->writeUnlock();
+                if (soleLeaf != nullptr) soleLeaf->writeUnlock();
                 goto restart;
               }
 
@@ -617,12 +799,21 @@ restart:
               secondNodeN->writeUnlock();
 
               node->writeUnlockObsolete();
-              epoch.markNodeForDeletion(node, threadInfo);
+              epoch.markNodeForDeletion(node, Node::getMemoryClass(node),
+                                        Node::getSize(node), threadInfo);
             }
           } else {
             Node::removeAndUnlock(node, v, k[level], parentNode, parentVersion,
                                   parentKey, needRestart, threadInfo);
-            if (needRestart) goto restart;
+            if (needRestart) {
+              if (soleLeaf != nullptr) soleLeaf->writeUnlock();
+              goto restart;
+            }
+          }
+          if (soleLeaf != nullptr) {
+            soleLeaf->writeUnlockObsolete();
+            epoch.markNodeForDeletion(soleLeaf, doDeleteLeaf, MemoryClass::Leaf,
+                                      soleLeaf->getSize(), threadInfo);
           }
           return true;
         }
@@ -662,9 +853,9 @@ Tree::CheckPrefixPessimisticResult Tree::checkPrefixPessimistic(
     Key kt;
     for (uint32_t i = 0; i < n->getPrefixLength(); ++i) {
       if (i == maxStoredPrefixLength) {
-        auto anyTID = Node::getAnyChildTid(n, needRestart);
+        auto anyLeaf = Node::getAnyChildLeaf(n, needRestart);
         if (needRestart) return CheckPrefixPessimisticResult::Match;
-        keyLoader.load(anyTID, kt);
+        keyLoader.load(anyLeaf, kt);
       }
       uint8_t curKey =
           i >= maxStoredPrefixLength ? kt[level] : n->getPrefix()[i];
@@ -672,9 +863,9 @@ Tree::CheckPrefixPessimisticResult Tree::checkPrefixPessimistic(
         nonMatchingKey = curKey;
         if (n->getPrefixLength() > maxStoredPrefixLength) {
           if (i < maxStoredPrefixLength) {
-            auto anyTID = Node::getAnyChildTid(n, needRestart);
+            auto anyLeaf = Node::getAnyChildLeaf(n, needRestart);
             if (needRestart) return CheckPrefixPessimisticResult::Match;
-            keyLoader.load(anyTID, kt);
+            keyLoader.load(anyLeaf, kt);
           }
           memcpy(nonMatchingPrefix, &kt[0] + level + 1,
                  std::min((n->getPrefixLength() - (level - prevLevel) - 1),
@@ -700,9 +891,9 @@ Tree::PCCompareResults Tree::checkPrefixCompare(const Node *n, const Key &k,
     Key kt;
     for (uint32_t i = 0; i < n->getPrefixLength(); ++i) {
       if (i == maxStoredPrefixLength) {
-        auto anyTID = Node::getAnyChildTid(n, needRestart);
+        auto anyLeaf = Node::getAnyChildLeaf(n, needRestart);
         if (needRestart) return PCCompareResults::Equal;
-        keyLoader.load(anyTID, kt);
+        keyLoader.load(anyLeaf, kt);
       }
       uint8_t kLevel = (k.getKeyLen() > level) ? k[level] : fillKey;
 
@@ -727,9 +918,9 @@ Tree::PCEqualsResults Tree::checkPrefixEquals(const Node *n, uint32_t &level,
     Key kt;
     for (uint32_t i = 0; i < n->getPrefixLength(); ++i) {
       if (i == maxStoredPrefixLength) {
-        auto anyTID = Node::getAnyChildTid(n, needRestart);
+        auto anyLeaf = Node::getAnyChildLeaf(n, needRestart);
         if (needRestart) return PCEqualsResults::BothMatch;
-        keyLoader.load(anyTID, kt);
+        keyLoader.load(anyLeaf, kt);
       }
       uint8_t startLevel = (start.getKeyLen() > level) ? start[level] : 0;
       uint8_t endLevel = (end.getKeyLen() > level) ? end[level] : 255;
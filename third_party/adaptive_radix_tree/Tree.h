@@ -13,8 +13,10 @@ class Tree {
   using LoadKeyFunction = void (*)(void *ctx, TID tid, Key &key);
 
  public:
-  /// Constructor
-  explicit Tree(LoadKeyFunction loadKey, void *arg);
+  /// Constructor. If inlineKeys is set, keys of at most maxInlineKeyLength
+  /// bytes are stored in their leaf so that lookups never call loadKey for
+  /// them.
+  explicit Tree(LoadKeyFunction loadKey, void *arg, bool inlineKeys = false);
 
   ~Tree();
 
@@ -30,6 +32,15 @@ class Tree {
   bool lookup(const Key &k, std::vector<TID> &results,
               ThreadInfo &threadEpochInfo) const;
 
+  /// Lookup the TIDs of each of the provided keys, storing those of keys[i]
+  /// in results[i]. Lookups are run in groups that advance one node at a
+  /// time, prefetching the next node of each lookup so that their cache
+  /// misses overlap. Keys should be sorted so that neighbouring lookups share
+  /// their path through the tree.
+  void lookupBatch(const Key *const keys[], std::size_t numKeys,
+                   std::vector<TID> results[],
+                   ThreadInfo &threadEpochInfo) const;
+
   /// Looks up all key-value pairs between the provided start and end keys.
   /// Results are placed in the provided result vector (of the provided size).
   /// The actual number of results that were inserted is in the output parameter
@@ -53,6 +64,22 @@ class Tree {
 
   void setLoadKeyFunc(LoadKeyFunction loadKey, void *ctx);
 
+  /// Are short keys stored in the leaves of this tree?
+  bool storesKeysInline() const { return inlineKeys; }
+
+  /// Bytes held by reachable nodes of the given class
+  uint64_t getMemoryUsage(MemoryClass memoryClass) const;
+
+  /// Bytes held by unlinked nodes that have not been reclaimed yet
+  uint64_t getGarbageSize() const;
+
+  /// Total bytes held by the tree, including garbage awaiting reclamation
+  uint64_t getMemoryFootprint() const;
+
+  /// Reclaim all unlinked nodes that no thread can still observe. Returns the
+  /// number of nodes freed.
+  std::size_t collectGarbage();
+
  private:
   // Class to help loading the key for a given TID
   class KeyLoader {
@@ -73,11 +100,40 @@ class Tree {
     }
 
     void load(TID tid, Key &key) const { loadKey(ctx, tid, key); }
+
+    // Load the key of the provided leaf, reading it from the leaf itself if
+    // it's stored there
+    void load(const Node *leaf, Key &key) const;
+  };
+
+  /// The number of lookups lookupBatch() interleaves
+  static constexpr std::size_t lookupBatchSize = 8;
+
+  /// The state of one of the interleaved lookups of lookupBatch()
+  struct Probe {
+    std::size_t idx;
+    Node *node;
+    uint64_t v;
+    Node *next;
+    uint32_t level;
+    bool optimisticPrefixMatch;
   };
 
-  /// Function to check that the key for the provided TID is correct. This is
+  /// Advance the given lookup by one node. Returns true once the lookup has
+  /// finished, or needs to be restarted.
+  bool advanceProbe(Probe &probe, const Key &k, std::vector<TID> &results,
+                    bool &needRestart) const;
+
+  /// Function to check that the key of the provided leaf is correct. This is
   /// done by loading the key and performing a comparison with the provided key.
-  TID checkKey(TID tid, const Key &k) const;
+  bool checkKey(const Node *leaf, const Key &k) const;
+
+  /// Create a leaf for the given key-value pair. The key is stored in the leaf
+  /// if inlining is enabled and the key is short enough.
+  Node *newLeaf(const Key &k, TID tid);
+
+  /// Free a leaf created by newLeaf() that never made it into the tree
+  void discardLeaf(Node *leaf);
 
   /// Optimistic prefix check
   enum class CheckPrefixResult : uint8_t { Match, NoMatch, OptimisticMatch };
@@ -115,6 +171,9 @@ class Tree {
   // A callback function to load a key given a TID
   KeyLoader keyLoader;
 
+  // Should short keys be stored in leaves?
+  const bool inlineKeys;
+
   // GC
   Epoch epoch;
 };